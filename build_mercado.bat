@@ -11,43 +11,142 @@ set SRC=src
 set INC=include
 set OBJ=build\obj
 set BIN=build\bin
+set LIB=build\lib
 
 echo Limpando builds anteriores...
 if exist "%OBJ%\*.o" del /q "%OBJ%\*.o" >nul 2>&1
 if exist "%OBJ%\*.d" del /q "%OBJ%\*.d" >nul 2>&1
 if exist "%BIN%\mercado.exe" del "%BIN%\mercado.exe" >nul 2>&1
+if exist "%LIB%\libmercado.*" del /q "%LIB%\libmercado.*" >nul 2>&1
+if exist "%BIN%\mercado.dll" del "%BIN%\mercado.dll" >nul 2>&1
 
 if not exist "%OBJ%" mkdir "%OBJ%"
 if not exist "%BIN%" mkdir "%BIN%"
+if not exist "%LIB%" mkdir "%LIB%"
 
 echo.
-echo [1/6] Compilando logger.c...
+echo [1/28] Compilando logger.c...
 gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\logger.c" -o "%OBJ%\logger.o"
 if errorlevel 1 goto erro
 
-echo [2/6] Compilando product.c...
+echo [2/28] Compilando product.c...
 gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\product.c" -o "%OBJ%\product.o"
 if errorlevel 1 goto erro
 
-echo [3/6] Compilando persistence.c...
+echo [3/28] Compilando persistence.c...
 gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\persistence.c" -o "%OBJ%\persistence.o"
 if errorlevel 1 goto erro
 
-echo [4/6] Compilando validation.c...
+echo [4/28] Compilando validation.c...
 gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\validation.c" -o "%OBJ%\validation.o"
 if errorlevel 1 goto erro
 
-echo [5/6] Compilando utils.c...
+echo [5/28] Compilando utils.c...
 gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\utils.c" -o "%OBJ%\utils.o"
 if errorlevel 1 goto erro
 
-echo [6/6] Compilando main.c...
+echo [6/28] Compilando movimentacao.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\movimentacao.c" -o "%OBJ%\movimentacao.o"
+if errorlevel 1 goto erro
+
+echo [7/28] Compilando sync.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\sync.c" -o "%OBJ%\sync.o"
+if errorlevel 1 goto erro
+
+echo [8/28] Compilando replay.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\replay.c" -o "%OBJ%\replay.o"
+if errorlevel 1 goto erro
+
+echo [9/28] Compilando velocity.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\velocity.c" -o "%OBJ%\velocity.o"
+if errorlevel 1 goto erro
+
+echo [10/28] Compilando reservation.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\reservation.c" -o "%OBJ%\reservation.o"
+if errorlevel 1 goto erro
+
+echo [11/28] Compilando relatorio.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\relatorio.c" -o "%OBJ%\relatorio.o"
+if errorlevel 1 goto erro
+
+echo [12/28] Compilando aggregation.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\aggregation.c" -o "%OBJ%\aggregation.o"
+if errorlevel 1 goto erro
+
+echo [13/28] Compilando ranking.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\ranking.c" -o "%OBJ%\ranking.o"
+if errorlevel 1 goto erro
+
+echo [14/28] Compilando report_cache.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\report_cache.c" -o "%OBJ%\report_cache.o"
+if errorlevel 1 goto erro
+
+echo [15/28] Compilando snapshot_diff.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\snapshot_diff.c" -o "%OBJ%\snapshot_diff.o"
+if errorlevel 1 goto erro
+
+echo [16/28] Compilando listing.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\listing.c" -o "%OBJ%\listing.o"
+if errorlevel 1 goto erro
+
+echo [17/28] Compilando sorting.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\sorting.c" -o "%OBJ%\sorting.o"
+if errorlevel 1 goto erro
+
+echo [18/28] Compilando name_index.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\name_index.c" -o "%OBJ%\name_index.o"
+if errorlevel 1 goto erro
+
+echo [19/28] Compilando range_index.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\range_index.c" -o "%OBJ%\range_index.o"
+if errorlevel 1 goto erro
+
+echo [20/28] Compilando slot_bitmap.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\slot_bitmap.c" -o "%OBJ%\slot_bitmap.o"
+if errorlevel 1 goto erro
+
+echo [21/28] Compilando filter_query.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\filter_query.c" -o "%OBJ%\filter_query.o"
+if errorlevel 1 goto erro
+
+echo [22/28] Compilando batch.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\batch.c" -o "%OBJ%\batch.o"
+if errorlevel 1 goto erro
+
+echo [23/28] Compilando server.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\server.c" -o "%OBJ%\server.o"
+if errorlevel 1 goto erro
+
+echo [24/28] Compilando mercado.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\mercado.c" -o "%OBJ%\mercado.o"
+if errorlevel 1 goto erro
+
+echo [25/28] Compilando chain.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\chain.c" -o "%OBJ%\chain.o"
+if errorlevel 1 goto erro
+
+echo [26/28] Compilando mvcc.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\mvcc.c" -o "%OBJ%\mvcc.o"
+if errorlevel 1 goto erro
+
+echo [27/28] Compilando replication.c...
+gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\replication.c" -o "%OBJ%\replication.o"
+if errorlevel 1 goto erro
+
+echo [28/28] Compilando main.c...
 gcc -c -I"%INC%" -finput-charset=UTF-8 -fexec-charset=UTF-8 -Wall "%SRC%\main.c" -o "%OBJ%\main.o"
 if errorlevel 1 goto erro
 
 echo.
 echo Linkando executavel...
-gcc "%OBJ%\logger.o" "%OBJ%\product.o" "%OBJ%\persistence.o" "%OBJ%\validation.o" "%OBJ%\utils.o" "%OBJ%\main.o" -o "%BIN%\mercado.exe"
+gcc "%OBJ%\logger.o" "%OBJ%\product.o" "%OBJ%\persistence.o" "%OBJ%\validation.o" "%OBJ%\utils.o" "%OBJ%\movimentacao.o" "%OBJ%\sync.o" "%OBJ%\replay.o" "%OBJ%\velocity.o" "%OBJ%\reservation.o" "%OBJ%\relatorio.o" "%OBJ%\aggregation.o" "%OBJ%\ranking.o" "%OBJ%\report_cache.o" "%OBJ%\snapshot_diff.o" "%OBJ%\listing.o" "%OBJ%\sorting.o" "%OBJ%\name_index.o" "%OBJ%\range_index.o" "%OBJ%\slot_bitmap.o" "%OBJ%\filter_query.o" "%OBJ%\batch.o" "%OBJ%\server.o" "%OBJ%\mercado.o" "%OBJ%\chain.o" "%OBJ%\mvcc.o" "%OBJ%\replication.o" "%OBJ%\main.o" -o "%BIN%\mercado.exe" -pthread -lm
+if errorlevel 1 goto erro
+
+echo.
+echo Gerando libmercado (estatica e DLL)...
+ar rcs "%LIB%\libmercado.a" "%OBJ%\logger.o" "%OBJ%\product.o" "%OBJ%\persistence.o" "%OBJ%\validation.o" "%OBJ%\utils.o" "%OBJ%\movimentacao.o" "%OBJ%\sync.o" "%OBJ%\replay.o" "%OBJ%\velocity.o" "%OBJ%\reservation.o" "%OBJ%\relatorio.o" "%OBJ%\aggregation.o" "%OBJ%\ranking.o" "%OBJ%\report_cache.o" "%OBJ%\snapshot_diff.o" "%OBJ%\listing.o" "%OBJ%\sorting.o" "%OBJ%\name_index.o" "%OBJ%\range_index.o" "%OBJ%\slot_bitmap.o" "%OBJ%\filter_query.o" "%OBJ%\batch.o" "%OBJ%\server.o" "%OBJ%\mercado.o" "%OBJ%\chain.o" "%OBJ%\mvcc.o" "%OBJ%\replication.o"
+if errorlevel 1 goto erro
+gcc -shared "%OBJ%\logger.o" "%OBJ%\product.o" "%OBJ%\persistence.o" "%OBJ%\validation.o" "%OBJ%\utils.o" "%OBJ%\movimentacao.o" "%OBJ%\sync.o" "%OBJ%\replay.o" "%OBJ%\velocity.o" "%OBJ%\reservation.o" "%OBJ%\relatorio.o" "%OBJ%\aggregation.o" "%OBJ%\ranking.o" "%OBJ%\report_cache.o" "%OBJ%\snapshot_diff.o" "%OBJ%\listing.o" "%OBJ%\sorting.o" "%OBJ%\name_index.o" "%OBJ%\range_index.o" "%OBJ%\slot_bitmap.o" "%OBJ%\filter_query.o" "%OBJ%\batch.o" "%OBJ%\server.o" "%OBJ%\mercado.o" "%OBJ%\chain.o" "%OBJ%\mvcc.o" "%OBJ%\replication.o" -o "%BIN%\mercado.dll" -Wl,--out-implib,"%LIB%\libmercado.dll.a" -pthread -lm
 if errorlevel 1 goto erro
 
 echo.
@@ -55,6 +154,7 @@ echo ========================================
 echo   BUILD CONCLUIDO COM SUCESSO!
 echo ========================================
 echo Executavel: %BIN%\mercado.exe
+echo Bibliotecas: %LIB%\libmercado.a, %BIN%\mercado.dll
 echo.
 echo Pressione qualquer tecla para executar...
 pause >nul
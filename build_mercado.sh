@@ -9,6 +9,7 @@ SRC="src"
 INC="include"
 OBJ="build/obj"
 BIN="build/bin"
+LIB="build/lib"
 EXECUTAVEL="$BIN/mercado"
 
 # Cores para o terminal (opcional, mas fica bonito)
@@ -26,10 +27,12 @@ echo ""
 echo "Limpando builds anteriores..."
 rm -f "$OBJ"/*.o "$OBJ"/*.d
 rm -f "$EXECUTAVEL"
+rm -f "$LIB"/libmercado.*
 
 # Cria diretórios se não existirem (-p cria toda a árvore necessária)
 mkdir -p "$OBJ"
 mkdir -p "$BIN"
+mkdir -p "$LIB"
 
 echo ""
 
@@ -43,28 +46,116 @@ check_error() {
 
 # 2. Compilação (Passo a Passo igual ao .bat)
 
-echo "[1/6] Compilando logger.c..."
-gcc -c -I"$INC" -Wall "$SRC/logger.c" -o "$OBJ/logger.o"
+echo "[1/28] Compilando logger.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/logger.c" -o "$OBJ/logger.o"
 check_error "logger.c"
 
-echo "[2/6] Compilando product.c..."
-gcc -c -I"$INC" -Wall "$SRC/product.c" -o "$OBJ/product.o"
+echo "[2/28] Compilando product.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/product.c" -o "$OBJ/product.o"
 check_error "product.c"
 
-echo "[3/6] Compilando persistence.c..."
-gcc -c -I"$INC" -Wall "$SRC/persistence.c" -o "$OBJ/persistence.o"
+echo "[3/28] Compilando persistence.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/persistence.c" -o "$OBJ/persistence.o"
 check_error "persistence.c"
 
-echo "[4/6] Compilando validation.c..."
-gcc -c -I"$INC" -Wall "$SRC/validation.c" -o "$OBJ/validation.o"
+echo "[4/28] Compilando validation.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/validation.c" -o "$OBJ/validation.o"
 check_error "validation.c"
 
-echo "[5/6] Compilando utils.c..."
-gcc -c -I"$INC" -Wall "$SRC/utils.c" -o "$OBJ/utils.o"
+echo "[5/28] Compilando utils.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/utils.c" -o "$OBJ/utils.o"
 check_error "utils.c"
 
-echo "[6/6] Compilando main.c..."
-gcc -c -I"$INC" -Wall "$SRC/main.c" -o "$OBJ/main.o"
+echo "[6/28] Compilando movimentacao.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/movimentacao.c" -o "$OBJ/movimentacao.o"
+check_error "movimentacao.c"
+
+echo "[7/28] Compilando sync.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/sync.c" -o "$OBJ/sync.o"
+check_error "sync.c"
+
+echo "[8/28] Compilando replay.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/replay.c" -o "$OBJ/replay.o"
+check_error "replay.c"
+
+echo "[9/28] Compilando velocity.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/velocity.c" -o "$OBJ/velocity.o"
+check_error "velocity.c"
+
+echo "[10/28] Compilando reservation.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/reservation.c" -o "$OBJ/reservation.o"
+check_error "reservation.c"
+
+echo "[11/28] Compilando relatorio.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/relatorio.c" -o "$OBJ/relatorio.o"
+check_error "relatorio.c"
+
+echo "[12/28] Compilando aggregation.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/aggregation.c" -o "$OBJ/aggregation.o"
+check_error "aggregation.c"
+
+echo "[13/28] Compilando ranking.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/ranking.c" -o "$OBJ/ranking.o"
+check_error "ranking.c"
+
+echo "[14/28] Compilando report_cache.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/report_cache.c" -o "$OBJ/report_cache.o"
+check_error "report_cache.c"
+
+echo "[15/28] Compilando snapshot_diff.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/snapshot_diff.c" -o "$OBJ/snapshot_diff.o"
+check_error "snapshot_diff.c"
+
+echo "[16/28] Compilando listing.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/listing.c" -o "$OBJ/listing.o"
+check_error "listing.c"
+
+echo "[17/28] Compilando sorting.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/sorting.c" -o "$OBJ/sorting.o"
+check_error "sorting.c"
+
+echo "[18/28] Compilando name_index.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/name_index.c" -o "$OBJ/name_index.o"
+check_error "name_index.c"
+
+echo "[19/28] Compilando range_index.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/range_index.c" -o "$OBJ/range_index.o"
+check_error "range_index.c"
+
+echo "[20/28] Compilando slot_bitmap.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/slot_bitmap.c" -o "$OBJ/slot_bitmap.o"
+check_error "slot_bitmap.c"
+
+echo "[21/28] Compilando filter_query.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/filter_query.c" -o "$OBJ/filter_query.o"
+check_error "filter_query.c"
+
+echo "[22/28] Compilando batch.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/batch.c" -o "$OBJ/batch.o"
+check_error "batch.c"
+
+echo "[23/28] Compilando server.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/server.c" -o "$OBJ/server.o"
+check_error "server.c"
+
+echo "[24/28] Compilando mercado.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/mercado.c" -o "$OBJ/mercado.o"
+check_error "mercado.c"
+
+echo "[25/28] Compilando chain.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/chain.c" -o "$OBJ/chain.o"
+check_error "chain.c"
+
+echo "[26/28] Compilando mvcc.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/mvcc.c" -o "$OBJ/mvcc.o"
+check_error "mvcc.c"
+
+echo "[27/28] Compilando replication.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/replication.c" -o "$OBJ/replication.o"
+check_error "replication.c"
+
+echo "[28/28] Compilando main.c..."
+gcc -c -fPIC -I"$INC" -Wall "$SRC/main.c" -o "$OBJ/main.o"
 check_error "main.c"
 
 echo ""
@@ -72,16 +163,25 @@ echo ""
 # 3. Linkagem
 echo "Linkando executável..."
 # O *.o pega todos os objetos na pasta, simplificando a linha
-gcc "$OBJ"/*.o -o "$EXECUTAVEL"
+gcc "$OBJ"/*.o -o "$EXECUTAVEL" -pthread -lm
 check_error "Linkagem final"
 
+# 4. Bibliotecas (todos os objetos menos o menu)
+echo "Gerando libmercado (estatica e compartilhada)..."
+LIB_OBJS=$(ls "$OBJ"/*.o | grep -v '/main\.o$')
+ar rcs "$LIB/libmercado.a" $LIB_OBJS
+check_error "libmercado.a"
+gcc -shared $LIB_OBJS -o "$LIB/libmercado.so" -pthread -lm
+check_error "libmercado.so"
+
 echo ""
 echo -e "${GREEN}========================================${NC}"
 echo -e "${GREEN}  BUILD CONCLUÍDO COM SUCESSO!${NC}"
 echo -e "${GREEN}========================================${NC}"
 echo "Executável: $EXECUTAVEL"
+echo "Bibliotecas: $LIB/libmercado.a, $LIB/libmercado.so"
 echo ""
 
-# 4. Execução
+# 5. Execução
 read -p "Pressione ENTER para executar..."
 ./"$EXECUTAVEL"
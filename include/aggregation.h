@@ -0,0 +1,81 @@
+#ifndef AGGREGATION_H
+#define AGGREGATION_H
+
+#include "product.h"
+
+// ============================================================================
+// MÓDULO: aggregation — Totais do estoque agrupados (categoria, unidade, preço)
+// ============================================================================
+// Agrupa os produtos ativos do banco e calcula, por grupo, contagem,
+// quantidade, valor do estoque e preço mínimo, máximo e médio. Todos os
+// valores monetários são inteiros em centavos (soma exata, sem erro de float).
+// O banco (até MAX_PRODUCTS produtos) é percorrido em uma única passada na
+// thread que chama: com poucas centenas de linhas, criar threads custa mais
+// que a soma inteira.
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// quantidade máxima de grupos de um agrupamento
+#define AGGREGATE_MAX_GROUPS 64
+// largura padrão das faixas de preço (R$ 10,00)
+#define AGGREGATE_DEFAULT_BAND_CENTS 1000
+
+// ============================================================================
+// ENUMERAÇÕES
+// ============================================================================
+
+// critério de agrupamento
+typedef enum {
+    GROUP_BY_CATEGORY = 1,  // uma linha por categoria
+    GROUP_BY_UNIT,          // uma linha por unidade de medida
+    GROUP_BY_PRICE_BAND     // faixas de preço de largura fixa
+} group_by;
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+// totais de um grupo (valores monetários em centavos)
+typedef struct {
+    long long count;            // produtos ativos no grupo
+    long long quantity;         // soma das quantidades em estoque
+    long long value_cents;      // soma de preço × quantidade
+    long long price_sum_cents;  // soma dos preços (para a média)
+    long long min_price_cents;  // menor preço do grupo
+    long long max_price_cents;  // maior preço do grupo
+} aggregate_group;
+
+// resultado de um agrupamento
+typedef struct {
+    group_by key;                               // critério usado
+    long long band_cents;                       // largura das faixas de preço
+    int group_count;                            // grupos possíveis (índices válidos)
+    aggregate_group groups[AGGREGATE_MAX_GROUPS];
+    aggregate_group total;                      // totais de todos os grupos
+    double elapsed_seconds;                     // duração
+} aggregate_result;
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// agrupa os produtos ativos do banco
+// - band_cents: largura das faixas de preço (0 = AGGREGATE_DEFAULT_BAND_CENTS);
+//   a última faixa acumula todos os preços acima
+// - cada produto é lido de forma consistente (não bloqueia escritores)
+// - retorna 1 se sucesso, 0 se parâmetros inválidos
+int aggregate_products(const product_bank *bank, group_by key, long long band_cents,
+                       aggregate_result *result);
+
+// preço médio do grupo em centavos (arredondado), 0 se vazio
+long long aggregate_average_price_cents(const aggregate_group *group);
+
+// descreve o grupo de índice index (nome da categoria, unidade ou faixa)
+// - escreve em out (até size bytes) e retorna out
+char *aggregate_group_label(const aggregate_result *result, int index, char *out, size_t size);
+
+// converte critério de agrupamento em string descritiva
+// - retorna string estática (não precisa liberar memória)
+const char *group_by_to_string(int key);
+
+#endif // AGGREGATION_H
@@ -0,0 +1,76 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+#include "product.h"
+#include "movimentacao.h"
+
+// ============================================================================
+// MÓDULO: batch — Modo lote (comandos por linha, sem menus nem pausas)
+// ============================================================================
+// Lê comandos de um arquivo ou da entrada padrão, um por linha, com campos
+// separados por ';' (caractere que nunca aparece em nomes válidos):
+//
+//   register;nome;preco;quantidade;minimo;categoria;unidade
+//   update;codigo;nome;preco;quantidade;minimo;categoria;unidade
+//   deactivate;codigo
+//   activate;codigo
+//   query;codigo
+//   move;codigo;tipo;quantidade        (tipo: entrada, venda, perda, ajuste)
+//   save
+//
+// Categoria e unidade são os números do menu. No update, campo vazio mantém
+// o valor atual. Linhas vazias e linhas começando com '#' são ignoradas.
+//
+// Cada comando produz uma linha de resposta:
+//   OK;<comando>[;campos]              (ex.: "OK;register;42")
+//   ERRO;<linha>;<motivo>
+//
+// Linhas register consecutivas são validadas juntas, em uma passada
+// (validate_product_columns), e só as limpas são cadastradas; a resposta de
+// erro de um cadastro lista todas as regras violadas, separadas por ", ".
+//
+// A entrada é lida em blocos de BATCH_BUFFER_SIZE bytes e as respostas são
+// acumuladas em um buffer do mesmo tamanho, de modo que milhões de comandos
+// custam poucas chamadas de sistema. Erros não interrompem o lote.
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// tamanho dos buffers de leitura e de escrita (1 MiB)
+#define BATCH_BUFFER_SIZE (1 << 20)
+
+// maior linha de comando aceita (bytes, sem o '\n')
+#define BATCH_LINE_MAX 512
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+// estado usado pelos comandos
+typedef struct {
+    product_bank *bank;
+    movement_ledger *ledger;            // livro das movimentações (move, save)
+    const char *products_path;          // arquivo de produtos (save)
+    const char *movements_path;         // arquivo de movimentações (save)
+} batch_session;
+
+// resumo de um lote
+typedef struct {
+    long long lines;                    // linhas lidas (inclusive vazias e comentários)
+    long long commands;                 // comandos executados
+    long long errors;                   // comandos com erro
+    double elapsed_seconds;             // duração
+} batch_summary;
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// executa todos os comandos de input, escrevendo as respostas em output
+// - o banco fica em modo silencioso durante o lote (sem mensagens no console)
+// - summary (opcional): recebe contagens e duração
+// - retorna 1 se o lote foi lido até o fim, 0 se parâmetros inválidos,
+//   memória insuficiente ou erro de leitura/escrita
+int run_batch(batch_session *session, FILE *input, FILE *output, batch_summary *summary);
+
+#endif // BATCH_H
@@ -0,0 +1,130 @@
+#ifndef CHAIN_H
+#define CHAIN_H
+
+#include <stddef.h>
+#include "mercado.h"
+#include "sync.h"
+
+// ============================================================================
+// MÓDULO: chain — Rede de lojas: vários estoques em um único processo
+// ============================================================================
+// Cada loja é um estoque próprio (mercado_store), identificado pelo número
+// da loja, com seus arquivos em data_dir:
+//   loja_<numero>_products.dat e loja_<numero>_movements.dat
+// As lojas são encontradas por busca binária no número.
+//
+// O catálogo é cadastrado pela rede (chain_register_product), na mesma ordem
+// em todas as lojas, de modo que um código identifica o mesmo produto em
+// todas elas.
+//
+// Atualizações em lote (apply_chain_updates) são divididas em fatias pelo
+// par (loja, código): cada fatia é aplicada por uma thread, então as
+// atualizações de um mesmo produto seguem na ordem do lote e threads
+// diferentes nunca disputam o mesmo produto.
+//
+// Consultas de toda a rede (chain_total_stock) distribuem as lojas entre
+// threads; cada uma soma as suas em totais parciais e os parciais são
+// juntados no fim.
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// maior quantidade de lojas de uma rede
+#define CHAIN_MAX_STORES 256
+
+// tamanho máximo dos caminhos dos arquivos de uma loja
+#define CHAIN_PATH_MAX 256
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+// loja da rede
+typedef struct {
+    int store_id;
+    mercado_store *store;
+    char products_path[CHAIN_PATH_MAX];
+    char movements_path[CHAIN_PATH_MAX];
+} chain_store;
+
+// rede de lojas
+// - cada loja é alocada à parte e não muda de lugar até close_store_chain:
+//   as opções do estoque apontam para os caminhos guardados nela
+// - stores, by_id e count são publicados sob o seqlock directory:
+//   find_chain_store e as operações de toda a rede leem sem bloquear
+//   enquanto outra thread abre uma loja
+typedef struct {
+    chain_store *stores[CHAIN_MAX_STORES];  // em ordem de abertura
+    chain_store *by_id[CHAIN_MAX_STORES];   // as mesmas, em ordem de store_id
+    int count;
+    char data_dir[CHAIN_PATH_MAX];
+    mercado_lock_mode lock_mode;            // modo de trava de cada loja
+    int thread_count;                       // threads das operações em paralelo
+    spin_lock lock;                         // serializa a publicação de lojas e cadastros
+    seq_lock directory;                     // protege stores, by_id e count para os leitores
+} store_chain;
+
+// atualização de estoque de uma loja (entrada do lote)
+typedef struct {
+    int store_id;
+    int code;
+    movement_type type;
+    int quantity;
+    int status;                 // saída: 1 aplicada, 0 recusada, -1 loja inexistente
+} chain_update;
+
+// estoque de um produto somado em toda a rede
+typedef struct {
+    int code;
+    long long quantity;         // soma das quantidades em estoque
+    long long available;        // soma das quantidades disponíveis
+    int stores_active;          // lojas em que o produto está ativo
+    int stores_below_minimum;   // lojas com disponível no mínimo ou abaixo
+} chain_stock;
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// inicializa rede vazia
+// - data_dir: pasta dos arquivos das lojas (já existente)
+// - thread_count: threads das operações em paralelo (0 = processadores)
+void initialize_store_chain(store_chain *chain, const char *data_dir,
+                            mercado_lock_mode lock_mode, int thread_count);
+
+// abre (ou cria) a loja store_id, carregando seus arquivos se existirem
+// - os arquivos são lidos fora da trava da rede; a loja só é publicada no fim
+// - retorna 1 se sucesso, 0 se já aberta, rede cheia, caminho longo demais
+//   ou memória insuficiente
+// - não deve correr junto com as operações em paralelo da rede
+int open_chain_store(store_chain *chain, int store_id);
+
+// estoque da loja (NULL se não aberta)
+// - pode correr junto com open_chain_store (não bloqueia)
+mercado_store *find_chain_store(store_chain *chain, int store_id);
+
+// fecha todas as lojas (sem gravar; ver save_store_chain)
+void close_store_chain(store_chain *chain);
+
+// grava os arquivos de todas as lojas, em paralelo
+// - retorna quantidade de lojas gravadas com sucesso
+int save_store_chain(store_chain *chain);
+
+// cadastra o produto em todas as lojas
+// - confere antes o espaço em todas as lojas: ou cadastra em todas, ou em
+//   nenhuma (o próximo código segue igual em toda a rede)
+// - retorna o código (o mesmo em todas), ou -1 se inválido, se alguma loja
+//   está cheia ou se os códigos divergiram (catálogo cadastrado fora da rede)
+int chain_register_product(store_chain *chain, const char *name, float price, int quantity,
+                           int minimum_stock, int category, int unit);
+
+// aplica um lote de movimentações em paralelo, fatiado por (loja, código)
+// - preenche updates[i].status
+// - retorna quantidade de atualizações aplicadas
+size_t apply_chain_updates(store_chain *chain, chain_update *updates, size_t count);
+
+// soma o estoque dos códigos pedidos em todas as lojas, em paralelo
+// - out[i] recebe os totais de codes[i]
+// - retorna 1 se sucesso, 0 se parâmetros inválidos ou memória insuficiente
+int chain_total_stock(store_chain *chain, const int codes[], size_t count, chain_stock out[]);
+
+#endif // CHAIN_H
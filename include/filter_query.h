@@ -0,0 +1,108 @@
+#ifndef FILTER_QUERY_H
+#define FILTER_QUERY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "product.h"
+#include "range_index.h"
+#include "slot_bitmap.h"
+
+// ============================================================================
+// MÓDULO: filter_query — Filtros combinados compilados em conjuntos de bits
+// ============================================================================
+// Uma consulta é uma lista de critérios que precisam valer todos ao mesmo
+// tempo (E lógico), cada um podendo ser invertido (NÃO): categoria, unidade,
+// ativo, abaixo do mínimo, faixa de preço e faixa de quantidade. Exemplo:
+// categoria = Bebidas E abaixo do mínimo E preço > R$ 10,00. Sem critério de
+// ativo na lista, a consulta considera só os produtos ativos.
+//
+// A execução monta o resultado como conjunto comprimido de posições
+// (slot_bitmap):
+// 1. critérios de faixa com índice (range_index) viram conjuntos direto do
+//    índice, sem tocar nos produtos, e são intersectados antes de qualquer
+//    varredura; faixas largas demais, em que o índice não compensa, ficam
+//    para a varredura;
+// 2. os demais critérios são avaliados juntos em uma única varredura por
+//    blocos de 65536 posições que monta os mapas de bits palavra a palavra;
+//    se o passo 1 já restringiu o resultado, só as posições ainda presentes
+//    são examinadas e blocos ausentes são pulados inteiros.
+//
+// O resultado alimenta as listagens paginadas (open_selection_listing) e os
+// relatórios (open_selection_report_source).
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// maior quantidade de critérios de uma consulta
+#define FILTER_MAX_PREDICATES 8
+
+// ============================================================================
+// ENUMERAÇÕES
+// ============================================================================
+
+// campo de um critério
+typedef enum {
+    FILTER_CATEGORY = 1,        // categoria igual a low
+    FILTER_UNIT,                // unidade igual a low
+    FILTER_ACTIVE,              // produto ativo
+    FILTER_BELOW_MINIMUM,       // disponível no mínimo ou abaixo
+    FILTER_PRICE,               // preço em centavos entre low e high
+    FILTER_QUANTITY             // quantidade em estoque entre low e high
+} filter_field;
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+// critério
+typedef struct {
+    filter_field field;
+    uint32_t low;               // valor (categoria, unidade) ou limite inferior
+    uint32_t high;              // limite superior (faixas)
+    int negate;                 // 1 = produtos que NÃO atendem ao critério
+} filter_predicate;
+
+// consulta
+typedef struct {
+    filter_predicate predicates[FILTER_MAX_PREDICATES];
+    int count;
+    range_index *prices;        // índice de preço (opcional)
+    range_index *quantities;    // índice de quantidade (opcional)
+} filter_query;
+
+// resultado de uma consulta
+typedef struct {
+    slot_bitmap slots;          // posições que atendem a todos os critérios
+    long long matches;          // quantidade de posições em slots (só ativos,
+                                // salvo critério de ativo explícito)
+    int index_predicates;       // critérios resolvidos pelos índices
+    int scanned_chunks;         // blocos de 65536 posições varridos
+    double elapsed_seconds;     // duração
+} filter_result;
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// inicializa uma consulta vazia (todos os produtos ativos do banco)
+// - prices/quantities: índices de faixa usados quando compensam (podem ser NULL)
+void initialize_filter_query(filter_query *query, range_index *prices, range_index *quantities);
+
+// acrescenta um critério
+// - categoria e unidade usam só low; ativo e abaixo do mínimo ignoram os dois
+// - retorna 1 se sucesso, 0 se critério inválido ou consulta cheia
+int add_filter_predicate(filter_query *query, filter_field field,
+                         uint32_t low, uint32_t high, int negate);
+
+// executa a consulta sobre o banco
+// - result deve ser liberado com free_filter_result
+// - retorna 1 se sucesso, 0 se parâmetros inválidos ou memória insuficiente
+int run_filter_query(const filter_query *query, const product_bank *bank, filter_result *result);
+
+// libera o resultado
+void free_filter_result(filter_result *result);
+
+// descreve um critério em texto (ex.: "preco entre R$ 10.00 e R$ 20.00")
+// - retorna 1 se sucesso, 0 se não coube em out
+int describe_filter_predicate(const filter_predicate *predicate, char *out, size_t size);
+
+#endif // FILTER_QUERY_H
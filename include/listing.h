@@ -0,0 +1,99 @@
+#ifndef LISTING_H
+#define LISTING_H
+
+#include <stddef.h>
+#include "product.h"
+#include "slot_bitmap.h"
+#include "sorting.h"
+
+// ============================================================================
+// MÓDULO: listing — Listagens paginadas com cursor
+// ============================================================================
+// Em vez de copiar a lista inteira para um array do tamanho do banco, a
+// listagem é aberta uma vez e lida em páginas: cada chamada continua da
+// posição onde a anterior parou e só examina as posições necessárias para
+// preencher a página pedida. Telas paginadas e exportações em fluxo tocam
+// apenas as linhas que de fato mostram ou gravam.
+//
+// Ordem estável: em ordem de código (a ordem das posições do banco), como
+// produtos nunca são removidos do array e novos cadastros vão para o final,
+// uma página nunca repete nem pula produtos já percorridos, mesmo com
+// cadastros e vendas acontecendo entre uma página e outra. Nas demais
+// ordens (nome, preço, quantidade, valor) a sequência de posições é fixada
+// na abertura a partir das visões do módulo sorting; as linhas mostram os
+// valores atuais de cada produto.
+// Cada linha é uma cópia consistente do produto (não bloqueia escritores).
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// tamanho de página usado pelas telas do menu
+#define LISTING_PAGE_SIZE 20
+
+// ============================================================================
+// ENUMERAÇÕES
+// ============================================================================
+
+// critério de seleção das linhas
+typedef enum {
+    LISTING_ACTIVE = 1,         // todos os produtos ativos
+    LISTING_BELOW_MINIMUM,      // ativos com disponível no mínimo ou abaixo
+    LISTING_CATEGORY,           // ativos de uma categoria
+    LISTING_SELECTION           // ativos de um conjunto de posições (filtros combinados)
+} listing_filter;
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+// linha entregue pelo cursor
+typedef struct {
+    product item;           // cópia consistente do produto
+    int available;          // quantidade disponível (estoque menos reservas)
+} listing_row;
+
+// cursor de uma listagem aberta
+typedef struct {
+    const product_bank *bank;
+    listing_filter filter;
+    int category;           // categoria (apenas LISTING_CATEGORY)
+    int order;              // sort_key, com ou sem SORT_DESCENDING
+    int slot;               // próxima posição do banco a examinar (ordem de código)
+    int *order_slots;       // posições na ordem pedida (NULL em ordem de código)
+    int order_count;        // posições em order_slots
+    int position;           // próxima entrada de order_slots
+    int emitted;            // linhas já entregues
+    int finished;           // 1 quando o fim do banco foi alcançado
+} listing_cursor;
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// abre uma listagem sobre o banco
+// - category: usada apenas com LISTING_CATEGORY
+// - order: sort_key (SORT_BY_CODE = ordem do banco), com ou sem SORT_DESCENDING
+// - retorna 1 se sucesso, 0 se parâmetros inválidos ou memória insuficiente
+int open_listing(listing_cursor *cursor, const product_bank *bank,
+                 listing_filter filter, int category, int order);
+
+// abre uma listagem dos produtos ativos cujas posições estão em selection
+// - a seleção é copiada: pode ser liberada logo depois da abertura
+// - order: sort_key (SORT_BY_CODE = ordem do banco), com ou sem SORT_DESCENDING
+// - retorna 1 se sucesso, 0 se parâmetros inválidos ou memória insuficiente
+int open_selection_listing(listing_cursor *cursor, const product_bank *bank,
+                           const slot_bitmap *selection, int order);
+
+// lê a próxima página de até page_size linhas
+// - continua de onde a chamada anterior parou
+// - retorna quantidade de linhas preenchidas em out (0 = fim da listagem)
+int next_listing_page(listing_cursor *cursor, listing_row out[], size_t page_size);
+
+// verifica se ainda pode haver linhas depois da última página lida
+// - retorna 1 se a listagem não terminou, 0 caso contrário
+int listing_has_more(const listing_cursor *cursor);
+
+// encerra a listagem e libera a ordem guardada no cursor
+// (o cursor pode ser reaberto com open_listing)
+void close_listing(listing_cursor *cursor);
+
+#endif // LISTING_H
@@ -2,7 +2,9 @@
 #define LOGGER_H
 
 #include <stdio.h>
+#include <stdint.h>
 #include <time.h>
+#include <pthread.h>
 
 // enum que representa níveis de log disponíveis
 // permite filtrar logs conforme a importância da mensagem
@@ -13,6 +15,50 @@ typedef enum {
     LOG_ERROR
 } log_level_t;
 
+// quantidade de baldes do limite de taxa (pontos de chamada acompanhados)
+#define LOG_RATE_SLOTS 64
+// tamanho máximo de uma mensagem (demais caracteres são truncados)
+#define LOG_MESSAGE_MAX 1024
+
+// trecho da mensagem guardado no balde (aviso de descartes na remoção)
+#define LOG_RATE_SAMPLE 120
+
+// balde de fichas de um ponto de chamada (arquivo + linha)
+typedef struct {
+    uint64_t key;               // chave: hash do arquivo e da linha (0 = livre)
+    int tokens;                 // fichas disponíveis
+    time_t last_refill;         // última reposição de fichas
+    unsigned long suppressed;   // mensagens descartadas desde a última escrita
+    log_level_t level;          // nível da última mensagem descartada
+    const char *file;           // ponto de chamada, para o aviso
+    int line;
+    char module[32];            // módulo e início da última mensagem descartada
+    char sample[LOG_RATE_SAMPLE];
+} log_rate_bucket;
+
+// instância de log: arquivo, nível, limite de taxa e última mensagem
+// - cada instância tem sua trava; várias threads podem escrever na mesma
+// - log_message escreve na instância do processo (logger_default), ou na
+//   que tiver sido indicada com logger_redirect
+typedef struct {
+    pthread_mutex_t lock;
+    FILE *file;                 // arquivo aberto (NULL = sem arquivo)
+    log_level_t level;          // nível mínimo registrado
+    int show_console;           // 1 = também escreve no terminal
+    log_rate_bucket buckets[LOG_RATE_SLOTS];
+    int rate_burst;
+    int rate_per_second;        // 0 = sem limitação
+    int has_last;               // última mensagem escrita (repetições)
+    log_level_t last_level;
+    char last_module[64];
+    char last_message[LOG_MESSAGE_MAX];
+    unsigned long repeat_count;
+} logger;
+
+// ============================================================================
+// API DO LOG DO PROCESSO
+// ============================================================================
+
 // inicializa o sistema de logging
 // filename: nome do arquivo de log (usa stdout caso NULL)
 // level_minimo: nível mínimo a registrar (LOG_INFO recomendado para produção)
@@ -21,9 +67,50 @@ void logger_init(const char *file_name, log_level_t level_minimum, int show_cons
 
 // registra mensagem de log, incluindo timestamp, nível e módulo de origem
 // Todas as mensagens devem estar em português e indicar claramente o evento
-void log_message(log_level_t level, const char *module, const char *message);
+// - macro: o ponto de chamada (__FILE__, __LINE__) identifica o balde do
+//   limite de taxa, então mensagens montadas com valores variáveis no mesmo
+//   ponto dividem o balde
+#define log_message(level, module, message) \
+    log_message_at(__FILE__, __LINE__, (level), (module), (message))
+void log_message_at(const char *file, int line, log_level_t level, const char *module,
+                    const char *message);
+
+// configura a limitação de taxa por ponto de chamada (token bucket)
+// burst: quantidade de mensagens liberadas de uma vez por ponto de chamada
+// per_second: mensagens repostas por segundo (0 desativa a limitação)
+// mensagens idênticas consecutivas são sempre agrupadas em
+// "Ultima mensagem repetida N vezes", independente desta configuração
+void logger_set_rate_limit(int burst, int per_second);
 
 // encerra o sistema de logging, fechando o arquivo se necessário
 void logger_close(void);
 
+// ============================================================================
+// API DE INSTÂNCIAS (reentrante, para quem embute a biblioteca)
+// ============================================================================
+
+// inicializa uma instância (mesmos parâmetros de logger_init)
+// - retorna 1 se sucesso, 0 se o arquivo não pôde ser aberto (a instância
+//   fica utilizável, só com o console)
+int logger_open(logger *instance, const char *file_name, log_level_t level_minimum,
+                int show_console);
+
+// registra mensagem na instância (macro, como log_message)
+#define logger_write(instance, level, module, message) \
+    logger_write_at((instance), __FILE__, __LINE__, (level), (module), (message))
+void logger_write_at(logger *instance, const char *file, int line, log_level_t level,
+                     const char *module, const char *message);
+
+// limitação de taxa da instância (ver logger_set_rate_limit)
+void logger_configure_rate_limit(logger *instance, int burst, int per_second);
+
+// encerra a instância, fechando o arquivo
+void logger_shutdown(logger *instance);
+
+// instância usada pelo log do processo
+logger *logger_default(void);
+
+// faz log_message escrever em instance (NULL volta à instância do processo)
+void logger_redirect(logger *instance);
+
 #endif //LOGGER_H
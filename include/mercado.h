@@ -0,0 +1,159 @@
+#ifndef MERCADO_H
+#define MERCADO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "product.h"
+#include "movimentacao.h"
+#include "range_index.h"
+#include "mvcc.h"
+#include "validation.h"
+
+// ============================================================================
+// MÓDULO: mercado — API da biblioteca libmercado (estoque embutido)
+// ============================================================================
+// O programa de menu guarda banco, livro e índices em variáveis globais de
+// main.c. Quem embute o estoque (ex.: o software do caixa) usa um handle
+// mercado_store, criado por mercado_open, que reúne banco, livro de
+// movimentações, velocidade de vendas e índices de faixa. Vários handles
+// podem coexistir no mesmo processo e todas as funções recebem o handle.
+//
+// Modos de trava (mercado_options.lock_mode):
+// - MERCADO_LOCK_FINE: as travas finas do próprio banco (seqlocks por faixa,
+//   quantidades atômicas, trava de cadastro); leituras e escritas correm em
+//   paralelo. Carga do arquivo exige que nada mais esteja em andamento.
+// - MERCADO_LOCK_RWLOCK: além delas, uma trava de leitores e escritores no
+//   handle: consultas e gravação em arquivo correm juntas, alterações e carga
+//   são exclusivas. Mais simples de raciocinar quando o chamador usa também
+//   os outros módulos (listagens, filtros, relatórios) sobre mercado_bank,
+//   envolvendo essas chamadas em mercado_begin_read/mercado_end_read.
+//
+// As mensagens da biblioteca vão para log_message; para um arquivo próprio,
+// use logger_open e logger_redirect (logger.h). O banco do handle fica em
+// modo silencioso (nenhuma mensagem no console).
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// ============================================================================
+// ENUMERAÇÕES
+// ============================================================================
+
+// modo de trava do handle
+typedef enum {
+    MERCADO_LOCK_FINE = 0,
+    MERCADO_LOCK_RWLOCK
+} mercado_lock_mode;
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+// opções de abertura
+typedef struct {
+    const char *products_path;          // arquivo de produtos (NULL = sem arquivo)
+    const char *movements_path;         // arquivo de movimentações (NULL = sem arquivo)
+    mercado_lock_mode lock_mode;
+    int load_saved;                     // 1 = carrega os arquivos na abertura
+} mercado_options;
+
+// handle de um estoque (estrutura opaca)
+typedef struct mercado_store mercado_store;
+
+// ============================================================================
+// API PÚBLICA - CICLO DE VIDA
+// ============================================================================
+
+// cria um estoque vazio (ou carregado dos arquivos, se load_saved)
+// - retorna o handle, ou NULL se memória insuficiente
+mercado_store *mercado_open(const mercado_options *options);
+
+// libera o handle (não grava nada; ver mercado_save)
+void mercado_close(mercado_store *store);
+
+// grava produtos e movimentações nos arquivos das opções
+// - pode correr junto com as operações (inclusive no modo MERCADO_LOCK_FINE):
+//   os arquivos recebem cópias consistentes de cada um, tiradas no início
+// - retorna 1 se sucesso, 0 se erro de gravação ou sem arquivo configurado
+int mercado_save(mercado_store *store);
+
+// descarta o estado em memória e recarrega dos arquivos
+// - retorna 1 se sucesso, 0 se o arquivo de produtos não pôde ser lido ou se
+//   há fotos abertas (mercado_open_snapshot)
+int mercado_load(mercado_store *store);
+
+// ============================================================================
+// API PÚBLICA - OPERAÇÕES
+// ============================================================================
+
+// cadastra produto (mesmas validações de register_product)
+// - retorna o código do produto, ou -1 se inválido ou banco cheio
+int mercado_register(mercado_store *store, const char *name, float price, int quantity,
+                     int minimum_stock, int category, int unit);
+
+// importa produtos em lote: valida todas as linhas em uma passada
+// (validate_product_columns) e cadastra só as que não violam nenhuma regra
+// - todas as colunas são obrigatórias
+// - report recebe os erros de todas as linhas (liberar com free_validation_report)
+// - codes (opcional, columns->count posições): código de cada linha, ou -1
+// - se o banco encher, as linhas válidas seguintes ficam sem cadastro
+//   (código -1): são columns->count - report->invalid_count - retorno linhas,
+//   também contadas no registro da importação
+// - retorna a quantidade cadastrada, ou -1 se colunas ausentes ou memória
+//   insuficiente
+long mercado_import(mercado_store *store, const product_columns *columns,
+                    validation_report *report, int *codes);
+
+// edita produto (campos inválidos são mantidos, como em update_product)
+// - nova quantidade é registrada no livro como ajuste (set_product_quantity);
+//   a atual é mantida se ficaria abaixo do estoque reservado
+// - retorna 1 se sucesso, 0 se produto não encontrado ou quantidade recusada
+int mercado_update(mercado_store *store, int code, const char *name, float price, int quantity,
+                   int minimum_stock, int category, int unit);
+
+// inativa / reativa produto
+// - retorna 1 se sucesso, 0 se produto não encontrado (ou já no estado pedido)
+int mercado_deactivate(mercado_store *store, int code);
+int mercado_activate(mercado_store *store, int code);
+
+// copia o produto de forma consistente (ativos e inativos)
+// - available (opcional): recebe a quantidade disponível (estoque - reservas)
+// - retorna 1 se ativo, 0 se inativo, -1 se não encontrado
+int mercado_lookup(mercado_store *store, int code, product *out, int *available);
+
+// registra movimentação (ver record_movement)
+// - quantity_after (opcional): recebe a quantidade em estoque depois dela
+// - retorna 1 se sucesso, 0 se recusada (produto, quantidade ou estoque)
+int mercado_move(mercado_store *store, int code, movement_type type, int quantity,
+                 int *quantity_after);
+
+// códigos dos produtos ativos com preço (centavos) ou quantidade entre low
+// e high, em ordem de valor, até max_out
+// - retorna quantidade de códigos, ou -1 se parâmetros inválidos ou memória
+int mercado_range(mercado_store *store, range_field field, uint32_t low, uint32_t high,
+                  int out_codes[], size_t max_out);
+
+// abre uma foto do estoque (mvcc.h): relatórios e exportações longas leem
+// uma única versão do banco sem bloquear vendas, em qualquer modo de trava
+// - fechar com mercado_close_snapshot; mercado_load exige nenhuma foto aberta
+// - retorna 1 se sucesso, 0 se MVCC_MAX_SNAPSHOTS fotos já estão abertas
+int mercado_open_snapshot(mercado_store *store, bank_snapshot *snapshot);
+void mercado_close_snapshot(mercado_store *store, bank_snapshot *snapshot);
+
+// ============================================================================
+// API PÚBLICA - ACESSO AOS MÓDULOS
+// ============================================================================
+
+// banco, livro e índices do handle (para listagens, filtros e relatórios)
+product_bank *mercado_bank(mercado_store *store);
+movement_ledger *mercado_ledger(mercado_store *store);
+range_index *mercado_range_index(mercado_store *store, range_field field);
+
+// seção de leitura / de escrita sobre o handle
+// - no modo MERCADO_LOCK_RWLOCK, adquirem a trava do handle; no modo
+//   MERCADO_LOCK_FINE não fazem nada
+void mercado_begin_read(mercado_store *store);
+void mercado_end_read(mercado_store *store);
+void mercado_begin_write(mercado_store *store);
+void mercado_end_write(mercado_store *store);
+
+#endif // MERCADO_H
@@ -0,0 +1,182 @@
+#ifndef MOVIMENTACAO_H
+#define MOVIMENTACAO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "product.h"
+#include "sync.h"
+#include "velocity.h"
+
+// ============================================================================
+// MÓDULO: movimentacao — Livro de movimentações de estoque
+// ============================================================================
+// Toda entrada, venda, perda ou ajuste de estoque é registrada como um
+// registro compacto de tamanho fixo em um livro somente-anexação (append-only),
+// armazenado em blocos de tamanho fixo. Anexar é O(1) e nunca move registros
+// já gravados. Cada registro aponta para o registro anterior do mesmo
+// produto, formando uma cadeia que permite consultar o histórico de um
+// produto sem varrer o livro inteiro.
+// O livro é seguro para uso simultâneo por vários terminais: anexações são
+// serializadas por uma trava curta, e a quantidade do produto é alterada
+// atomicamente dentro dela (a ordem do livro é a ordem de aplicação). Nada é
+// alocado dentro da trava: blocos, o array de blocos e o índice de cadeias
+// crescem antes dela, e os avisos (gerações, ouvintes, métricas de venda)
+// saem depois. O array de blocos trocado no crescimento não é liberado até
+// free_movement_ledger, então os ponteiros lidos dele continuam válidos.
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// quantidade de registros por bloco do livro
+#define MOVEMENT_CHUNK_SIZE 4096
+// marcador de fim de cadeia (produto sem movimentação anterior)
+#define MOVEMENT_NONE UINT32_MAX
+// quantidade máxima de itens em uma cesta de checkout
+#define CHECKOUT_MAX_ITEMS 256
+// arrays de blocos substituídos guardados até free_movement_ledger
+// (a capacidade dobra a cada troca: 32 trocas cobrem todos os índices)
+#define MOVEMENT_RETIRED_ARRAYS 32
+
+// ============================================================================
+// ENUMERAÇÕES
+// ============================================================================
+
+// tipos de movimentação de estoque
+typedef enum {
+    MOVEMENT_OPENING = 1,   // saldo inicial (gravado na 1ª movimentação do produto)
+    MOVEMENT_IN,            // entrada de mercadoria
+    MOVEMENT_SALE,          // venda
+    MOVEMENT_LOSS,          // perda (quebra, validade, furto)
+    MOVEMENT_ADJUSTMENT     // ajuste de inventário (positivo ou negativo)
+} movement_type;
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+// registro de uma movimentação (tamanho fixo, 24 bytes)
+typedef struct {
+    int32_t code;           // código do produto movimentado
+    int32_t delta;          // variação aplicada à quantidade (com sinal)
+    uint32_t prev;          // índice do registro anterior do mesmo produto
+    uint32_t batch;         // lançamento ao qual pertence (0 = movimentação avulsa)
+    uint32_t timestamp;     // momento da movimentação (segundos desde epoch)
+    uint8_t type;           // tipo (enum movement_type)
+    uint8_t reserved[3];    // reservado (alinhamento)
+} movement_record;
+
+// o tamanho faz parte do formato de movements.dat (record_size no cabeçalho)
+_Static_assert(sizeof(movement_record) == 24, "movement_record deve ter 24 bytes");
+
+// livro de movimentações em memória
+typedef struct {
+    movement_record **chunks;   // blocos de MOVEMENT_CHUNK_SIZE registros
+    size_t chunk_count;         // blocos alocados
+    size_t chunk_capacity;      // capacidade do array de blocos
+    movement_record **retired[MOVEMENT_RETIRED_ARRAYS]; // arrays de blocos anteriores
+    int retired_count;
+    uint32_t count;             // total de registros no livro
+    uint32_t last_batch;        // último identificador de lançamento em lote
+    uint32_t *heads;            // último registro de cada código (MOVEMENT_NONE se nenhum)
+    size_t head_capacity;       // capacidade do array heads (maior código + 1)
+    spin_lock lock;             // serializa anexações e consultas
+    velocity_tracker *velocity; // opcional: métricas de venda atualizadas a cada movimentação
+} movement_ledger;
+
+// item de uma cesta de checkout
+typedef struct {
+    int code;               // código do produto
+    int quantity;           // quantidade vendida (positiva)
+} basket_item;
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// inicializa o livro vazio (não aloca memória até o primeiro registro)
+void initialize_movement_ledger(movement_ledger *ledger);
+
+// libera toda a memória do livro e o deixa vazio
+// (o acompanhamento de vendas associado continua associado)
+void free_movement_ledger(movement_ledger *ledger);
+
+// associa o acompanhamento de vendas atualizado a cada movimentação
+// (NULL desassocia)
+void attach_velocity_tracker(movement_ledger *ledger, velocity_tracker *tracker);
+
+// reavalia o alerta de ruptura do produto ativo fora de uma movimentação
+// - usado ao reativar: a inativação tira o produto do alerta na consulta
+//   seguinte, mas a reativação não o devolve sem uma nova avaliação
+void refresh_stockout_alert(const movement_ledger *ledger, product_bank *bank, int code);
+
+// recalcula as métricas de venda percorrendo o livro inteiro
+// - usado após carregar o livro do disco; exige acompanhamento associado
+void rebuild_sales_velocity(const movement_ledger *ledger, const product_bank *bank);
+
+// registra uma movimentação e aplica a variação à quantidade do produto
+// - quantity: quantidade movimentada (positiva) para entrada, venda e perda;
+//   para ajuste, a variação com sinal
+// - na primeira movimentação do produto, grava antes o saldo inicial, de modo
+//   que a soma das variações da cadeia reproduz sempre a quantidade atual
+// - retorna 1 se sucesso, 0 se erro (produto inexistente, quantidade inválida
+//   ou estoque insuficiente); em caso de erro nada é alterado
+int record_movement(movement_ledger *ledger, product_bank *bank, int code,
+                    movement_type type, int quantity);
+
+// edição de quantidade (menu, modo lote, biblioteca): registra como ajuste a
+// diferença entre new_quantity e a quantidade atual
+// - a diferença é calculada dentro da trava do livro (vendas concorrentes
+//   não se perdem)
+// - recusa quantidade abaixo do estoque reservado
+// - retorna 1 se sucesso (ou quantidade já igual), 0 se erro
+int set_product_quantity(movement_ledger *ledger, product_bank *bank, int code, int new_quantity);
+
+// finaliza a venda de uma cesta inteira de forma atômica (tudo ou nada)
+// - resolve todos os códigos de uma vez, soma itens repetidos e confere o
+//   estoque de cada produto antes de alterar qualquer coisa
+// - se tudo estiver disponível, baixa todas as quantidades e grava os
+//   registros como um único lançamento (mesmo identificador de lote)
+// - failed_item (opcional): recebe o índice do item que impediu a venda,
+//   ou -1 se a falha não se deve a um item específico
+// - retorna o identificador do lançamento (> 0), ou 0 se nada foi aplicado
+uint32_t checkout_basket(movement_ledger *ledger, product_bank *bank,
+                         const basket_item *items, size_t item_count, int *failed_item);
+
+// anexa registros lidos de arquivo (usado pela persistência)
+// - as cadeias por produto são refeitas: o campo prev dos registros é recalculado
+// - os registros não são aplicados ao banco (ver replay_movements)
+// - retorna 1 se sucesso, 0 se memória insuficiente ou código inválido
+int append_loaded_movements(movement_ledger *ledger, const movement_record *records,
+                            size_t count);
+
+// reserva quantity unidades disponíveis do produto (pedido online)
+// - a reserva reduz o disponível, mas não o estoque físico
+// - retorna 1 se reservado, 0 se o disponível não é suficiente
+int hold_stock(movement_ledger *ledger, product_bank *bank, int code, int quantity);
+
+// devolve ao disponível unidades reservadas (expiração ou cancelamento)
+void release_held_stock(product_bank *bank, int code, int quantity);
+
+// confirma unidades reservadas como venda: baixa o estoque e grava no livro
+// - retorna 1 se sucesso, 0 se erro (a reserva continua pendente)
+int commit_held_stock(movement_ledger *ledger, product_bank *bank, int code, int quantity);
+
+// retorna o registro na posição index, ou NULL se fora do livro
+// (registros gravados nunca mudam; o ponteiro continua válido até free)
+const movement_record *get_movement(const movement_ledger *ledger, uint32_t index);
+
+// copia até max_out registros a partir da posição first (envio do livro)
+// - retorna quantidade copiada (0 se first está no fim do livro)
+size_t copy_movements(const movement_ledger *ledger, uint32_t first,
+                      movement_record *out_array, size_t max_out);
+
+// lista o histórico de um produto, do mais recente para o mais antigo
+// - percorre apenas a cadeia do produto (custo proporcional ao histórico dele)
+// - retorna quantidade de registros preenchidos em out_array
+int list_product_movements(const movement_ledger *ledger, int code,
+                           const movement_record *out_array[], size_t max_out);
+
+// converte tipo de movimentação em string descritiva
+// - retorna string estática (não precisa liberar memória)
+const char *movement_type_to_string(int type);
+
+#endif // MOVIMENTACAO_H
@@ -0,0 +1,149 @@
+#ifndef MVCC_H
+#define MVCC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "product.h"
+#include "sync.h"
+
+// ============================================================================
+// MÓDULO: mvcc — Leituras por versão do banco de produtos
+// ============================================================================
+// Um relatório longo que lê o banco direto vê cada produto de forma
+// consistente (seqlock), mas não o banco inteiro: vendas feitas no meio da
+// leitura aparecem em parte dos produtos. Uma foto (bank_snapshot) fixa uma
+// versão do banco inteiro sem bloquear as vendas:
+// - o banco é dividido em páginas de MVCC_PAGE_PRODUCTS produtos
+// - enquanto há fotos abertas, a primeira alteração de uma página depois da
+//   foto mais nova copia a página antes de alterá-la (cópia na escrita); as
+//   cópias de uma página formam uma cadeia da mais nova para a mais velha
+// - a foto lê cada página na cópia mais velha feita depois dela ou, se não
+//   houver, no próprio banco
+// - ao abrir e fechar fotos, as cópias que nenhuma foto aberta alcança são
+//   desligadas das cadeias e liberadas quando nenhuma foto que podia estar
+//   lendo-as continua aberta
+//
+// As funções que alteram produtos já publicados (update_product, inativação,
+// reativação e adjust_product_quantity) avisam este módulo; cadastros não
+// precisam (a foto guarda a quantidade de produtos do momento em que foi
+// aberta). Reservas não são versionadas: o disponível de uma foto é a
+// quantidade da foto menos o reservado atual.
+// Carga do arquivo e reconstrução pelo livro trocam o banco inteiro e exigem
+// que nenhuma foto esteja aberta.
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// produtos por página copiada
+#define MVCC_PAGE_PRODUCTS 64
+// quantidade de páginas do banco
+#define MVCC_PAGE_COUNT ((MAX_PRODUCTS + MVCC_PAGE_PRODUCTS - 1) / MVCC_PAGE_PRODUCTS)
+// quantidade máxima de fotos abertas ao mesmo tempo
+#define MVCC_MAX_SNAPSHOTS 64
+// contadores de escritores em andamento (por posição, evita disputa)
+#define MVCC_WRITER_LANES 16
+// travas das cadeias de cópias (página % MVCC_PAGE_LOCKS)
+#define MVCC_PAGE_LOCKS 64
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+// cópia de uma página, válida para as fotos de versão até version
+typedef struct page_version {
+    uint64_t version;                   // foto mais nova quando a cópia foi feita
+    struct page_version *older;         // cópia anterior da mesma página
+    struct page_version *next_retired;  // fila de liberação
+    uint64_t retired_at;                // relógio quando foi desligada da cadeia
+    product items[MVCC_PAGE_PRODUCTS];
+} page_version;
+
+// contador de escritores em andamento alinhado em linha de cache própria
+typedef struct {
+    long in_flight;
+    char padding[CACHE_LINE_SIZE - sizeof(long)];
+} writer_lane;
+
+// versões do banco (ligadas em bank->versions)
+typedef struct bank_versions {
+    product_bank *bank;
+    page_version *heads[MVCC_PAGE_COUNT];   // cópia mais nova de cada página
+    uint64_t saved[MVCC_PAGE_COUNT];        // versão da última cópia de cada página
+    spin_lock page_locks[MVCC_PAGE_LOCKS];
+    writer_lane lanes[2][MVCC_WRITER_LANES];// escritores por paridade de época
+    unsigned epoch;                         // época dos escritores que começam agora
+    uint64_t clock;                         // versão da última foto já pronta
+    uint64_t newest_open;                   // versão da foto aberta mais nova (0 = nenhuma)
+    uint64_t open_versions[MVCC_MAX_SNAPSHOTS];
+    int open_count;
+    page_version *retired;                  // cópias desligadas, ainda não liberadas
+    spin_lock lock;                         // serializa abertura, fechamento e limpeza
+    size_t pages_copied;                    // cópias feitas desde a ativação
+    size_t pages_retained;                  // cópias ainda em memória
+} bank_versions;
+
+// foto de uma versão do banco
+typedef struct {
+    bank_versions *versions;
+    uint64_t version;
+    int count;                  // produtos visíveis (posições 0..count-1)
+    int position;               // posição do cursor de next_snapshot_product
+} bank_snapshot;
+
+// números das versões
+typedef struct {
+    int open_snapshots;
+    size_t pages_copied;
+    size_t pages_retained;
+    size_t bytes_retained;
+} versions_stats;
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// ativa as leituras por versão no banco
+// - a partir daqui as alterações passam a avisar o módulo
+// - retorna 1 se sucesso (ou já ativas), 0 se memória insuficiente
+int enable_bank_versions(product_bank *bank);
+
+// desativa e libera as versões do banco
+// - exige que nenhuma foto esteja aberta e nenhuma alteração em andamento
+void disable_bank_versions(product_bank *bank);
+
+// abre uma foto da versão atual do banco
+// - espera as alterações em andamento terminarem (não bloqueia as seguintes)
+// - retorna 1 se sucesso, 0 se versões não ativas ou MVCC_MAX_SNAPSHOTS abertas
+int open_bank_snapshot(product_bank *bank, bank_snapshot *snapshot);
+
+// fecha a foto e libera as cópias que ninguém mais alcança
+void close_bank_snapshot(bank_snapshot *snapshot);
+
+// copia o produto da posição slot como estava na versão da foto
+// - retorna 1 se o produto está ativo, 0 se inativo, -1 se slot está fora da foto
+int read_snapshot_product_at(const bank_snapshot *snapshot, int slot, product *out);
+
+// copia o produto com o código pedido como estava na versão da foto
+// - retorna 1 se ativo, 0 se inativo, -1 se não existia na foto
+int read_snapshot_product(const bank_snapshot *snapshot, int code, product *out);
+
+// próximo produto ativo da foto, em ordem de código
+// - retorna 1 se copiado em out, 0 ao final
+int next_snapshot_product(bank_snapshot *snapshot, product *out);
+
+// números das versões do banco
+void get_versions_stats(const product_bank *bank, versions_stats *out);
+
+// ----------------------------------------------------------------------------
+// Chamados pelo banco (product.c) em volta de cada alteração de um produto
+// já publicado. versions_write_begin copia a página se há foto aberta que
+// ainda não a tem; o valor retornado é passado a versions_write_end.
+// ----------------------------------------------------------------------------
+unsigned versions_write_begin(bank_versions *versions, int slot);
+void versions_write_end(bank_versions *versions, unsigned token);
+
+// antes de uma alteração que será feita dentro de outra trava (livro de
+// movimentações): copia já a página, se uma foto pronta ainda não a tem,
+// para que versions_write_begin não precise alocar dentro da trava
+void versions_prepare_write(bank_versions *versions, int slot);
+
+#endif // MVCC_H
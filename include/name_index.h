@@ -0,0 +1,104 @@
+#ifndef NAME_INDEX_H
+#define NAME_INDEX_H
+
+#include <stddef.h>
+#include "product.h"
+#include "sync.h"
+
+// ============================================================================
+// MÓDULO: name_index — Busca aproximada de nomes por trigramas
+// ============================================================================
+// Cada nome é normalizado (minúsculas, sem acentos, pontuação vira espaço)
+// e quebrado em trigramas por palavra: "acucar" -> "  a", " ac", "acu",
+// "cuc", "uca", "car", "ar ". O índice invertido guarda, para cada trigrama,
+// a lista das posições dos produtos que o contêm.
+//
+// A busca quebra o texto digitado da mesma forma e percorre apenas as listas
+// mais raras: um nome que contém pelo menos T dos Q trigramas da consulta
+// aparece obrigatoriamente em uma das Q - T + 1 listas mais curtas. Os
+// candidatos são conferidos do que mais apareceu para o que menos apareceu,
+// parando quando nem o melhor caso alcança o pior dos N guardados (o
+// tamanho de cada nome em trigramas fica guardado, então empates de
+// cobertura são decididos sem reler o nome). Assim
+// "acucar", "açúcar" e "acucar refinad" encontram "AÇÚCAR REFINADO 1KG".
+//
+// O índice é mantido pelos avisos de alteração de nome do banco: cadastros
+// e renomeações entram na hora; recarga do arquivo reconstrói o índice na
+// próxima busca. Entradas antigas deixadas por renomeações são ignoradas
+// (cada candidato é conferido com o nome atual) e descartadas quando o
+// índice é reconstruído. A reconstrução monta listas novas fora da trava
+// (buscas concorrentes seguem com as listas antigas) e as troca de uma vez;
+// renomeações ocorridas durante a montagem são reaplicadas na troca.
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// maior quantidade de resultados de uma busca
+#define NAME_SEARCH_MAX_RESULTS 50
+// fração mínima dos trigramas da consulta que o nome precisa conter
+#define NAME_SEARCH_MIN_COVERAGE 0.5
+// símbolos de um trigrama: espaço, a-z, 0-9 e "outro"
+#define TRIGRAM_SYMBOLS 38
+// quantidade de trigramas distintos
+#define TRIGRAM_COUNT (TRIGRAM_SYMBOLS * TRIGRAM_SYMBOLS * TRIGRAM_SYMBOLS)
+// renomeações guardadas durante uma reconstrução (além disso, reconstrói de novo)
+#define NAME_PENDING_RENAMES 64
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+// posições que contêm um trigrama
+typedef struct {
+    int *slots;
+    int count;
+    int capacity;
+} posting_list;
+
+// índice de trigramas de um banco
+typedef struct {
+    product_bank *bank;
+    posting_list *lists;        // TRIGRAM_COUNT listas
+    int indexed_count;          // posições [0, indexed_count) já indexadas
+    long long postings;         // entradas em todas as listas
+    long long stale_postings;   // entradas acrescentadas por renomeações
+    int needs_rebuild;          // 1 = reconstruir na próxima busca
+    int rebuilding;             // 1 = uma busca está montando listas novas
+    int rebuild_count;          // posições cobertas pela montagem em curso
+    int renamed[NAME_PENDING_RENAMES]; // renomeadas durante a montagem
+    int renamed_count;
+
+    // por posição (dimensionado pelo tamanho do banco)
+    unsigned char *trigram_counts; // trigramas distintos do nome atual
+    unsigned char *hits;        // rascunho da busca: listas em que a posição apareceu
+    int *touched;               // posições com hits > 0
+    int *candidates;            // touched ordenado por hits
+    int scratch_capacity;       // posições alocadas nos arrays acima
+
+    spin_lock lock;             // serializa buscas e atualizações
+} name_index;
+
+// produto encontrado
+typedef struct {
+    product item;               // cópia consistente do produto
+    double score;               // fração dos trigramas da consulta presentes no nome
+    double similarity;          // semelhança do nome inteiro (Jaccard dos trigramas)
+} name_match;
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// cria o índice e passa a ouvir as alterações de nome do banco
+// - os produtos já cadastrados são indexados na primeira busca
+// - retorna 1 se sucesso, 0 se memória insuficiente ou limite de ouvintes
+int initialize_name_index(name_index *index, product_bank *bank);
+
+// deixa de ouvir o banco e libera a memória do índice
+void free_name_index(name_index *index);
+
+// busca os limit nomes mais parecidos com query (limit até NAME_SEARCH_MAX_RESULTS)
+// - out sai ordenado do mais parecido para o menos parecido
+// - retorna quantidade de produtos preenchidos em out, ou -1 se erro
+int search_product_names(name_index *index, const char *query, name_match out[], int limit);
+
+#endif // NAME_INDEX_H
@@ -1,7 +1,9 @@
 #ifndef PERSISTENCE_H
 #define PERSISTENCE_H
 
+#include <stdio.h>
 #include "product.h"
+#include "movimentacao.h"
 
 // ============================================================================
 // MODULO: persistence — Salvar e carregar dados em arquivo binário
@@ -16,11 +18,38 @@
 // versao do formato de arquivo (para controle de compatibilidade)
 #define FILE_FORMAT_VERSION 1
 
+// nome padrao do arquivo do livro de movimentacoes
+#define MOVEMENTS_FILE_PATH "data/movements.dat"
+
+// versao do formato do arquivo de movimentacoes
+#define MOVEMENTS_FORMAT_VERSION 1
+
+// produtos lidos por vez na leitura em fluxo de um arquivo de dados
+#define SNAPSHOT_READ_BATCH 512
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+// leitura em fluxo de um arquivo de dados (produtos em ordem de codigo),
+// sem carregar o arquivo inteiro na memoria
+typedef struct {
+    FILE *file;
+    int product_count;                      // produtos no arquivo (cabecalho)
+    int next_code;                          // proximo codigo (cabecalho)
+    int remaining;                          // produtos ainda nao lidos do arquivo
+    int filled;                             // produtos validos em batch
+    int position;                           // proximo produto de batch
+    product batch[SNAPSHOT_READ_BATCH];     // bloco lido do arquivo
+} snapshot_reader;
+
 // ============================================================================
 // API PUBLICA
 // ============================================================================
 
 // salva o banco de produtos em arquivo binario
+// - pode correr junto com vendas e cadastros: grava uma copia consistente
+//   (contagem e proximo codigo lidos juntos, cada produto pelo seqlock)
 // retorna 1 se sucesso, 0 se erro
 int save_products_to_file(const product_bank *bank, const char *file_path);
 
@@ -28,6 +57,28 @@ int save_products_to_file(const product_bank *bank, const char *file_path);
 // retorna 1 se sucesso, 0 se erro (arquivo nao existe ou corrupto)
 int load_products_from_file(product_bank *bank, const char *file_path);
 
+// salva o livro de movimentacoes em arquivo binario (bloco a bloco)
+// - pode correr junto com novas movimentacoes: grava os registros
+//   existentes quando a contagem foi lida na trava do livro
+// retorna 1 se sucesso, 0 se erro
+int save_movements_to_file(const movement_ledger *ledger, const char *file_path);
+
+// carrega o livro de movimentacoes do arquivo, anexando ao livro informado
+// (as quantidades do banco nao sao alteradas: use replay_movements)
+// retorna 1 se sucesso, 0 se erro (arquivo nao existe ou corrupto)
+int load_movements_from_file(movement_ledger *ledger, const char *file_path);
+
+// abre arquivo de dados para leitura em fluxo (le e valida o cabecalho)
+// retorna 1 se sucesso, 0 se erro (arquivo nao existe ou versao incompativel)
+int open_snapshot_reader(snapshot_reader *reader, const char *file_path);
+
+// le o proximo produto do arquivo (ativos e inativos, em ordem de codigo)
+// retorna 1 se leu, 0 no fim do arquivo, -1 se o arquivo esta truncado
+int read_next_snapshot_product(snapshot_reader *reader, product *out);
+
+// fecha o arquivo aberto por open_snapshot_reader
+void close_snapshot_reader(snapshot_reader *reader);
+
 // verifica se arquivo de dados existe
 // retorna 1 se existe, 0 caso contrario
 int data_file_exists(const char *file_path);
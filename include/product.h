@@ -2,6 +2,8 @@
 #define PRODUCT_H
 
 #include <stddef.h>
+#include <stdint.h>
+#include "sync.h"
 
 // ============================================================================
 // MÓDULO: product — Gerenciamento de produtos do sistema de mercado
@@ -16,6 +18,20 @@
 #define MAX_PRODUCTS 500
 // tamanho máximo do nome do produto (incluindo terminador nulo)
 #define PRODUCT_NAME_MAX_LENGTH 64
+// quantidade de faixas de travas do banco (posição % BANK_LOCK_STRIPES)
+#define BANK_LOCK_STRIPES 64
+// quantidade máxima de ouvintes de alteração por banco
+#define BANK_MAX_LISTENERS 4
+
+// campos informados aos ouvintes (combinados em uma máscara)
+#define PRODUCT_FIELD_NAME     (1 << 0)
+#define PRODUCT_FIELD_PRICE    (1 << 1)
+#define PRODUCT_FIELD_QUANTITY (1 << 2)
+// cadastro editado fora das movimentações: cadastro, edição, inativação e
+// reativação (nunca avisado dentro da trava do livro de movimentações)
+#define PRODUCT_FIELD_CATALOG  (1 << 3)
+#define PRODUCT_FIELD_ALL      (PRODUCT_FIELD_NAME | PRODUCT_FIELD_PRICE | PRODUCT_FIELD_QUANTITY \
+                                | PRODUCT_FIELD_CATALOG)
 
 // ============================================================================
 // ENUMERAÇÕES
@@ -55,11 +71,56 @@ typedef struct {
     int active;                         // 1 = ativo, 0 = inativo (deleção lógica)
 } product;
 
+// chave de comparação do nome: minúsculas e sem acentos (fold_text),
+// calculada uma vez no cadastro, na renomeação e na carga do arquivo, para
+// que ordenações e índices nunca normalizem o mesmo nome de novo
+typedef struct {
+    char text[PRODUCT_NAME_MAX_LENGTH]; // nome normalizado, terminado em '\0'
+    unsigned char length;               // bytes em text (sem o '\0')
+} name_key;
+
+// versões do banco para leituras por foto (mvcc.h)
+struct bank_versions;
+
+// ouvinte avisado quando campos indexados de um produto mudam (índices)
+// - slot: posição do produto cadastrado ou alterado, ou -1 quando o banco
+//   inteiro mudou (reinicialização, carga do arquivo, reconstrução pelo livro)
+// - fields: campos alterados (PRODUCT_FIELD_*)
+// - é chamado na thread que fez a alteração, sem travas do banco
+typedef struct {
+    void (*on_change)(void *context, int slot, int fields);
+    void *context;
+    int fields;                         // campos de interesse do ouvinte
+} product_listener;
+
 // estrutura que representa o banco de produtos em memória
+// produtos nunca são removidos do array e os códigos são crescentes, então
+// list está sempre ordenado por código (permite busca binária)
+//
+// concorrência: vários terminais podem usar o mesmo banco ao mesmo tempo
+// - quantidade é alterada com operações atômicas (adjust_product_quantity)
+// - edições completas de um produto usam o seqlock da sua faixa
+// - leitores nunca bloqueiam: repetem a leitura se a faixa mudou no meio
+// - cadastros são serializados por register_lock e publicados via count
+//
+// gerações: toda alteração incrementa generation e a geração da categoria do
+// produto alterado; quem guarda resultados calculados (cache de relatórios)
+// compara as gerações para saber se o resultado ainda vale
 typedef struct {
     product list[MAX_PRODUCTS];         // array de produtos cadastrados
     int count;                          // quantidade atual de produtos (ativos + inativos)
     int next_code;                      // próximo código a ser atribuído (auto-increment)
+    int reserved[MAX_PRODUCTS];         // quantidade reservada por posição (não persistido)
+    name_key name_keys[MAX_PRODUCTS];   // nome normalizado por posição (não persistido)
+    seq_lock stripes[BANK_LOCK_STRIPES];// seqlocks das faixas de posições (não persistido)
+    spin_lock register_lock;            // serializa cadastros (não persistido)
+    uint64_t epoch;                     // inicialização do banco, única no processo (não persistido)
+    uint64_t generation;                // geração global (não persistido)
+    uint64_t category_generations[CATEGORY_OTHERS + 1]; // por categoria; 0 = desconhecida
+    product_listener listeners[BANK_MAX_LISTENERS]; // ouvintes (não persistido)
+    int listener_count;
+    int quiet;                          // 1 = sem mensagens no console (modo lote, não persistido)
+    struct bank_versions *versions;     // leituras por versão (NULL = desativadas, não persistido)
 } product_bank;
 
 // ============================================================================
@@ -69,6 +130,10 @@ typedef struct {
 // inicializa o banco de produtos
 // - zera o array de produtos
 // - count = 0, next_code = 1
+// - as gerações começam em um valor nunca usado antes no processo, então
+//   resultados guardados antes de uma reinicialização nunca voltam a valer
+// - ouvintes já registrados, o modo silencioso e as versões são mantidos;
+//   os ouvintes são avisados (slot -1)
 void initialize_product_bank(product_bank *bank);
 
 // ============================================================================
@@ -82,31 +147,119 @@ void initialize_product_bank(product_bank *bank);
 int register_product(product_bank *bank, const char *name, float price,
                     int quantity, int minimum_stock, int category, int unit);
 
+// cadastra um produto cujos campos já foram validados (sem repetir as regras)
+// - uso: linhas aprovadas por validate_product_columns
+// - retorna o código do produto cadastrado, ou -1 se o banco está cheio
+int register_validated_product(product_bank *bank, const char *name, float price,
+                               int quantity, int minimum_stock, int category, int unit);
+
 // busca produto pelo código
 // - retorna ponteiro para o produto encontrado, ou NULL se não existir
 product *find_product_by_code(product_bank *bank, int code);
 
+// busca vários produtos de uma só vez (ex.: itens de uma cesta)
+// - codes deve estar em ordem crescente: cada busca continua de onde a
+//   anterior parou, em uma única passada pelo banco
+// - out_array[i] recebe o produto ativo de codes[i], ou NULL se não existir
+// - retorna quantidade de códigos encontrados
+int find_products_by_codes(product_bank *bank, const int codes[], size_t count,
+                           product *out_array[]);
+
 // busca produto pelo nome (busca parcial, case-insensitive)
 // - retorna código do primeiro produto encontrado, ou -1 se não existir
 int find_product_by_name(product_bank *bank, const char *name);
 
 // atualiza dados de um produto existente
-// - permite alterar todos os campos exceto o código
+// - permite alterar todos os campos exceto o código e a quantidade
+// - quantidade muda só por variação (adjust_product_quantity), registrada no
+//   livro como ajuste (record_movement): uma gravação absoluta perderia
+//   vendas concorrentes e seria desfeita pela reconstrução pelo livro
+// - campos inválidos são mantidos; o mínimo é conferido com a quantidade atual
 // - retorna 1 se sucesso, 0 se produto não encontrado
 int update_product(product_bank *bank, int code, const char *new_name,
-                  float new_price, int new_quantity, int new_minimum_stock,
+                  float new_price, int new_minimum_stock,
                   int new_category, int new_unit);
 
+// grava a imagem de um produto vinda de outro banco (réplica)
+// - código existente (ativo ou inativo): substitui todos os campos
+// - código igual ao próximo código: cadastra na próxima posição
+// - não valida os campos: a imagem já foi validada no banco de origem
+// - retorna 1 se aplicada, 0 se o código não existe nem é o próximo, ou cheio
+int apply_product_image(product_bank *bank, const product *image);
+
 // inativa um produto (deleção lógica)
 // - produto não é removido do array, apenas marcado como inativo
 // - retorna 1 se sucesso, 0 se não encontrado
 int deactivate_product(product_bank *bank, int code);
 
+// soma delta à quantidade do produto de forma atômica (sem travas)
+// - caminho rápido para vendas concorrentes de vários terminais
+// - a quantidade resultante precisa ficar entre 0 e MAX_QUANTITY
+// - previous (opcional): recebe a quantidade anterior à alteração
+// - retorna 1 se aplicado, 0 se o resultado seria inválido (nada é alterado)
+int adjust_product_quantity(product_bank *bank, product *p, int delta, int *previous);
+
+// partes de adjust_product_quantity para quem altera dentro de uma trava
+// própria (livro de movimentações): prepare_product_change antes da trava
+// (cópias para fotos abertas, que alocam), apply_quantity_delta dentro dela
+// (só o compare-and-swap) e publish_quantity_change depois de liberá-la
+// (gerações e ouvintes)
+void prepare_product_change(product_bank *bank, const product *p);
+int apply_quantity_delta(product_bank *bank, product *p, int delta, int *previous);
+void publish_quantity_change(product_bank *bank, product *p);
+
+// quantidade disponível para venda: em estoque menos o reservado
+// (reservas de pedidos online não saem do estoque até a confirmação)
+int available_quantity(const product_bank *bank, const product *p);
+
+// copia um produto de forma consistente, sem bloquear escritores
+// - retorna 1 se o produto ativo foi encontrado e copiado em out, 0 caso contrário
+int read_product_snapshot(const product_bank *bank, int code, product *out);
+
+// copia de forma consistente o produto da posição slot do banco
+// - usado para percorrer o banco inteiro em ordem de código
+// - retorna 1 se o produto está ativo, 0 se inativo, -1 se slot está fora do banco
+int read_product_at(const product_bank *bank, int slot, product *out);
+
+// copia de forma consistente a chave de nome da posição slot do banco
+// - retorna 1 se o produto está ativo, 0 se inativo, -1 se slot está fora do banco
+int read_name_key_at(const product_bank *bank, int slot, name_key *out);
+
+// recalcula as chaves de nome de todas as posições
+// - chamado depois de preencher list sem passar pelo cadastro (carga do arquivo)
+void refresh_name_keys(product_bank *bank);
+
 // ativa novamente um produto inativo
 // - útil para recuperar produtos removidos por engano
 // - retorna 1 se sucesso, 0 se não encontrado ou já ativo
 int activate_product(product_bank *bank, int code);
 
+// registra uma alteração feita fora das funções do banco (carga de arquivo,
+// reservas, reconstrução pelo livro): avança as gerações
+// - category: categoria do produto alterado, ou -1 para todas
+void mark_product_changed(product_bank *bank, int category);
+
+// registra um ouvinte de alteração dos campos fields (PRODUCT_FIELD_*)
+// - retorna 1 se sucesso, 0 se já há BANK_MAX_LISTENERS ouvintes
+int add_product_listener(product_bank *bank, int fields,
+                         void (*on_change)(void *context, int slot, int fields), void *context);
+
+// remove um ouvinte registrado com add_product_listener
+void remove_product_listener(product_bank *bank,
+                             void (*on_change)(void *context, int slot, int fields), void *context);
+
+// avisa os ouvintes interessados que campos da posição slot mudaram
+// (-1 = banco inteiro)
+// - chamado pelas funções do banco, pela carga do arquivo e pela
+//   reconstrução pelo livro
+void notify_product_changed(product_bank *bank, int slot, int fields);
+
+// geração global atual (muda a cada alteração do banco)
+uint64_t bank_generation(const product_bank *bank);
+
+// geração atual de uma categoria (categorias inválidas usam a posição 0)
+uint64_t category_generation(const product_bank *bank, int category);
+
 // ============================================================================
 // API PÚBLICA - CONSULTAS E RELATÓRIOS
 // ============================================================================
@@ -118,6 +271,7 @@ int list_active_products(const product_bank *bank, product *out_array[], size_t
 
 // lista produtos com estoque abaixo do mínimo
 // - identifica produtos que precisam de reposição
+// - considera a quantidade disponível (estoque menos reservas)
 // - retorna quantidade de produtos em situação crítica
 int list_products_below_minimum(const product_bank *bank, product *out_array[], size_t max_out);
 
@@ -0,0 +1,138 @@
+#ifndef RANGE_INDEX_H
+#define RANGE_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "product.h"
+#include "listing.h"
+#include "sync.h"
+
+// ============================================================================
+// MÓDULO: range_index — Índices ordenados de preço e quantidade (faixas)
+// ============================================================================
+// Cada índice guarda as entradas (valor, posição) de todos os produtos em
+// ordem crescente de valor (preço em centavos ou quantidade em estoque) e,
+// em caso de empate, de código. Uma consulta "preço entre R$ 5,00 e R$ 9,90"
+// faz uma busca binária até o início da faixa e percorre só as entradas de
+// dentro dela, em vez de examinar o banco inteiro.
+//
+// O índice é formado por uma sequência ordenada principal e por uma pequena
+// sequência de alterações recentes (delta), também ordenada. Cada alteração
+// de preço ou quantidade avisada pelo banco (update_product, vendas, entradas,
+// checkout) só marca a posição em um mapa de bits atômico, sem trava: vendas
+// em terminais diferentes não disputam o índice. A consulta seguinte recolhe
+// as posições marcadas e, para cada valor que mudou, insere uma entrada nova
+// no delta e invalida a anterior da mesma posição (cada posição tem um
+// carimbo que é incrementado a cada alteração; entradas com carimbo antigo
+// são ignoradas). Quando o delta enche, as duas
+// sequências são intercaladas em uma nova sequência principal, já sem as
+// entradas obsoletas. A leitura intercala as duas sequências na hora.
+//
+// Recarga do arquivo e reconstrução pelo livro reconstroem o índice na
+// próxima consulta (radix sort das chaves, O(n)).
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// entradas do delta antes da intercalação com a sequência principal
+#define RANGE_DELTA_MAX 4096
+// palavras do mapa de posições alteradas (uma posição por bit)
+#define RANGE_DIRTY_WORDS ((MAX_PRODUCTS + 63) / 64)
+
+// ============================================================================
+// ENUMERAÇÕES
+// ============================================================================
+
+// campo indexado
+typedef enum {
+    RANGE_BY_PRICE = 1,         // preço unitário em centavos
+    RANGE_BY_QUANTITY           // quantidade em estoque
+} range_field;
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+// entrada do índice
+typedef struct {
+    uint64_t key;               // valor nos 32 bits altos, posição nos 32 baixos
+    uint32_t stamp;             // carimbo da posição quando a entrada foi criada
+} range_entry;
+
+// índice de um campo do banco
+typedef struct {
+    product_bank *bank;
+    range_field field;
+
+    range_entry *run;           // sequência principal, ordenada
+    range_entry *spare;         // destino da próxima intercalação
+    int run_count;
+    int run_capacity;           // entradas alocadas em run e em spare
+    range_entry delta[RANGE_DELTA_MAX]; // alterações recentes, ordenadas
+    int delta_count;
+
+    // por posição (dimensionado pelo tamanho do banco)
+    uint32_t *values;           // valor indexado atual
+    uint32_t *stamps;           // carimbo atual
+    int slot_capacity;          // posições alocadas nos arrays acima
+
+    int indexed_count;          // posições [0, indexed_count) já indexadas
+    int needs_rebuild;          // 1 = reconstruir na próxima consulta
+    uint64_t dirty[RANGE_DIRTY_WORDS]; // posições alteradas desde a última consulta (atômico)
+    int dirty_pending;          // 1 = há bits marcados em dirty (atômico)
+    spin_lock lock;             // serializa consultas e a aplicação das alterações
+} range_index;
+
+// cursor de uma consulta por faixa
+typedef struct {
+    range_index *index;
+    uint32_t low;               // limite inferior (inclusive)
+    uint32_t high;              // limite superior (inclusive)
+    uint64_t next_key;          // primeira chave ainda não examinada
+    int emitted;                // linhas já entregues
+    int finished;               // 1 quando o fim da faixa foi alcançado
+} range_cursor;
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// cria o índice e passa a ouvir as alterações do campo no banco
+// - os produtos já cadastrados são indexados na primeira consulta
+// - retorna 1 se sucesso, 0 se parâmetros inválidos ou limite de ouvintes
+int initialize_range_index(range_index *index, product_bank *bank, range_field field);
+
+// deixa de ouvir o banco e libera a memória do índice
+void free_range_index(range_index *index);
+
+// valor indexado de um produto (preço em centavos ou quantidade)
+uint32_t range_value_of(range_field field, const product *p);
+
+// abre uma consulta dos produtos ativos com valor entre low e high
+// - em ordem crescente de valor e, nos empates, de código
+// - retorna 1 se sucesso, 0 se parâmetros inválidos (low > high)
+int open_range(range_cursor *cursor, range_index *index, uint32_t low, uint32_t high);
+
+// lê a próxima página de até page_size linhas
+// - cada página continua a partir da última chave entregue: produtos que
+//   mudaram de valor entre uma página e outra aparecem na posição nova
+// - retorna quantidade de linhas preenchidas em out (0 = fim da consulta,
+//   -1 se memória insuficiente para reconstruir o índice)
+int next_range_page(range_cursor *cursor, listing_row out[], size_t page_size);
+
+// copia as posições com valor entre low e high (ativos e inativos), em
+// ordem de valor, para out
+// - usado pelos filtros combinados (filter_query)
+// - retorna quantidade de posições, ou -1 se passariam de max_out ou se
+//   faltou memória para reconstruir o índice
+int collect_range_slots(range_index *index, uint32_t low, uint32_t high,
+                        int out[], size_t max_out);
+
+// verifica se ainda pode haver linhas depois da última página lida
+// - retorna 1 se a consulta não terminou, 0 caso contrário
+int range_has_more(const range_cursor *cursor);
+
+// converte campo em string descritiva
+// - retorna string estática (não precisa liberar memória)
+const char *range_field_to_string(range_field field);
+
+#endif // RANGE_INDEX_H
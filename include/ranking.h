@@ -0,0 +1,74 @@
+#ifndef RANKING_H
+#define RANKING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "product.h"
+#include "velocity.h"
+#include "relatorio.h"
+
+// ============================================================================
+// MÓDULO: ranking — Consultas "top K" sobre o catálogo
+// ============================================================================
+// Responde perguntas como "50 maiores valores em estoque" sem ordenar o
+// catálogo inteiro: uma única passada pelo banco mantém os K melhores em um
+// heap limitado (a raiz é o pior dos K guardados), custo O(n log K) e
+// memória O(K). No final o próprio heap é ordenado no lugar.
+// O heap vive no array de saída do chamador: nenhuma memória é alocada.
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// maior K aceito por uma consulta
+#define RANKING_MAX_K 1000
+
+// ============================================================================
+// ENUMERAÇÕES
+// ============================================================================
+
+// critérios de classificação
+typedef enum {
+    RANKING_STOCK_VALUE = 1,    // maior valor em estoque (preço × quantidade)
+    RANKING_LOWEST_COVER,       // menor cobertura em dias (só produtos com vendas)
+    RANKING_OVERSTOCK           // maior excesso: quantidade / estoque mínimo
+} ranking_metric;
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+// produto classificado
+typedef struct {
+    product item;           // cópia consistente do produto
+    int available;          // quantidade disponível (estoque menos reservas)
+    double score;           // valor do critério (R$, dias ou múltiplo do mínimo)
+} ranking_entry;
+
+// cursor sobre um resultado (estado da fonte de relatório)
+typedef struct {
+    const ranking_entry *entries;
+    int count;
+    int position;           // próxima entrada a entregar
+} ranking_cursor;
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// seleciona os k melhores produtos ativos pelo critério
+// - velocity: obrigatório para RANKING_LOWEST_COVER (ignorado nos demais)
+// - now: instante usado no cálculo da cobertura (segundos desde epoch)
+// - out: array com espaço para k entradas; sai ordenado do melhor para o pior
+// - retorna quantidade de entradas preenchidas (até k)
+int rank_products(const product_bank *bank, velocity_tracker *velocity, ranking_metric metric,
+                  size_t k, uint32_t now, ranking_entry out[]);
+
+// prepara uma fonte de relatório que entrega as entradas na ordem do ranking
+// (cada linha leva o score, exibido na coluna "indicador")
+void open_ranking_report_source(report_source *source, ranking_cursor *cursor,
+                                const ranking_entry *entries, int count);
+
+// converte critério em string descritiva
+// - retorna string estática (não precisa liberar memória)
+const char *ranking_metric_to_string(int metric);
+
+#endif // RANKING_H
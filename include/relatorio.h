@@ -0,0 +1,170 @@
+#ifndef RELATORIO_H
+#define RELATORIO_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include "product.h"
+#include "listing.h"
+#include "mvcc.h"
+
+// ============================================================================
+// MÓDULO: relatorio — Geração de relatórios em arquivo (relatorios/)
+// ============================================================================
+// Os relatórios são gerados em fluxo: as linhas vêm de uma fonte (cursor
+// sobre o banco ou qualquer outro iterador) e são formatadas direto em um
+// buffer de escrita grande e reaproveitável, que só vai para o arquivo quando
+// enche. Nenhuma memória é alocada por linha, então o custo é proporcional
+// ao número de linhas e independe do tamanho do banco em memória.
+// Formatos: CSV, texto de largura fixa e JSON.
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// diretório onde os relatórios são gravados
+#define REPORT_DIRECTORY "relatorios"
+// tamanho padrão do buffer de escrita (1 MiB)
+#define REPORT_BUFFER_SIZE (1 << 20)
+// tamanho máximo do caminho de um relatório
+#define REPORT_PATH_MAX 128
+
+// ============================================================================
+// ENUMERAÇÕES
+// ============================================================================
+
+// tipos de relatório
+typedef enum {
+    REPORT_INVENTORY = 1,   // inventário: todos os produtos ativos
+    REPORT_VALUATION,       // valorização: valor do estoque por produto e categoria
+    REPORT_LOW_STOCK,       // reposição: produtos com disponível no mínimo ou abaixo
+    REPORT_RANKING          // ranking: linhas na ordem da fonte, com o indicador
+} report_kind;
+
+// formatos de saída
+typedef enum {
+    REPORT_FORMAT_CSV = 1,  // valores separados por vírgula
+    REPORT_FORMAT_TEXT,     // texto com colunas de largura fixa
+    REPORT_FORMAT_JSON      // objeto JSON com array de linhas
+} report_format;
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+// linha entregue pela fonte de dados
+typedef struct {
+    product item;           // cópia consistente do produto
+    int available;          // quantidade disponível (estoque menos reservas)
+    double score;           // indicador da linha (rankings; 0 nas demais fontes)
+} report_row;
+
+// fonte de linhas do relatório
+// - next preenche row e retorna 1, ou retorna 0 ao final
+typedef struct {
+    int (*next)(void *state, report_row *row);
+    void *state;            // estado do iterador (passado a next)
+} report_source;
+
+// cursor sobre o banco de produtos (estado da fonte do banco)
+typedef struct {
+    listing_cursor listing; // listagem dos ativos, lida uma linha por vez
+} bank_report_cursor;
+
+// buffer de escrita reaproveitável entre relatórios
+typedef struct {
+    char *data;             // memória do buffer
+    size_t size;            // capacidade
+    size_t used;            // bytes ainda não gravados
+    size_t written;         // bytes já gravados no arquivo atual
+    FILE *file;             // arquivo de destino atual
+    int failed;             // 1 se alguma gravação falhou
+} report_buffer;
+
+// resumo de um relatório gerado
+typedef struct {
+    int rows;                       // linhas de produto escritas
+    size_t bytes;                   // tamanho do arquivo
+    long long total_value_cents;    // valor total do estoque listado (centavos)
+    double elapsed_seconds;         // duração da geração
+} report_summary;
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// aloca o buffer de escrita (size = 0 usa REPORT_BUFFER_SIZE)
+// - retorna 1 se sucesso, 0 se memória insuficiente
+int initialize_report_buffer(report_buffer *buffer, size_t size);
+
+// libera a memória do buffer
+void free_report_buffer(report_buffer *buffer);
+
+// prepara uma fonte que percorre os produtos ativos do banco
+// - order: sort_key (SORT_BY_CODE = ordem de código), com ou sem SORT_DESCENDING
+// - cada produto é copiado de forma consistente (não bloqueia escritores)
+// - retorna 1 se sucesso, 0 se ordem inválida ou memória insuficiente
+int open_bank_report_source(report_source *source, bank_report_cursor *cursor,
+                            const product_bank *bank, int order);
+
+// prepara uma fonte que percorre os produtos ativos de uma seleção
+// (resultado de um filtro combinado), na ordem pedida
+// - retorna 1 se sucesso, 0 se ordem inválida ou memória insuficiente
+int open_selection_report_source(report_source *source, bank_report_cursor *cursor,
+                                 const product_bank *bank, const slot_bitmap *selection,
+                                 int order);
+
+// prepara uma fonte que percorre os produtos ativos de uma foto do banco
+// (mvcc.h), em ordem de código: o relatório inteiro reflete uma única versão
+// enquanto as vendas continuam; o disponível usa as reservas atuais
+// - a foto precisa ficar aberta até o fim do relatório
+// - retorna 1 se sucesso, 0 se foto inválida
+int open_snapshot_report_source(report_source *source, bank_snapshot *snapshot);
+
+// libera a ordem guardada pela fonte do banco
+void close_bank_report_source(bank_report_cursor *cursor);
+
+// monta o caminho relatorios/<tipo>_<AAAAMMDD_HHMMSS>.<extensão>
+// - retorna 1 se sucesso, 0 se o caminho não cabe em out
+int build_report_path(char *out, size_t size, report_kind kind, report_format format);
+
+// monta o caminho relatorios/<nome>_<AAAAMMDD_HHMMSS>.<extensão> (outros módulos)
+// - retorna 1 se sucesso, 0 se o caminho não cabe em out
+int build_named_report_path(char *out, size_t size, const char *name, const char *extension);
+
+// escrita de relatórios de outros módulos pelo mesmo buffer:
+// begin_report_file, report_put_* e end_report_file
+
+// cria o diretório do arquivo se necessário e abre o arquivo como destino do
+// buffer (já inicializado)
+// - retorna 1 se sucesso, 0 se erro
+int begin_report_file(report_buffer *buffer, const char *file_path);
+
+// acrescenta texto ao arquivo atual
+void report_put_text(report_buffer *buffer, const char *text);
+
+// acrescenta número inteiro em decimal
+void report_put_long(report_buffer *buffer, long long value);
+
+// acrescenta o preço do produto com duas casas (em centavos, como nos relatórios)
+void report_put_price(report_buffer *buffer, const product *p);
+
+// acrescenta texto como campo CSV (entre aspas se necessário)
+void report_put_csv_text(report_buffer *buffer, const char *text);
+
+// grava o que resta no buffer e fecha o arquivo
+// - complete = 0 descarta o arquivo (relatório interrompido)
+// - retorna 1 se o arquivo foi gravado por inteiro, 0 se erro ou descartado
+int end_report_file(report_buffer *buffer, const char *file_path, int complete);
+
+// gera um relatório completo no arquivo file_path
+// - cria o diretório relatorios/ se necessário
+// - as linhas são filtradas conforme o tipo (ex.: reposição só inclui
+//   produtos com disponível menor ou igual ao mínimo)
+// - summary (opcional): recebe linhas, bytes, valor total e duração
+// - retorna 1 se sucesso, 0 se erro (o arquivo incompleto é removido)
+int write_report(report_buffer *buffer, report_kind kind, report_format format,
+                 report_source *source, const char *file_path, report_summary *summary);
+
+// converte tipo de relatório em string descritiva
+// - retorna string estática (não precisa liberar memória)
+const char *report_kind_to_string(int kind);
+
+#endif // RELATORIO_H
@@ -0,0 +1,49 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "product.h"
+#include "movimentacao.h"
+
+// ============================================================================
+// MÓDULO: replay — Reconstrução do estoque a partir do livro de movimentações
+// ============================================================================
+// Na inicialização, as quantidades do snapshot (products.dat) são conferidas
+// contra a soma das movimentações de cada produto. O livro é dividido entre
+// várias threads: cada uma soma sua faixa de registros em totais privados por
+// código (sem escrita compartilhada); depois os códigos são particionados
+// entre as threads, que juntam os totais parciais, gravam o resultado no
+// banco e contam as divergências em relação ao snapshot.
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// quantidade máxima de threads de reconstrução
+#define REPLAY_MAX_THREADS PARALLEL_MAX_THREADS
+
+// resultado de uma reconstrução
+typedef struct {
+    unsigned records;           // registros processados
+    unsigned unknown_records;   // registros de códigos inexistentes no banco
+    int products_folded;        // produtos com histórico no livro
+    int mismatches;             // produtos cujo saldo difere do snapshot
+    int threads;                // threads utilizadas
+    double elapsed_seconds;     // duração total
+} replay_report;
+
+// reconstrói as quantidades a partir do livro e confere com o snapshot
+// - thread_count: threads de trabalho (0 = quantidade de processadores)
+// - apply: se 1, os produtos divergentes recebem a quantidade do livro
+// - livro e banco não podem ser alterados durante a reconstrução
+// - report (opcional): recebe estatísticas e divergências
+// - retorna 1 se sucesso, 0 se erro (parâmetros inválidos ou memória)
+int replay_movements(const movement_ledger *ledger, product_bank *bank,
+                     int thread_count, int apply, replay_report *report);
+
+// carrega o snapshot de produtos e o livro de movimentações e reconstrói as
+// quantidades a partir do livro (em paralelo), conferindo com o snapshot
+// - sem arquivo de movimentações (ou com ele ilegível), vale o snapshot
+// - recalcula a velocidade de vendas do rastreador ligado ao livro
+// - retorna 1 se o snapshot foi carregado, 0 caso contrário
+int restore_saved_state(product_bank *bank, movement_ledger *ledger,
+                        const char *products_path, const char *movements_path);
+
+#endif // REPLAY_H
@@ -0,0 +1,178 @@
+#ifndef REPLICATION_H
+#define REPLICATION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "product.h"
+#include "movimentacao.h"
+
+// ============================================================================
+// MÓDULO: replication — Réplica de prontidão por envio do livro
+// ============================================================================
+// O processo principal envia continuamente suas alterações a um processo
+// réplica da mesma máquina, por um socket de domínio Unix; a réplica aplica
+// no próprio banco e pode ser promovida a principal se a máquina ou o
+// processo principal cair.
+//
+// O livro de movimentações já é um diário somente-anexação de toda alteração
+// de quantidade: o envio lê registros novos do livro (nenhuma escrita a mais
+// por venda). Alterações de cadastro (cadastro, edição, inativação e
+// reativação) são capturadas por um ouvinte do banco como imagens completas
+// do produto, cada uma marcada com a posição do livro no momento da captura
+// (dentro da trava do livro): a réplica aplica registros e imagens
+// exatamente nessa ordem, e a quantidade da imagem é a do produto naquela
+// posição.
+//
+// A cada conexão o envio recomeça do zero: o livro inteiro é reenviado e os
+// produtos vão em blocos de imagens (cada bloco capturado dentro da trava do
+// livro, sem parar as vendas por mais que um bloco). Depois disso seguem só
+// as alterações novas. A réplica monta essa ressincronização à parte e só
+// troca o seu estado no primeiro SYNC marcado como completo: uma promoção no
+// meio dela assume a última sincronização completa, nunca um catálogo pela
+// metade.
+//
+// Protocolo (inteiros em little-endian, estruturas no formato binário de
+// products.dat e movements.dat: mesma máquina e mesmo executável):
+//   quadro     = u32 tamanho (tipo + conteúdo) | u8 tipo | conteúdo
+//   RESET      -                                  (réplica recomeça a ressincronização)
+//   PRODUCTS   u32 posição | u32 n | n × produto  (imagens na posição do livro)
+//   MOVEMENTS  u32 primeiro | u32 n | n × registro
+//   SYNC       u64 enviado (ns) | u32 posição | u8 completo
+//                                                 (tudo até a posição enviado;
+//                                                  completo = 1 depois da
+//                                                  sincronização inicial)
+//   ACK        u64 enviado (ns) | u32 posição     (réplica -> principal)
+//
+// Atraso: a réplica mede o tempo entre o envio de um SYNC e sua aplicação;
+// o principal mede os registros ainda não confirmados e o tempo de ida e
+// volta do último ACK.
+// Disponível apenas em sistemas POSIX (Linux).
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// registros por quadro MOVEMENTS
+#define REPLICATION_BATCH_RECORDS 4096
+// produtos por bloco da sincronização inicial
+#define REPLICATION_SYNC_PRODUCTS 4096
+// intervalo entre rodadas de envio (ms)
+#define REPLICATION_INTERVAL_MS 5
+// intervalo entre tentativas de conexão à réplica (ms)
+#define REPLICATION_RETRY_MS 1000
+// maior quadro aceito pela réplica (bytes de conteúdo)
+#define REPLICATION_FRAME_MAX (16 + REPLICATION_SYNC_PRODUCTS * sizeof(product))
+
+// ============================================================================
+// ENUMERAÇÕES
+// ============================================================================
+
+// tipos de quadro
+typedef enum {
+    REPLICATION_RESET = 1,
+    REPLICATION_PRODUCTS,
+    REPLICATION_MOVEMENTS,
+    REPLICATION_SYNC,
+    REPLICATION_ACK
+} replication_frame;
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+// imagem de produto capturada na posição do livro
+typedef struct {
+    uint32_t position;
+    product item;
+} catalog_image;
+
+// números do envio (principal)
+typedef struct {
+    int connected;                  // 1 = réplica conectada
+    uint64_t connections;           // conexões (cada uma reenvia tudo)
+    uint64_t records_shipped;
+    uint64_t images_shipped;
+    uint32_t shipped_position;      // livro enviado até aqui
+    uint32_t acked_position;        // livro confirmado pela réplica até aqui
+    uint32_t lag_records;           // registros do livro ainda não confirmados
+    double last_round_trip_seconds; // SYNC -> ACK do último ACK
+} replication_stats;
+
+// envio ao processo réplica (principal)
+typedef struct {
+    product_bank *bank;
+    movement_ledger *ledger;
+    char socket_path[108];
+    pthread_t thread;
+    int running;
+    int fd;
+    // imagens pendentes (protegidas pela trava do livro)
+    catalog_image *pending;
+    size_t pending_count;
+    size_t pending_capacity;
+    int capturing;                  // 1 = conectado, capturando alterações
+    int synced;                     // 1 = sincronização inicial concluída
+    int captured_slots;             // posições do banco já enviadas como imagem
+    int reset_requested;            // 1 = banco trocado inteiro: recomeçar o envio
+    spin_lock stats_lock;
+    replication_stats stats;
+} replication_primary;
+
+// configuração da réplica
+typedef struct {
+    const char *socket_path;
+    product_bank *bank;
+    movement_ledger *ledger;
+} standby_config;
+
+// números da réplica
+typedef struct {
+    uint64_t connections;
+    uint64_t resets;
+    uint64_t frames;
+    uint64_t records_applied;
+    uint64_t images_applied;
+    uint64_t divergences;           // registros ou imagens que não puderam ser aplicados
+    uint64_t resyncs_completed;     // ressincronizações completas trocadas pelo estado
+    uint32_t applied_position;      // livro aplicado até aqui
+    double last_lag_seconds;        // atraso do último SYNC aplicado
+    double max_lag_seconds;
+} standby_stats;
+
+// ============================================================================
+// API PÚBLICA - PRINCIPAL
+// ============================================================================
+
+// começa a enviar as alterações de bank e ledger para a réplica em socket_path
+// - uma thread própria conecta (e reconecta) à réplica e envia a cada
+//   REPLICATION_INTERVAL_MS
+// - retorna 1 se a thread foi criada, 0 caso contrário
+int start_replication(replication_primary *primary, product_bank *bank,
+                      movement_ledger *ledger, const char *socket_path);
+
+// envia o que faltar, encerra a thread e desliga o ouvinte
+void stop_replication(replication_primary *primary);
+
+// números do envio
+void get_replication_stats(replication_primary *primary, replication_stats *out);
+
+// ============================================================================
+// API PÚBLICA - RÉPLICA
+// ============================================================================
+
+// recebe e aplica as alterações do principal até request_standby_promotion
+// ou request_standby_stop
+// - a cada nova conexão o banco e o livro da réplica são trocados pelos
+//   reenviados, mas só quando a ressincronização fica completa
+// - stats (opcional): recebe os números ao final
+// - retorna 1 se promovida (estado pronto para assumir), 0 se encerrada sem
+//   promoção ou sem nenhuma sincronização completa, -1 se o socket ou a
+//   memória da ressincronização não puderam ser criados
+int run_standby(const standby_config *config, standby_stats *stats);
+
+// pede a promoção da réplica (pode ser chamada por tratador de sinal)
+void request_standby_promotion(void);
+
+// pede o encerramento da réplica sem promoção (tratador de sinal)
+void request_standby_stop(void);
+
+#endif // REPLICATION_H
@@ -0,0 +1,63 @@
+#ifndef REPORT_CACHE_H
+#define REPORT_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "product.h"
+#include "aggregation.h"
+#include "sync.h"
+
+// ============================================================================
+// MÓDULO: report_cache — Cache dos resumos usados pelos painéis
+// ============================================================================
+// Guarda o resultado dos resumos repetidos a cada atualização de tela
+// (produtos ativos, quantos estão abaixo do mínimo, totais por categoria)
+// junto com as gerações do banco em que foram calculados. Enquanto as
+// gerações não mudam, a consulta devolve o resultado guardado em O(1); ao
+// mudar, recalcula uma vez e guarda de novo. As listas em si são lidas em
+// páginas pelo módulo listing.
+// Os totais por categoria usam a geração da própria categoria: vender uma
+// bebida não invalida os totais de limpeza.
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// cache associado a um banco
+typedef struct {
+    const product_bank *bank;
+
+    // produtos ativos (depende da geração global)
+    uint64_t active_generation;         // 0 = não calculado
+    int active_count;
+
+    // produtos abaixo do mínimo (depende da geração global)
+    uint64_t below_generation;          // 0 = não calculado
+    int below_count;
+
+    // totais por categoria (cada um válido na geração da sua categoria)
+    uint64_t category_generations[CATEGORY_OTHERS + 1];
+    aggregate_group category_totals[CATEGORY_OTHERS + 1];
+
+    unsigned hits;                      // consultas atendidas pelo cache
+    unsigned misses;                    // consultas que precisaram recalcular
+    spin_lock lock;                     // protege os valores guardados (recálculos correm fora)
+} report_cache;
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// inicializa o cache vazio para o banco
+void initialize_report_cache(report_cache *cache, const product_bank *bank);
+
+// quantidade de produtos ativos
+int cached_active_count(report_cache *cache);
+
+// quantidade de produtos com disponível no mínimo ou abaixo (mesmo critério
+// da listagem LISTING_BELOW_MINIMUM)
+int cached_below_minimum_count(report_cache *cache);
+
+// totais da categoria (contagem, quantidade, valor e preços em centavos)
+// - retorna 1 se sucesso, 0 se categoria inválida
+int cached_category_totals(report_cache *cache, int category, aggregate_group *out);
+
+#endif // REPORT_CACHE_H
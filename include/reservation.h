@@ -0,0 +1,90 @@
+#ifndef RESERVATION_H
+#define RESERVATION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "product.h"
+#include "movimentacao.h"
+#include "sync.h"
+
+// ============================================================================
+// MÓDULO: reservation — Reservas de estoque com expiração automática
+// ============================================================================
+// Pedidos online seguram estoque antes do pagamento. Uma reserva reduz a
+// quantidade disponível (estoque menos reservado) sem tocar no estoque
+// físico, e expira sozinha após o prazo se não for confirmada.
+//
+// As expirações ficam em uma roda de temporização hierárquica com três
+// níveis (256 x 1 s, 64 x 256 s, 64 x 16384 s, ~12 dias no total): cada
+// tick custa O(1) mais as reservas que vencem nele, independentemente de
+// quantas reservas estão pendentes; reservas distantes descem de nível
+// (cascata) à medida que o prazo se aproxima.
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// posições do nível 0 da roda (1 tick = 1 segundo cada)
+#define WHEEL_LEVEL0_SIZE 256
+// posições dos níveis 1 e 2 da roda
+#define WHEEL_LEVEL_SIZE 64
+// maior prazo aceito para uma reserva (em segundos)
+#define RESERVATION_MAX_TIMEOUT ((WHEEL_LEVEL0_SIZE * WHEEL_LEVEL_SIZE * WHEEL_LEVEL_SIZE) - 1)
+// maior quantidade de reservas pendentes ao mesmo tempo (tamanho máximo do
+// pool: a posição + 1 ocupa 20 bits do identificador)
+#define RESERVATION_MAX_PENDING ((1 << 20) - 1)
+
+// reserva pendente (posição no pool de reservas)
+typedef struct {
+    int code;               // produto reservado (0 = entrada livre)
+    int quantity;           // quantidade reservada
+    uint32_t expires_at;    // tick de expiração
+    uint16_t generation;    // invalida identificadores de reservas antigas
+    int bucket;             // lista da roda onde está (-1 = nenhuma)
+    int prev;               // anterior na lista da posição da roda (-1 = início)
+    int next;               // próxima na lista (-1 = fim; também lista livre)
+} reservation_entry;
+
+// tabela de reservas pendentes e roda de temporização
+typedef struct {
+    movement_ledger *ledger;            // livro onde confirmações viram vendas
+    product_bank *bank;                 // banco cujo disponível é reservado
+    reservation_entry *entries;         // pool de reservas
+    int capacity;                       // tamanho do pool
+    int free_head;                      // primeira entrada livre (-1 = nenhuma)
+    int pending;                        // reservas pendentes
+    uint32_t current_tick;              // último tick processado (segundos)
+    int level0[WHEEL_LEVEL0_SIZE];      // nível 0: vence no tick exato
+    int level1[WHEEL_LEVEL_SIZE];       // nível 1: faixas de 256 ticks
+    int level2[WHEEL_LEVEL_SIZE];       // nível 2: faixas de 16384 ticks
+    spin_lock lock;                     // protege pool e roda
+} reservation_table;
+
+// inicializa a tabela associada ao livro e ao banco
+// - now: instante atual (segundos desde epoch), ponto de partida da roda
+void initialize_reservation_table(reservation_table *table, movement_ledger *ledger,
+                                  product_bank *bank, uint32_t now);
+
+// desfaz todas as reservas pendentes e libera a memória da tabela
+void free_reservation_table(reservation_table *table);
+
+// cria reserva de quantity unidades do produto, válida por timeout_seconds
+// - timeout_seconds: entre 1 e RESERVATION_MAX_TIMEOUT
+// - retorna o identificador da reserva (> 0), ou 0 se não há disponível
+uint32_t create_reservation(reservation_table *table, int code, int quantity,
+                            uint32_t timeout_seconds);
+
+// confirma a reserva como venda (baixa o estoque e grava no livro)
+// - retorna 1 se sucesso, 0 se a reserva não existe mais (expirou) ou não
+//   pôde ser confirmada (nesse caso as unidades voltam ao disponível)
+int commit_reservation(reservation_table *table, uint32_t id);
+
+// cancela a reserva, devolvendo as unidades ao disponível
+// - retorna 1 se sucesso, 0 se a reserva não existe mais
+int cancel_reservation(reservation_table *table, uint32_t id);
+
+// avança a roda até now, expirando as reservas vencidas
+// - as unidades das vencidas voltam ao disponível fora da trava da tabela,
+//   em lotes
+// - retorna quantidade de reservas expiradas
+int advance_reservations(reservation_table *table, uint32_t now);
+
+#endif // RESERVATION_H
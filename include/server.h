@@ -0,0 +1,112 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "product.h"
+#include "movimentacao.h"
+#include "range_index.h"
+
+// ============================================================================
+// MÓDULO: server — Serviço local do estoque (socket Unix, epoll)
+// ============================================================================
+// Um único processo é dono do banco e atende vários caixas da mesma máquina
+// por um socket de domínio Unix, em vez de cada caixa ter sua cópia de
+// products.dat. O laço de eventos usa epoll em uma única thread: nenhuma
+// trava é disputada e as operações são aplicadas na ordem em que chegam.
+//
+// Protocolo binário (inteiros em little-endian):
+//   quadro     = u32 tamanho | conteúdo (tamanho bytes, até SERVER_FRAME_MAX)
+//   requisição = u32 id | u8 operação | argumentos
+//   resposta   = u32 id | u8 situação | corpo
+//
+// O cliente pode enviar várias requisições sem esperar as respostas
+// (pipelining); as respostas voltam na mesma ordem e levam o id da
+// requisição. Operações (argumentos -> corpo da resposta OK):
+//   PING    -                                   -> -
+//   LOOKUP  i32 código                          -> produto (ver abaixo)
+//   MOVE    i32 código, u8 tipo, i32 quantidade -> i32 quantidade atual
+//   RANGE   u8 campo, u32 mín, u32 máx, u16 limite
+//                                               -> u16 n, u8 há_mais, n × i32 código
+//   STATS   -                                   -> u64 requisições, u64 conexões,
+//                                                  u32 p50, p99, p999, máx (ns)
+// produto = i32 código, u32 preço em centavos, i32 quantidade, i32 disponível,
+//           i32 mínimo, u8 categoria, u8 unidade, u8 ativo, u8 n, n bytes do nome
+//
+// A latência de cada requisição (da leitura do quadro até a resposta ficar
+// pronta para envio, incluindo a espera atrás das anteriores do mesmo lote)
+// vai para um histograma log-linear, de onde saem os percentis.
+// Disponível apenas em sistemas POSIX com epoll (Linux).
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// maior quadro aceito (bytes de conteúdo)
+#define SERVER_FRAME_MAX 4096
+
+// maior quantidade de códigos de uma resposta RANGE
+#define SERVER_RANGE_MAX 1000
+
+// faixas do histograma de latência
+#define SERVER_LATENCY_BUCKETS 312
+
+// ============================================================================
+// ENUMERAÇÕES
+// ============================================================================
+
+// operações
+typedef enum {
+    SERVER_OP_PING = 1,
+    SERVER_OP_LOOKUP,
+    SERVER_OP_MOVE,
+    SERVER_OP_RANGE,
+    SERVER_OP_STATS
+} server_operation;
+
+// situação da resposta
+typedef enum {
+    SERVER_OK = 0,
+    SERVER_NOT_FOUND,           // código inexistente
+    SERVER_REFUSED,             // movimentação recusada (quantidade ou estoque)
+    SERVER_BAD_REQUEST,         // operação desconhecida ou argumentos inválidos
+    SERVER_FAILED               // erro interno (ex.: memória insuficiente)
+} server_status;
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+// configuração do serviço
+typedef struct {
+    const char *socket_path;
+    product_bank *bank;
+    movement_ledger *ledger;    // movimentações (MOVE)
+    range_index *prices;        // consultas RANGE por preço (pode ser NULL)
+    range_index *quantities;    // consultas RANGE por quantidade (pode ser NULL)
+} server_config;
+
+// estatísticas do serviço
+typedef struct {
+    uint64_t requests;          // requisições atendidas
+    uint64_t connections;       // conexões aceitas
+    uint64_t protocol_errors;   // conexões encerradas por quadro inválido
+    uint64_t latency[SERVER_LATENCY_BUCKETS]; // histograma de latência
+} server_stats;
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// atende clientes até request_server_stop ser chamada
+// - stats (opcional): recebe as estatísticas ao final
+// - retorna 1 se encerrado normalmente, 0 se o socket não pôde ser criado
+//   ou a plataforma não tem suporte
+int run_server(const server_config *config, server_stats *stats);
+
+// pede o encerramento do serviço (pode ser chamada por tratador de sinal)
+void request_server_stop(void);
+
+// percentil da latência em nanossegundos (fraction entre 0 e 1, ex.: 0.99)
+// - retorna o limite superior da faixa do histograma que contém o percentil
+uint64_t server_latency_percentile(const server_stats *stats, double fraction);
+
+#endif // SERVER_H
@@ -0,0 +1,86 @@
+#ifndef SLOT_BITMAP_H
+#define SLOT_BITMAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+// MÓDULO: slot_bitmap — Conjuntos comprimidos de posições do banco
+// ============================================================================
+// Conjunto de posições no estilo "roaring": as posições são divididas em
+// blocos de 65536 (os 16 bits altos escolhem o bloco) e cada bloco presente
+// guarda os 16 bits baixos em um de dois formatos:
+// - lista ordenada de uint16_t, quando tem até BITMAP_ARRAY_MAX posições
+//   (conjuntos esparsos ocupam 2 bytes por posição);
+// - mapa de bits de 8 KiB, quando tem mais (conjuntos densos ocupam 1 bit
+//   por posição e a interseção vira AND de palavras de 64 bits).
+// Blocos vazios não são guardados. A interseção escolhe o algoritmo pelo
+// formato dos dois lados (intercalação de listas, consulta de bits ou AND
+// palavra a palavra) e o resultado volta ao formato mais compacto.
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// posições por bloco
+#define BITMAP_CHUNK_SLOTS 65536
+// palavras de 64 bits de um bloco em mapa de bits
+#define BITMAP_WORDS (BITMAP_CHUNK_SLOTS / 64)
+// maior bloco guardado como lista (acima disso, mapa de bits)
+#define BITMAP_ARRAY_MAX 4096
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+// bloco de 65536 posições
+typedef struct {
+    uint32_t key;               // número do bloco (posição >> 16)
+    int cardinality;            // posições presentes no bloco
+    uint16_t *values;           // lista ordenada (NULL no formato mapa de bits)
+    uint64_t *words;            // mapa de bits (NULL no formato lista)
+} bitmap_container;
+
+// conjunto de posições (blocos em ordem crescente de key)
+typedef struct {
+    bitmap_container *containers;
+    int count;
+    int capacity;
+} slot_bitmap;
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// inicializa um conjunto vazio
+void initialize_slot_bitmap(slot_bitmap *bitmap);
+
+// libera a memória do conjunto (fica vazio e pode ser reutilizado)
+void free_slot_bitmap(slot_bitmap *bitmap);
+
+// acrescenta ao final um bloco descrito por mapa de bits
+// - key precisa ser maior que a de todos os blocos já presentes
+// - blocos vazios são ignorados
+// - retorna 1 se sucesso, 0 se ordem inválida ou memória insuficiente
+int bitmap_append_words(slot_bitmap *bitmap, uint32_t key, const uint64_t words[BITMAP_WORDS]);
+
+// monta o conjunto a partir de posições em ordem crescente (sem repetição)
+// - o conteúdo anterior é descartado
+// - retorna 1 se sucesso, 0 se memória insuficiente
+int bitmap_from_sorted(slot_bitmap *bitmap, const int *slots, size_t count);
+
+// out = a ∩ b (out não pode ser a nem b)
+// - o conteúdo anterior de out é descartado
+// - retorna 1 se sucesso, 0 se memória insuficiente
+int bitmap_and(const slot_bitmap *a, const slot_bitmap *b, slot_bitmap *out);
+
+// verifica se a posição está no conjunto
+// - retorna 1 se está, 0 caso contrário
+int bitmap_contains(const slot_bitmap *bitmap, int slot);
+
+// quantidade de posições do conjunto
+long long bitmap_cardinality(const slot_bitmap *bitmap);
+
+// copia as posições em ordem crescente para out
+// - retorna quantidade de posições copiadas (no máximo max_out)
+int bitmap_to_slots(const slot_bitmap *bitmap, int out[], size_t max_out);
+
+#endif // SLOT_BITMAP_H
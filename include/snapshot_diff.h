@@ -0,0 +1,50 @@
+#ifndef SNAPSHOT_DIFF_H
+#define SNAPSHOT_DIFF_H
+
+#include "product.h"
+#include "relatorio.h"
+
+// ============================================================================
+// MÓDULO: snapshot_diff — Diferenças entre dois arquivos de dados
+// ============================================================================
+// Compara dois arquivos products.dat (ex.: ontem e hoje, ou original e
+// backup) lendo ambos em fluxo, na ordem de código, com uma junção por
+// intercalação (merge join): a memória usada não depende do tamanho dos
+// arquivos. Produtos novos, removidos, inativados, reativados e alterações de
+// preço, quantidade e demais campos vão para um relatório CSV em relatorios/.
+// Sem relatório, serve como verificação rápida de backup/restauração.
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// resultado da comparação
+typedef struct {
+    int old_count;              // produtos no arquivo anterior
+    int new_count;              // produtos no arquivo novo
+    int added;                  // códigos só no arquivo novo
+    int removed;                // códigos só no arquivo anterior
+    int deactivated;            // ativos que ficaram inativos
+    int reactivated;            // inativos que voltaram a ficar ativos
+    int price_changed;          // produtos com preço alterado
+    int quantity_changed;       // produtos com quantidade alterada
+    int other_changed;          // nome, mínimo, categoria ou unidade alterados
+    int unchanged;              // produtos idênticos
+    int changed_products;       // produtos com qualquer diferença (linhas do relatório)
+    int header_changed;         // 1 se o próximo código difere
+    double elapsed_seconds;     // duração
+} snapshot_diff_summary;
+
+// compara dois arquivos de dados
+// - report_path: arquivo CSV com uma linha por produto alterado, ou NULL
+//   para apenas comparar
+// - buffer: buffer de escrita dos relatórios (relatorio.h), exigido quando
+//   há report_path
+// - retorna 1 se a comparação foi concluída, 0 se erro (arquivo ausente,
+//   versão incompatível, truncado ou fora de ordem de código)
+int diff_snapshots(const char *old_path, const char *new_path, report_buffer *buffer,
+                   const char *report_path, snapshot_diff_summary *summary);
+
+// verifica se a comparação encontrou alguma diferença
+// - retorna 1 se os arquivos têm o mesmo conteúdo, 0 caso contrário
+int snapshots_identical(const snapshot_diff_summary *summary);
+
+#endif // SNAPSHOT_DIFF_H
@@ -0,0 +1,86 @@
+#ifndef SORTING_H
+#define SORTING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "product.h"
+
+// ============================================================================
+// MÓDULO: sorting — Visões ordenadas do banco (nome, preço, quantidade, valor)
+// ============================================================================
+// Cada visão é a lista das posições dos produtos ativos na ordem pedida.
+// Em vez de qsort com comparador por ponteiros, a chave de cada produto é
+// extraída para um inteiro de 64 bits (preço e valor em centavos, quantidade,
+// ou os 8 primeiros bytes da chave de nome guardada no banco: minúsculas e
+// sem acento, normalizada uma vez no cadastro e na renomeação) e os
+// pares (chave, posição) são ordenados por radix sort LSD, estável, em
+// passadas de 8 bits (passadas em que todos os pares caem no mesmo balde
+// são puladas). Só os nomes com o mesmo prefixo de 8 bytes são comparados
+// por inteiro depois.
+//
+// As visões ficam guardadas por banco, junto com a geração. Quando o banco
+// muda, as chaves são extraídas de novo (O(n), barato) e comparadas com as
+// anteriores: se poucos produtos mudaram, eles são retirados da visão,
+// ordenados à parte e intercalados de volta (O(n + k log k)); só quando
+// muitos mudaram a visão é ordenada do zero.
+//
+// Empates saem sempre em ordem de código, inclusive nas ordens decrescentes.
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// combinado com uma chave de ordenação: maior primeiro
+#define SORT_DESCENDING 0x100
+
+// ============================================================================
+// ENUMERAÇÕES
+// ============================================================================
+
+// chaves de ordenação
+typedef enum {
+    SORT_BY_CODE = 0,       // código (ordem natural do banco, sem visão)
+    SORT_BY_NAME,           // nome sem diferenciar maiúsculas nem acentos
+    SORT_BY_PRICE,          // preço unitário
+    SORT_BY_QUANTITY,       // quantidade em estoque
+    SORT_BY_VALUE           // valor em estoque (preço × quantidade)
+} sort_key;
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+// par (chave, posição) ordenado pelo radix sort
+typedef struct {
+    uint64_t key;
+    int slot;
+} sort_pair;
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// verifica se order é uma chave válida, com ou sem SORT_DESCENDING
+// - retorna 1 se válida, 0 caso contrário
+int is_valid_sort_order(int order);
+
+// preenche out_slots com as posições dos produtos ativos na ordem pedida
+// - reaproveita a visão guardada se o banco não mudou desde o último uso
+// - retorna quantidade de posições preenchidas, ou -1 se ordem inválida ou
+//   memória insuficiente
+int sorted_slots(const product_bank *bank, int order, int out_slots[], size_t max_out);
+
+// ordena pairs por chave crescente (radix sort LSD estável de 8 bits)
+// - scratch: área auxiliar com o mesmo tamanho de pairs
+// - também usado pelos índices de faixa (range_index)
+void radix_sort_pairs(sort_pair *pairs, sort_pair *scratch, size_t count);
+
+// libera a memória de todas as visões guardadas
+void free_sorted_views(void);
+
+// libera as visões guardadas de um banco (antes de liberar o banco)
+void forget_sorted_views(const product_bank *bank);
+
+// converte ordem em string descritiva
+// - retorna string estática (não precisa liberar memória)
+const char *sort_order_to_string(int order);
+
+#endif // SORTING_H
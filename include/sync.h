@@ -0,0 +1,63 @@
+#ifndef SYNC_H
+#define SYNC_H
+
+#include <stddef.h>
+
+// ============================================================================
+// MÓDULO: sync — Primitivas de sincronização leves
+// ============================================================================
+// Travas de espera ativa (spin lock) e seqlocks construídas sobre operações
+// atômicas do compilador. Não exigem inicialização além de zerar a memória,
+// por isso podem viver dentro de estruturas como product_bank.
+// - spin lock: exclusão mútua para seções críticas curtas
+// - seqlock: escritores são exclusivos entre si; leitores nunca bloqueiam,
+//   apenas repetem a leitura se um escritor alterou os dados no meio dela
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// tamanho de linha de cache (evita falso compartilhamento entre travas)
+#define CACHE_LINE_SIZE 64
+// quantidade máxima de threads de uma execução paralela
+#define PARALLEL_MAX_THREADS 16
+
+// trava de espera ativa (0 = livre, 1 = ocupada)
+typedef struct {
+    int locked;
+} spin_lock;
+
+// seqlock alinhado em linha de cache própria
+// sequence par = estável, ímpar = escritor em andamento
+typedef struct {
+    unsigned sequence;
+    char padding[CACHE_LINE_SIZE - sizeof(unsigned)];
+} seq_lock;
+
+// adquire a trava, esperando enquanto estiver ocupada
+void spin_lock_acquire(spin_lock *lock);
+
+// libera a trava
+void spin_lock_release(spin_lock *lock);
+
+// inicia uma escrita: exclui outros escritores e sinaliza os leitores
+void seq_lock_write_begin(seq_lock *lock);
+
+// encerra a escrita, publicando os dados alterados
+void seq_lock_write_end(seq_lock *lock);
+
+// inicia uma leitura: retorna a sequência observada (espera escritor terminar)
+unsigned seq_lock_read_begin(const seq_lock *lock);
+
+// verifica se a leitura iniciada com start precisa ser repetida
+// retorna 1 se um escritor alterou os dados durante a leitura
+int seq_lock_read_retry(const seq_lock *lock, unsigned start);
+
+// retorna a quantidade de processadores disponíveis (mínimo 1)
+int cpu_count(void);
+
+// executa worker sobre count tarefas do array tasks (cada uma com task_size bytes)
+// - count - 1 tarefas rodam em threads novas e a primeira na thread atual
+// - se não for possível criar uma thread, a tarefa roda na thread atual
+// - retorna quando todas as tarefas terminaram (count máximo: PARALLEL_MAX_THREADS)
+void run_parallel(void *(*worker)(void *), void *tasks, size_t task_size, int count);
+
+#endif // SYNC_H
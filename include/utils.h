@@ -1,6 +1,8 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <stddef.h>
+
 // ============================================================================
 // MÓDULO: utils — Funções utilitárias de I/O seguro e manipulação de texto
 // ============================================================================
@@ -47,13 +49,31 @@ void read_str_safe(char *str, int max_length);
 // --------------------------------------------------------------------------
 // Converte uma string para letras maiúsculas (in-place).
 // Usada para normalização em buscas case-insensitive.
+// Letras acentuadas UTF-8 de Latin-1 ("ç", "ã") também são convertidas.
 // --------------------------------------------------------------------------
 void str_to_upper(char *str);
 
+// --------------------------------------------------------------------------
+// Normaliza um texto UTF-8 para comparação: minúsculas e sem acentos
+// ("AÇÚCAR" -> "acucar"), de modo que a ordem dos bytes seja a ordem
+// alfabética. Letras de U+00C0 a U+017F viram a letra base (por tabela),
+// acentos combinantes de texto decomposto são descartados e trechos só de
+// ASCII são convertidos 8 bytes por vez. Lê no máximo max_length bytes de
+// text; out precisa de max_length + 1 bytes e sai terminada em '\0'.
+// Retorna o tamanho do texto normalizado.
+// --------------------------------------------------------------------------
+int fold_text(const char *text, size_t max_length, char *out);
+
 // --------------------------------------------------------------------------
 // Pausa a execução e aguarda o usuário pressionar ENTER.
 // Usado para manter menus e mensagens visíveis antes de limpar a tela.
 // --------------------------------------------------------------------------
 void pause_screen(void);
 
+// --------------------------------------------------------------------------
+// Retorna o tempo de um relógio monotônico, em segundos.
+// Só faz sentido comparar dois valores (medir duração de operações).
+// --------------------------------------------------------------------------
+double monotonic_seconds(void);
+
 #endif // UTILS_H
@@ -1,6 +1,9 @@
 #ifndef VALIDATION_H
 #define VALIDATION_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 // ============================================================================
 // MÓDULO: validation — Validações de entrada para o sistema de mercado
 // ============================================================================
@@ -91,4 +94,88 @@ int is_valid_category(int category);
 // --------------------------------------------------------------------------
 int is_valid_unit(int unit);
 
+// ============================================================================
+// VALIDAÇÃO EM LOTE
+// ============================================================================
+// As funções acima validam um valor por vez e o cadastro para no primeiro
+// erro: uma importação grande rejeitada precisa ser corrigida e reenviada
+// erro por erro. A validação em lote percorre colunas de candidatos (uma por
+// campo) uma única vez e devolve, para cada regra, um mapa de bits com as
+// linhas que a violam — todos os erros de todas as linhas de uma vez.
+//
+// As linhas são tratadas em blocos de 64 (uma palavra de cada mapa):
+// - faixas numéricas são comparações sem desvio sobre o bloco inteiro, que o
+//   compilador transforma em instruções vetoriais, e o resultado de cada
+//   linha vira um bit da palavra
+// - nomes são conferidos por uma tabela de classes de byte (permitido,
+//   espaço, proibido) consultada uma vez por byte
+// As regras são as mesmas das funções acima, com uma diferença: preço NaN é
+// rejeitado.
+// ============================================================================
+
+// regras verificadas em lote
+typedef enum {
+    VALIDATION_RULE_NAME = 0,       // is_valid_name_format
+    VALIDATION_RULE_PRICE,          // is_valid_price
+    VALIDATION_RULE_QUANTITY,       // is_valid_quantity
+    VALIDATION_RULE_MINIMUM_STOCK,  // is_valid_minimum_stock
+    VALIDATION_RULE_CATEGORY,       // is_valid_category
+    VALIDATION_RULE_UNIT,           // is_valid_unit
+    VALIDATION_RULE_COUNT
+} validation_rule;
+
+// candidatos em colunas (posição i de cada coluna = linha i)
+// - coluna NULL: regra não verificada (linhas não falham nela); o estoque
+//   mínimo precisa também da coluna de quantidades
+typedef struct {
+    size_t count;
+    const char *const *names;       // nome NULL falha na regra do nome
+    const float *prices;
+    const int *quantities;
+    const int *minimum_stocks;
+    const int *categories;
+    const int *units;
+} product_columns;
+
+// falhas de um lote
+typedef struct {
+    size_t count;                                   // linhas verificadas
+    size_t words;                                   // palavras de cada mapa
+    uint64_t *failures[VALIDATION_RULE_COUNT];      // bit i = linha i viola a regra
+    uint64_t *invalid;                              // bit i = linha i viola alguma regra
+    size_t failure_counts[VALIDATION_RULE_COUNT];
+    size_t invalid_count;                           // linhas com ao menos um erro
+} validation_report;
+
+// --------------------------------------------------------------------------
+// Valida todas as linhas das colunas em uma passada
+// - report recebe os mapas de falhas (liberar com free_validation_report)
+//
+// Retorna: 1 se sucesso, 0 se memória insuficiente
+// --------------------------------------------------------------------------
+int validate_product_columns(const product_columns *columns, validation_report *report);
+
+// --------------------------------------------------------------------------
+// Regras violadas pela linha row
+//
+// Retorna: máscara com o bit (1 << regra) de cada regra violada (0 = válida)
+// --------------------------------------------------------------------------
+unsigned validation_row_failures(const validation_report *report, size_t row);
+
+// --------------------------------------------------------------------------
+// Próxima linha a partir de row que viola a regra (rule = VALIDATION_RULE_COUNT
+// para qualquer regra)
+//
+// Retorna: a linha, ou report->count se não há mais
+// --------------------------------------------------------------------------
+size_t next_validation_failure(const validation_report *report, validation_rule rule, size_t row);
+
+// --------------------------------------------------------------------------
+// Motivo do erro de uma regra, sem acentos (ex.: "preco invalido")
+// --------------------------------------------------------------------------
+const char *validation_rule_message(validation_rule rule);
+
+// libera os mapas de falhas
+void free_validation_report(validation_report *report);
+
 #endif // VALIDATION_H
@@ -0,0 +1,85 @@
+#ifndef VELOCITY_H
+#define VELOCITY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "product.h"
+#include "sync.h"
+
+// ============================================================================
+// MÓDULO: velocity — Velocidade de vendas e dias de cobertura
+// ============================================================================
+// Mantém, para cada produto, uma soma de vendas com decaimento exponencial:
+//     S(t) = soma de q_i * exp(-lambda * (t - t_i)),  lambda = ln 2 / meia-vida
+// A velocidade (unidades/dia) é lambda * S(t) e os dias de cobertura são
+// quantidade / velocidade. Cada venda atualiza S em O(1), sem reler histórico.
+//
+// Alerta de ruptura: produtos cuja cobertura ficou abaixo do horizonte são
+// mantidos em uma lista encadeada atualizada a cada evento. Entre eventos a
+// cobertura só aumenta (a velocidade decai e a quantidade não muda), então a
+// lista é sempre um superconjunto dos produtos em alerta: a consulta apenas
+// confere os candidatos, sem varrer o catálogo.
+// Identificadores em inglês, snake_case; comentários em português.
+// ============================================================================
+
+// meia-vida padrão do decaimento das vendas (em dias)
+#define VELOCITY_DEFAULT_HALF_LIFE_DAYS 7.0
+// horizonte padrão do alerta de ruptura (em dias)
+#define VELOCITY_DEFAULT_HORIZON_DAYS 14.0
+// cobertura de produtos sem vendas recentes (considerada infinita)
+#define DAYS_OF_COVER_INFINITE 1e9
+
+// métricas de um produto (indexadas pela posição no banco)
+typedef struct {
+    double decayed_sales;   // S(t) no instante last_update
+    uint32_t last_update;   // instante da última atualização (segundos desde epoch)
+    int in_alert;           // 1 se está na lista de alerta
+    int alert_prev;         // posição anterior na lista de alerta (-1 = início)
+    int alert_next;         // próxima posição na lista de alerta (-1 = fim)
+} velocity_entry;
+
+// acompanhamento de vendas de um banco
+typedef struct velocity_tracker {
+    velocity_entry entries[MAX_PRODUCTS];   // métricas por posição do banco
+    double lambda_per_day;                  // taxa de decaimento (ln 2 / meia-vida)
+    double horizon_days;                    // horizonte máximo do alerta
+    int alert_head;                         // primeira posição da lista de alerta
+    int alert_count;                        // candidatos na lista de alerta
+    spin_lock lock;                         // protege entradas e lista
+} velocity_tracker;
+
+// inicializa o acompanhamento sem vendas
+// - half_life_days: meia-vida do decaimento (<= 0 usa o padrão)
+// - horizon_days: maior horizonte consultável no alerta (<= 0 usa o padrão)
+void initialize_velocity_tracker(velocity_tracker *tracker, double half_life_days,
+                                 double horizon_days);
+
+// zera as métricas de todos os produtos, mantendo meia-vida e horizonte
+void reset_velocity_tracker(velocity_tracker *tracker);
+
+// registra uma venda do produto (O(1)) e reavalia o alerta de ruptura
+// - when: instante da venda (segundos desde epoch)
+void velocity_record_sale(velocity_tracker *tracker, const product_bank *bank,
+                          const product *p, int quantity, uint32_t when);
+
+// reavalia o alerta após mudança de quantidade sem venda (entrada, ajuste)
+void velocity_refresh(velocity_tracker *tracker, const product_bank *bank,
+                      const product *p, uint32_t when);
+
+// velocidade de vendas do produto no instante now (unidades por dia)
+double sales_velocity(velocity_tracker *tracker, const product_bank *bank,
+                      const product *p, uint32_t now);
+
+// dias de cobertura do produto no instante now
+// - retorna DAYS_OF_COVER_INFINITE se o produto não tem vendas recentes
+double days_of_cover(velocity_tracker *tracker, const product_bank *bank,
+                     const product *p, uint32_t now);
+
+// lista produtos ativos que esgotam em menos de days dias
+// - days é limitado ao horizonte do acompanhamento
+// - percorre apenas os candidatos da lista de alerta
+// - retorna quantidade de produtos preenchidos em out_array
+int list_stockout_alerts(velocity_tracker *tracker, const product_bank *bank,
+                         double days, uint32_t now, product *out_array[], size_t max_out);
+
+#endif // VELOCITY_H
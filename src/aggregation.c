@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <string.h>
+#include "aggregation.h"
+#include "utils.h"
+
+// ============================================================================
+// MÓDULO: aggregation — Implementação dos agrupamentos
+// ============================================================================
+// Uma passada acumula cada produto no seu grupo; os totais gerais são a
+// soma dos grupos.
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// grupo vazio: mínimo e máximo prontos para a primeira comparação
+static void reset_group(aggregate_group *g) {
+    memset(g, 0, sizeof(*g));
+    g->min_price_cents = -1;
+}
+
+// acrescenta um produto aos totais do grupo
+static void add_to_group(aggregate_group *g, long long price, int quantity) {
+    g->count++;
+    g->quantity += quantity;
+    g->value_cents += price * quantity;
+    g->price_sum_cents += price;
+    if (g->min_price_cents < 0 || price < g->min_price_cents) g->min_price_cents = price;
+    if (price > g->max_price_cents) g->max_price_cents = price;
+}
+
+// soma os totais de from em into
+static void merge_group(aggregate_group *into, const aggregate_group *from) {
+    if (from->count == 0) return;
+    into->count += from->count;
+    into->quantity += from->quantity;
+    into->value_cents += from->value_cents;
+    into->price_sum_cents += from->price_sum_cents;
+    if (into->min_price_cents < 0 || from->min_price_cents < into->min_price_cents) {
+        into->min_price_cents = from->min_price_cents;
+    }
+    if (from->max_price_cents > into->max_price_cents) into->max_price_cents = from->max_price_cents;
+}
+
+// índice do grupo do produto (0 = categoria ou unidade desconhecida)
+static int group_index(const aggregate_result *result, const product *p, long long price) {
+    long long index;
+    switch (result->key) {
+        case GROUP_BY_CATEGORY: index = p->category; break;
+        case GROUP_BY_UNIT:     index = p->unit; break;
+        default:                index = price / result->band_cents; break;
+    }
+    if (index < 0 || index >= result->group_count) {
+        // fora da tabela: faixa de preço vai para a última, o resto para "desconhecida"
+        index = result->key == GROUP_BY_PRICE_BAND ? result->group_count - 1 : 0;
+    }
+    return (int)index;
+}
+
+// agrupa produtos ativos do banco
+int aggregate_products(const product_bank *bank, group_by key, long long band_cents,
+                       aggregate_result *result) {
+    if (!bank || !result) return 0;
+    if (key != GROUP_BY_CATEGORY && key != GROUP_BY_UNIT && key != GROUP_BY_PRICE_BAND) return 0;
+    double started_at = monotonic_seconds();
+
+    memset(result, 0, sizeof(*result));
+    result->key = key;
+    result->band_cents = band_cents > 0 ? band_cents : AGGREGATE_DEFAULT_BAND_CENTS;
+    result->group_count = AGGREGATE_MAX_GROUPS;
+    if (key == GROUP_BY_CATEGORY) result->group_count = CATEGORY_OTHERS + 1;
+    if (key == GROUP_BY_UNIT) result->group_count = UNIT_ML + 1;
+    for (int g = 0; g < result->group_count; g++) reset_group(&result->groups[g]);
+
+    int total = __atomic_load_n(&bank->count, __ATOMIC_ACQUIRE);
+    product item;
+    for (int slot = 0; slot < total; slot++) {
+        if (read_product_at(bank, slot, &item) != 1) continue;
+        long long price = (long long)((double)item.price * 100.0 + 0.5);
+        add_to_group(&result->groups[group_index(result, &item, price)], price, item.quantity);
+    }
+
+    reset_group(&result->total);
+    for (int g = 0; g < result->group_count; g++) merge_group(&result->total, &result->groups[g]);
+    result->elapsed_seconds = monotonic_seconds() - started_at;
+    return 1;
+}
+
+// preço médio do grupo
+long long aggregate_average_price_cents(const aggregate_group *group) {
+    if (!group || group->count == 0) return 0;
+    return (group->price_sum_cents + group->count / 2) / group->count;
+}
+
+// descreve o grupo
+char *aggregate_group_label(const aggregate_result *result, int index, char *out, size_t size) {
+    if (!out || size == 0) return out;
+    out[0] = '\0';
+    if (!result) return out;
+
+    switch (result->key) {
+        case GROUP_BY_CATEGORY:
+            snprintf(out, size, "%s", category_to_string(index));
+            break;
+        case GROUP_BY_UNIT:
+            snprintf(out, size, "%s", unit_to_string(index));
+            break;
+        case GROUP_BY_PRICE_BAND: {
+            long long low = index * result->band_cents;
+            if (index == result->group_count - 1) {
+                snprintf(out, size, "R$ %lld,%02lld ou mais", low / 100, low % 100);
+            } else {
+                long long high = low + result->band_cents - 1;
+                snprintf(out, size, "R$ %lld,%02lld a %lld,%02lld",
+                         low / 100, low % 100, high / 100, high % 100);
+            }
+            break;
+        }
+    }
+    return out;
+}
+
+// converte critério em string
+const char *group_by_to_string(int key) {
+    switch (key) {
+        case GROUP_BY_CATEGORY: return "Categoria";
+        case GROUP_BY_UNIT: return "Unidade";
+        case GROUP_BY_PRICE_BAND: return "Faixa de Preco";
+        default: return "Desconhecido";
+    }
+}
@@ -0,0 +1,509 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "batch.h"
+#include "logger.h"
+#include "persistence.h"
+#include "utils.h"
+#include "validation.h"
+
+// ============================================================================
+// MÓDULO: batch — Implementação do modo lote
+// ============================================================================
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// maior quantidade de campos de um comando (update)
+#define BATCH_MAX_FIELDS 8
+
+// cadastros consecutivos validados juntos (validate_product_columns)
+#define BATCH_REGISTER_GROUP 256
+
+// ============================================================================
+// LEITURA E ESCRITA COM BUFFER
+// ============================================================================
+
+// leitor de linhas
+typedef struct {
+    FILE *file;
+    char *data;                 // BATCH_BUFFER_SIZE + 1 bytes (espaço do '\0' final)
+    size_t start;               // início da próxima linha
+    size_t end;                 // fim dos bytes lidos
+    int eof;
+    int failed;                 // erro de leitura
+    int skipping;               // descartando o resto de uma linha maior que o buffer
+} batch_reader;
+
+// escritor de respostas
+typedef struct {
+    FILE *file;
+    char *data;                 // BATCH_BUFFER_SIZE bytes
+    size_t used;
+    int failed;                 // erro de escrita
+} batch_writer;
+
+// próxima linha da entrada, terminada em '\0' e sem "\r\n"
+// - too_long: 1 se a linha passou de BATCH_LINE_MAX (conteúdo descartado)
+// - retorna o tamanho da linha, ou -1 no fim da entrada
+static long next_line(batch_reader *reader, char **line, int *too_long) {
+    while (1) {
+        char *from = reader->data + reader->start;
+        char *newline = memchr(from, '\n', reader->end - reader->start);
+        if (newline || (reader->eof && (reader->start < reader->end || reader->skipping))) {
+            size_t length = newline ? (size_t)(newline - from) : reader->end - reader->start;
+            reader->start += length + (newline ? 1 : 0);
+            if (length > 0 && from[length - 1] == '\r') length--;
+            from[length] = '\0';
+            *line = from;
+            *too_long = reader->skipping || length > BATCH_LINE_MAX;
+            reader->skipping = 0;
+            return (long)length;
+        }
+        if (reader->eof) return -1;
+
+        // sem linha completa no buffer: move o resto para o início e lê mais
+        size_t pending = reader->end - reader->start;
+        if (pending == BATCH_BUFFER_SIZE) {
+            reader->skipping = 1;    // linha maior que o buffer inteiro
+            pending = 0;
+        } else if (pending > 0 && reader->start > 0) {
+            memmove(reader->data, from, pending);
+        }
+        reader->start = 0;
+        reader->end = pending;
+        size_t got = fread(reader->data + pending, 1, BATCH_BUFFER_SIZE - pending, reader->file);
+        reader->end += got;
+        if (got == 0) {
+            reader->eof = 1;
+            reader->failed = ferror(reader->file) != 0;
+        }
+    }
+}
+
+// descarrega as respostas acumuladas
+static void flush_writer(batch_writer *writer) {
+    if (writer->used > 0 && !writer->failed
+        && fwrite(writer->data, 1, writer->used, writer->file) != writer->used) {
+        writer->failed = 1;
+    }
+    writer->used = 0;
+}
+
+// acrescenta uma linha formatada às respostas
+static void write_line(batch_writer *writer, const char *format, ...) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        size_t room = BATCH_BUFFER_SIZE - writer->used;
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(writer->data + writer->used, room, format, args);
+        va_end(args);
+        if (written < 0) return;
+        if ((size_t)written < room) {
+            writer->used += (size_t)written;
+            return;
+        }
+        flush_writer(writer);    // não coube: esvazia e tenta de novo
+    }
+}
+
+// ============================================================================
+// CAMPOS
+// ============================================================================
+
+// separa a linha em campos (in-place)
+// - retorna quantidade de campos, ou max + 1 se há campos demais
+static int split_fields(char *line, char *fields[], int max) {
+    int count = 0;
+    char *cursor = line;
+    while (1) {
+        if (count == max) return max + 1;
+        fields[count++] = cursor;
+        char *separator = strchr(cursor, ';');
+        if (!separator) return count;
+        *separator = '\0';
+        cursor = separator + 1;
+    }
+}
+
+// converte campo inteiro (o texto inteiro precisa ser o número)
+static int parse_int_field(const char *text, int *out) {
+    char *end;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || value < INT_MIN || value > INT_MAX) return 0;
+    *out = (int)value;
+    return 1;
+}
+
+// converte campo de preço (aceita ',' ou '.' como separador decimal)
+static int parse_price_field(const char *text, float *out) {
+    char copy[32];
+    size_t length = strlen(text);
+    if (length == 0 || length >= sizeof(copy)) return 0;
+    memcpy(copy, text, length + 1);
+    char *comma = strchr(copy, ',');
+    if (comma) *comma = '.';
+    char *end;
+    float value = strtof(copy, &end);
+    if (*end != '\0') return 0;
+    *out = value;
+    return 1;
+}
+
+// ============================================================================
+// COMANDOS
+// ============================================================================
+
+// cada comando escreve a própria linha OK, ou devolve o motivo do erro
+typedef const char *(*batch_command)(batch_session *session, char *fields[], int count,
+                                     batch_writer *writer);
+
+// valida e preenche os campos de um produto (register e update)
+// - fields: nome, preço, quantidade, mínimo, categoria, unidade
+// - campos vazios mantêm o valor de out (só no update; allow_empty = 1)
+// - retorna NULL se válido, ou o motivo do erro
+static const char *read_product_fields(char *fields[], int allow_empty, product *out) {
+    if (fields[0][0] || !allow_empty) {
+        if (strlen(fields[0]) >= PRODUCT_NAME_MAX_LENGTH) return "nome longo demais";
+        if (!is_valid_name_format(fields[0])) return "nome invalido";
+        strcpy(out->name, fields[0]);
+    }
+    if ((fields[1][0] || !allow_empty)
+        && (!parse_price_field(fields[1], &out->price) || !is_valid_price(out->price))) {
+        return "preco invalido";
+    }
+    if ((fields[2][0] || !allow_empty)
+        && (!parse_int_field(fields[2], &out->quantity) || !is_valid_quantity(out->quantity))) {
+        return "quantidade invalida";
+    }
+    if (fields[3][0] || !allow_empty) {
+        if (!parse_int_field(fields[3], &out->minimum_stock)) return "estoque minimo invalido";
+    }
+    if (!is_valid_minimum_stock(out->minimum_stock, out->quantity)) return "estoque minimo invalido";
+    if ((fields[4][0] || !allow_empty)
+        && (!parse_int_field(fields[4], &out->category) || !is_valid_category(out->category))) {
+        return "categoria invalida";
+    }
+    if ((fields[5][0] || !allow_empty)
+        && (!parse_int_field(fields[5], &out->unit) || !is_valid_unit(out->unit))) {
+        return "unidade invalida";
+    }
+    return NULL;
+}
+
+// ============================================================================
+// CADASTROS EM GRUPO
+// ============================================================================
+// Linhas register consecutivas são guardadas em colunas e validadas juntas,
+// em uma passada, quando chega outro comando, o grupo enche ou a entrada
+// acaba. As respostas continuam na ordem das linhas.
+
+// cadastros pendentes (os nomes são copiados: o buffer de leitura muda)
+typedef struct {
+    size_t count;
+    long long lines[BATCH_REGISTER_GROUP];                  // linha de cada cadastro
+    char names[BATCH_REGISTER_GROUP][PRODUCT_NAME_MAX_LENGTH];
+    const char *name_columns[BATCH_REGISTER_GROUP];         // aponta para names
+    float prices[BATCH_REGISTER_GROUP];
+    int quantities[BATCH_REGISTER_GROUP];
+    int minimum_stocks[BATCH_REGISTER_GROUP];
+    int categories[BATCH_REGISTER_GROUP];
+    int units[BATCH_REGISTER_GROUP];
+} register_group;
+
+// register;nome;preco;quantidade;minimo;categoria;unidade
+// - só confere o formato dos campos; as regras ficam para flush_registers
+static const char *queue_register(register_group *group, char *fields[], int count,
+                                  long long line_number) {
+    if (count != 7) return "uso: register;nome;preco;quantidade;minimo;categoria;unidade";
+    size_t row = group->count;
+    if (strlen(fields[1]) >= PRODUCT_NAME_MAX_LENGTH) return "nome longo demais";
+    if (!parse_price_field(fields[2], &group->prices[row])) return "preco invalido";
+    if (!parse_int_field(fields[3], &group->quantities[row])) return "quantidade invalida";
+    if (!parse_int_field(fields[4], &group->minimum_stocks[row])) return "estoque minimo invalido";
+    if (!parse_int_field(fields[5], &group->categories[row])) return "categoria invalida";
+    if (!parse_int_field(fields[6], &group->units[row])) return "unidade invalida";
+    strcpy(group->names[row], fields[1]);
+    group->name_columns[row] = group->names[row];
+    group->lines[row] = line_number;
+    group->count++;
+    return NULL;
+}
+
+// valida o grupo em uma passada e cadastra as linhas limpas
+// - cada linha com erro recebe uma resposta com todas as regras violadas
+// - retorna quantidade de linhas com erro
+static long long flush_registers(batch_session *session, register_group *group,
+                                 batch_writer *writer) {
+    if (group->count == 0) return 0;
+    product_columns columns = {
+        group->count, group->name_columns, group->prices, group->quantities,
+        group->minimum_stocks, group->categories, group->units
+    };
+    validation_report report;
+    long long errors = 0;
+    if (!validate_product_columns(&columns, &report)) {
+        for (size_t row = 0; row < group->count; row++) {
+            write_line(writer, "ERRO;%lld;memoria insuficiente\n", group->lines[row]);
+        }
+        errors = (long long)group->count;
+        group->count = 0;
+        return errors;
+    }
+
+    size_t failing = next_validation_failure(&report, VALIDATION_RULE_COUNT, 0);
+    for (size_t row = 0; row < group->count; row++) {
+        if (row == failing) {
+            // motivos separados por ", " (';' separa os campos da resposta)
+            char reason[160] = "";
+            unsigned rules = validation_row_failures(&report, row);
+            for (int rule = 0; rule < VALIDATION_RULE_COUNT; rule++) {
+                if (!(rules & (1u << rule))) continue;
+                if (reason[0]) strcat(reason, ", ");
+                strcat(reason, validation_rule_message((validation_rule)rule));
+            }
+            write_line(writer, "ERRO;%lld;%s\n", group->lines[row], reason);
+            errors++;
+            failing = next_validation_failure(&report, VALIDATION_RULE_COUNT, row + 1);
+            continue;
+        }
+        int code = register_validated_product(session->bank, group->names[row], group->prices[row],
+                                              group->quantities[row], group->minimum_stocks[row],
+                                              group->categories[row], group->units[row]);
+        if (code < 0) {
+            write_line(writer, "ERRO;%lld;limite de produtos atingido\n", group->lines[row]);
+            errors++;
+            continue;
+        }
+        write_line(writer, "OK;register;%d\n", code);
+    }
+    free_validation_report(&report);
+    group->count = 0;
+    return errors;
+}
+
+// update;codigo;nome;preco;quantidade;minimo;categoria;unidade
+static const char *command_update(batch_session *session, char *fields[], int count,
+                                  batch_writer *writer) {
+    if (count != 8) return "uso: update;codigo;nome;preco;quantidade;minimo;categoria;unidade";
+    int code;
+    if (!parse_int_field(fields[1], &code) || !is_valid_code(code)) return "codigo invalido";
+    product current;
+    if (!read_product_snapshot(session->bank, code, &current)) return "produto nao encontrado";
+    int old_quantity = current.quantity;
+    const char *error = read_product_fields(fields + 2, 1, &current);
+    if (error) return error;
+    // alteração de quantidade é registrada como ajuste no livro (como no menu);
+    // update_product não grava a quantidade
+    if (current.quantity != old_quantity) {
+        if (!session->ledger) return "livro de movimentacoes indisponivel";
+        if (!set_product_quantity(session->ledger, session->bank, code, current.quantity)) {
+            return "quantidade invalida ou abaixo do reservado";
+        }
+    }
+    if (!update_product(session->bank, code, current.name, current.price,
+                        current.minimum_stock, current.category, current.unit)) {
+        return "produto nao encontrado";
+    }
+    write_line(writer, "OK;update;%d\n", code);
+    return NULL;
+}
+
+// deactivate;codigo
+static const char *command_deactivate(batch_session *session, char *fields[], int count,
+                                      batch_writer *writer) {
+    int code;
+    if (count != 2) return "uso: deactivate;codigo";
+    if (!parse_int_field(fields[1], &code) || !is_valid_code(code)) return "codigo invalido";
+    if (!deactivate_product(session->bank, code)) return "produto nao encontrado";
+    write_line(writer, "OK;deactivate;%d\n", code);
+    return NULL;
+}
+
+// activate;codigo
+static const char *command_activate(batch_session *session, char *fields[], int count,
+                                    batch_writer *writer) {
+    int code;
+    if (count != 2) return "uso: activate;codigo";
+    if (!parse_int_field(fields[1], &code) || !is_valid_code(code)) return "codigo invalido";
+    if (!activate_product(session->bank, code)) return "produto nao encontrado ou ja ativo";
+    refresh_stockout_alert(session->ledger, session->bank, code);
+    write_line(writer, "OK;activate;%d\n", code);
+    return NULL;
+}
+
+// query;codigo
+// - OK;query;codigo;nome;preco;quantidade;minimo;categoria;unidade;ativo
+static const char *command_query(batch_session *session, char *fields[], int count,
+                                 batch_writer *writer) {
+    int code;
+    if (count != 2) return "uso: query;codigo";
+    if (!parse_int_field(fields[1], &code) || !is_valid_code(code)) return "codigo invalido";
+    product p;
+    p.code = 0;
+    read_product_snapshot(session->bank, code, &p);   // inativos também são mostrados
+    if (p.code != code) return "produto nao encontrado";
+    write_line(writer, "OK;query;%d;%s;%.2f;%d;%d;%d;%d;%d\n", p.code, p.name, p.price,
+               p.quantity, p.minimum_stock, p.category, p.unit, p.active);
+    return NULL;
+}
+
+// move;codigo;tipo;quantidade
+// - OK;move;codigo;quantidade_atual
+static const char *command_move(batch_session *session, char *fields[], int count,
+                                batch_writer *writer) {
+    static const struct { const char *name; movement_type type; } types[] = {
+        { "entrada", MOVEMENT_IN }, { "venda", MOVEMENT_SALE },
+        { "perda", MOVEMENT_LOSS }, { "ajuste", MOVEMENT_ADJUSTMENT }
+    };
+    int code, quantity;
+    if (count != 4) return "uso: move;codigo;tipo;quantidade";
+    if (!session->ledger) return "livro de movimentacoes indisponivel";
+    if (!parse_int_field(fields[1], &code) || !is_valid_code(code)) return "codigo invalido";
+    int type = 0;
+    for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+        if (strcmp(fields[2], types[i].name) == 0) type = types[i].type;
+    }
+    if (!type) return "tipo invalido (entrada, venda, perda, ajuste)";
+    if (!parse_int_field(fields[3], &quantity)) return "quantidade invalida";
+    if (!record_movement(session->ledger, session->bank, code, (movement_type)type, quantity)) {
+        return "movimentacao recusada (produto, quantidade ou estoque)";
+    }
+    product p;
+    read_product_snapshot(session->bank, code, &p);
+    write_line(writer, "OK;move;%d;%d\n", code, p.quantity);
+    return NULL;
+}
+
+// save
+// - OK;save;produtos
+static const char *command_save(batch_session *session, char *fields[], int count,
+                                batch_writer *writer) {
+    (void)fields;
+    if (count != 1) return "uso: save";
+    if (!session->products_path
+        || !save_products_to_file(session->bank, session->products_path)) {
+        return "falha ao salvar produtos";
+    }
+    if (session->ledger && session->movements_path
+        && !save_movements_to_file(session->ledger, session->movements_path)) {
+        return "falha ao salvar movimentacoes";
+    }
+    write_line(writer, "OK;save;%d\n", session->bank->count);
+    return NULL;
+}
+
+// comandos reconhecidos
+static const struct {
+    const char *name;
+    batch_command run;
+} commands[] = {
+    { "update", command_update },
+    { "deactivate", command_deactivate },
+    { "activate", command_activate },
+    { "query", command_query },
+    { "move", command_move },
+    { "save", command_save }
+};
+
+// executa uma linha (register entra no grupo; os demais comandos descarregam
+// o grupo antes, para que vejam os cadastros e as respostas sigam a ordem)
+// - retorna quantidade de erros respondidos (do grupo e da própria linha)
+static long long run_line(batch_session *session, register_group *group, char *line,
+                          long long line_number, batch_writer *writer) {
+    char *fields[BATCH_MAX_FIELDS];
+    int count = split_fields(line, fields, BATCH_MAX_FIELDS);
+    if (count <= BATCH_MAX_FIELDS && strcmp(fields[0], "register") == 0) {
+        const char *error = queue_register(group, fields, count, line_number);
+        if (!error) {
+            return group->count == BATCH_REGISTER_GROUP ? flush_registers(session, group, writer) : 0;
+        }
+        long long errors = flush_registers(session, group, writer);
+        write_line(writer, "ERRO;%lld;%s\n", line_number, error);
+        return errors + 1;
+    }
+
+    long long errors = flush_registers(session, group, writer);
+    const char *error = "comando desconhecido";
+    if (count > BATCH_MAX_FIELDS) {
+        error = "campos demais";
+    } else {
+        for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+            if (strcmp(fields[0], commands[i].name) == 0) {
+                error = commands[i].run(session, fields, count, writer);
+                break;
+            }
+        }
+    }
+    if (!error) return errors;
+    write_line(writer, "ERRO;%lld;%s\n", line_number, error);
+    return errors + 1;
+}
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// executa o lote
+int run_batch(batch_session *session, FILE *input, FILE *output, batch_summary *summary) {
+    if (!session || !session->bank || !input || !output) return 0;
+    batch_summary totals;
+    memset(&totals, 0, sizeof(totals));
+
+    batch_reader reader;
+    batch_writer writer;
+    memset(&reader, 0, sizeof(reader));
+    memset(&writer, 0, sizeof(writer));
+    reader.file = input;
+    reader.data = malloc(BATCH_BUFFER_SIZE + 1);
+    writer.file = output;
+    writer.data = malloc(BATCH_BUFFER_SIZE);
+    register_group *group = malloc(sizeof(register_group));
+    if (!reader.data || !writer.data || !group) {
+        free(reader.data);
+        free(writer.data);
+        free(group);
+        log_message(LOG_ERROR, "batch", "Memoria insuficiente para o modo lote");
+        return 0;
+    }
+    group->count = 0;
+
+    int quiet = session->bank->quiet;
+    session->bank->quiet = 1;
+    double started_at = monotonic_seconds();
+    char *line;
+    int too_long;
+    long length;
+    while ((length = next_line(&reader, &line, &too_long)) >= 0 && !writer.failed) {
+        totals.lines++;
+        if (too_long) {
+            totals.commands++;
+            totals.errors += flush_registers(session, group, &writer) + 1;
+            write_line(&writer, "ERRO;%lld;linha longa demais\n", totals.lines);
+            continue;
+        }
+        if (length == 0 || line[0] == '#') continue;
+        totals.commands++;
+        totals.errors += run_line(session, group, line, totals.lines, &writer);
+    }
+    totals.errors += flush_registers(session, group, &writer);
+    flush_writer(&writer);
+    if (!writer.failed && fflush(output) != 0) writer.failed = 1;
+    totals.elapsed_seconds = monotonic_seconds() - started_at;
+    session->bank->quiet = quiet;
+
+    char message[200];
+    snprintf(message, sizeof(message), "Lote concluido: %lld comandos, %lld erros, %.3f s",
+             totals.commands, totals.errors, totals.elapsed_seconds);
+    log_message(totals.errors ? LOG_WARNING : LOG_INFO, "batch", message);
+    if (reader.failed) log_message(LOG_ERROR, "batch", "Erro de leitura da entrada do lote");
+    if (writer.failed) log_message(LOG_ERROR, "batch", "Erro de escrita da saida do lote");
+
+    int ok = !reader.failed && !writer.failed;
+    free(reader.data);
+    free(writer.data);
+    free(group);
+    if (summary) *summary = totals;
+    return ok;
+}
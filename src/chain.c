@@ -0,0 +1,401 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "chain.h"
+#include "logger.h"
+
+// ============================================================================
+// MÓDULO: chain — Implementação da rede de lojas
+// ============================================================================
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// threads de uma operação sobre work_items itens
+static int threads_for(const store_chain *chain, size_t work_items) {
+    int threads = chain->thread_count;
+    if (threads > PARALLEL_MAX_THREADS) threads = PARALLEL_MAX_THREADS;
+    if ((size_t)threads > work_items) threads = (int)work_items;
+    return threads > 0 ? threads : 1;
+}
+
+// posição da loja em by_id (ou onde seria inserida)
+// - leitores fora da trava podem ver uma entrada ainda não publicada (NULL):
+//   nesse caso *torn recebe 1 e a leitura precisa ser repetida
+static int lower_bound_store(store_chain *chain, int count, int store_id, int *torn) {
+    int low = 0, high = count;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        const chain_store *entry = __atomic_load_n(&chain->by_id[mid], __ATOMIC_ACQUIRE);
+        if (!entry) {
+            *torn = 1;
+            return 0;
+        }
+        if (entry->store_id < store_id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// loja store_id em by_id (chamador segura a trava da rede)
+static chain_store *find_store_locked(store_chain *chain, int store_id) {
+    int torn = 0;
+    int position = lower_bound_store(chain, chain->count, store_id, &torn);
+    if (position < chain->count && chain->by_id[position]->store_id == store_id) {
+        return chain->by_id[position];
+    }
+    return NULL;
+}
+
+// ============================================================================
+// LOJAS
+// ============================================================================
+
+// rede vazia
+void initialize_store_chain(store_chain *chain, const char *data_dir,
+                            mercado_lock_mode lock_mode, int thread_count) {
+    if (!chain) return;
+    memset(chain, 0, sizeof(*chain));
+    snprintf(chain->data_dir, sizeof(chain->data_dir), "%s", data_dir ? data_dir : ".");
+    chain->lock_mode = lock_mode;
+    chain->thread_count = thread_count > 0 ? thread_count : cpu_count();
+}
+
+// abre a loja
+int open_chain_store(store_chain *chain, int store_id) {
+    if (!chain) return 0;
+    spin_lock_acquire(&chain->lock);
+    int refused = chain->count >= CHAIN_MAX_STORES || find_store_locked(chain, store_id);
+    spin_lock_release(&chain->lock);
+    if (refused) return 0;
+
+    // leitura dos arquivos fora da trava: cadastros e outras aberturas seguem
+    chain_store *entry = calloc(1, sizeof(chain_store));
+    if (!entry) {
+        log_message(LOG_ERROR, "chain", "Memoria insuficiente para abrir a loja");
+        return 0;
+    }
+    entry->store_id = store_id;
+    int products_length = snprintf(entry->products_path, sizeof(entry->products_path),
+                                   "%s/loja_%d_products.dat", chain->data_dir, store_id);
+    int movements_length = snprintf(entry->movements_path, sizeof(entry->movements_path),
+                                    "%s/loja_%d_movements.dat", chain->data_dir, store_id);
+    if (products_length >= CHAIN_PATH_MAX || movements_length >= CHAIN_PATH_MAX) {
+        free(entry);
+        log_message(LOG_ERROR, "chain", "Caminho dos arquivos da loja muito longo");
+        return 0;
+    }
+    mercado_options options = { entry->products_path, entry->movements_path, chain->lock_mode, 1 };
+    entry->store = mercado_open(&options);
+    if (!entry->store) {
+        free(entry);
+        return 0;
+    }
+
+    // publica: confere de novo (outra thread pode ter aberto a mesma loja)
+    spin_lock_acquire(&chain->lock);
+    if (chain->count >= CHAIN_MAX_STORES || find_store_locked(chain, store_id)) {
+        spin_lock_release(&chain->lock);
+        mercado_close(entry->store);
+        free(entry);
+        return 0;
+    }
+    int torn = 0;
+    int position = lower_bound_store(chain, chain->count, store_id, &torn);
+    seq_lock_write_begin(&chain->directory);
+    for (int i = chain->count; i > position; i--) {
+        __atomic_store_n(&chain->by_id[i], chain->by_id[i - 1], __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&chain->by_id[position], entry, __ATOMIC_RELEASE);
+    __atomic_store_n(&chain->stores[chain->count], entry, __ATOMIC_RELEASE);
+    __atomic_store_n(&chain->count, chain->count + 1, __ATOMIC_RELAXED);
+    seq_lock_write_end(&chain->directory);
+    spin_lock_release(&chain->lock);
+    return 1;
+}
+
+// estoque da loja (leitura sem trava, repetida se uma abertura a cruzou)
+mercado_store *find_chain_store(store_chain *chain, int store_id) {
+    if (!chain) return NULL;
+    mercado_store *store;
+    unsigned start;
+    int torn;
+    do {
+        start = seq_lock_read_begin(&chain->directory);
+        int count = __atomic_load_n(&chain->count, __ATOMIC_RELAXED);
+        torn = 0;
+        int position = lower_bound_store(chain, count, store_id, &torn);
+        store = NULL;
+        if (!torn && position < count) {
+            const chain_store *entry = __atomic_load_n(&chain->by_id[position], __ATOMIC_ACQUIRE);
+            if (!entry) torn = 1;
+            else if (entry->store_id == store_id) store = entry->store;
+        }
+    } while (torn || seq_lock_read_retry(&chain->directory, start));
+    return store;
+}
+
+// copia os estoques das lojas abertas, na ordem de abertura
+// - lê sob o seqlock directory: não espera aberturas nem cadastros em curso
+// - retorna quantidade de lojas em out (até CHAIN_MAX_STORES)
+static int snapshot_stores(store_chain *chain, mercado_store *out[]) {
+    unsigned start;
+    int count, torn;
+    do {
+        start = seq_lock_read_begin(&chain->directory);
+        count = __atomic_load_n(&chain->count, __ATOMIC_RELAXED);
+        torn = 0;
+        for (int i = 0; i < count && !torn; i++) {
+            const chain_store *entry = __atomic_load_n(&chain->stores[i], __ATOMIC_ACQUIRE);
+            if (!entry) torn = 1;
+            else out[i] = entry->store;
+        }
+    } while (torn || seq_lock_read_retry(&chain->directory, start));
+    return count;
+}
+
+// fecha as lojas
+void close_store_chain(store_chain *chain) {
+    if (!chain) return;
+    for (int i = 0; i < chain->count; i++) {
+        mercado_close(chain->stores[i]->store);
+        free(chain->stores[i]);
+        chain->stores[i] = NULL;
+        chain->by_id[i] = NULL;
+    }
+    chain->count = 0;
+}
+
+// tarefa de gravação: lojas [first, end) da cópia
+typedef struct {
+    mercado_store *const *stores;
+    int first;
+    int end;
+    int saved;
+} save_task;
+
+static void *save_worker(void *argument) {
+    save_task *task = argument;
+    for (int i = task->first; i < task->end; i++) {
+        task->saved += mercado_save(task->stores[i]);
+    }
+    return NULL;
+}
+
+// grava todas as lojas
+int save_store_chain(store_chain *chain) {
+    if (!chain) return 0;
+    mercado_store *stores[CHAIN_MAX_STORES];
+    int store_count = snapshot_stores(chain, stores);
+    if (store_count == 0) return 0;
+    save_task tasks[PARALLEL_MAX_THREADS];
+    int threads = threads_for(chain, (size_t)store_count);
+    for (int t = 0; t < threads; t++) {
+        tasks[t].stores = stores;
+        tasks[t].first = (int)((long long)store_count * t / threads);
+        tasks[t].end = (int)((long long)store_count * (t + 1) / threads);
+        tasks[t].saved = 0;
+    }
+    run_parallel(save_worker, tasks, sizeof(save_task), threads);
+    int saved = 0;
+    for (int t = 0; t < threads; t++) saved += tasks[t].saved;
+    if (saved < store_count) {
+        log_message(LOG_ERROR, "chain", "Falha ao gravar os arquivos de uma ou mais lojas");
+    }
+    return saved;
+}
+
+// ============================================================================
+// CATÁLOGO
+// ============================================================================
+
+// cadastra em todas as lojas
+int chain_register_product(store_chain *chain, const char *name, float price, int quantity,
+                           int minimum_stock, int category, int unit) {
+    if (!chain || chain->count == 0) return -1;
+    spin_lock_acquire(&chain->lock);
+
+    // o próximo código precisa ser o mesmo em todas as lojas, e todas
+    // precisam ter espaço: um cadastro que parasse no meio deixaria os
+    // próximos códigos divergentes (não há como desfazer um cadastro)
+    int next_code = mercado_bank(chain->stores[0]->store)->next_code;
+    for (int i = 0; i < chain->count; i++) {
+        const product_bank *bank = mercado_bank(chain->stores[i]->store);
+        if (bank->next_code != next_code) {
+            spin_lock_release(&chain->lock);
+            log_message(LOG_ERROR, "chain", "Catalogos das lojas divergem: cadastro recusado");
+            return -1;
+        }
+        if (__atomic_load_n(&bank->count, __ATOMIC_ACQUIRE) >= MAX_PRODUCTS) {
+            spin_lock_release(&chain->lock);
+            log_message(LOG_WARNING, "chain", "Loja sem espaco para novos produtos: cadastro recusado");
+            return -1;
+        }
+    }
+
+    // os dados são os mesmos em todas: se forem inválidos, a primeira loja
+    // recusa antes de qualquer cadastro
+    int code = -1;
+    for (int i = 0; i < chain->count; i++) {
+        code = mercado_register(chain->stores[i]->store, name, price, quantity,
+                                minimum_stock, category, unit);
+        if (code < 0) {
+            if (i > 0) log_message(LOG_ERROR, "chain", "Cadastro interrompido: catalogos das lojas divergem");
+            break;
+        }
+    }
+    spin_lock_release(&chain->lock);
+    return code;
+}
+
+// ============================================================================
+// ATUALIZAÇÕES EM PARALELO
+// ============================================================================
+
+// tarefa de atualização: entradas order[begin, end) do lote
+typedef struct {
+    store_chain *chain;
+    chain_update *updates;
+    const size_t *order;
+    size_t begin;
+    size_t end;
+    size_t applied;
+} update_task;
+
+static void *update_worker(void *argument) {
+    update_task *task = argument;
+    for (size_t k = task->begin; k < task->end; k++) {
+        chain_update *update = &task->updates[task->order[k]];
+        mercado_store *store = find_chain_store(task->chain, update->store_id);
+        if (!store) {
+            update->status = -1;
+            continue;
+        }
+        update->status = mercado_move(store, update->code, update->type, update->quantity, NULL);
+        task->applied += (size_t)update->status;
+    }
+    return NULL;
+}
+
+// fatia de um par (loja, código)
+static int shard_of(int store_id, int code, int shards) {
+    uint32_t hash = (uint32_t)store_id * 2654435761u ^ (uint32_t)code * 2246822519u;
+    hash ^= hash >> 15;
+    return (int)(hash % (uint32_t)shards);
+}
+
+// aplica o lote
+size_t apply_chain_updates(store_chain *chain, chain_update *updates, size_t count) {
+    if (!chain || !updates || count == 0) return 0;
+    int shards = threads_for(chain, count);
+
+    // separa as entradas por fatia mantendo a ordem do lote (contagem)
+    size_t *order = malloc(count * sizeof(size_t));
+    unsigned char *shard = malloc(count);
+    if (!order || !shard) {
+        free(order);
+        free(shard);
+        log_message(LOG_ERROR, "chain", "Memoria insuficiente para o lote da rede");
+        return 0;
+    }
+    size_t starts[PARALLEL_MAX_THREADS + 1] = { 0 };
+    for (size_t i = 0; i < count; i++) {
+        shard[i] = (unsigned char)shard_of(updates[i].store_id, updates[i].code, shards);
+        starts[shard[i] + 1]++;
+    }
+    for (int s = 0; s < shards; s++) starts[s + 1] += starts[s];
+    size_t next[PARALLEL_MAX_THREADS];
+    memcpy(next, starts, sizeof(next));
+    for (size_t i = 0; i < count; i++) order[next[shard[i]]++] = i;
+
+    update_task tasks[PARALLEL_MAX_THREADS];
+    for (int s = 0; s < shards; s++) {
+        tasks[s].chain = chain;
+        tasks[s].updates = updates;
+        tasks[s].order = order;
+        tasks[s].begin = starts[s];
+        tasks[s].end = starts[s + 1];
+        tasks[s].applied = 0;
+    }
+    run_parallel(update_worker, tasks, sizeof(update_task), shards);
+
+    size_t applied = 0;
+    for (int s = 0; s < shards; s++) applied += tasks[s].applied;
+    free(order);
+    free(shard);
+    return applied;
+}
+
+// ============================================================================
+// CONSULTAS DE TODA A REDE
+// ============================================================================
+
+// tarefa de soma: lojas [first, end) da cópia, totais parciais em partial
+typedef struct {
+    mercado_store *const *stores;
+    const int *codes;
+    size_t count;
+    int first;
+    int end;
+    chain_stock *partial;
+} stock_task;
+
+static void *stock_worker(void *argument) {
+    stock_task *task = argument;
+    product item;
+    int available;
+    for (int s = task->first; s < task->end; s++) {
+        mercado_store *store = task->stores[s];
+        for (size_t k = 0; k < task->count; k++) {
+            if (mercado_lookup(store, task->codes[k], &item, &available) != 1) continue;
+            chain_stock *total = &task->partial[k];
+            total->quantity += item.quantity;
+            total->available += available;
+            total->stores_active++;
+            if (available <= item.minimum_stock) total->stores_below_minimum++;
+        }
+    }
+    return NULL;
+}
+
+// soma o estoque na rede
+int chain_total_stock(store_chain *chain, const int codes[], size_t count, chain_stock out[]) {
+    if (!chain || !codes || !out) return 0;
+    // lojas abertas durante a consulta ficam de fora
+    mercado_store *stores[CHAIN_MAX_STORES];
+    int store_count = snapshot_stores(chain, stores);
+    int threads = threads_for(chain, (size_t)store_count);
+    chain_stock *partials = calloc((size_t)threads * (count ? count : 1), sizeof(chain_stock));
+    if (!partials) {
+        log_message(LOG_ERROR, "chain", "Memoria insuficiente para a consulta da rede");
+        return 0;
+    }
+
+    stock_task tasks[PARALLEL_MAX_THREADS];
+    for (int t = 0; t < threads; t++) {
+        tasks[t].stores = stores;
+        tasks[t].codes = codes;
+        tasks[t].count = count;
+        tasks[t].first = (int)((long long)store_count * t / threads);
+        tasks[t].end = (int)((long long)store_count * (t + 1) / threads);
+        tasks[t].partial = partials + (size_t)t * count;
+    }
+    run_parallel(stock_worker, tasks, sizeof(stock_task), threads);
+
+    // junta os parciais
+    for (size_t k = 0; k < count; k++) {
+        memset(&out[k], 0, sizeof(chain_stock));
+        out[k].code = codes[k];
+        for (int t = 0; t < threads; t++) {
+            const chain_stock *part = &tasks[t].partial[k];
+            out[k].quantity += part->quantity;
+            out[k].available += part->available;
+            out[k].stores_active += part->stores_active;
+            out[k].stores_below_minimum += part->stores_below_minimum;
+        }
+    }
+    free(partials);
+    return 1;
+}
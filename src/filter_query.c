@@ -0,0 +1,309 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "filter_query.h"
+#include "logger.h"
+#include "sorting.h"
+#include "utils.h"
+#include "validation.h"
+
+// ============================================================================
+// MÓDULO: filter_query — Implementação dos filtros combinados
+// ============================================================================
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// o índice só é usado quando a faixa tem até 1/FILTER_INDEX_DIVISOR das
+// posições do banco (acima disso a varredura sequencial é mais barata)
+#define FILTER_INDEX_DIVISOR 8
+
+// ============================================================================
+// AVALIAÇÃO
+// ============================================================================
+
+// verifica se o produto da posição slot atende ao critério
+// - lê os campos direto do array (inteiros alinhados): a listagem que
+//   consome o resultado copia cada produto de forma consistente depois
+static int predicate_holds(const filter_predicate *predicate, const product_bank *bank, int slot) {
+    const product *p = &bank->list[slot];
+    int holds = 0;
+    switch (predicate->field) {
+        case FILTER_CATEGORY:
+            holds = p->category == (int)predicate->low;
+            break;
+        case FILTER_UNIT:
+            holds = p->unit == (int)predicate->low;
+            break;
+        case FILTER_ACTIVE:
+            holds = p->active;
+            break;
+        case FILTER_BELOW_MINIMUM:
+            holds = __atomic_load_n(&p->quantity, __ATOMIC_RELAXED)
+                  - __atomic_load_n(&bank->reserved[slot], __ATOMIC_RELAXED) <= p->minimum_stock;
+            break;
+        case FILTER_PRICE: {
+            uint32_t cents = range_value_of(RANGE_BY_PRICE, p);
+            holds = cents >= predicate->low && cents <= predicate->high;
+            break;
+        }
+        case FILTER_QUANTITY: {
+            uint32_t quantity = range_value_of(RANGE_BY_QUANTITY, p);
+            holds = quantity >= predicate->low && quantity <= predicate->high;
+            break;
+        }
+    }
+    return holds != predicate->negate;
+}
+
+// verifica se a posição atende a todos os critérios da lista
+static int all_hold(const filter_predicate *const *predicates, int count,
+                    const product_bank *bank, int slot) {
+    for (int i = 0; i < count; i++) {
+        if (!predicate_holds(predicates[i], bank, slot)) return 0;
+    }
+    return 1;
+}
+
+// varre um bloco e marca em words as posições que atendem aos critérios
+// - restrict_to: só examina as posições deste bloco (NULL = bloco inteiro)
+static void scan_chunk(const filter_predicate *const *predicates, int count,
+                       const product_bank *bank, int total, uint32_t key,
+                       const bitmap_container *restrict_to, uint64_t words[BITMAP_WORDS]) {
+    int base = (int)(key << 16);
+    memset(words, 0, BITMAP_WORDS * sizeof(uint64_t));
+
+    if (!restrict_to) {
+        int end = total - base < BITMAP_CHUNK_SLOTS ? total - base : BITMAP_CHUNK_SLOTS;
+        for (int offset = 0; offset < end; offset++) {
+            uint64_t bit = (uint64_t)all_hold(predicates, count, bank, base + offset);
+            words[offset >> 6] |= bit << (offset & 63);
+        }
+    } else if (restrict_to->values) {
+        for (int i = 0; i < restrict_to->cardinality; i++) {
+            int offset = restrict_to->values[i];
+            if (base + offset >= total) break;
+            uint64_t bit = (uint64_t)all_hold(predicates, count, bank, base + offset);
+            words[offset >> 6] |= bit << (offset & 63);
+        }
+    } else {
+        for (int w = 0; w < BITMAP_WORDS; w++) {
+            uint64_t word = restrict_to->words[w];
+            while (word) {
+                int offset = w * 64 + __builtin_ctzll(word);
+                word &= word - 1;
+                if (base + offset >= total) continue;
+                uint64_t bit = (uint64_t)all_hold(predicates, count, bank, base + offset);
+                words[w] |= bit << (offset & 63);
+            }
+        }
+    }
+}
+
+// ============================================================================
+// ÍNDICES
+// ============================================================================
+
+// índice de faixa que atende ao critério (NULL se não há)
+static range_index *index_for(const filter_query *query, const filter_predicate *predicate) {
+    if (predicate->negate) return NULL;
+    if (predicate->field == FILTER_PRICE) return query->prices;
+    if (predicate->field == FILTER_QUANTITY) return query->quantities;
+    return NULL;
+}
+
+// monta o conjunto de um critério de faixa a partir do índice
+// - slots/pairs: rascunho com max_out posições (pairs com 2 * max_out)
+// - retorna 1 se montado, 0 se a faixa é larga demais (ou faltou memória)
+static int collect_from_index(range_index *index, const filter_predicate *predicate, int total,
+                              int *slots, sort_pair *pairs, size_t max_out, slot_bitmap *out) {
+    int count = collect_range_slots(index, predicate->low, predicate->high, slots, max_out);
+    if (count < 0) return 0;
+
+    // o índice devolve em ordem de valor; o conjunto precisa de ordem de posição
+    int kept = 0;
+    for (int i = 0; i < count; i++) {
+        if (slots[i] >= total) continue;     // cadastrado depois do início da consulta
+        pairs[kept].key = (uint64_t)slots[i];
+        pairs[kept].slot = slots[i];
+        kept++;
+    }
+    radix_sort_pairs(pairs, pairs + kept, (size_t)kept);
+    for (int i = 0; i < kept; i++) slots[i] = pairs[i].slot;
+    return bitmap_from_sorted(out, slots, (size_t)kept);
+}
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// consulta vazia
+void initialize_filter_query(filter_query *query, range_index *prices, range_index *quantities) {
+    if (!query) return;
+    memset(query, 0, sizeof(*query));
+    query->prices = prices;
+    query->quantities = quantities;
+}
+
+// acrescenta critério
+int add_filter_predicate(filter_query *query, filter_field field,
+                         uint32_t low, uint32_t high, int negate) {
+    if (!query || query->count >= FILTER_MAX_PREDICATES) return 0;
+    switch (field) {
+        case FILTER_CATEGORY:
+            if (!is_valid_category((int)low)) return 0;
+            break;
+        case FILTER_UNIT:
+            if (!is_valid_unit((int)low)) return 0;
+            break;
+        case FILTER_ACTIVE:
+        case FILTER_BELOW_MINIMUM:
+            break;
+        case FILTER_PRICE:
+        case FILTER_QUANTITY:
+            if (low > high) return 0;
+            break;
+        default:
+            return 0;
+    }
+    filter_predicate *predicate = &query->predicates[query->count++];
+    predicate->field = field;
+    predicate->low = low;
+    predicate->high = high;
+    predicate->negate = negate ? 1 : 0;
+    return 1;
+}
+
+// executa a consulta
+int run_filter_query(const filter_query *query, const product_bank *bank, filter_result *result) {
+    if (!query || !bank || !result) return 0;
+    memset(result, 0, sizeof(*result));
+    initialize_slot_bitmap(&result->slots);
+    double started_at = monotonic_seconds();
+    int total = __atomic_load_n(&bank->count, __ATOMIC_ACQUIRE);
+
+    // passo 1: faixas resolvidas pelos índices
+    slot_bitmap selected, partial, merged;
+    initialize_slot_bitmap(&selected);
+    initialize_slot_bitmap(&partial);
+    initialize_slot_bitmap(&merged);
+    int restricted = 0;
+    const filter_predicate *scan[FILTER_MAX_PREDICATES + 1];
+    int scan_count = 0;
+    size_t max_out = (size_t)total / FILTER_INDEX_DIVISOR;
+    int *slots = NULL;
+    sort_pair *pairs = NULL;
+    int ok = 1;
+
+    for (int i = 0; i < query->count && ok; i++) {
+        const filter_predicate *predicate = &query->predicates[i];
+        range_index *index = index_for(query, predicate);
+        if (index && !slots && max_out > 0) {
+            slots = malloc(max_out * sizeof(int));
+            pairs = malloc(2 * max_out * sizeof(sort_pair));
+        }
+        if (!index || !slots || !pairs
+            || !collect_from_index(index, predicate, total, slots, pairs, max_out, &partial)) {
+            scan[scan_count++] = predicate;
+            continue;
+        }
+        result->index_predicates++;
+        if (!restricted) {
+            selected = partial;
+            initialize_slot_bitmap(&partial);
+            restricted = 1;
+        } else {
+            ok = bitmap_and(&selected, &partial, &merged);
+            free_slot_bitmap(&selected);
+            free_slot_bitmap(&partial);
+            selected = merged;
+            initialize_slot_bitmap(&merged);
+        }
+    }
+    free(slots);
+    free(pairs);
+
+    // sem critério de ativo explícito, o resultado só tem produtos ativos
+    // (as listagens e relatórios da seleção só mostram ativos: matches precisa
+    // contar o mesmo)
+    static const filter_predicate only_active = { FILTER_ACTIVE, 0, 0, 0 };
+    int has_active = 0;
+    for (int i = 0; i < query->count; i++) {
+        if (query->predicates[i].field == FILTER_ACTIVE) has_active = 1;
+    }
+    if (!has_active) scan[scan_count++] = &only_active;
+
+    // passo 2: demais critérios em uma única varredura
+    if (ok && (scan_count > 0 || !restricted)) {
+        uint64_t *words = malloc(BITMAP_WORDS * sizeof(uint64_t));
+        ok = words != NULL;
+        if (ok && !restricted) {
+            for (uint32_t key = 0; ok && (int)(key << 16) < total; key++) {
+                scan_chunk(scan, scan_count, bank, total, key, NULL, words);
+                ok = bitmap_append_words(&result->slots, key, words);
+                result->scanned_chunks++;
+            }
+        } else if (ok) {
+            for (int c = 0; ok && c < selected.count; c++) {
+                const bitmap_container *container = &selected.containers[c];
+                scan_chunk(scan, scan_count, bank, total, container->key, container, words);
+                ok = bitmap_append_words(&result->slots, container->key, words);
+                result->scanned_chunks++;
+            }
+        }
+        free(words);
+        free_slot_bitmap(&selected);
+    } else {
+        result->slots = selected;
+    }
+    free_slot_bitmap(&partial);
+
+    if (!ok) {
+        free_slot_bitmap(&result->slots);
+        log_message(LOG_ERROR, "filter_query", "Memoria insuficiente para executar o filtro");
+        return 0;
+    }
+    result->matches = bitmap_cardinality(&result->slots);
+    result->elapsed_seconds = monotonic_seconds() - started_at;
+    return 1;
+}
+
+// libera o resultado
+void free_filter_result(filter_result *result) {
+    if (!result) return;
+    free_slot_bitmap(&result->slots);
+    result->matches = 0;
+}
+
+// descreve critério
+int describe_filter_predicate(const filter_predicate *predicate, char *out, size_t size) {
+    if (!predicate || !out || size == 0) return 0;
+    const char *prefix = predicate->negate ? "NAO " : "";
+    int written = 0;
+    switch (predicate->field) {
+        case FILTER_CATEGORY:
+            written = snprintf(out, size, "%scategoria = %s", prefix,
+                               category_to_string((int)predicate->low));
+            break;
+        case FILTER_UNIT:
+            written = snprintf(out, size, "%sunidade = %s", prefix,
+                               unit_to_string((int)predicate->low));
+            break;
+        case FILTER_ACTIVE:
+            written = snprintf(out, size, "%sativo", prefix);
+            break;
+        case FILTER_BELOW_MINIMUM:
+            written = snprintf(out, size, "%sabaixo do minimo", prefix);
+            break;
+        case FILTER_PRICE:
+            written = snprintf(out, size, "%spreco entre R$ %.2f e R$ %.2f", prefix,
+                               predicate->low / 100.0, predicate->high / 100.0);
+            break;
+        case FILTER_QUANTITY:
+            written = snprintf(out, size, "%squantidade entre %u e %u", prefix,
+                               predicate->low, predicate->high);
+            break;
+        default:
+            written = snprintf(out, size, "criterio desconhecido");
+    }
+    return written >= 0 && (size_t)written < size;
+}
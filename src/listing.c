@@ -0,0 +1,146 @@
+#include <stdlib.h>
+#include <string.h>
+#include "listing.h"
+
+// ============================================================================
+// MÓDULO: listing — Implementação das listagens paginadas
+// ============================================================================
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// verifica se a linha atende ao critério do cursor
+static int row_matches(const listing_cursor *cursor, const listing_row *row) {
+    switch (cursor->filter) {
+        case LISTING_ACTIVE:
+            return 1;
+        case LISTING_BELOW_MINIMUM:
+            return row->available <= row->item.minimum_stock;
+        case LISTING_CATEGORY:
+            return row->item.category == cursor->category;
+        case LISTING_SELECTION:
+            return 1;
+    }
+    return 0;
+}
+
+// abre a listagem
+int open_listing(listing_cursor *cursor, const product_bank *bank,
+                 listing_filter filter, int category, int order) {
+    if (!cursor) return 0;
+    // cursor inválido já nasce encerrado (next_listing_page devolve 0)
+    memset(cursor, 0, sizeof(*cursor));
+    cursor->finished = 1;
+    if (!bank) return 0;
+    if (filter < LISTING_ACTIVE || filter > LISTING_CATEGORY) return 0;
+    if (filter == LISTING_CATEGORY
+        && (category < CATEGORY_FOOD || category > CATEGORY_OTHERS)) return 0;
+    if (!is_valid_sort_order(order)) return 0;
+
+    if (order != SORT_BY_CODE) {
+        // a ordem é fixada agora: cadastros posteriores não entram na listagem
+        int total = __atomic_load_n(&bank->count, __ATOMIC_ACQUIRE);
+        cursor->order_slots = malloc((size_t)(total > 0 ? total : 1) * sizeof(int));
+        if (!cursor->order_slots) return 0;
+        cursor->order_count = sorted_slots(bank, order, cursor->order_slots, (size_t)total);
+        if (cursor->order_count < 0) {
+            free(cursor->order_slots);
+            cursor->order_slots = NULL;
+            return 0;
+        }
+    }
+
+    cursor->finished = 0;
+    cursor->bank = bank;
+    cursor->filter = filter;
+    cursor->category = category;
+    cursor->order = order;
+    return 1;
+}
+
+// abre a listagem de uma seleção
+int open_selection_listing(listing_cursor *cursor, const product_bank *bank,
+                           const slot_bitmap *selection, int order) {
+    if (!cursor) return 0;
+    memset(cursor, 0, sizeof(*cursor));
+    cursor->finished = 1;
+    if (!bank || !selection || !is_valid_sort_order(order)) return 0;
+
+    // a sequência de posições é fixada agora, como nas listagens ordenadas
+    long long selected = bitmap_cardinality(selection);
+    int total = __atomic_load_n(&bank->count, __ATOMIC_ACQUIRE);
+    size_t capacity = (size_t)(order == SORT_BY_CODE ? selected : total);
+    cursor->order_slots = malloc((capacity > 0 ? capacity : 1) * sizeof(int));
+    if (!cursor->order_slots) return 0;
+
+    if (order == SORT_BY_CODE) {
+        // posições crescentes = ordem de código
+        cursor->order_count = bitmap_to_slots(selection, cursor->order_slots, capacity);
+    } else {
+        int count = sorted_slots(bank, order, cursor->order_slots, capacity);
+        if (count < 0) {
+            free(cursor->order_slots);
+            cursor->order_slots = NULL;
+            return 0;
+        }
+        int kept = 0;
+        for (int i = 0; i < count; i++) {
+            if (bitmap_contains(selection, cursor->order_slots[i])) {
+                cursor->order_slots[kept++] = cursor->order_slots[i];
+            }
+        }
+        cursor->order_count = kept;
+    }
+
+    cursor->finished = 0;
+    cursor->bank = bank;
+    cursor->filter = LISTING_SELECTION;
+    cursor->order = order;
+    return 1;
+}
+
+// próxima página
+int next_listing_page(listing_cursor *cursor, listing_row out[], size_t page_size) {
+    if (!cursor || !cursor->bank || !out || cursor->finished) return 0;
+
+    int count = 0;
+    while (count < (int)page_size) {
+        listing_row *row = &out[count];
+        int slot;
+        if (cursor->order_slots) {
+            if (cursor->position >= cursor->order_count) {
+                cursor->finished = 1;
+                break;
+            }
+            slot = cursor->order_slots[cursor->position++];
+        } else {
+            slot = cursor->slot++;
+        }
+        int status = read_product_at(cursor->bank, slot, &row->item);
+        if (status < 0) {
+            cursor->finished = 1;
+            break;
+        }
+        if (status == 0) continue;
+
+        row->available = row->item.quantity
+                       - __atomic_load_n(&cursor->bank->reserved[slot], __ATOMIC_RELAXED);
+        if (row_matches(cursor, row)) count++;
+    }
+    cursor->emitted += count;
+    return count;
+}
+
+// ainda há linhas?
+int listing_has_more(const listing_cursor *cursor) {
+    return cursor && cursor->bank && !cursor->finished;
+}
+
+// encerra a listagem
+void close_listing(listing_cursor *cursor) {
+    if (!cursor) return;
+    free(cursor->order_slots);
+    cursor->order_slots = NULL;
+    cursor->order_count = 0;
+    cursor->bank = NULL;
+    cursor->finished = 1;
+}
@@ -1,5 +1,6 @@
 #include "logger.h"
 #include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -25,15 +26,6 @@
 // Identificadores em inglês, snake_case; comentários em português
 // ============================================================================
 
-// ponteiro para o arquivo de log aberto (NULL se não configurado)
-static FILE *log_file = NULL;
-
-// nível mínimo de log a ser registrado (eventos abaixo são ignorados)
-static log_level_t current_level = LOG_INFO;
-
-// flag que define se logs também devem aparecer no console
-static int show_console = 1;
-
 // strings descritivas para cada nível de log (para formatação)
 static const char *level_names[] = {
     "DEBUG",
@@ -42,6 +34,36 @@ static const char *level_names[] = {
     "ERROR"
 };
 
+// ============================================================================
+// LIMITAÇÃO DE TAXA E AGRUPAMENTO DE REPETIÇÕES
+// ============================================================================
+// Um laço de falha (arquivo de dados ausente, disco cheio) pode disparar a
+// mesma mensagem milhares de vezes. Cada ponto de chamada, identificado pelo
+// arquivo e pela linha (log_message é uma macro), tem um balde de fichas:
+// mensagens com valores variáveis no texto caem no mesmo balde. Mensagens
+// além da taxa são descartadas e apenas contadas; a contagem pendente é escrita quando o balde é
+// reaproveitado ou o log é encerrado. Mensagens idênticas consecutivas
+// são agrupadas em uma única linha "Ultima mensagem repetida N vezes".
+// ============================================================================
+
+// posições examinadas na tabela antes de reaproveitar um balde
+#define RATE_LIMIT_PROBES 4
+// valores padrão: rajada de 20 mensagens, reposição de 5 por segundo
+#define DEFAULT_RATE_BURST 20
+#define DEFAULT_RATE_PER_SECOND 5
+
+// instância do log do processo (usada por log_message)
+static logger process_logger = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .level = LOG_INFO,
+    .show_console = 1,
+    .rate_burst = DEFAULT_RATE_BURST,
+    .rate_per_second = DEFAULT_RATE_PER_SECOND
+};
+
+// instância em que log_message escreve (NULL = process_logger)
+static logger *redirected = NULL;
+
 // ============================================================================
 // FUNÇÃO: extract_directory_path
 // Extrai o caminho do diretório de um caminho de arquivo completo
@@ -101,86 +123,384 @@ static int create_directory_if_needed(const char *file_path) {
 }
 
 // ============================================================================
-// FUNÇÃO: logger_init
-// Inicializa o sistema de logging
+// FUNÇÃO: configure_logger
+// Define nível e console e abre o arquivo da instância
+// - retorna 1 se sucesso, 0 se o arquivo não pôde ser aberto
 // ============================================================================
-void logger_init(const char *file_name, log_level_t level_minimum, int show_console_flag) {
+static int configure_logger(logger *instance, const char *file_name,
+                            log_level_t level_minimum, int show_console_flag) {
     // Configura encoding UTF-8 no console do Windows
     #ifdef _WIN32
         SetConsoleOutputCP(CP_UTF8);
         SetConsoleCP(CP_UTF8);
     #endif
 
-    current_level = level_minimum;
-    show_console = show_console_flag;
+    pthread_mutex_lock(&instance->lock);
+    instance->level = level_minimum;
+    instance->show_console = show_console_flag;
+    if (instance->file) {
+        fclose(instance->file);
+        instance->file = NULL;
+    }
+    pthread_mutex_unlock(&instance->lock);
 
     // Se não foi especificado arquivo, usa apenas stdout
     if (!file_name) {
-        log_file = NULL;
-        return;
+        return 1;
     }
 
     // Cria o diretório se necessário
     if (!create_directory_if_needed(file_name)) {
         fprintf(stderr, "Aviso: nao foi possivel criar diretorio para logs\n");
         fprintf(stderr, "Continuando sem arquivo de log...\n");
-        log_file = NULL;
-        return;
+        return 0;
     }
 
     // Abre arquivo em modo append (adiciona no final, preserva conteúdo anterior)
-    log_file = fopen(file_name, "a");
-    if (!log_file) {
+    FILE *file = fopen(file_name, "a");
+    if (!file) {
         fprintf(stderr, "Aviso: nao foi possivel abrir arquivo de log: %s\n", file_name);
         fprintf(stderr, "Continuando sem arquivo de log...\n");
-        return;
+        return 0;
     }
+    pthread_mutex_lock(&instance->lock);
+    instance->file = file;
+    pthread_mutex_unlock(&instance->lock);
 
     // Registra inicialização do sistema
-    log_message(LOG_INFO, "LOGGER", "Sistema de logging inicializado");
+    logger_write(instance, LOG_INFO, "LOGGER", "Sistema de logging inicializado");
+    return 1;
 }
 
 // ============================================================================
-// FUNÇÃO: log_message
-// Registra uma mensagem de log com timestamp e nível
+// FUNÇÃO: logger_init
+// Inicializa o log do processo
 // ============================================================================
-void log_message(log_level_t level, const char *module, const char *message) {
-    // Ignora mensagens abaixo do nível mínimo configurado
-    if (level < current_level) {
-        return;
-    }
+void logger_init(const char *file_name, log_level_t level_minimum, int show_console_flag) {
+    configure_logger(&process_logger, file_name, level_minimum, show_console_flag);
+}
 
-    // Obtém timestamp atual
-    time_t now = time(NULL);
-    struct tm *t = localtime(&now);
+// ============================================================================
+// FUNÇÃO: logger_open
+// Inicializa uma instância independente
+// ============================================================================
+int logger_open(logger *instance, const char *file_name, log_level_t level_minimum,
+                int show_console_flag) {
+    if (!instance) return 0;
+    memset(instance, 0, sizeof(*instance));
+    pthread_mutex_init(&instance->lock, NULL);
+    instance->rate_burst = DEFAULT_RATE_BURST;
+    instance->rate_per_second = DEFAULT_RATE_PER_SECOND;
+    return configure_logger(instance, file_name, level_minimum, show_console_flag);
+}
+
+// ============================================================================
+// FUNÇÃO: write_line
+// Formata e escreve uma linha de log no arquivo e/ou console
+// ============================================================================
+static void write_line(logger *instance, log_level_t level, const char *module,
+                       const char *message, time_t now) {
+    // Obtém timestamp (versões reentrantes de localtime)
+    struct tm t;
+    #ifdef _WIN32
+        localtime_s(&t, &now);
+    #else
+        localtime_r(&now, &t);
+    #endif
     char timestamp[32];
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", t);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &t);
 
     // Formata mensagem: [TIMESTAMP] [NIVEL] [MODULO] mensagem
-    char formatted[1024];
+    char formatted[LOG_MESSAGE_MAX + 128];
     snprintf(formatted, sizeof(formatted), "[%s] [%-7s] [%s] %s\n",
              timestamp, level_names[level], module, message);
 
     // Escreve no arquivo de log (se configurado)
-    if (log_file) {
-        fputs(formatted, log_file);
-        fflush(log_file);  // Força escrita imediata (importante para debug de crashes)
+    if (instance->file) {
+        fputs(formatted, instance->file);
+        fflush(instance->file);  // Força escrita imediata (importante para debug de crashes)
     }
 
     // Escreve no console (se habilitado)
-    if (show_console) {
+    if (instance->show_console) {
         fputs(formatted, stdout);
     }
 }
 
+// ============================================================================
+// FUNÇÃO: flush_repeat_summary
+// Escreve o resumo de repetições pendentes da última mensagem
+// ============================================================================
+static void flush_repeat_summary(logger *instance, time_t now) {
+    if (instance->repeat_count == 0) {
+        return;
+    }
+
+    char summary[LOG_MESSAGE_MAX];
+    snprintf(summary, sizeof(summary), "Ultima mensagem repetida %lu %s", instance->repeat_count,
+             instance->repeat_count == 1 ? "vez" : "vezes");
+    write_line(instance, instance->last_level, instance->last_module, summary, now);
+    instance->repeat_count = 0;
+}
+
+// ============================================================================
+// FUNÇÃO: is_repeat_of_last
+// Verifica se a mensagem é idêntica à última escrita
+// ============================================================================
+static int is_repeat_of_last(const logger *instance, log_level_t level,
+                             const char *module, const char *message) {
+    return instance->has_last
+        && level == instance->last_level
+        && strncmp(module, instance->last_module, sizeof(instance->last_module) - 1) == 0
+        && strncmp(message, instance->last_message, sizeof(instance->last_message) - 1) == 0;
+}
+
+// ============================================================================
+// FUNÇÃO: remember_last
+// Guarda a mensagem escrita para detectar repetições seguintes
+// ============================================================================
+static void remember_last(logger *instance, log_level_t level, const char *module,
+                          const char *message) {
+    instance->has_last = 1;
+    instance->last_level = level;
+    strncpy(instance->last_module, module, sizeof(instance->last_module) - 1);
+    instance->last_module[sizeof(instance->last_module) - 1] = '\0';
+    strncpy(instance->last_message, message, sizeof(instance->last_message) - 1);
+    instance->last_message[sizeof(instance->last_message) - 1] = '\0';
+}
+
+// ============================================================================
+// FUNÇÃO: rate_key
+// Chave do balde: hash FNV-1a do arquivo e da linha do ponto de chamada
+// (nunca 0, que marca balde livre)
+// ============================================================================
+static uint64_t rate_key(const char *file, int line) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char *c = (const unsigned char *)file; *c; c++) {
+        hash = (hash ^ *c) * 1099511628211ULL;
+    }
+    for (int i = 0; i < 4; i++) {
+        hash = (hash ^ (unsigned char)((unsigned)line >> (8 * i))) * 1099511628211ULL;
+    }
+    return hash ? hash : 1;
+}
+
+// ============================================================================
+// FUNÇÃO: suppressed_note
+// Texto do aviso de descartes ("1 mensagem suprimida", "N mensagens ...")
+// ============================================================================
+static void suppressed_note(char *note, size_t size, unsigned long suppressed,
+                            const char *file, int line, const char *sample) {
+    snprintf(note, size, "%lu %s pelo limite de taxa (%s:%d), ultima: %.200s", suppressed,
+             suppressed == 1 ? "mensagem suprimida" : "mensagens suprimidas", file, line, sample);
+}
+
+// ============================================================================
+// FUNÇÃO: flush_suppressed
+// Escreve o aviso de mensagens descartadas de um balde que vai ser reaproveitado
+// ============================================================================
+static void flush_suppressed(logger *instance, log_rate_bucket *b, time_t now) {
+    if (b->key == 0 || b->suppressed == 0) return;
+    char note[LOG_MESSAGE_MAX];
+    suppressed_note(note, sizeof(note), b->suppressed, b->file, b->line, b->sample);
+    write_line(instance, b->level, b->module, note, now);
+    b->suppressed = 0;
+}
+
+// ============================================================================
+// FUNÇÃO: find_rate_bucket
+// Localiza (ou reaproveita) o balde de fichas de um ponto de chamada
+// ============================================================================
+static log_rate_bucket *find_rate_bucket(logger *instance, const char *file, int line,
+                                         time_t now) {
+    uint64_t key = rate_key(file, line);
+    size_t start = (size_t)(key % LOG_RATE_SLOTS);
+
+    // procura o ponto de chamada nas posições próximas; se não achar, reaproveita o
+    // balde com reposição mais antiga (provavelmente ocioso)
+    log_rate_bucket *victim = &instance->buckets[start];
+    for (size_t i = 0; i < RATE_LIMIT_PROBES; i++) {
+        log_rate_bucket *b = &instance->buckets[(start + i) % LOG_RATE_SLOTS];
+        if (b->key == key) {
+            return b;
+        }
+        if (b->last_refill < victim->last_refill) {
+            victim = b;
+        }
+    }
+
+    // descartes pendentes do balde antigo não se perdem
+    flush_suppressed(instance, victim, now);
+    victim->key = key;
+    victim->tokens = instance->rate_burst;
+    victim->last_refill = now;
+    victim->suppressed = 0;
+    victim->file = file;
+    victim->line = line;
+    return victim;
+}
+
+// ============================================================================
+// FUNÇÃO: rate_limit_allow
+// Consome uma ficha do ponto de chamada; retorna 0 se a mensagem deve ser
+// descartada. Em caso de sucesso, informa em suppressed_out quantas
+// mensagens foram descartadas desde a última escrita desta mensagem
+// ============================================================================
+static int rate_limit_allow(logger *instance, const char *file, int line, log_level_t level,
+                            const char *module, const char *message, time_t now,
+                            unsigned long *suppressed_out) {
+    *suppressed_out = 0;
+    if (instance->rate_per_second <= 0) {
+        return 1;  // limitação desativada
+    }
+
+    log_rate_bucket *b = find_rate_bucket(instance, file, line, now);
+
+    // repõe fichas proporcionalmente ao tempo decorrido
+    if (now > b->last_refill) {
+        double refill = difftime(now, b->last_refill) * instance->rate_per_second;
+        if (refill >= (double)(instance->rate_burst - b->tokens)) {
+            b->tokens = instance->rate_burst;
+        } else {
+            b->tokens += (int)refill;
+        }
+        b->last_refill = now;
+    }
+
+    if (b->tokens <= 0) {
+        // a última descartada vai no aviso (o texto varia no mesmo ponto)
+        b->suppressed++;
+        b->level = level;
+        snprintf(b->module, sizeof(b->module), "%s", module);
+        snprintf(b->sample, sizeof(b->sample), "%s", message);
+        return 0;
+    }
+
+    b->tokens--;
+    *suppressed_out = b->suppressed;
+    b->suppressed = 0;
+    return 1;
+}
+
+// ============================================================================
+// FUNÇÃO: logger_configure_rate_limit
+// Configura a limitação de taxa por ponto de chamada de uma instância
+// ============================================================================
+void logger_configure_rate_limit(logger *instance, int burst, int per_second) {
+    if (!instance) return;
+    pthread_mutex_lock(&instance->lock);
+    instance->rate_burst = burst > 0 ? burst : 1;
+    instance->rate_per_second = per_second > 0 ? per_second : 0;
+    time_t now = time(NULL);
+    for (size_t i = 0; i < LOG_RATE_SLOTS; i++) flush_suppressed(instance, &instance->buckets[i], now);
+    memset(instance->buckets, 0, sizeof(instance->buckets));
+    pthread_mutex_unlock(&instance->lock);
+}
+
+// ============================================================================
+// FUNÇÃO: logger_set_rate_limit
+// Configura a limitação de taxa do log do processo
+// ============================================================================
+void logger_set_rate_limit(int burst, int per_second) {
+    logger_configure_rate_limit(&process_logger, burst, per_second);
+}
+
+// ============================================================================
+// FUNÇÃO: logger_write_at
+// Registra uma mensagem com timestamp e nível em uma instância
+// ============================================================================
+void logger_write_at(logger *instance, const char *file, int line, log_level_t level,
+                     const char *module, const char *message) {
+    if (!instance) return;
+    pthread_mutex_lock(&instance->lock);
+
+    // Ignora mensagens abaixo do nível mínimo configurado
+    if (level < instance->level) {
+        pthread_mutex_unlock(&instance->lock);
+        return;
+    }
+
+    // Obtém timestamp atual
+    time_t now = time(NULL);
+
+    // Mensagem idêntica à anterior: apenas conta (nenhuma escrita em disco)
+    if (is_repeat_of_last(instance, level, module, message)) {
+        instance->repeat_count++;
+        pthread_mutex_unlock(&instance->lock);
+        return;
+    }
+    flush_repeat_summary(instance, now);
+
+    // Ponto de chamada acima da taxa: descarta e conta
+    unsigned long suppressed;
+    if (rate_limit_allow(instance, file, line, level, module, message, now, &suppressed)) {
+        if (suppressed > 0) {
+            char note[LOG_MESSAGE_MAX];
+            log_rate_bucket *b = find_rate_bucket(instance, file, line, now);
+            suppressed_note(note, sizeof(note), suppressed, file, line, b->sample);
+            write_line(instance, level, module, note, now);
+        }
+
+        write_line(instance, level, module, message, now);
+        remember_last(instance, level, module, message);
+    }
+    pthread_mutex_unlock(&instance->lock);
+}
+
+// ============================================================================
+// FUNÇÃO: log_message_at
+// Registra uma mensagem no log do processo (ou na instância redirecionada)
+// ============================================================================
+void log_message_at(const char *file, int line, log_level_t level, const char *module,
+                    const char *message) {
+    logger *target = __atomic_load_n(&redirected, __ATOMIC_ACQUIRE);
+    logger_write_at(target ? target : &process_logger, file, line, level, module, message);
+}
+
+// ============================================================================
+// FUNÇÃO: logger_shutdown
+// Finaliza uma instância e fecha o arquivo
+// ============================================================================
+void logger_shutdown(logger *instance) {
+    if (!instance) return;
+
+    // Registra repetições e descartes ainda pendentes antes de encerrar
+    pthread_mutex_lock(&instance->lock);
+    time_t now = time(NULL);
+    flush_repeat_summary(instance, now);
+    for (size_t i = 0; i < LOG_RATE_SLOTS; i++) flush_suppressed(instance, &instance->buckets[i], now);
+    int has_file = instance->file != NULL;
+    pthread_mutex_unlock(&instance->lock);
+
+    if (has_file) {
+        logger_write(instance, LOG_INFO, "LOGGER", "Sistema de logging finalizado");
+        pthread_mutex_lock(&instance->lock);
+        fclose(instance->file);
+        instance->file = NULL;
+        pthread_mutex_unlock(&instance->lock);
+    }
+}
+
 // ============================================================================
 // FUNÇÃO: logger_close
-// Finaliza o sistema de logging e fecha o arquivo
+// Finaliza o log do processo
 // ============================================================================
 void logger_close(void) {
-    if (log_file) {
-        log_message(LOG_INFO, "LOGGER", "Sistema de logging finalizado");
-        fclose(log_file);
-        log_file = NULL;
-    }
+    logger_shutdown(&process_logger);
+}
+
+// ============================================================================
+// FUNÇÃO: logger_default
+// Instância do log do processo
+// ============================================================================
+logger *logger_default(void) {
+    return &process_logger;
+}
+
+// ============================================================================
+// FUNÇÃO: logger_redirect
+// Troca a instância em que log_message escreve
+// ============================================================================
+void logger_redirect(logger *instance) {
+    __atomic_store_n(&redirected, instance, __ATOMIC_RELEASE);
 }
@@ -1,12 +1,30 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <signal.h>
 
 #ifdef _WIN32
     #include <windows.h>
 #endif
 
 #include "product.h"
+#include "aggregation.h"
+#include "batch.h"
+#include "filter_query.h"
+#include "listing.h"
+#include "movimentacao.h"
+#include "name_index.h"
+#include "range_index.h"
+#include "relatorio.h"
+#include "ranking.h"
+#include "replay.h"
+#include "snapshot_diff.h"
+#include "sorting.h"
+#include "report_cache.h"
+#include "reservation.h"
+#include "server.h"
+#include "replication.h"
 #include "persistence.h"
 #include "logger.h"
 #include "utils.h"
@@ -23,9 +41,48 @@
 // banco de produtos global
 static product_bank bank;
 
+// livro de movimentações de estoque
+static movement_ledger ledger;
+
+// velocidade de vendas e dias de cobertura (alimentados pelo livro)
+static velocity_tracker velocity;
+
+// reservas de pedidos online (expiram pela roda de temporização)
+static reservation_table reservations;
+
+// resumos dos painéis, recalculados só quando o banco muda
+static report_cache dashboard;
+
+// buffer de escrita dos relatórios (alocado no primeiro uso e reaproveitado)
+static report_buffer report_output;
+
+// índice de trigramas para a busca aproximada por nome
+static name_index names;
+
+// índices ordenados para as consultas por faixa de preço e de quantidade
+static range_index prices;
+static range_index quantities;
+
 // caminho do arquivo de dados
 #define DATA_FILE_PATH "data/products.dat"
 
+// opção de linha de comando do modo lote
+#define BATCH_OPTION "--batch"
+
+// opção de linha de comando do serviço local e socket padrão
+#define SERVER_OPTION "--serve"
+#define SERVER_SOCKET_PATH "data/mercado.sock"
+
+// opção de linha de comando da réplica e socket padrão do envio
+#define STANDBY_OPTION "--standby"
+#define REPLICA_SOCKET_PATH "data/replica.sock"
+
+// resultados exibidos pela busca por nome
+#define NAME_SEARCH_SHOWN 10
+
+// alertas de ruptura exibidos por consulta
+#define STOCKOUT_ALERTS_SHOWN 100
+
 // protótipos das funções de menu
 void show_main_menu(void);
 void handle_register_product(void);
@@ -36,13 +93,40 @@ void handle_delete_product(void);
 void handle_products_below_minimum(void);
 void handle_save_data(void);
 void handle_load_data(void);
+void handle_stock_movement(void);
+void handle_movement_history(void);
+void handle_checkout(void);
+void handle_stockout_alerts(void);
+void handle_reservations(void);
+void handle_export_report(void);
+void handle_grouped_summary(void);
+void handle_rankings(void);
+void handle_snapshot_diff(void);
+void handle_range_query(void);
+void handle_filter_query(void);
+static int load_saved_state(void);
+static int run_batch_mode(int argc, char **argv);
+static int run_server_mode(int argc, char **argv);
+static int run_standby_mode(int argc, char **argv);
+static int serve_until_stopped(const char *socket_path, const char *replica_path);
+static void shutdown_system(void);
+static int ask_next_page(void);
+static int read_sort_order(void);
+static int read_filter_predicate(filter_query *query);
 
 // ============================================================================
 // FUNÇÃO: main
 // Função principal - inicializa sistema e executa loop do menu
+// - "mercado --batch [entrada] [saida]" executa comandos em lote, sem menu
+// - "mercado --serve [socket] [replica]" atende os caixas pelo serviço local
+//   (e envia as alterações à réplica, se indicada)
+// - "mercado --standby [replica] [socket]" mantém a réplica de prontidão
 // ============================================================================
-int main(void) {
+int main(int argc, char **argv) {
     int option;
+    int batch_mode = argc >= 2 && strcmp(argv[1], BATCH_OPTION) == 0;
+    int server_mode = argc >= 2 && strcmp(argv[1], SERVER_OPTION) == 0;
+    int standby_mode = argc >= 2 && strcmp(argv[1], STANDBY_OPTION) == 0;
 
     // ========================================================================
     // CONFIGURAÇÃO INICIAL DO SISTEMA
@@ -55,10 +139,39 @@ int main(void) {
     #endif
 
     // Inicializa sistema de logging (agora cria diretório automaticamente)
-    logger_init("logs/system.log", LOG_INFO, 1);
+    // - no modo lote a saída padrão é só das respostas: log apenas no arquivo
+    logger_init("logs/system.log", LOG_INFO, !batch_mode);
 
     // Inicializa banco de produtos vazio
     initialize_product_bank(&bank);
+    initialize_report_cache(&dashboard, &bank);
+    if (!initialize_name_index(&names, &bank)) {
+        log_message(LOG_WARNING, "MAIN", "Busca por nome indisponivel");
+    }
+    if (!initialize_range_index(&prices, &bank, RANGE_BY_PRICE)
+        || !initialize_range_index(&quantities, &bank, RANGE_BY_QUANTITY)) {
+        log_message(LOG_WARNING, "MAIN", "Consulta por faixa indisponivel");
+    }
+    initialize_movement_ledger(&ledger);
+    initialize_velocity_tracker(&velocity, VELOCITY_DEFAULT_HALF_LIFE_DAYS,
+                                VELOCITY_DEFAULT_HORIZON_DAYS);
+    attach_velocity_tracker(&ledger, &velocity);
+    initialize_reservation_table(&reservations, &ledger, &bank, (uint32_t)time(NULL));
+
+    // Carrega dados salvos e reconstrói o estoque a partir das movimentações
+    if (data_file_exists(DATA_FILE_PATH)) {
+        load_saved_state();
+    }
+
+    if (batch_mode) {
+        return run_batch_mode(argc, argv);
+    }
+    if (server_mode) {
+        return run_server_mode(argc, argv);
+    }
+    if (standby_mode) {
+        return run_standby_mode(argc, argv);
+    }
 
     log_message(LOG_INFO, "MAIN", "Sistema de controle de mercado iniciado");
 
@@ -67,6 +180,9 @@ int main(void) {
     // ========================================================================
 
     while (1) {
+        // Devolve ao disponível as reservas vencidas desde a última volta
+        advance_reservations(&reservations, (uint32_t)time(NULL));
+
         show_main_menu();
 
         printf("\nEscolha uma opcao: ");
@@ -103,10 +219,43 @@ int main(void) {
             case 8:
                 handle_load_data();
                 break;
+            case 9:
+                handle_stock_movement();
+                break;
+            case 10:
+                handle_movement_history();
+                break;
+            case 11:
+                handle_checkout();
+                break;
+            case 12:
+                handle_stockout_alerts();
+                break;
+            case 13:
+                handle_reservations();
+                break;
+            case 14:
+                handle_export_report();
+                break;
+            case 15:
+                handle_grouped_summary();
+                break;
+            case 16:
+                handle_rankings();
+                break;
+            case 17:
+                handle_snapshot_diff();
+                break;
+            case 18:
+                handle_range_query();
+                break;
+            case 19:
+                handle_filter_query();
+                break;
             case 0:
                 printf("\nEncerrando sistema...\n");
                 log_message(LOG_INFO, "MAIN", "Sistema encerrado pelo usuario");
-                logger_close();
+                shutdown_system();
                 return 0;
             default:
                 printf("\nOpcao invalida! Tente novamente.\n");
@@ -126,7 +275,7 @@ void show_main_menu(void) {
     printf("========================================\n");
     printf("   SISTEMA DE CONTROLE DE MERCADO\n");
     printf("========================================\n");
-    printf("  Produtos cadastrados: %d\n", count_active_products(&bank));
+    printf("  Produtos cadastrados: %d\n", cached_active_count(&dashboard));
     printf("========================================\n");
     printf("  1 - Cadastrar Produto\n");
     printf("  2 - Listar Todos os Produtos\n");
@@ -136,6 +285,17 @@ void show_main_menu(void) {
     printf("  6 - Produtos Abaixo do Minimo\n");
     printf("  7 - Salvar Dados\n");
     printf("  8 - Recarregar Dados\n");
+    printf("  9 - Movimentar Estoque\n");
+    printf(" 10 - Historico de Movimentacoes\n");
+    printf(" 11 - Caixa (Venda de Cesta)\n");
+    printf(" 12 - Alerta de Ruptura (Dias de Cobertura)\n");
+    printf(" 13 - Reservas (Pedidos Online)\n");
+    printf(" 14 - Exportar Relatorio (relatorios/)\n");
+    printf(" 15 - Resumo Agrupado (Categoria/Unidade/Preco)\n");
+    printf(" 16 - Rankings (Top K)\n");
+    printf(" 17 - Comparar Arquivos de Dados (Auditoria)\n");
+    printf(" 18 - Consulta por Faixa (Preco/Quantidade)\n");
+    printf(" 19 - Filtro Combinado (Categoria/Unidade/Minimo/Faixas)\n");
     printf("  0 - Sair\n");
     printf("========================================\n");
 }
@@ -253,71 +413,162 @@ void handle_register_product(void) {
     pause_screen();
 }
 
+// ============================================================================
+// FUNÇÃO: ask_next_page
+// Pergunta se a listagem continua na próxima página
+// Retorna 1 para continuar, 0 para encerrar
+// ============================================================================
+static int ask_next_page(void) {
+    char buffer[MAX_INPUT_BUFFER_SIZE];
+    printf("\nENTER para a proxima pagina, 0 para sair: ");
+    if (fgets(buffer, sizeof(buffer), stdin) == NULL) {
+        return 0;
+    }
+    return buffer[0] != '0';
+}
+
+// ============================================================================
+// FUNÇÃO: read_sort_order
+// Pergunta a ordem de uma listagem ou relatório
+// Retorna a ordem (sort_key com ou sem SORT_DESCENDING), ou -1 se inválida
+// ============================================================================
+static int read_sort_order(void) {
+    static const int orders[] = {
+        SORT_BY_CODE, SORT_BY_NAME,
+        SORT_BY_PRICE, SORT_BY_PRICE | SORT_DESCENDING,
+        SORT_BY_QUANTITY, SORT_BY_QUANTITY | SORT_DESCENDING,
+        SORT_BY_VALUE | SORT_DESCENDING
+    };
+    int option_count = (int)(sizeof(orders) / sizeof(orders[0]));
+
+    printf("Ordenar por:\n");
+    for (int i = 0; i < option_count; i++) {
+        printf("  %d - %s\n", i, sort_order_to_string(orders[i]));
+    }
+    printf("Ordem: ");
+    int option = read_int_safe();
+    if (option < 0 || option >= option_count) {
+        return -1;
+    }
+    return orders[option];
+}
+
 // ============================================================================
 // FUNÇÃO: handle_list_products
-// Lista todos os produtos ativos do sistema
+// Lista os produtos ativos (todos ou de uma categoria) em páginas
 // ============================================================================
 void handle_list_products(void) {
     printf("\n========================================\n");
     printf("        LISTA DE PRODUTOS\n");
     printf("========================================\n");
 
-    product *list[MAX_PRODUCTS];
-    int count = list_active_products(&bank, list, MAX_PRODUCTS);
+    printf("Categoria (0 = todas, 1 a 5): ");
+    int category = read_int_safe();
+    int order = read_sort_order();
 
-    if (count == 0) {
-        printf("Nenhum produto cadastrado.\n");
+    listing_cursor cursor;
+    int opened = 0;
+    if (order >= 0 && category == 0) {
+        opened = open_listing(&cursor, &bank, LISTING_ACTIVE, 0, order);
+    } else if (order >= 0) {
+        opened = open_listing(&cursor, &bank, LISTING_CATEGORY, category, order);
+    }
+    if (!opened) {
+        printf("\nCategoria ou ordem invalida!\n");
         pause_screen();
         return;
     }
 
-    for (int i = 0; i < count; i++) {
-        printf("\n[%d] Codigo: %d\n", i + 1, list[i]->code);
-        printf("    Nome: %s\n", list[i]->name);
-        printf("    Preco: R$ %.2f\n", list[i]->price);
-        printf("    Estoque: %d %s\n", list[i]->quantity, unit_to_string(list[i]->unit));
-        printf("    Minimo: %d\n", list[i]->minimum_stock);
-        printf("    Categoria: %s\n", category_to_string(list[i]->category));
-        printf("----------------------------------------\n");
+    listing_row page[LISTING_PAGE_SIZE];
+    int count;
+    while ((count = next_listing_page(&cursor, page, LISTING_PAGE_SIZE)) > 0) {
+        for (int i = 0; i < count; i++) {
+            const product *p = &page[i].item;
+            printf("\n[%d] Codigo: %d\n", cursor.emitted - count + i + 1, p->code);
+            printf("    Nome: %s\n", p->name);
+            printf("    Preco: R$ %.2f\n", p->price);
+            printf("    Estoque: %d %s\n", p->quantity, unit_to_string(p->unit));
+            printf("    Minimo: %d\n", p->minimum_stock);
+            printf("    Categoria: %s\n", category_to_string(p->category));
+            printf("----------------------------------------\n");
+        }
+        if (count < LISTING_PAGE_SIZE || !listing_has_more(&cursor) || !ask_next_page()) {
+            break;
+        }
     }
 
-    printf("\nTotal: %d produtos cadastrados\n", count);
+    int shown = cursor.emitted;
+    int complete = !listing_has_more(&cursor);
+    close_listing(&cursor);
+
+    if (shown == 0) {
+        printf("Nenhum produto cadastrado.\n");
+    } else if (complete) {
+        printf("\nTotal: %d produtos listados\n", shown);
+    } else {
+        printf("\nListagem interrompida: %d produtos exibidos\n", shown);
+    }
     pause_screen();
 }
 
 // ============================================================================
 // FUNÇÃO: handle_search_product
-// Busca produto por código
+// Busca produto por código ou, se for digitado texto, pelo nome aproximado
+// (tolera falta de acentos, letras trocadas e palavras incompletas)
 // ============================================================================
 void handle_search_product(void) {
     printf("\n========================================\n");
     printf("         BUSCAR PRODUTO\n");
     printf("========================================\n");
 
-    printf("Digite o codigo: ");
-    int code = read_int_safe();
+    char text[MAX_INPUT_BUFFER_SIZE];
+    printf("Digite o codigo ou o nome: ");
+    read_str_safe(text, sizeof(text));
 
-    if (code < 0) {
-        printf("\nCodigo invalido!\n");
+    // só dígitos: busca pelo código
+    int digits = text[0] != '\0';
+    for (int i = 0; text[i]; i++) {
+        if (text[i] < '0' || text[i] > '9') digits = 0;
+    }
+
+    if (digits) {
+        product *p = find_product_by_code(&bank, atoi(text));
+
+        if (p) {
+            printf("\n========================================\n");
+            printf("       PRODUTO ENCONTRADO\n");
+            printf("========================================\n");
+            printf("  Codigo: %d\n", p->code);
+            printf("  Nome: %s\n", p->name);
+            printf("  Preco: R$ %.2f\n", p->price);
+            printf("  Estoque: %d %s\n", p->quantity, unit_to_string(p->unit));
+            printf("  Estoque minimo: %d\n", p->minimum_stock);
+            printf("  Categoria: %s\n", category_to_string(p->category));
+            printf("========================================\n");
+        } else {
+            printf("\nProduto nao encontrado!\n");
+        }
         pause_screen();
         return;
     }
 
-    product *p = find_product_by_code(&bank, code);
+    name_match matches[NAME_SEARCH_SHOWN];
+    double started_at = monotonic_seconds();
+    int count = search_product_names(&names, text, matches, NAME_SEARCH_SHOWN);
+    double elapsed = monotonic_seconds() - started_at;
 
-    if (p) {
-        printf("\n========================================\n");
-        printf("       PRODUTO ENCONTRADO\n");
-        printf("========================================\n");
-        printf("  Codigo: %d\n", p->code);
-        printf("  Nome: %s\n", p->name);
-        printf("  Preco: R$ %.2f\n", p->price);
-        printf("  Estoque: %d %s\n", p->quantity, unit_to_string(p->unit));
-        printf("  Estoque minimo: %d\n", p->minimum_stock);
-        printf("  Categoria: %s\n", category_to_string(p->category));
-        printf("========================================\n");
+    if (count < 0) {
+        printf("\nBusca por nome indisponivel! Verifique o log.\n");
+    } else if (count == 0) {
+        printf("\nNenhum produto com nome parecido.\n");
     } else {
-        printf("\nProduto nao encontrado!\n");
+        printf("\n%-8s %-40s %10s %10s %6s\n", "Codigo", "Nome", "Preco R$", "Estoque", "Nota");
+        for (int i = 0; i < count; i++) {
+            const product *p = &matches[i].item;
+            printf("%-8d %-40s %10.2f %10d %5.0f%%\n", p->code, p->name, p->price,
+                   p->quantity, matches[i].score * 100.0);
+        }
+        printf("\n%d produto(s) em %.2f ms\n", count, elapsed * 1000.0);
     }
 
     pause_screen();
@@ -384,8 +635,14 @@ void handle_update_product(void) {
         minimum = p->minimum_stock;
     }
 
+    // Alteração de quantidade é registrada como ajuste no livro de movimentações
+    if (quantity != p->quantity && !set_product_quantity(&ledger, &bank, code, quantity)) {
+        printf("\nQuantidade invalida ou abaixo do reservado! Mantendo a quantidade atual.\n");
+        quantity = p->quantity;
+    }
+
     // Atualizar produto
-    if (update_product(&bank, code, name, price, quantity, minimum, p->category, p->unit)) {
+    if (update_product(&bank, code, name, price, minimum, p->category, p->unit)) {
         printf("\n========================================\n");
         printf("  PRODUTO ATUALIZADO COM SUCESSO!\n");
         printf("========================================\n");
@@ -454,30 +711,216 @@ void handle_products_below_minimum(void) {
     printf("  PRODUTOS ABAIXO DO ESTOQUE MINIMO\n");
     printf("========================================\n");
 
-    product *list[MAX_PRODUCTS];
-    int count = list_products_below_minimum(&bank, list, MAX_PRODUCTS);
+    int total = cached_below_minimum_count(&dashboard);
 
-    if (count == 0) {
+    if (total == 0) {
         printf("\nTodos os produtos estao com estoque adequado!\n");
         printf("Nenhuma reposicao necessaria.\n");
         pause_screen();
         return;
     }
 
-    printf("\nATENCAO! %d produto(s) precisam de reposicao:\n\n", count);
-
-    for (int i = 0; i < count; i++) {
-        printf("[%d] Codigo: %d\n", i + 1, list[i]->code);
-        printf("    Nome: %s\n", list[i]->name);
-        printf("    Estoque atual: %d %s\n", list[i]->quantity, unit_to_string(list[i]->unit));
-        printf("    Estoque minimo: %d %s\n", list[i]->minimum_stock, unit_to_string(list[i]->unit));
-        printf("    DEFICIT: %d %s\n", list[i]->minimum_stock - list[i]->quantity, unit_to_string(list[i]->unit));
-        printf("----------------------------------------\n");
+    printf("\nATENCAO! %d produto(s) precisam de reposicao:\n\n", total);
+
+    listing_cursor cursor;
+    listing_row page[LISTING_PAGE_SIZE];
+    int count;
+    open_listing(&cursor, &bank, LISTING_BELOW_MINIMUM, 0, SORT_BY_CODE);
+    while ((count = next_listing_page(&cursor, page, LISTING_PAGE_SIZE)) > 0) {
+        for (int i = 0; i < count; i++) {
+            const product *p = &page[i].item;
+            printf("[%d] Codigo: %d\n", cursor.emitted - count + i + 1, p->code);
+            printf("    Nome: %s\n", p->name);
+            printf("    Estoque atual: %d %s\n", p->quantity, unit_to_string(p->unit));
+            printf("    Estoque minimo: %d %s\n", p->minimum_stock, unit_to_string(p->unit));
+            printf("    DEFICIT: %d %s\n", p->minimum_stock - p->quantity, unit_to_string(p->unit));
+            printf("----------------------------------------\n");
+        }
+        if (count < LISTING_PAGE_SIZE || !listing_has_more(&cursor) || !ask_next_page()) {
+            break;
+        }
     }
+    close_listing(&cursor);
 
     pause_screen();
 }
 
+// ============================================================================
+// FUNÇÃO: shutdown_system
+// Libera as estruturas do sistema e fecha o log
+// ============================================================================
+static void shutdown_system(void) {
+    free_reservation_table(&reservations);
+    free_movement_ledger(&ledger);
+    free_report_buffer(&report_output);
+    free_sorted_views();
+    free_name_index(&names);
+    free_range_index(&prices);
+    free_range_index(&quantities);
+    logger_close();
+}
+
+// ============================================================================
+// FUNÇÃO: run_batch_mode
+// Executa os comandos de um arquivo (ou da entrada padrão) sem menus nem
+// pausas: mercado --batch [entrada|-] [saida|-]
+// - retorna o código de saída do processo (0 = todos os comandos com sucesso)
+// ============================================================================
+static int run_batch_mode(int argc, char **argv) {
+    const char *input_path = argc >= 3 ? argv[2] : "-";
+    const char *output_path = argc >= 4 ? argv[3] : "-";
+    int use_stdin = strcmp(input_path, "-") == 0;
+    int use_stdout = strcmp(output_path, "-") == 0;
+
+    FILE *input = use_stdin ? stdin : fopen(input_path, "rb");
+    if (!input) {
+        fprintf(stderr, "Nao foi possivel abrir a entrada do lote: %s\n", input_path);
+        shutdown_system();
+        return EXIT_FAILURE;
+    }
+    FILE *output = use_stdout ? stdout : fopen(output_path, "wb");
+    if (!output) {
+        fprintf(stderr, "Nao foi possivel criar a saida do lote: %s\n", output_path);
+        if (!use_stdin) fclose(input);
+        shutdown_system();
+        return EXIT_FAILURE;
+    }
+
+    batch_session session = { &bank, &ledger, DATA_FILE_PATH, MOVEMENTS_FILE_PATH };
+    batch_summary summary = { 0 };
+    int ok = run_batch(&session, input, output, &summary);
+    if (!use_stdin) fclose(input);
+    if (!use_stdout && fclose(output) != 0) ok = 0;
+
+    fprintf(stderr, "Lote: %lld comandos, %lld erros, %.3f s (%.0f comandos/s)\n",
+            summary.commands, summary.errors, summary.elapsed_seconds,
+            summary.elapsed_seconds > 0 ? summary.commands / summary.elapsed_seconds : 0.0);
+    shutdown_system();
+    return ok && summary.errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// ============================================================================
+// FUNÇÃO: stop_server_on_signal
+// Tratador de SIGINT/SIGTERM do serviço local
+// ============================================================================
+static void stop_server_on_signal(int signal_number) {
+    (void)signal_number;
+    request_server_stop();
+}
+
+// ============================================================================
+// FUNÇÃO: run_server_mode
+// Atende os caixas pelo socket local até SIGINT/SIGTERM e salva os dados ao
+// encerrar: mercado --serve [socket] [replica]
+// - com replica, envia as alterações ao processo réplica nesse socket
+// - retorna o código de saída do processo
+// ============================================================================
+static int run_server_mode(int argc, char **argv) {
+    int ok = serve_until_stopped(argc >= 3 ? argv[2] : SERVER_SOCKET_PATH,
+                                 argc >= 4 ? argv[3] : NULL);
+    shutdown_system();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// ============================================================================
+// FUNÇÃO: serve_until_stopped
+// Serviço local até SIGINT/SIGTERM, com envio opcional à réplica; salva os
+// dados ao encerrar
+// - retorna 1 se sucesso, 0 se erro
+// ============================================================================
+static int serve_until_stopped(const char *socket_path, const char *replica_path) {
+    server_config config = { socket_path, &bank, &ledger, &prices, &quantities };
+    signal(SIGINT, stop_server_on_signal);
+    signal(SIGTERM, stop_server_on_signal);
+
+    replication_primary primary;
+    int replicating = replica_path && start_replication(&primary, &bank, &ledger, replica_path);
+    if (replica_path && !replicating) {
+        log_message(LOG_WARNING, "MAIN", "Servico sem replica: envio nao iniciado");
+    }
+
+    server_stats stats;
+    int ok = run_server(&config, &stats);
+    if (replicating) {
+        replication_stats shipped;
+        get_replication_stats(&primary, &shipped);
+        stop_replication(&primary);
+        fprintf(stderr, "Replica: %llu registros e %llu imagens enviados, %u nao confirmados\n",
+                (unsigned long long)shipped.records_shipped,
+                (unsigned long long)shipped.images_shipped, shipped.lag_records);
+    }
+    if (ok && !(save_products_to_file(&bank, DATA_FILE_PATH)
+                && save_movements_to_file(&ledger, MOVEMENTS_FILE_PATH))) {
+        log_message(LOG_ERROR, "MAIN", "Falha ao salvar dados no encerramento do servico");
+        ok = 0;
+    }
+    return ok;
+}
+
+// ============================================================================
+// FUNÇÃO: promote_standby_on_signal / stop_standby_on_signal
+// Tratadores da réplica: SIGUSR1 promove, SIGINT/SIGTERM encerram
+// ============================================================================
+#ifndef _WIN32
+static void promote_standby_on_signal(int signal_number) {
+    (void)signal_number;
+    request_standby_promotion();
+}
+#endif
+
+static void stop_standby_on_signal(int signal_number) {
+    (void)signal_number;
+    request_standby_stop();
+}
+
+// ============================================================================
+// FUNÇÃO: run_standby_mode
+// Mantém a réplica de prontidão aplicando o que o principal envia:
+// mercado --standby [replica] [socket]
+// - SIGUSR1 promove: a réplica salva os dados e passa a atender os caixas
+//   no socket do serviço local
+// - SIGINT/SIGTERM encerram sem promoção (nada é salvo)
+// - retorna o código de saída do processo
+// ============================================================================
+static int run_standby_mode(int argc, char **argv) {
+    standby_config config = { argc >= 3 ? argv[2] : REPLICA_SOCKET_PATH, &bank, &ledger };
+#ifndef _WIN32
+    signal(SIGUSR1, promote_standby_on_signal);
+#endif
+    signal(SIGINT, stop_standby_on_signal);
+    signal(SIGTERM, stop_standby_on_signal);
+
+    standby_stats stats;
+    int promoted = run_standby(&config, &stats);
+    fprintf(stderr, "Replica: %llu registros e %llu imagens aplicados, atraso maximo %.3f ms\n",
+            (unsigned long long)stats.records_applied, (unsigned long long)stats.images_applied,
+            stats.max_lag_seconds * 1000.0);
+    if (promoted != 1) {
+        shutdown_system();
+        return promoted == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // promovida: o estado aplicado vira o estado salvo antes de atender
+    int ok = save_products_to_file(&bank, DATA_FILE_PATH)
+          && save_movements_to_file(&ledger, MOVEMENTS_FILE_PATH);
+    if (!ok) {
+        log_message(LOG_ERROR, "MAIN", "Falha ao salvar dados na promocao da replica");
+    } else {
+        ok = serve_until_stopped(argc >= 4 ? argv[3] : SERVER_SOCKET_PATH, NULL);
+    }
+    shutdown_system();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// ============================================================================
+// FUNÇÃO: load_saved_state
+// Carrega o snapshot de produtos e o livro de movimentações, reconstruindo
+// as quantidades a partir do livro (em paralelo) e conferindo com o snapshot
+// ============================================================================
+static int load_saved_state(void) {
+    return restore_saved_state(&bank, &ledger, DATA_FILE_PATH, MOVEMENTS_FILE_PATH);
+}
+
 // ============================================================================
 // FUNÇÃO: handle_save_data
 // Salva todos os produtos em arquivo binário
@@ -488,12 +931,13 @@ void handle_save_data(void) {
     printf("========================================\n");
     printf("Salvando dados em arquivo...\n");
 
-    if (save_products_to_file(&bank, DATA_FILE_PATH)) {
+    if (save_products_to_file(&bank, DATA_FILE_PATH)
+        && save_movements_to_file(&ledger, MOVEMENTS_FILE_PATH)) {
         printf("\n========================================\n");
         printf("  DADOS SALVOS COM SUCESSO!\n");
         printf("========================================\n");
         printf("  Arquivo: %s\n", DATA_FILE_PATH);
-        printf("  Produtos salvos: %d\n", count_active_products(&bank));
+        printf("  Produtos salvos: %d\n", cached_active_count(&dashboard));
         printf("========================================\n");
         log_message(LOG_INFO, "MAIN", "Dados salvos em arquivo com sucesso");
     } else {
@@ -523,12 +967,15 @@ void handle_load_data(void) {
         return;
     }
 
-    // Reinicializa banco de produtos
+    // Desfaz reservas pendentes e reinicializa banco, livro e métricas
+    free_reservation_table(&reservations);
     initialize_product_bank(&bank);
+    free_movement_ledger(&ledger);
+    reset_velocity_tracker(&velocity);
 
     printf("\nCarregando dados do arquivo...\n");
 
-    if (load_products_from_file(&bank, DATA_FILE_PATH)) {
+    if (load_saved_state()) {
         printf("\n========================================\n");
         printf("  DADOS RECARREGADOS COM SUCESSO!\n");
         printf("========================================\n");
@@ -543,3 +990,837 @@ void handle_load_data(void) {
 
     pause_screen();
 }
+
+// ============================================================================
+// FUNÇÃO: handle_stock_movement
+// Registra entrada, venda, perda ou ajuste de estoque no livro de movimentações
+// ============================================================================
+void handle_stock_movement(void) {
+    printf("\n========================================\n");
+    printf("        MOVIMENTAR ESTOQUE\n");
+    printf("========================================\n");
+
+    printf("Digite o codigo do produto: ");
+    int code = read_int_safe();
+
+    product *p = find_product_by_code(&bank, code);
+    if (!p) {
+        printf("\nProduto nao encontrado!\n");
+        pause_screen();
+        return;
+    }
+
+    printf("\nProduto: %s (Estoque: %d %s)\n", p->name, p->quantity, unit_to_string(p->unit));
+    printf("\nTipos de movimentacao:\n");
+    printf("  %d - Entrada\n", MOVEMENT_IN);
+    printf("  %d - Venda\n", MOVEMENT_SALE);
+    printf("  %d - Perda\n", MOVEMENT_LOSS);
+    printf("  %d - Ajuste (+ ou -)\n", MOVEMENT_ADJUSTMENT);
+    printf("Tipo: ");
+    int type = read_int_safe();
+
+    if (type < MOVEMENT_IN || type > MOVEMENT_ADJUSTMENT) {
+        printf("\nTipo invalido! Operacao cancelada.\n");
+        pause_screen();
+        return;
+    }
+
+    int quantity;
+    if (type == MOVEMENT_ADJUSTMENT) {
+        // read_int_safe usa -1 como erro; o sinal do ajuste é perguntado à parte
+        printf("Direcao do ajuste (1=Acrescentar, 2=Retirar): ");
+        int direction = read_int_safe();
+        printf("Quantidade: ");
+        quantity = read_int_safe();
+        if (quantity <= 0 || (direction != 1 && direction != 2)) {
+            quantity = 0;  // rejeitado por record_movement
+        } else if (direction == 2) {
+            quantity = -quantity;
+        }
+    } else {
+        printf("Quantidade: ");
+        quantity = read_int_safe();
+    }
+
+    if (record_movement(&ledger, &bank, code, (movement_type)type, quantity)) {
+        printf("\n========================================\n");
+        printf("  MOVIMENTACAO REGISTRADA!\n");
+        printf("========================================\n");
+        printf("  %s de %d %s\n", movement_type_to_string(type),
+               quantity < 0 ? -quantity : quantity, unit_to_string(p->unit));
+        printf("  Novo estoque: %d %s\n", p->quantity, unit_to_string(p->unit));
+        printf("========================================\n");
+        log_message(LOG_INFO, "MAIN", "Movimentacao de estoque registrada");
+    } else {
+        printf("\nErro ao registrar movimentacao!\n");
+        printf("Verifique a quantidade e o estoque disponivel.\n");
+    }
+
+    pause_screen();
+}
+
+// ============================================================================
+// FUNÇÃO: handle_movement_history
+// Exibe as movimentações mais recentes de um produto
+// ============================================================================
+void handle_movement_history(void) {
+    printf("\n========================================\n");
+    printf("    HISTORICO DE MOVIMENTACOES\n");
+    printf("========================================\n");
+
+    printf("Digite o codigo do produto: ");
+    int code = read_int_safe();
+
+    product *p = find_product_by_code(&bank, code);
+    if (!p) {
+        printf("\nProduto nao encontrado!\n");
+        pause_screen();
+        return;
+    }
+
+    // exibe apenas as movimentações mais recentes (cadeia do produto)
+    const movement_record *history[20];
+    int count = list_product_movements(&ledger, code, history, 20);
+
+    printf("\nProduto: %s\n", p->name);
+    if (count == 0) {
+        printf("Nenhuma movimentacao registrada.\n");
+        pause_screen();
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        time_t when = (time_t)history[i]->timestamp;
+        char timestamp[32];
+        strftime(timestamp, sizeof(timestamp), "%d/%m/%Y %H:%M:%S", localtime(&when));
+        printf("  %s  %-14s %+d %s\n", timestamp, movement_type_to_string(history[i]->type),
+               history[i]->delta, unit_to_string(p->unit));
+    }
+    printf("----------------------------------------\n");
+    printf("Estoque atual: %d %s\n", p->quantity, unit_to_string(p->unit));
+
+    pause_screen();
+}
+
+// ============================================================================
+// FUNÇÃO: handle_checkout
+// Registra a venda de uma cesta inteira: ou todos os itens são baixados
+// do estoque, ou nenhum é
+// ============================================================================
+void handle_checkout(void) {
+    printf("\n========================================\n");
+    printf("        CAIXA - VENDA DE CESTA\n");
+    printf("========================================\n");
+    printf("Informe os itens (codigo 0 para finalizar)\n\n");
+
+    basket_item items[CHECKOUT_MAX_ITEMS];
+    size_t count = 0;
+
+    while (count < CHECKOUT_MAX_ITEMS) {
+        printf("Item %zu - codigo: ", count + 1);
+        int code = read_int_safe();
+        if (code == 0) {
+            break;
+        }
+        if (code < 0) {
+            continue;  // entrada inválida: pede o código novamente
+        }
+
+        printf("Item %zu - quantidade: ", count + 1);
+        int quantity = read_int_safe();
+        if (quantity <= 0) {
+            printf("Quantidade invalida! Item ignorado.\n");
+            continue;
+        }
+
+        items[count].code = code;
+        items[count].quantity = quantity;
+        count++;
+    }
+
+    if (count == 0) {
+        printf("\nCesta vazia. Operacao cancelada.\n");
+        pause_screen();
+        return;
+    }
+
+    int failed_item;
+    uint32_t batch = checkout_basket(&ledger, &bank, items, count, &failed_item);
+
+    if (batch > 0) {
+        printf("\n========================================\n");
+        printf("  VENDA FINALIZADA COM SUCESSO!\n");
+        printf("========================================\n");
+        printf("  Lancamento: %u\n", (unsigned)batch);
+        printf("  Itens: %zu\n", count);
+        printf("========================================\n");
+        log_message(LOG_INFO, "MAIN", "Venda de cesta finalizada");
+    } else {
+        printf("\nVenda recusada! Nenhum item foi baixado do estoque.\n");
+        if (failed_item >= 0) {
+            printf("Item %d (codigo %d): produto inexistente ou estoque insuficiente.\n",
+                   failed_item + 1, items[failed_item].code);
+        }
+    }
+
+    pause_screen();
+}
+
+// ============================================================================
+// FUNÇÃO: handle_stockout_alerts
+// Lista produtos que devem esgotar em poucos dias no ritmo atual de vendas
+// ============================================================================
+void handle_stockout_alerts(void) {
+    printf("\n========================================\n");
+    printf("   ALERTA DE RUPTURA DE ESTOQUE\n");
+    printf("========================================\n");
+
+    printf("Esgotam em quantos dias? (1 a %d): ", (int)VELOCITY_DEFAULT_HORIZON_DAYS);
+    int days = read_int_safe();
+
+    if (days <= 0) {
+        printf("\nQuantidade de dias invalida!\n");
+        pause_screen();
+        return;
+    }
+
+    // a lista de alerta é curta por natureza: mostra no máximo STOCKOUT_ALERTS_SHOWN
+    product *list[STOCKOUT_ALERTS_SHOWN];
+    uint32_t now = (uint32_t)time(NULL);
+    int count = list_stockout_alerts(&velocity, &bank, days, now, list, STOCKOUT_ALERTS_SHOWN);
+
+    if (count == 0) {
+        printf("\nNenhum produto deve esgotar nesse prazo.\n");
+        pause_screen();
+        return;
+    }
+
+    printf("\nATENCAO! %d produto(s) podem esgotar:\n\n", count);
+
+    for (int i = 0; i < count; i++) {
+        printf("[%d] Codigo: %d\n", i + 1, list[i]->code);
+        printf("    Nome: %s\n", list[i]->name);
+        printf("    Estoque atual: %d %s\n", list[i]->quantity, unit_to_string(list[i]->unit));
+        printf("    Vendas/dia: %.2f\n", sales_velocity(&velocity, &bank, list[i], now));
+        printf("    Cobertura: %.1f dias\n", days_of_cover(&velocity, &bank, list[i], now));
+        printf("----------------------------------------\n");
+        if ((i + 1) % LISTING_PAGE_SIZE == 0 && i + 1 < count && !ask_next_page()) {
+            break;
+        }
+    }
+    if (count == STOCKOUT_ALERTS_SHOWN) {
+        printf("\n(exibidos os primeiros %d alertas)\n", STOCKOUT_ALERTS_SHOWN);
+    }
+
+    pause_screen();
+}
+
+// ============================================================================
+// FUNÇÃO: handle_reservations
+// Cria, confirma ou cancela reservas de pedidos online
+// ============================================================================
+void handle_reservations(void) {
+    printf("\n========================================\n");
+    printf("   RESERVAS (PEDIDOS ONLINE)\n");
+    printf("========================================\n");
+    printf("  Reservas pendentes: %d\n", reservations.pending);
+    printf("  1 - Nova reserva\n");
+    printf("  2 - Confirmar reserva (venda)\n");
+    printf("  3 - Cancelar reserva\n");
+    printf("Escolha: ");
+    int option = read_int_safe();
+
+    if (option == 1) {
+        printf("Codigo do produto: ");
+        int code = read_int_safe();
+        product *p = find_product_by_code(&bank, code);
+        if (!p || !p->active) {
+            printf("\nProduto nao encontrado!\n");
+            pause_screen();
+            return;
+        }
+        printf("Disponivel: %d %s\n", available_quantity(&bank, p), unit_to_string(p->unit));
+
+        printf("Quantidade: ");
+        int quantity = read_int_safe();
+        printf("Validade da reserva em minutos: ");
+        int minutes = read_int_safe();
+
+        if (quantity <= 0 || minutes <= 0 || minutes > (int)(RESERVATION_MAX_TIMEOUT / 60)) {
+            printf("\nQuantidade ou validade invalida!\n");
+            pause_screen();
+            return;
+        }
+
+        uint32_t id = create_reservation(&reservations, code, quantity, (uint32_t)minutes * 60);
+        if (id) {
+            printf("\nReserva criada! Numero: %u\n", id);
+        } else {
+            printf("\nDisponivel insuficiente para a reserva.\n");
+        }
+    } else if (option == 2 || option == 3) {
+        printf("Numero da reserva: ");
+        int id = read_int_safe();
+        int ok = id > 0 && (option == 2 ? commit_reservation(&reservations, (uint32_t)id)
+                                        : cancel_reservation(&reservations, (uint32_t)id));
+        if (ok) {
+            printf("\nReserva %s!\n", option == 2 ? "confirmada" : "cancelada");
+        } else {
+            printf("\nReserva inexistente ou expirada.\n");
+        }
+    } else {
+        printf("\nOpcao invalida!\n");
+    }
+
+    pause_screen();
+}
+
+// ============================================================================
+// FUNÇÃO: handle_export_report
+// Gera relatório de inventário, valorização ou reposição em relatorios/
+// ============================================================================
+void handle_export_report(void) {
+    printf("\n========================================\n");
+    printf("       EXPORTAR RELATORIO\n");
+    printf("========================================\n");
+    printf("  1 - %s\n", report_kind_to_string(REPORT_INVENTORY));
+    printf("  2 - %s\n", report_kind_to_string(REPORT_VALUATION));
+    printf("  3 - %s\n", report_kind_to_string(REPORT_LOW_STOCK));
+    printf("Tipo: ");
+    int kind = read_int_safe();
+    printf("Formato (1=CSV, 2=Texto, 3=JSON): ");
+    int format = read_int_safe();
+    int order = read_sort_order();
+
+    if (kind < REPORT_INVENTORY || kind > REPORT_LOW_STOCK
+        || format < REPORT_FORMAT_CSV || format > REPORT_FORMAT_JSON || order < 0) {
+        printf("\nTipo, formato ou ordem invalido!\n");
+        pause_screen();
+        return;
+    }
+
+    if (!report_output.data && !initialize_report_buffer(&report_output, 0)) {
+        printf("\nMemoria insuficiente para gerar o relatorio.\n");
+        pause_screen();
+        return;
+    }
+
+    char path[REPORT_PATH_MAX];
+    build_report_path(path, sizeof(path), (report_kind)kind, (report_format)format);
+
+    report_source source;
+    bank_report_cursor cursor;
+    report_summary summary;
+    int ok = open_bank_report_source(&source, &cursor, &bank, order)
+          && write_report(&report_output, (report_kind)kind, (report_format)format,
+                          &source, path, &summary);
+    close_bank_report_source(&cursor);
+
+    if (ok) {
+        printf("\n========================================\n");
+        printf("  RELATORIO GERADO!\n");
+        printf("========================================\n");
+        printf("  Arquivo: %s\n", path);
+        printf("  Produtos: %d\n", summary.rows);
+        printf("  Valor total: R$ %.2f\n", summary.total_value_cents / 100.0);
+        printf("  Tempo: %.3f s\n", summary.elapsed_seconds);
+        printf("========================================\n");
+    } else {
+        printf("\nErro ao gerar relatorio! Verifique o log.\n");
+    }
+
+    pause_screen();
+}
+
+// ============================================================================
+// FUNÇÃO: handle_grouped_summary
+// Mostra contagem, quantidade, valor e preços agrupados por um critério
+// ============================================================================
+void handle_grouped_summary(void) {
+    printf("\n========================================\n");
+    printf("       RESUMO AGRUPADO\n");
+    printf("========================================\n");
+    printf("  1 - Por %s\n", group_by_to_string(GROUP_BY_CATEGORY));
+    printf("  2 - Por %s\n", group_by_to_string(GROUP_BY_UNIT));
+    printf("  3 - Por %s\n", group_by_to_string(GROUP_BY_PRICE_BAND));
+    printf("Agrupar: ");
+    int key = read_int_safe();
+
+    if (key < GROUP_BY_CATEGORY || key > GROUP_BY_PRICE_BAND) {
+        printf("\nOpcao invalida!\n");
+        pause_screen();
+        return;
+    }
+
+    long long band_cents = 0;
+    if (key == GROUP_BY_PRICE_BAND) {
+        printf("Largura da faixa em R$ (ex: 10.00): ");
+        float band = read_float_safe();
+        if (band <= 0) {
+            printf("\nLargura invalida!\n");
+            pause_screen();
+            return;
+        }
+        band_cents = (long long)(band * 100.0f + 0.5f);
+    }
+
+    aggregate_result result;
+    if (!aggregate_products(&bank, (group_by)key, band_cents, &result)) {
+        printf("\nErro ao agrupar produtos!\n");
+        pause_screen();
+        return;
+    }
+
+    printf("\n%-24s %8s %10s %14s %10s %10s %10s\n",
+           group_by_to_string(key), "Itens", "Qtd", "Valor R$", "Min R$", "Media R$", "Max R$");
+    printf("----------------------------------------------------------------------------------------------\n");
+
+    char label[48];
+    for (int g = 0; g < result.group_count; g++) {
+        const aggregate_group *group = &result.groups[g];
+        if (group->count == 0) continue;
+        long long average = aggregate_average_price_cents(group);
+        printf("%-24s %8lld %10lld %11lld.%02lld %7lld.%02lld %7lld.%02lld %7lld.%02lld\n",
+               aggregate_group_label(&result, g, label, sizeof(label)),
+               group->count, group->quantity,
+               group->value_cents / 100, group->value_cents % 100,
+               group->min_price_cents / 100, group->min_price_cents % 100,
+               average / 100, average % 100,
+               group->max_price_cents / 100, group->max_price_cents % 100);
+    }
+
+    printf("----------------------------------------------------------------------------------------------\n");
+    printf("%-24s %8lld %10lld %11lld.%02lld\n", "TOTAL", result.total.count, result.total.quantity,
+           result.total.value_cents / 100, result.total.value_cents % 100);
+    printf("\n(%.3f s)\n", result.elapsed_seconds);
+
+    pause_screen();
+}
+
+// ============================================================================
+// FUNÇÃO: handle_rankings
+// Mostra os K primeiros produtos de um critério, com exportação opcional
+// ============================================================================
+void handle_rankings(void) {
+    printf("\n========================================\n");
+    printf("       RANKINGS (TOP K)\n");
+    printf("========================================\n");
+    printf("  1 - %s\n", ranking_metric_to_string(RANKING_STOCK_VALUE));
+    printf("  2 - %s\n", ranking_metric_to_string(RANKING_LOWEST_COVER));
+    printf("  3 - %s\n", ranking_metric_to_string(RANKING_OVERSTOCK));
+    printf("Criterio: ");
+    int metric = read_int_safe();
+    printf("Quantos produtos? (1 a %d): ", RANKING_MAX_K);
+    int k = read_int_safe();
+
+    if (metric < RANKING_STOCK_VALUE || metric > RANKING_OVERSTOCK || k <= 0 || k > RANKING_MAX_K) {
+        printf("\nCriterio ou quantidade invalida!\n");
+        pause_screen();
+        return;
+    }
+
+    static ranking_entry entries[RANKING_MAX_K];
+    int count = rank_products(&bank, &velocity, (ranking_metric)metric, (size_t)k,
+                              (uint32_t)time(NULL), entries);
+
+    if (count == 0) {
+        printf("\nNenhum produto para este criterio.\n");
+        pause_screen();
+        return;
+    }
+
+    printf("\n%s:\n\n", ranking_metric_to_string(metric));
+    for (int i = 0; i < count; i++) {
+        const product *p = &entries[i].item;
+        printf("%4d. [%d] %-30s ", i + 1, p->code, p->name);
+        switch (metric) {
+            case RANKING_STOCK_VALUE: printf("R$ %.2f\n", entries[i].score); break;
+            case RANKING_LOWEST_COVER: printf("%.1f dias\n", entries[i].score); break;
+            default: printf("%.1fx o minimo\n", entries[i].score); break;
+        }
+    }
+
+    printf("\nExportar para %s/? (1=Sim, 0=Nao): ", REPORT_DIRECTORY);
+    if (read_int_safe() == 1) {
+        char path[REPORT_PATH_MAX];
+        report_source source;
+        ranking_cursor cursor;
+        report_summary summary;
+
+        if (!report_output.data && !initialize_report_buffer(&report_output, 0)) {
+            printf("\nMemoria insuficiente para gerar o relatorio.\n");
+            pause_screen();
+            return;
+        }
+        build_report_path(path, sizeof(path), REPORT_RANKING, REPORT_FORMAT_CSV);
+        open_ranking_report_source(&source, &cursor, entries, count);
+        if (write_report(&report_output, REPORT_RANKING, REPORT_FORMAT_CSV, &source, path, &summary)) {
+            printf("\nRanking exportado: %s\n", path);
+        } else {
+            printf("\nErro ao exportar ranking! Verifique o log.\n");
+        }
+    }
+
+    pause_screen();
+}
+
+// ============================================================================
+// FUNÇÃO: handle_snapshot_diff
+// Compara dois arquivos de dados ou verifica um backup recém-criado
+// ============================================================================
+void handle_snapshot_diff(void) {
+    printf("\n========================================\n");
+    printf("   COMPARAR ARQUIVOS DE DADOS\n");
+    printf("========================================\n");
+    printf("  1 - Criar backup e verificar\n");
+    printf("  2 - Comparar dois arquivos (relatorio de diferencas)\n");
+    printf("Escolha: ");
+    int option = read_int_safe();
+
+    char old_path[256];
+    char new_path[256];
+    char report_path[REPORT_PATH_MAX];
+    snapshot_diff_summary summary;
+
+    if (option == 1) {
+        if (!backup_data_file(DATA_FILE_PATH)) {
+            printf("\nErro ao criar backup! Salve os dados antes.\n");
+            pause_screen();
+            return;
+        }
+        snprintf(old_path, sizeof(old_path), "%s.backup", DATA_FILE_PATH);
+        if (!diff_snapshots(DATA_FILE_PATH, old_path, NULL, NULL, &summary)) {
+            printf("\nErro ao verificar backup! Verifique o log.\n");
+        } else if (snapshots_identical(&summary)) {
+            printf("\nBackup verificado: %s identico ao original (%d produtos).\n",
+                   old_path, summary.new_count);
+        } else {
+            printf("\nATENCAO! Backup difere do original em %d produto(s).\n",
+                   summary.changed_products);
+        }
+        pause_screen();
+        return;
+    }
+
+    if (option != 2) {
+        printf("\nOpcao invalida!\n");
+        pause_screen();
+        return;
+    }
+
+    printf("Arquivo anterior (ex: %s.backup): ", DATA_FILE_PATH);
+    read_str_safe(old_path, sizeof(old_path));
+    printf("Arquivo novo (ENTER = %s): ", DATA_FILE_PATH);
+    read_str_safe(new_path, sizeof(new_path));
+    if (new_path[0] == '\0') {
+        snprintf(new_path, sizeof(new_path), "%s", DATA_FILE_PATH);
+    }
+
+    if (!report_output.data && !initialize_report_buffer(&report_output, 0)) {
+        printf("\nMemoria insuficiente para gerar o relatorio.\n");
+        pause_screen();
+        return;
+    }
+    build_named_report_path(report_path, sizeof(report_path), "diferencas", "csv");
+    if (!diff_snapshots(old_path, new_path, &report_output, report_path, &summary)) {
+        printf("\nErro ao comparar arquivos! Verifique o log.\n");
+        pause_screen();
+        return;
+    }
+
+    printf("\n========================================\n");
+    printf("  Produtos: %d -> %d\n", summary.old_count, summary.new_count);
+    printf("  Novos: %d | Removidos: %d\n", summary.added, summary.removed);
+    printf("  Inativados: %d | Reativados: %d\n", summary.deactivated, summary.reactivated);
+    printf("  Preco alterado: %d\n", summary.price_changed);
+    printf("  Quantidade alterada: %d\n", summary.quantity_changed);
+    printf("  Outros campos: %d\n", summary.other_changed);
+    printf("  Sem alteracao: %d\n", summary.unchanged);
+    printf("  Relatorio: %s\n", report_path);
+    printf("  Tempo: %.3f s\n", summary.elapsed_seconds);
+    printf("========================================\n");
+
+    pause_screen();
+}
+
+// ============================================================================
+// FUNÇÃO: handle_range_query
+// Lista os produtos com preço ou quantidade dentro de uma faixa, em páginas
+// (remarcação de preços e reposição de estoque)
+// ============================================================================
+void handle_range_query(void) {
+    printf("\n========================================\n");
+    printf("   CONSULTA POR FAIXA\n");
+    printf("========================================\n");
+    printf("  1 - Faixa de preco\n");
+    printf("  2 - Faixa de quantidade em estoque\n");
+    printf("Escolha: ");
+    int option = read_int_safe();
+
+    range_index *index;
+    uint32_t low, high;
+    if (option == 1) {
+        printf("Preco minimo (R$): ");
+        float low_price = read_float_safe();
+        printf("Preco maximo (R$): ");
+        float high_price = read_float_safe();
+        if (low_price < 0 || high_price < 0) {
+            printf("\nPreco invalido!\n");
+            pause_screen();
+            return;
+        }
+        index = &prices;
+        low = (uint32_t)((double)low_price * 100.0 + 0.5);
+        high = (uint32_t)((double)high_price * 100.0 + 0.5);
+    } else if (option == 2) {
+        printf("Quantidade minima: ");
+        int low_quantity = read_int_safe();
+        printf("Quantidade maxima: ");
+        int high_quantity = read_int_safe();
+        if (low_quantity < 0 || high_quantity < 0) {
+            printf("\nQuantidade invalida!\n");
+            pause_screen();
+            return;
+        }
+        index = &quantities;
+        low = (uint32_t)low_quantity;
+        high = (uint32_t)high_quantity;
+    } else {
+        printf("\nOpcao invalida!\n");
+        pause_screen();
+        return;
+    }
+
+    range_cursor cursor;
+    if (!open_range(&cursor, index, low, high)) {
+        printf("\nFaixa invalida! O minimo deve ser menor ou igual ao maximo.\n");
+        pause_screen();
+        return;
+    }
+
+    listing_row page[LISTING_PAGE_SIZE];
+    int count;
+    while ((count = next_range_page(&cursor, page, LISTING_PAGE_SIZE)) > 0) {
+        for (int i = 0; i < count; i++) {
+            const product *p = &page[i].item;
+            printf("\n[%d] Codigo: %d | %s\n", cursor.emitted - count + i + 1, p->code, p->name);
+            printf("    Preco: R$ %.2f | Estoque: %d %s (disponivel: %d, minimo: %d)\n",
+                   p->price, p->quantity, unit_to_string(p->unit),
+                   page[i].available, p->minimum_stock);
+        }
+        if (count < LISTING_PAGE_SIZE || !range_has_more(&cursor) || !ask_next_page()) {
+            break;
+        }
+    }
+
+    if (count < 0) {
+        printf("\nErro na consulta! Verifique o log.\n");
+    } else if (cursor.emitted == 0) {
+        printf("\nNenhum produto na faixa.\n");
+    } else if (!range_has_more(&cursor)) {
+        printf("\nTotal: %d produtos na faixa\n", cursor.emitted);
+    } else {
+        printf("\nConsulta interrompida: %d produtos exibidos\n", cursor.emitted);
+    }
+    pause_screen();
+}
+
+// ============================================================================
+// FUNÇÃO: read_filter_predicate
+// Pergunta um critério do filtro combinado e o acrescenta à consulta
+// Retorna 1 se acrescentou, 0 se terminou (opção 0), -1 se inválido
+// ============================================================================
+static int read_filter_predicate(filter_query *query) {
+    printf("\nCriterios (todos precisam valer):\n");
+    printf("  1 - Categoria\n");
+    printf("  2 - Unidade\n");
+    printf("  3 - Abaixo do minimo\n");
+    printf("  4 - Faixa de preco\n");
+    printf("  5 - Faixa de quantidade\n");
+    printf("  0 - Executar\n");
+    printf("Criterio: ");
+    int option = read_int_safe();
+    if (option == 0) {
+        return 0;
+    }
+
+    filter_field field;
+    uint32_t low = 0, high = 0;
+    switch (option) {
+        case 1:
+            field = FILTER_CATEGORY;
+            for (int c = CATEGORY_FOOD; c <= CATEGORY_OTHERS; c++) {
+                printf("  %d - %s\n", c, category_to_string(c));
+            }
+            printf("Categoria: ");
+            low = (uint32_t)read_int_safe();
+            break;
+        case 2:
+            field = FILTER_UNIT;
+            for (int u = UNIT_PIECE; u <= UNIT_ML; u++) {
+                printf("  %d - %s\n", u, unit_to_string(u));
+            }
+            printf("Unidade: ");
+            low = (uint32_t)read_int_safe();
+            break;
+        case 3:
+            field = FILTER_BELOW_MINIMUM;
+            break;
+        case 4: {
+            field = FILTER_PRICE;
+            printf("Preco minimo (R$): ");
+            float low_price = read_float_safe();
+            printf("Preco maximo (R$): ");
+            float high_price = read_float_safe();
+            if (low_price < 0 || high_price < 0) {
+                return -1;
+            }
+            low = (uint32_t)((double)low_price * 100.0 + 0.5);
+            high = (uint32_t)((double)high_price * 100.0 + 0.5);
+            break;
+        }
+        case 5: {
+            field = FILTER_QUANTITY;
+            printf("Quantidade minima: ");
+            int low_quantity = read_int_safe();
+            printf("Quantidade maxima: ");
+            int high_quantity = read_int_safe();
+            if (low_quantity < 0 || high_quantity < 0) {
+                return -1;
+            }
+            low = (uint32_t)low_quantity;
+            high = (uint32_t)high_quantity;
+            break;
+        }
+        default:
+            return -1;
+    }
+
+    printf("Inverter criterio (1 = produtos que NAO atendem, 0 = normal): ");
+    int negate = read_int_safe() == 1;
+    return add_filter_predicate(query, field, low, high, negate) ? 1 : -1;
+}
+
+// ============================================================================
+// FUNÇÃO: handle_filter_query
+// Monta um filtro com vários critérios, mostra quantos produtos atendem e
+// lista ou exporta o resultado
+// ============================================================================
+void handle_filter_query(void) {
+    printf("\n========================================\n");
+    printf("   FILTRO COMBINADO\n");
+    printf("========================================\n");
+
+    filter_query query;
+    initialize_filter_query(&query, &prices, &quantities);
+
+    int status;
+    while (query.count < FILTER_MAX_PREDICATES && (status = read_filter_predicate(&query)) != 0) {
+        if (status < 0) {
+            printf("\nCriterio invalido! Ignorado.\n");
+        }
+    }
+
+    filter_result result;
+    if (!run_filter_query(&query, &bank, &result)) {
+        printf("\nErro ao executar o filtro! Verifique o log.\n");
+        pause_screen();
+        return;
+    }
+
+    printf("\n========================================\n");
+    for (int i = 0; i < query.count; i++) {
+        char description[96];
+        describe_filter_predicate(&query.predicates[i], description, sizeof(description));
+        printf("  %s %s\n", i == 0 ? "   " : " E ", description);
+    }
+    printf("----------------------------------------\n");
+    printf("  Produtos encontrados: %lld\n", result.matches);
+    printf("  Tempo: %.3f ms (%d criterio(s) pelo indice, %d bloco(s) varrido(s))\n",
+           result.elapsed_seconds * 1000.0, result.index_predicates, result.scanned_chunks);
+    printf("========================================\n");
+
+    if (result.matches == 0) {
+        free_filter_result(&result);
+        pause_screen();
+        return;
+    }
+
+    printf("  1 - Listar\n");
+    printf("  2 - Exportar (%s)\n", report_kind_to_string(REPORT_INVENTORY));
+    printf("  0 - Voltar\n");
+    printf("Escolha: ");
+    int option = read_int_safe();
+    if (option != 1 && option != 2) {
+        free_filter_result(&result);
+        return;
+    }
+    int format = REPORT_FORMAT_CSV;
+    if (option == 2) {
+        printf("Formato (1=CSV, 2=Texto, 3=JSON): ");
+        format = read_int_safe();
+    }
+    int order = read_sort_order();
+    if (order < 0 || format < REPORT_FORMAT_CSV || format > REPORT_FORMAT_JSON) {
+        printf("\nOrdem ou formato invalido!\n");
+        free_filter_result(&result);
+        pause_screen();
+        return;
+    }
+
+    if (option == 2) {
+        if (!report_output.data && !initialize_report_buffer(&report_output, 0)) {
+            printf("\nMemoria insuficiente para gerar o relatorio.\n");
+            free_filter_result(&result);
+            pause_screen();
+            return;
+        }
+        char path[REPORT_PATH_MAX];
+        build_named_report_path(path, sizeof(path), "filtro",
+                                format == REPORT_FORMAT_CSV ? "csv"
+                                : format == REPORT_FORMAT_TEXT ? "txt" : "json");
+        report_source source;
+        bank_report_cursor cursor;
+        report_summary summary;
+        int ok = open_selection_report_source(&source, &cursor, &bank, &result.slots, order)
+              && write_report(&report_output, REPORT_INVENTORY, (report_format)format,
+                              &source, path, &summary);
+        close_bank_report_source(&cursor);
+        free_filter_result(&result);
+        if (ok) {
+            printf("\nRelatorio gerado: %s (%d produtos, %.3f s)\n",
+                   path, summary.rows, summary.elapsed_seconds);
+        } else {
+            printf("\nErro ao gerar relatorio! Verifique o log.\n");
+        }
+        pause_screen();
+        return;
+    }
+
+    listing_cursor cursor;
+    int opened = open_selection_listing(&cursor, &bank, &result.slots, order);
+    free_filter_result(&result);
+    if (!opened) {
+        printf("\nErro ao abrir a listagem! Verifique o log.\n");
+        pause_screen();
+        return;
+    }
+
+    listing_row page[LISTING_PAGE_SIZE];
+    int count;
+    while ((count = next_listing_page(&cursor, page, LISTING_PAGE_SIZE)) > 0) {
+        for (int i = 0; i < count; i++) {
+            const product *p = &page[i].item;
+            printf("\n[%d] Codigo: %d | %s\n", cursor.emitted - count + i + 1, p->code, p->name);
+            printf("    %s | Preco: R$ %.2f | Estoque: %d %s (disponivel: %d, minimo: %d)\n",
+                   category_to_string(p->category), p->price, p->quantity,
+                   unit_to_string(p->unit), page[i].available, p->minimum_stock);
+        }
+        if (count < LISTING_PAGE_SIZE || !listing_has_more(&cursor) || !ask_next_page()) {
+            break;
+        }
+    }
+    printf("\n%d produtos exibidos\n", cursor.emitted);
+    close_listing(&cursor);
+    pause_screen();
+}
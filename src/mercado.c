@@ -0,0 +1,317 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mercado.h"
+#include "logger.h"
+#include "persistence.h"
+#include "replay.h"
+#include "sorting.h"
+#include "velocity.h"
+
+// ============================================================================
+// MÓDULO: mercado — Implementação da API da biblioteca
+// ============================================================================
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// páginas lidas do índice por mercado_range
+#define MERCADO_RANGE_PAGE 64
+
+// estado de um estoque embutido
+struct mercado_store {
+    product_bank bank;
+    movement_ledger ledger;
+    velocity_tracker velocity;
+    range_index prices;
+    range_index quantities;
+    int indexes_ready;                  // 1 = índices de faixa ouvindo o banco
+    mercado_options options;
+    pthread_rwlock_t lock;              // usada só em MERCADO_LOCK_RWLOCK
+};
+
+// ============================================================================
+// TRAVAS
+// ============================================================================
+
+void mercado_begin_read(mercado_store *store) {
+    if (store && store->options.lock_mode == MERCADO_LOCK_RWLOCK) pthread_rwlock_rdlock(&store->lock);
+}
+
+void mercado_end_read(mercado_store *store) {
+    if (store && store->options.lock_mode == MERCADO_LOCK_RWLOCK) pthread_rwlock_unlock(&store->lock);
+}
+
+void mercado_begin_write(mercado_store *store) {
+    if (store && store->options.lock_mode == MERCADO_LOCK_RWLOCK) pthread_rwlock_wrlock(&store->lock);
+}
+
+void mercado_end_write(mercado_store *store) {
+    if (store && store->options.lock_mode == MERCADO_LOCK_RWLOCK) pthread_rwlock_unlock(&store->lock);
+}
+
+// ============================================================================
+// CICLO DE VIDA
+// ============================================================================
+
+// cria o estoque
+mercado_store *mercado_open(const mercado_options *options) {
+    mercado_store *store = calloc(1, sizeof(mercado_store));
+    if (!store) {
+        log_message(LOG_ERROR, "mercado", "Memoria insuficiente para abrir o estoque");
+        return NULL;
+    }
+    if (options) store->options = *options;
+    if (pthread_rwlock_init(&store->lock, NULL) != 0) {
+        free(store);
+        return NULL;
+    }
+
+    store->bank.quiet = 1;
+    initialize_product_bank(&store->bank);
+    store->indexes_ready = initialize_range_index(&store->prices, &store->bank, RANGE_BY_PRICE)
+                        && initialize_range_index(&store->quantities, &store->bank, RANGE_BY_QUANTITY);
+    if (!store->indexes_ready) {
+        log_message(LOG_WARNING, "mercado", "Consulta por faixa indisponivel");
+    }
+    if (!enable_bank_versions(&store->bank)) {
+        log_message(LOG_WARNING, "mercado", "Fotos do estoque indisponiveis");
+    }
+    initialize_movement_ledger(&store->ledger);
+    initialize_velocity_tracker(&store->velocity, VELOCITY_DEFAULT_HALF_LIFE_DAYS,
+                                VELOCITY_DEFAULT_HORIZON_DAYS);
+    attach_velocity_tracker(&store->ledger, &store->velocity);
+
+    if (store->options.load_saved && store->options.products_path
+        && data_file_exists(store->options.products_path)) {
+        restore_saved_state(&store->bank, &store->ledger, store->options.products_path,
+                            store->options.movements_path);
+    }
+    return store;
+}
+
+// libera o estoque
+void mercado_close(mercado_store *store) {
+    if (!store) return;
+    free_range_index(&store->prices);
+    free_range_index(&store->quantities);
+    forget_sorted_views(&store->bank);
+    disable_bank_versions(&store->bank);
+    free_movement_ledger(&store->ledger);
+    pthread_rwlock_destroy(&store->lock);
+    free(store);
+}
+
+// grava os arquivos (só lê o estado: é uma seção de leitura)
+int mercado_save(mercado_store *store) {
+    if (!store || !store->options.products_path) return 0;
+    mercado_begin_read(store);
+    int ok = save_products_to_file(&store->bank, store->options.products_path);
+    if (ok && store->options.movements_path) {
+        ok = save_movements_to_file(&store->ledger, store->options.movements_path);
+    }
+    mercado_end_read(store);
+    return ok;
+}
+
+// recarrega dos arquivos
+int mercado_load(mercado_store *store) {
+    if (!store || !store->options.products_path) return 0;
+    mercado_begin_write(store);
+    // fotos abertas leem páginas do banco que a carga vai trocar
+    versions_stats versions;
+    get_versions_stats(&store->bank, &versions);
+    if (versions.open_snapshots > 0) {
+        mercado_end_write(store);
+        log_message(LOG_WARNING, "mercado", "Recarga recusada: ha fotos do estoque abertas");
+        return 0;
+    }
+    // a nova inicialização do banco descarta as visões ordenadas guardadas
+    free_movement_ledger(&store->ledger);
+    initialize_product_bank(&store->bank);
+    int ok = restore_saved_state(&store->bank, &store->ledger, store->options.products_path,
+                                 store->options.movements_path);
+    mercado_end_write(store);
+    return ok;
+}
+
+// ============================================================================
+// OPERAÇÕES
+// ============================================================================
+
+// cadastra produto
+int mercado_register(mercado_store *store, const char *name, float price, int quantity,
+                     int minimum_stock, int category, int unit) {
+    if (!store) return -1;
+    mercado_begin_write(store);
+    int code = register_product(&store->bank, name, price, quantity, minimum_stock, category, unit);
+    mercado_end_write(store);
+    return code;
+}
+
+// importa produtos em lote: uma validação para o lote inteiro, cadastro das
+// linhas válidas sob uma única trava de escrita
+long mercado_import(mercado_store *store, const product_columns *columns,
+                    validation_report *report, int *codes) {
+    if (!store || !columns || !report || !columns->names || !columns->prices
+        || !columns->quantities || !columns->minimum_stocks || !columns->categories
+        || !columns->units) {
+        return -1;
+    }
+    if (!validate_product_columns(columns, report)) return -1;
+    if (codes) {
+        for (size_t row = 0; row < columns->count; row++) codes[row] = -1;
+    }
+
+    long registered = 0;
+    size_t bank_full = 0;                   // linhas válidas sem cadastro
+    mercado_begin_write(store);
+    size_t failing = next_validation_failure(report, VALIDATION_RULE_COUNT, 0);
+    for (size_t row = 0; row < columns->count; row++) {
+        // linhas com erro ficam de fora (já estão no relatório)
+        if (row == failing) {
+            failing = next_validation_failure(report, VALIDATION_RULE_COUNT, row + 1);
+            continue;
+        }
+        // linhas limpas já passaram pelas regras: cadastro sem repeti-las
+        int code = bank_full ? -1
+                 : register_validated_product(&store->bank, columns->names[row], columns->prices[row],
+                                              columns->quantities[row], columns->minimum_stocks[row],
+                                              columns->categories[row], columns->units[row]);
+        if (code < 0) {
+            bank_full++;
+            continue;
+        }
+        if (codes) codes[row] = code;
+        registered++;
+    }
+    mercado_end_write(store);
+
+    char message[200];
+    snprintf(message, sizeof(message),
+             "Importacao: %ld de %zu produtos cadastrados, %zu linhas com erro, %zu sem cadastro (banco cheio)",
+             registered, columns->count, report->invalid_count, bank_full);
+    log_message(report->invalid_count || bank_full ? LOG_WARNING : LOG_INFO, "mercado", message);
+    return registered;
+}
+
+// edita produto
+int mercado_update(mercado_store *store, int code, const char *name, float price, int quantity,
+                   int minimum_stock, int category, int unit) {
+    if (!store) return 0;
+    mercado_begin_write(store);
+    // alteração de quantidade é registrada como ajuste no livro, senão a
+    // reconstrução pelo livro (mercado_load, nova abertura) a desfaria
+    int quantity_ok = !is_valid_quantity(quantity)
+                   || set_product_quantity(&store->ledger, &store->bank, code, quantity);
+    int ok = update_product(&store->bank, code, name, price, minimum_stock, category, unit)
+          && quantity_ok;
+    mercado_end_write(store);
+    return ok;
+}
+
+// inativa produto
+int mercado_deactivate(mercado_store *store, int code) {
+    if (!store) return 0;
+    mercado_begin_write(store);
+    int ok = deactivate_product(&store->bank, code);
+    mercado_end_write(store);
+    return ok;
+}
+
+// reativa produto
+int mercado_activate(mercado_store *store, int code) {
+    if (!store) return 0;
+    mercado_begin_write(store);
+    int ok = activate_product(&store->bank, code);
+    if (ok) refresh_stockout_alert(&store->ledger, &store->bank, code);
+    mercado_end_write(store);
+    return ok;
+}
+
+// copia o produto
+int mercado_lookup(mercado_store *store, int code, product *out, int *available) {
+    if (!store || !out) return -1;
+    mercado_begin_read(store);
+    out->code = 0;
+    int status = read_product_snapshot(&store->bank, code, out);
+    if (out->code != code) {
+        status = -1;
+    } else if (available) {
+        // reservas são por posição: o disponível é lido no próprio banco
+        product *live = find_product_by_code(&store->bank, code);
+        *available = live ? available_quantity(&store->bank, live) : out->quantity;
+    }
+    mercado_end_read(store);
+    return status;
+}
+
+// registra movimentação
+int mercado_move(mercado_store *store, int code, movement_type type, int quantity,
+                 int *quantity_after) {
+    if (!store) return 0;
+    mercado_begin_write(store);
+    int ok = record_movement(&store->ledger, &store->bank, code, type, quantity);
+    if (ok && quantity_after) {
+        product item;
+        read_product_snapshot(&store->bank, code, &item);
+        *quantity_after = item.quantity;
+    }
+    mercado_end_write(store);
+    return ok;
+}
+
+// códigos por faixa de valor
+int mercado_range(mercado_store *store, range_field field, uint32_t low, uint32_t high,
+                  int out_codes[], size_t max_out) {
+    range_index *index = mercado_range_index(store, field);
+    if (!index || !out_codes) return -1;
+    mercado_begin_read(store);
+    range_cursor cursor;
+    int count = open_range(&cursor, index, low, high) ? 0 : -1;
+    listing_row rows[MERCADO_RANGE_PAGE];
+    while (count >= 0 && (size_t)count < max_out) {
+        size_t wanted = max_out - (size_t)count;
+        int got = next_range_page(&cursor, rows, wanted < MERCADO_RANGE_PAGE ? wanted : MERCADO_RANGE_PAGE);
+        if (got < 0) count = -1;
+        if (got <= 0) break;
+        for (int i = 0; i < got; i++) out_codes[count++] = rows[i].item.code;
+    }
+    mercado_end_read(store);
+    return count;
+}
+
+// abre foto (sem trava do handle: a foto não bloqueia escritores)
+int mercado_open_snapshot(mercado_store *store, bank_snapshot *snapshot) {
+    if (!store) return 0;
+    // seção de leitura: não abre no meio de uma recarga (modo de leitores e escritores)
+    mercado_begin_read(store);
+    int ok = open_bank_snapshot(&store->bank, snapshot);
+    mercado_end_read(store);
+    return ok;
+}
+
+// fecha foto
+void mercado_close_snapshot(mercado_store *store, bank_snapshot *snapshot) {
+    if (!store) return;
+    close_bank_snapshot(snapshot);
+}
+
+// ============================================================================
+// ACESSO AOS MÓDULOS
+// ============================================================================
+
+product_bank *mercado_bank(mercado_store *store) {
+    return store ? &store->bank : NULL;
+}
+
+movement_ledger *mercado_ledger(mercado_store *store) {
+    return store ? &store->ledger : NULL;
+}
+
+range_index *mercado_range_index(mercado_store *store, range_field field) {
+    if (!store || !store->indexes_ready) return NULL;
+    if (field == RANGE_BY_PRICE) return &store->prices;
+    if (field == RANGE_BY_QUANTITY) return &store->quantities;
+    return NULL;
+}
@@ -0,0 +1,573 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "movimentacao.h"
+#include "validation.h"
+#include "logger.h"
+
+// ============================================================================
+// MÓDULO: movimentacao — Implementação do livro de movimentações
+// ============================================================================
+// Registros ficam em blocos de tamanho fixo: anexar nunca realoca registros
+// existentes, apenas o array de ponteiros para blocos (raramente).
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// inicializa o livro vazio
+void initialize_movement_ledger(movement_ledger *ledger) {
+    if (!ledger) return;
+    memset(ledger, 0, sizeof(*ledger));
+}
+
+// libera blocos e índice de cadeias
+void free_movement_ledger(movement_ledger *ledger) {
+    if (!ledger) return;
+    for (size_t i = 0; i < ledger->chunk_count; i++) {
+        free(ledger->chunks[i]);
+    }
+    free(ledger->chunks);
+    for (int i = 0; i < ledger->retired_count; i++) {
+        free(ledger->retired[i]);
+    }
+    free(ledger->heads);
+    velocity_tracker *velocity = ledger->velocity;
+    initialize_movement_ledger(ledger);
+    ledger->velocity = velocity;
+}
+
+// associa acompanhamento de vendas
+void attach_velocity_tracker(movement_ledger *ledger, velocity_tracker *tracker) {
+    if (!ledger) return;
+    ledger->velocity = tracker;
+}
+
+// reavalia o alerta do produto reativado
+void refresh_stockout_alert(const movement_ledger *ledger, product_bank *bank, int code) {
+    if (!ledger || !ledger->velocity || !bank) return;
+    product *p = find_product_by_code(bank, code);
+    if (p) velocity_refresh(ledger->velocity, bank, p, (uint32_t)time(NULL));
+}
+
+// cresce, fora da trava, o que faltar para needed blocos e heads até
+// heads_needed - 1; dentro da trava só instala (cópias e trocas de ponteiros)
+// - chunk_count, chunk_capacity e head_capacity: valores lidos na trava
+// - retorna 0 se memória insuficiente
+static int grow_ledger(movement_ledger *ledger, size_t needed, size_t chunk_count,
+                       size_t chunk_capacity, size_t heads_needed, size_t head_capacity) {
+    int ok = 1;
+    movement_record **chunks = NULL;
+    size_t new_chunk_capacity = chunk_capacity;
+    if (needed > chunk_capacity) {
+        new_chunk_capacity = chunk_capacity ? chunk_capacity : 16;
+        while (new_chunk_capacity < needed) new_chunk_capacity *= 2;
+        chunks = malloc(new_chunk_capacity * sizeof(movement_record *));
+        ok = chunks != NULL;
+    }
+
+    size_t spare_count = needed > chunk_count ? needed - chunk_count : 0;
+    movement_record **spares = NULL;
+    if (ok && spare_count) {
+        spares = calloc(spare_count, sizeof(movement_record *));
+        ok = spares != NULL;
+        for (size_t i = 0; ok && i < spare_count; i++) {
+            spares[i] = malloc(MOVEMENT_CHUNK_SIZE * sizeof(movement_record));
+            ok = spares[i] != NULL;
+        }
+    }
+
+    // novas posições = MOVEMENT_NONE; as antigas são copiadas na instalação
+    uint32_t *heads = NULL;
+    size_t new_head_capacity = head_capacity;
+    if (ok && heads_needed > head_capacity) {
+        new_head_capacity = head_capacity ? head_capacity : 256;
+        while (new_head_capacity < heads_needed) new_head_capacity *= 2;
+        heads = malloc(new_head_capacity * sizeof(uint32_t));
+        ok = heads != NULL;
+        for (size_t i = head_capacity; ok && i < new_head_capacity; i++) heads[i] = MOVEMENT_NONE;
+    }
+
+    uint32_t *old_heads = NULL;
+    size_t used = 0;
+    if (ok) {
+        spin_lock_acquire(&ledger->lock);
+        // outra thread pode ter crescido antes: só instala o que ainda falta
+        if (chunks && new_chunk_capacity > ledger->chunk_capacity) {
+            if (ledger->retired_count == MOVEMENT_RETIRED_ARRAYS) {
+                ok = 0;
+            } else {
+                memcpy(chunks, ledger->chunks, ledger->chunk_count * sizeof(movement_record *));
+                if (ledger->chunks) ledger->retired[ledger->retired_count++] = ledger->chunks;
+                __atomic_store_n(&ledger->chunks, chunks, __ATOMIC_RELEASE);
+                ledger->chunk_capacity = new_chunk_capacity;
+                chunks = NULL;
+            }
+        }
+        while (used < spare_count && ledger->chunk_count < needed
+               && ledger->chunk_count < ledger->chunk_capacity) {
+            ledger->chunks[ledger->chunk_count++] = spares[used++];
+        }
+        if (heads && new_head_capacity > ledger->head_capacity) {
+            memcpy(heads, ledger->heads, ledger->head_capacity * sizeof(uint32_t));
+            old_heads = ledger->heads;
+            ledger->heads = heads;
+            ledger->head_capacity = new_head_capacity;
+            heads = NULL;
+        }
+        spin_lock_release(&ledger->lock);
+    }
+
+    free(chunks);
+    free(heads);
+    free(old_heads);
+    for (size_t i = used; spares && i < spare_count; i++) free(spares[i]);
+    free(spares);
+    return ok;
+}
+
+// adquire a trava do livro com espaço para mais count registros e heads
+// até code (o crescimento acontece fora dela); permite que um lote seja
+// anexado por inteiro ou não seja anexado
+// - retorna 1 com a trava adquirida, 0 (sem a trava) se limite de índices
+//   ou memória insuficiente
+static int acquire_with_space(movement_ledger *ledger, int code, uint32_t count) {
+    for (;;) {
+        spin_lock_acquire(&ledger->lock);
+        if (ledger->count > MOVEMENT_NONE - 1 - count) {   // limite de índices
+            spin_lock_release(&ledger->lock);
+            return 0;
+        }
+        size_t needed = ((size_t)ledger->count + count + MOVEMENT_CHUNK_SIZE - 1) / MOVEMENT_CHUNK_SIZE;
+        size_t heads_needed = (size_t)code + 1;
+        if (needed <= ledger->chunk_count && heads_needed <= ledger->head_capacity) return 1;
+
+        size_t chunk_count = ledger->chunk_count;
+        size_t chunk_capacity = ledger->chunk_capacity;
+        size_t head_capacity = ledger->head_capacity;
+        spin_lock_release(&ledger->lock);
+        if (!grow_ledger(ledger, needed, chunk_count, chunk_capacity, heads_needed, head_capacity)) {
+            return 0;
+        }
+    }
+}
+
+// anexa um registro já validado (espaço e heads devem estar reservados);
+// o chamador publica a nova contagem com publish_count
+static void append_record(movement_ledger *ledger, uint32_t index, int code, int delta,
+                          movement_type type, uint32_t batch, uint32_t timestamp) {
+    movement_record *r = &ledger->chunks[index / MOVEMENT_CHUNK_SIZE][index % MOVEMENT_CHUNK_SIZE];
+    r->code = code;
+    r->delta = delta;
+    r->prev = ledger->heads[code];
+    r->batch = batch;
+    r->timestamp = timestamp;
+    r->type = (uint8_t)type;
+    memset(r->reserved, 0, sizeof(r->reserved));
+    ledger->heads[code] = index;
+}
+
+// publica os registros anexados a leitores sem trava (gravação, envio)
+static void publish_count(movement_ledger *ledger, uint32_t count) {
+    __atomic_store_n(&ledger->count, count, __ATOMIC_RELEASE);
+}
+
+// verifica se o código ainda não tem nenhuma movimentação no livro
+static int needs_opening(const movement_ledger *ledger, int code) {
+    return code >= (int)ledger->head_capacity || ledger->heads[code] == MOVEMENT_NONE;
+}
+
+// calcula a variação com sinal correspondente ao tipo de movimentação
+// retorna 1 se a quantidade informada é coerente com o tipo
+static int movement_delta(movement_type type, int quantity, int *delta) {
+    switch (type) {
+        case MOVEMENT_IN:
+            *delta = quantity;
+            return quantity > 0;
+        case MOVEMENT_SALE:
+        case MOVEMENT_LOSS:
+            *delta = -quantity;
+            return quantity > 0;
+        case MOVEMENT_ADJUSTMENT:
+            *delta = quantity;
+            return quantity != 0;
+        default:
+            return 0;  // saldo inicial é gravado apenas internamente
+    }
+}
+
+// grava a movimentação já validada (chamada com a trava do livro adquirida
+// por acquire_with_space para 2 registros; a trava é liberada antes de
+// retornar e os avisos saem depois dela)
+static int record_locked(movement_ledger *ledger, product_bank *bank, product *p, int code,
+                         movement_type type, int quantity, int delta, uint32_t now) {
+    // venda não pode consumir estoque reservado; perdas e ajustes podem
+    // (refletem o estoque físico)
+    int previous;
+    if ((type == MOVEMENT_SALE && quantity > available_quantity(bank, p))
+        || !apply_quantity_delta(bank, p, delta, &previous)) {
+        spin_lock_release(&ledger->lock);
+        log_message(LOG_WARNING, "movimentacao", "Estoque insuficiente ou acima do limite");
+        return 0;
+    }
+
+    // primeira movimentação do produto: grava também o saldo inicial
+    uint32_t index = ledger->count;
+    if (needs_opening(ledger, code)) {
+        append_record(ledger, index++, code, previous, MOVEMENT_OPENING, 0, now);
+    }
+    append_record(ledger, index++, code, delta, type, 0, now);
+    publish_count(ledger, index);
+    spin_lock_release(&ledger->lock);
+
+    publish_quantity_change(bank, p);
+    // métricas de venda: O(1) por movimentação (trava própria do acompanhamento)
+    if (ledger->velocity) {
+        if (type == MOVEMENT_SALE) {
+            velocity_record_sale(ledger->velocity, bank, p, quantity, now);
+        } else {
+            velocity_refresh(ledger->velocity, bank, p, now);
+        }
+    }
+    return 1;
+}
+
+// registra movimentação e aplica a variação à quantidade do produto
+int record_movement(movement_ledger *ledger, product_bank *bank, int code,
+                    movement_type type, int quantity) {
+    if (!ledger || !bank) return 0;
+
+    int delta;
+    if (!movement_delta(type, quantity, &delta)) {
+        log_message(LOG_WARNING, "movimentacao", "Quantidade invalida para o tipo de movimentacao");
+        return 0;
+    }
+
+    product *p = find_product_by_code(bank, code);
+    if (!p) {
+        log_message(LOG_WARNING, "movimentacao", "Produto nao encontrado para movimentacao");
+        return 0;
+    }
+
+    uint32_t now = (uint32_t)time(NULL);
+    prepare_product_change(bank, p);
+    if (!acquire_with_space(ledger, code, 2)) {
+        log_message(LOG_ERROR, "movimentacao", "Memoria insuficiente para o livro de movimentacoes");
+        return 0;
+    }
+    return record_locked(ledger, bank, p, code, type, quantity, delta, now);
+}
+
+// edição de quantidade: registra como ajuste a diferença para new_quantity
+int set_product_quantity(movement_ledger *ledger, product_bank *bank, int code, int new_quantity) {
+    if (!ledger || !bank || new_quantity < 0 || new_quantity > MAX_QUANTITY) return 0;
+    product *p = find_product_by_code(bank, code);
+    if (!p) {
+        log_message(LOG_WARNING, "movimentacao", "Produto nao encontrado para movimentacao");
+        return 0;
+    }
+
+    uint32_t now = (uint32_t)time(NULL);
+    prepare_product_change(bank, p);
+    if (!acquire_with_space(ledger, code, 2)) {
+        log_message(LOG_ERROR, "movimentacao", "Memoria insuficiente para o livro de movimentacoes");
+        return 0;
+    }
+    // diferença calculada dentro da trava: vendas registradas entre a leitura
+    // do chamador e a edição não se perdem
+    int current = __atomic_load_n(&p->quantity, __ATOMIC_RELAXED);
+    if (new_quantity == current) {
+        spin_lock_release(&ledger->lock);
+        return 1;
+    }
+    // o estoque reservado precisa continuar coberto
+    if (new_quantity < __atomic_load_n(&bank->reserved[p - bank->list], __ATOMIC_RELAXED)) {
+        spin_lock_release(&ledger->lock);
+        log_message(LOG_WARNING, "movimentacao", "Quantidade abaixo do estoque reservado");
+        return 0;
+    }
+    return record_locked(ledger, bank, p, code, MOVEMENT_ADJUSTMENT, new_quantity - current,
+                         new_quantity - current, now);
+}
+
+// finaliza a venda de uma cesta inteira (tudo ou nada)
+uint32_t checkout_basket(movement_ledger *ledger, product_bank *bank,
+                         const basket_item *items, size_t item_count, int *failed_item) {
+    if (failed_item) *failed_item = -1;
+    if (!ledger || !bank || !items || item_count == 0 || item_count > CHECKOUT_MAX_ITEMS) {
+        return 0;
+    }
+
+    // ordena os índices dos itens por código (cesta pequena: inserção direta)
+    int order[CHECKOUT_MAX_ITEMS];
+    for (size_t i = 0; i < item_count; i++) {
+        if (items[i].quantity <= 0) {
+            if (failed_item) *failed_item = (int)i;
+            return 0;
+        }
+        size_t j = i;
+        while (j > 0 && items[order[j - 1]].code > items[i].code) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = (int)i;
+    }
+
+    // agrupa itens repetidos: um total por código distinto
+    int codes[CHECKOUT_MAX_ITEMS];
+    long long totals[CHECKOUT_MAX_ITEMS];
+    int first_item[CHECKOUT_MAX_ITEMS];
+    size_t distinct = 0;
+    for (size_t i = 0; i < item_count; i++) {
+        const basket_item *item = &items[order[i]];
+        if (distinct > 0 && codes[distinct - 1] == item->code) {
+            totals[distinct - 1] += item->quantity;
+            continue;
+        }
+        codes[distinct] = item->code;
+        totals[distinct] = item->quantity;
+        first_item[distinct] = order[i];
+        distinct++;
+    }
+
+    // cópias para fotos abertas antes da trava (os produtos são resolvidos
+    // de novo dentro dela: podem ter sido inativados no meio)
+    product *found[CHECKOUT_MAX_ITEMS];
+    find_products_by_codes(bank, codes, distinct, found);
+    for (size_t d = 0; d < distinct; d++) {
+        if (found[d]) prepare_product_change(bank, found[d]);
+    }
+
+    // espaço para o lançamento inteiro, com saldo inicial de todos os códigos
+    // (códigos em ordem: o último é o maior)
+    uint32_t now = (uint32_t)time(NULL);
+    if (!acquire_with_space(ledger, codes[distinct - 1], (uint32_t)distinct * 2)) {
+        log_message(LOG_ERROR, "movimentacao", "Memoria insuficiente para o livro de movimentacoes");
+        return 0;
+    }
+
+    // confere todas as linhas antes de alterar qualquer produto: toda
+    // alteração de quantidade passa por esta trava, então as baixas abaixo
+    // não falham e leitores sem trava nunca veem uma cesta pela metade
+    find_products_by_codes(bank, codes, distinct, found);
+    for (size_t d = 0; d < distinct; d++) {
+        if (!found[d] || totals[d] > available_quantity(bank, found[d])) {
+            spin_lock_release(&ledger->lock);
+            if (failed_item) *failed_item = first_item[d];
+            log_message(LOG_WARNING, "movimentacao", "Checkout recusado: produto inexistente ou sem estoque");
+            return 0;
+        }
+    }
+
+    // baixa cada produto atomicamente (sem tocar no estoque reservado)
+    int previous[CHECKOUT_MAX_ITEMS];
+    for (size_t d = 0; d < distinct; d++) {
+        apply_quantity_delta(bank, found[d], (int)-totals[d], &previous[d]);
+    }
+
+    // grava todas as baixas como um único lançamento
+    uint32_t batch = ++ledger->last_batch;
+    uint32_t index = ledger->count;
+    for (size_t d = 0; d < distinct; d++) {
+        if (needs_opening(ledger, codes[d])) {
+            append_record(ledger, index++, codes[d], previous[d], MOVEMENT_OPENING, batch, now);
+        }
+        append_record(ledger, index++, codes[d], (int)-totals[d], MOVEMENT_SALE, batch, now);
+    }
+    publish_count(ledger, index);
+    spin_lock_release(&ledger->lock);
+
+    for (size_t d = 0; d < distinct; d++) {
+        publish_quantity_change(bank, found[d]);
+        if (ledger->velocity) {
+            velocity_record_sale(ledger->velocity, bank, found[d], (int)totals[d], now);
+        }
+    }
+    return batch;
+}
+
+// anexa registros lidos de arquivo refazendo as cadeias
+int append_loaded_movements(movement_ledger *ledger, const movement_record *records,
+                            size_t count) {
+    if (!ledger || (!records && count > 0) || count > MOVEMENT_NONE) return 0;
+
+    // códigos conferidos antes: o lote é anexado inteiro ou não é anexado
+    int max_code = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (records[i].code < MIN_CODE || records[i].code > MAX_CODE) return 0;
+        if (records[i].code > max_code) max_code = records[i].code;
+    }
+    if (!acquire_with_space(ledger, max_code, (uint32_t)count)) return 0;
+    uint32_t index = ledger->count;
+    for (size_t i = 0; i < count; i++) {
+        const movement_record *r = &records[i];
+        append_record(ledger, index++, r->code, r->delta, (movement_type)r->type, r->batch, r->timestamp);
+        if (r->batch > ledger->last_batch) {
+            ledger->last_batch = r->batch;
+        }
+    }
+    publish_count(ledger, index);
+    spin_lock_release(&ledger->lock);
+    return 1;
+}
+
+// posição do produto no banco
+static size_t slot_of(const product_bank *bank, const product *p) {
+    return (size_t)(p - bank->list);
+}
+
+// reserva estoque disponível sem retirá-lo do estoque
+int hold_stock(movement_ledger *ledger, product_bank *bank, int code, int quantity) {
+    if (!ledger || !bank || quantity <= 0) return 0;
+    product *p = find_product_by_code(bank, code);
+    if (!p) return 0;
+
+    // mesma trava das vendas: reserva e venda nunca disputam a mesma unidade
+    spin_lock_acquire(&ledger->lock);
+    int ok = quantity <= available_quantity(bank, p);
+    if (ok) {
+        __atomic_fetch_add(&bank->reserved[slot_of(bank, p)], quantity, __ATOMIC_ACQ_REL);
+    }
+    spin_lock_release(&ledger->lock);
+    if (ok) mark_product_changed(bank, p->category);
+    return ok;
+}
+
+// desfaz uma reserva (expiração ou cancelamento)
+void release_held_stock(product_bank *bank, int code, int quantity) {
+    if (!bank || quantity <= 0) return;
+    product *p = find_product_by_code(bank, code);
+    if (!p) {
+        // produto inativado com reserva pendente: procura entre os inativos
+        for (int i = 0; i < bank->count; i++) {
+            if (bank->list[i].code == code) {
+                p = &bank->list[i];
+                break;
+            }
+        }
+        if (!p) return;
+    }
+    __atomic_fetch_sub(&bank->reserved[slot_of(bank, p)], quantity, __ATOMIC_ACQ_REL);
+    mark_product_changed(bank, p->category);
+}
+
+// confirma a reserva como venda: baixa o estoque e grava no livro
+int commit_held_stock(movement_ledger *ledger, product_bank *bank, int code, int quantity) {
+    if (!ledger || !bank || quantity <= 0) return 0;
+    product *p = find_product_by_code(bank, code);
+    if (!p) return 0;
+
+    uint32_t now = (uint32_t)time(NULL);
+    prepare_product_change(bank, p);
+    int previous;
+    if (!acquire_with_space(ledger, code, 2)) {
+        log_message(LOG_ERROR, "movimentacao", "Nao foi possivel confirmar a reserva");
+        return 0;
+    }
+    if (!apply_quantity_delta(bank, p, -quantity, &previous)) {
+        spin_lock_release(&ledger->lock);
+        log_message(LOG_ERROR, "movimentacao", "Nao foi possivel confirmar a reserva");
+        return 0;
+    }
+    __atomic_fetch_sub(&bank->reserved[slot_of(bank, p)], quantity, __ATOMIC_ACQ_REL);
+
+    uint32_t index = ledger->count;
+    if (needs_opening(ledger, code)) {
+        append_record(ledger, index++, code, previous, MOVEMENT_OPENING, 0, now);
+    }
+    append_record(ledger, index++, code, -quantity, MOVEMENT_SALE, 0, now);
+    publish_count(ledger, index);
+    spin_lock_release(&ledger->lock);
+
+    publish_quantity_change(bank, p);
+    if (ledger->velocity) {
+        velocity_record_sale(ledger->velocity, bank, p, quantity, now);
+    }
+    return 1;
+}
+
+// recalcula métricas de venda a partir do histórico completo
+void rebuild_sales_velocity(const movement_ledger *ledger, const product_bank *bank) {
+    if (!ledger || !bank || !ledger->velocity) return;
+    velocity_tracker *tracker = ledger->velocity;
+    reset_velocity_tracker(tracker);
+
+    for (uint32_t i = 0; i < ledger->count; i++) {
+        const movement_record *r = &ledger->chunks[i / MOVEMENT_CHUNK_SIZE][i % MOVEMENT_CHUNK_SIZE];
+        if (r->type != MOVEMENT_SALE) continue;
+        const product *p = find_product_by_code((product_bank *)bank, r->code);
+        if (p) {
+            velocity_record_sale(tracker, bank, p, -r->delta, r->timestamp);
+        }
+    }
+
+    // reavalia todos com a quantidade atual (após a reconstrução do estoque)
+    uint32_t now = (uint32_t)time(NULL);
+    for (int i = 0; i < bank->count; i++) {
+        velocity_refresh(tracker, bank, &bank->list[i], now);
+    }
+}
+
+// localiza o registro (chamador deve segurar a trava do livro)
+static const movement_record *record_at(const movement_ledger *ledger, uint32_t index) {
+    return &ledger->chunks[index / MOVEMENT_CHUNK_SIZE][index % MOVEMENT_CHUNK_SIZE];
+}
+
+// retorna o registro na posição index
+const movement_record *get_movement(const movement_ledger *ledger, uint32_t index) {
+    if (!ledger) return NULL;
+    spin_lock *lock = (spin_lock *)&ledger->lock;
+    spin_lock_acquire(lock);
+    const movement_record *r = index < ledger->count ? record_at(ledger, index) : NULL;
+    spin_lock_release(lock);
+    return r;
+}
+
+// copia registros consecutivos (bloco a bloco, dentro da trava)
+size_t copy_movements(const movement_ledger *ledger, uint32_t first,
+                      movement_record *out_array, size_t max_out) {
+    if (!ledger || !out_array) return 0;
+    spin_lock *lock = (spin_lock *)&ledger->lock;
+    spin_lock_acquire(lock);
+    size_t copied = 0;
+    while (copied < max_out && first < ledger->count) {
+        size_t offset = first % MOVEMENT_CHUNK_SIZE;
+        size_t length = MOVEMENT_CHUNK_SIZE - offset;
+        if (length > ledger->count - first) length = ledger->count - first;
+        if (length > max_out - copied) length = max_out - copied;
+        memcpy(&out_array[copied], &ledger->chunks[first / MOVEMENT_CHUNK_SIZE][offset],
+               length * sizeof(movement_record));
+        copied += length;
+        first += (uint32_t)length;
+    }
+    spin_lock_release(lock);
+    return copied;
+}
+
+// lista histórico do produto seguindo a cadeia (mais recente primeiro)
+int list_product_movements(const movement_ledger *ledger, int code,
+                           const movement_record *out_array[], size_t max_out) {
+    if (!ledger || !out_array || code < 0) return 0;
+
+    spin_lock *lock = (spin_lock *)&ledger->lock;
+    spin_lock_acquire(lock);
+    int count = 0;
+    uint32_t index = code < (int)ledger->head_capacity ? ledger->heads[code] : MOVEMENT_NONE;
+    while (index != MOVEMENT_NONE && count < (int)max_out) {
+        const movement_record *r = record_at(ledger, index);
+        out_array[count++] = r;
+        index = r->prev;
+    }
+    spin_lock_release(lock);
+    return count;
+}
+
+// converte tipo de movimentação para string amigável
+const char *movement_type_to_string(int type) {
+    switch (type) {
+        case MOVEMENT_OPENING: return "Saldo inicial";
+        case MOVEMENT_IN: return "Entrada";
+        case MOVEMENT_SALE: return "Venda";
+        case MOVEMENT_LOSS: return "Perda";
+        case MOVEMENT_ADJUSTMENT: return "Ajuste";
+        default: return "Desconhecida";
+    }
+}
@@ -0,0 +1,310 @@
+#include <stdlib.h>
+#include <string.h>
+#include "mvcc.h"
+#include "logger.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+    #define yield_thread() SwitchToThread()
+#else
+    #include <sched.h>
+    #define yield_thread() sched_yield()
+#endif
+
+// ============================================================================
+// MÓDULO: mvcc — Implementação das leituras por versão
+// ============================================================================
+// Protocolo entre fotos e escritores:
+// - o escritor soma 1 ao contador da sua época, lê newest_open e, se a página
+//   ainda não tem cópia para essa foto, copia antes de alterar
+// - a foto publica sua versão em newest_open, troca a época e espera os
+//   escritores da época anterior terminarem: quem leu newest_open antes da
+//   publicação já terminou; quem leu depois copia a página
+// - a cópia para a versão V só é feita depois dessa espera (clock = V), para
+//   não copiar uma página no meio de uma alteração anterior à foto; o
+//   escritor que chega antes sai do contador, espera e recomeça
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// versão a partir da qual as cópias refletem o banco da foto mais nova
+static uint64_t ready_version(const bank_versions *versions) {
+    return __atomic_load_n(&versions->clock, __ATOMIC_ACQUIRE);
+}
+
+// cópia mais velha da página ainda válida para a versão (NULL = ler o banco)
+static const page_version *find_page_version(const bank_versions *versions, int page,
+                                             uint64_t version) {
+    const page_version *found = NULL;
+    const page_version *node = __atomic_load_n(&versions->heads[page], __ATOMIC_ACQUIRE);
+    while (node && node->version >= version) {
+        found = node;
+        node = __atomic_load_n(&node->older, __ATOMIC_ACQUIRE);
+    }
+    return found;
+}
+
+// copia a página antes da primeira alteração depois da foto newest
+// (chamada só quando a foto newest já está pronta)
+static void preserve_page(bank_versions *versions, int page, uint64_t newest) {
+    spin_lock *lock = &versions->page_locks[page % MVCC_PAGE_LOCKS];
+    spin_lock_acquire(lock);
+    if (versions->saved[page] < newest) {
+        page_version *node = malloc(sizeof(page_version));
+        if (!node) {
+            spin_lock_release(lock);
+            log_message(LOG_ERROR, "mvcc", "Memoria insuficiente para copiar pagina: foto aberta pode ver alteracoes novas");
+            return;
+        }
+        int first = page * MVCC_PAGE_PRODUCTS;
+        int length = MAX_PRODUCTS - first < MVCC_PAGE_PRODUCTS ? MAX_PRODUCTS - first : MVCC_PAGE_PRODUCTS;
+        node->version = newest;
+        node->older = versions->heads[page];
+        node->next_retired = NULL;
+        node->retired_at = 0;
+        memcpy(node->items, &versions->bank->list[first], (size_t)length * sizeof(product));
+        __atomic_store_n(&versions->heads[page], node, __ATOMIC_RELEASE);
+        __atomic_store_n(&versions->saved[page], newest, __ATOMIC_RELEASE);
+        __atomic_fetch_add(&versions->pages_copied, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&versions->pages_retained, 1, __ATOMIC_RELAXED);
+    }
+    spin_lock_release(lock);
+}
+
+// ============================================================================
+// ESCRITORES
+// ============================================================================
+
+// antes de alterar a posição slot
+unsigned versions_write_begin(bank_versions *versions, int slot) {
+    unsigned lane = (unsigned)slot % MVCC_WRITER_LANES;
+    int page = slot / MVCC_PAGE_PRODUCTS;
+    for (;;) {
+        unsigned parity = __atomic_load_n(&versions->epoch, __ATOMIC_SEQ_CST) & 1u;
+        writer_lane *counter = &versions->lanes[parity][lane];
+        __atomic_fetch_add(&counter->in_flight, 1, __ATOMIC_SEQ_CST);
+
+        uint64_t newest = __atomic_load_n(&versions->newest_open, __ATOMIC_SEQ_CST);
+        if (!newest || __atomic_load_n(&versions->saved[page], __ATOMIC_ACQUIRE) >= newest) {
+            return parity * MVCC_WRITER_LANES + lane;
+        }
+        if (ready_version(versions) >= newest) {
+            preserve_page(versions, page, newest);
+            return parity * MVCC_WRITER_LANES + lane;
+        }
+        // a foto newest pode estar esperando justamente este contador: sai
+        // dele (nada foi alterado ainda), espera a foto ficar pronta e repete
+        __atomic_fetch_sub(&counter->in_flight, 1, __ATOMIC_SEQ_CST);
+        while (ready_version(versions) < newest) yield_thread();
+    }
+}
+
+// cópia antecipada: mesmo protocolo de uma alteração vazia (o chamador não
+// segura nenhuma trava, então pode esperar aqui a foto ficar pronta)
+void versions_prepare_write(bank_versions *versions, int slot) {
+    versions_write_end(versions, versions_write_begin(versions, slot));
+}
+
+// depois da alteração
+void versions_write_end(bank_versions *versions, unsigned token) {
+    writer_lane *lane = &versions->lanes[token / MVCC_WRITER_LANES][token % MVCC_WRITER_LANES];
+    __atomic_fetch_sub(&lane->in_flight, 1, __ATOMIC_SEQ_CST);
+}
+
+// troca a época e espera os escritores da anterior
+static void wait_for_writers(bank_versions *versions) {
+    unsigned parity = __atomic_fetch_add(&versions->epoch, 1, __ATOMIC_SEQ_CST) & 1u;
+    for (int lane = 0; lane < MVCC_WRITER_LANES; lane++) {
+        while (__atomic_load_n(&versions->lanes[parity][lane].in_flight, __ATOMIC_SEQ_CST) != 0) {
+            yield_thread();
+        }
+    }
+}
+
+// ============================================================================
+// LIMPEZA
+// ============================================================================
+
+// desliga as cópias que nenhuma foto aberta alcança e libera as que nenhuma
+// foto pode estar lendo (chamada com versions->lock)
+static void collect_versions(bank_versions *versions) {
+    uint64_t oldest = UINT64_MAX;
+    for (int i = 0; i < versions->open_count; i++) {
+        if (versions->open_versions[i] < oldest) oldest = versions->open_versions[i];
+    }
+
+    // a foto de versão V lê a cópia mais velha com version >= V: cópias com
+    // version < oldest não servem a nenhuma foto aberta
+    for (int page = 0; page < MVCC_PAGE_COUNT; page++) {
+        if (!__atomic_load_n(&versions->heads[page], __ATOMIC_ACQUIRE)) continue;
+        spin_lock *lock = &versions->page_locks[page % MVCC_PAGE_LOCKS];
+        spin_lock_acquire(lock);
+        page_version *keep = NULL;
+        page_version *node = versions->heads[page];
+        while (node && node->version >= oldest) {
+            keep = node;
+            node = node->older;
+        }
+        if (node) {
+            if (keep) {
+                __atomic_store_n(&keep->older, NULL, __ATOMIC_RELEASE);
+            } else {
+                __atomic_store_n(&versions->heads[page], NULL, __ATOMIC_RELEASE);
+            }
+        }
+        spin_lock_release(lock);
+        // fotos abertas ainda podem estar percorrendo a parte desligada
+        while (node) {
+            page_version *older = node->older;
+            node->retired_at = versions->clock;
+            node->next_retired = versions->retired;
+            versions->retired = node;
+            node = older;
+        }
+    }
+
+    // só fotos de versão <= retired_at podiam alcançar a cópia desligada
+    page_version **link = &versions->retired;
+    while (*link) {
+        page_version *node = *link;
+        if (node->retired_at < oldest) {
+            *link = node->next_retired;
+            free(node);
+            __atomic_fetch_sub(&versions->pages_retained, 1, __ATOMIC_RELAXED);
+        } else {
+            link = &node->next_retired;
+        }
+    }
+}
+
+// ============================================================================
+// ATIVAÇÃO
+// ============================================================================
+
+// ativa as versões
+int enable_bank_versions(product_bank *bank) {
+    if (!bank) return 0;
+    if (bank->versions) return 1;
+    bank_versions *versions = calloc(1, sizeof(bank_versions));
+    if (!versions) {
+        log_message(LOG_ERROR, "mvcc", "Memoria insuficiente para as versoes do banco");
+        return 0;
+    }
+    versions->bank = bank;
+    __atomic_store_n(&bank->versions, versions, __ATOMIC_RELEASE);
+    return 1;
+}
+
+// desativa e libera
+void disable_bank_versions(product_bank *bank) {
+    if (!bank || !bank->versions) return;
+    bank_versions *versions = bank->versions;
+    __atomic_store_n(&bank->versions, NULL, __ATOMIC_RELEASE);
+    versions->open_count = 0;
+    collect_versions(versions);
+    free(versions);
+}
+
+// ============================================================================
+// FOTOS
+// ============================================================================
+
+// abre foto
+int open_bank_snapshot(product_bank *bank, bank_snapshot *snapshot) {
+    if (!bank || !snapshot || !bank->versions) return 0;
+    bank_versions *versions = bank->versions;
+    spin_lock_acquire(&versions->lock);
+    if (versions->open_count >= MVCC_MAX_SNAPSHOTS) {
+        spin_lock_release(&versions->lock);
+        log_message(LOG_WARNING, "mvcc", "Limite de fotos abertas do banco atingido");
+        return 0;
+    }
+    uint64_t version = versions->clock + 1;
+    versions->open_versions[versions->open_count++] = version;
+    __atomic_store_n(&versions->newest_open, version, __ATOMIC_SEQ_CST);
+    wait_for_writers(versions);
+    // a partir daqui as páginas já podem ser copiadas para esta versão
+    __atomic_store_n(&versions->clock, version, __ATOMIC_RELEASE);
+
+    snapshot->versions = versions;
+    snapshot->version = version;
+    snapshot->count = __atomic_load_n(&bank->count, __ATOMIC_ACQUIRE);
+    snapshot->position = 0;
+    collect_versions(versions);
+    spin_lock_release(&versions->lock);
+    return 1;
+}
+
+// fecha foto
+void close_bank_snapshot(bank_snapshot *snapshot) {
+    if (!snapshot || !snapshot->versions) return;
+    bank_versions *versions = snapshot->versions;
+    spin_lock_acquire(&versions->lock);
+    uint64_t newest = 0;
+    for (int i = 0; i < versions->open_count; i++) {
+        if (versions->open_versions[i] == snapshot->version) {
+            versions->open_versions[i--] = versions->open_versions[--versions->open_count];
+            continue;
+        }
+        if (versions->open_versions[i] > newest) newest = versions->open_versions[i];
+    }
+    __atomic_store_n(&versions->newest_open, newest, __ATOMIC_SEQ_CST);
+    collect_versions(versions);
+    spin_lock_release(&versions->lock);
+    snapshot->versions = NULL;
+}
+
+// produto da posição na versão da foto
+int read_snapshot_product_at(const bank_snapshot *snapshot, int slot, product *out) {
+    if (!snapshot || !snapshot->versions || !out || slot < 0 || slot >= snapshot->count) return -1;
+    const bank_versions *versions = snapshot->versions;
+    int page = slot / MVCC_PAGE_PRODUCTS;
+    for (;;) {
+        const page_version *node = find_page_version(versions, page, snapshot->version);
+        if (node) {
+            *out = node->items[slot % MVCC_PAGE_PRODUCTS];
+            return out->active;
+        }
+        // sem cópia: lê o banco; se uma cópia apareceu no meio, a alteração
+        // pode já estar no banco e a leitura é refeita na cópia
+        read_product_at(versions->bank, slot, out);
+        if (!find_page_version(versions, page, snapshot->version)) return out->active;
+    }
+}
+
+// produto pelo código na versão da foto (códigos nunca mudam de posição)
+int read_snapshot_product(const bank_snapshot *snapshot, int code, product *out) {
+    if (!snapshot || !snapshot->versions) return -1;
+    const product *list = snapshot->versions->bank->list;
+    int low = 0, high = snapshot->count;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (list[mid].code < code) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low >= snapshot->count || list[low].code != code) return -1;
+    return read_snapshot_product_at(snapshot, low, out);
+}
+
+// próximo ativo da foto
+int next_snapshot_product(bank_snapshot *snapshot, product *out) {
+    if (!snapshot) return 0;
+    while (snapshot->position < snapshot->count) {
+        if (read_snapshot_product_at(snapshot, snapshot->position++, out) == 1) return 1;
+    }
+    return 0;
+}
+
+// números das versões
+void get_versions_stats(const product_bank *bank, versions_stats *out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (!bank || !bank->versions) return;
+    const bank_versions *versions = bank->versions;
+    out->open_snapshots = versions->open_count;
+    out->pages_copied = __atomic_load_n(&versions->pages_copied, __ATOMIC_RELAXED);
+    out->pages_retained = __atomic_load_n(&versions->pages_retained, __ATOMIC_RELAXED);
+    out->bytes_retained = out->pages_retained * sizeof(page_version);
+}
@@ -0,0 +1,504 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "name_index.h"
+#include "logger.h"
+#include "utils.h"
+
+// ============================================================================
+// MÓDULO: name_index — Implementação do índice de trigramas
+// ============================================================================
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// maior quantidade de trigramas extraídos de um texto
+#define NAME_MAX_TRIGRAMS 128
+// maior texto de consulta considerado (bytes)
+#define NAME_QUERY_MAX_LENGTH 128
+// capacidade inicial de uma lista de posições
+#define POSTING_INITIAL_CAPACITY 4
+
+// ============================================================================
+// TRIGRAMAS
+// ============================================================================
+
+// símbolo de um byte do texto normalizado
+// - retorna 0 para separadores, -1 para bytes de continuação UTF-8 (ignorados)
+static int symbol_of(unsigned char c) {
+    if (c >= 'a' && c <= 'z') return 1 + (c - 'a');
+    if (c >= '0' && c <= '9') return 27 + (c - '0');
+    if ((c & 0xC0) == 0x80) return -1;
+    if (c >= 0xC0) return TRIGRAM_SYMBOLS - 1;  // letra fora do Latin-1 básico
+    return 0;
+}
+
+// acrescenta um trigrama (se couber)
+static void emit_trigram(int *out, int *count, int a, int b, int c) {
+    if (*count < NAME_MAX_TRIGRAMS) {
+        out[(*count)++] = (a * TRIGRAM_SYMBOLS + b) * TRIGRAM_SYMBOLS + c;
+    }
+}
+
+// extrai os trigramas distintos de um texto já normalizado, em ordem crescente
+// - retorna quantidade de trigramas em out
+static int folded_trigrams(const char *folded, int length, int out[NAME_MAX_TRIGRAMS]) {
+    // cada palavra vira "  p", " pa", ..., "ra " (dois espaços antes, um depois)
+    int count = 0, first = 0, second = 0, in_word = 0;
+    for (int i = 0; i < length; i++) {
+        int symbol = symbol_of((unsigned char)folded[i]);
+        if (symbol < 0) continue;
+        if (symbol == 0) {
+            if (in_word) emit_trigram(out, &count, first, second, 0);
+            in_word = 0;
+            continue;
+        }
+        if (!in_word) {
+            first = second = 0;
+            in_word = 1;
+        }
+        emit_trigram(out, &count, first, second, symbol);
+        first = second;
+        second = symbol;
+    }
+    if (in_word) emit_trigram(out, &count, first, second, 0);
+
+    // ordena (poucos elementos) e remove repetidos
+    for (int i = 1; i < count; i++) {
+        int value = out[i], j = i - 1;
+        while (j >= 0 && out[j] > value) {
+            out[j + 1] = out[j];
+            j--;
+        }
+        out[j + 1] = value;
+    }
+    int unique = 0;
+    for (int i = 0; i < count; i++) {
+        if (unique == 0 || out[unique - 1] != out[i]) out[unique++] = out[i];
+    }
+    return unique;
+}
+
+// normaliza o texto digitado e extrai seus trigramas
+static int extract_trigrams(const char *text, size_t max_length, int out[NAME_MAX_TRIGRAMS]) {
+    char folded[NAME_QUERY_MAX_LENGTH + 1];
+    if (max_length > NAME_QUERY_MAX_LENGTH) max_length = NAME_QUERY_MAX_LENGTH;
+    return folded_trigrams(folded, fold_text(text, max_length, folded), out);
+}
+
+// trigramas do nome atual de uma posição (chave já normalizada no banco)
+// - retorna quantidade de trigramas, ou -1 se a posição está fora do banco
+static int slot_trigrams(const product_bank *bank, int slot, int out[NAME_MAX_TRIGRAMS]) {
+    name_key key;
+    if (read_name_key_at(bank, slot, &key) < 0) return -1;
+    return folded_trigrams(key.text, key.length, out);
+}
+
+// quantidade de trigramas em comum entre duas listas ordenadas
+static int common_trigrams(const int *a, int a_count, const int *b, int b_count) {
+    int i = 0, j = 0, common = 0;
+    while (i < a_count && j < b_count) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (a[i] > b[j]) {
+            j++;
+        } else {
+            common++;
+            i++;
+            j++;
+        }
+    }
+    return common;
+}
+
+// ============================================================================
+// MANUTENÇÃO DO ÍNDICE (chamada com a trava do índice)
+// ============================================================================
+
+// acrescenta a posição à lista
+static int append_posting(posting_list *list, int slot) {
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : POSTING_INITIAL_CAPACITY;
+        int *slots = realloc(list->slots, (size_t)capacity * sizeof(int));
+        if (!slots) return 0;
+        list->slots = slots;
+        list->capacity = capacity;
+    }
+    list->slots[list->count++] = slot;
+    return 1;
+}
+
+// garante arrays por posição para slot_count posições
+static int reserve_slots(name_index *index, int slot_count) {
+    if (slot_count <= index->scratch_capacity) return 1;
+    int capacity = index->scratch_capacity ? index->scratch_capacity : 1024;
+    while (capacity < slot_count) capacity *= 2;
+
+    unsigned char *counts = realloc(index->trigram_counts, (size_t)capacity);
+    if (!counts) return 0;
+    index->trigram_counts = counts;
+    unsigned char *hits = realloc(index->hits, (size_t)capacity);
+    if (!hits) return 0;
+    // posições novas começam zeradas; as antigas já voltaram a zero
+    memset(hits + index->scratch_capacity, 0, (size_t)(capacity - index->scratch_capacity));
+    index->hits = hits;
+    int *touched = realloc(index->touched, (size_t)capacity * sizeof(int));
+    if (!touched) return 0;
+    index->touched = touched;
+    int *candidates = realloc(index->candidates, (size_t)capacity * sizeof(int));
+    if (!candidates) return 0;
+    index->candidates = candidates;
+    index->scratch_capacity = capacity;
+    return 1;
+}
+
+// acrescenta às listas as entradas do nome atual de uma posição
+// - retorna quantidade de entradas, -1 se memória insuficiente ou -2 se a
+//   posição está fora do banco
+static int post_slot(const product_bank *bank, posting_list *lists, int slot) {
+    int trigrams[NAME_MAX_TRIGRAMS];
+    int count = slot_trigrams(bank, slot, trigrams);
+    if (count < 0) return -2;
+    for (int i = 0; i < count; i++) {
+        if (!append_posting(&lists[trigrams[i]], slot)) return -1;
+    }
+    return count;
+}
+
+// indexa o nome atual de uma posição
+// - retorna quantidade de entradas acrescentadas, ou -1 se memória insuficiente
+static int index_slot(name_index *index, int slot) {
+    if (!reserve_slots(index, slot + 1)) return -1;
+    int count = post_slot(index->bank, index->lists, slot);
+    if (count == -2) return 0;
+    if (count < 0) return -1;
+    index->trigram_counts[slot] = (unsigned char)count;
+    index->postings += count;
+    return count;
+}
+
+// indexa as posições cadastradas desde a última atualização
+static int catch_up(name_index *index) {
+    int total = __atomic_load_n(&index->bank->count, __ATOMIC_ACQUIRE);
+    while (index->indexed_count < total) {
+        if (index_slot(index, index->indexed_count) < 0) return 0;
+        index->indexed_count++;
+    }
+    return 1;
+}
+
+// libera listas de posições
+static void free_lists(posting_list *lists) {
+    if (!lists) return;
+    for (int t = 0; t < TRIGRAM_COUNT; t++) free(lists[t].slots);
+    free(lists);
+}
+
+// ============================================================================
+// RECONSTRUÇÃO (listas montadas fora da trava e trocadas sob ela)
+// ============================================================================
+
+// listas montadas à parte
+typedef struct {
+    posting_list *lists;
+    unsigned char *trigram_counts;
+    int indexed_count;
+    long long postings;
+} index_build;
+
+// indexa as posições [0, total) em listas novas (sem a trava do índice)
+// - retorna 1 se sucesso, 0 se memória insuficiente (nada fica alocado)
+static int build_index(const product_bank *bank, int total, index_build *build) {
+    memset(build, 0, sizeof(*build));
+    build->lists = calloc(TRIGRAM_COUNT, sizeof(posting_list));
+    build->trigram_counts = malloc((size_t)(total > 0 ? total : 1));
+    if (!build->lists || !build->trigram_counts) {
+        free_lists(build->lists);
+        free(build->trigram_counts);
+        return 0;
+    }
+    for (int slot = 0; slot < total; slot++) {
+        int count = post_slot(bank, build->lists, slot);
+        if (count == -1) {
+            free_lists(build->lists);
+            free(build->trigram_counts);
+            return 0;
+        }
+        if (count < 0) count = 0;
+        build->trigram_counts[slot] = (unsigned char)count;
+        build->postings += count;
+    }
+    build->indexed_count = total;
+    return 1;
+}
+
+// reconstrói o índice se estiver marcado
+// - a montagem corre fora da trava; só a troca das listas (e a reaplicação
+//   das renomeações ocorridas no meio) é feita com ela
+// - com outra reconstrução em curso, segue com as listas atuais
+// - retorna 1 se sucesso, 0 se memória insuficiente
+static int refresh_index(name_index *index) {
+    spin_lock_acquire(&index->lock);
+    int total = __atomic_load_n(&index->bank->count, __ATOMIC_ACQUIRE);
+    int start = index->needs_rebuild && !index->rebuilding;
+    if (start) {
+        index->needs_rebuild = 0;
+        index->rebuilding = 1;
+        index->rebuild_count = total;
+        index->renamed_count = 0;
+    }
+    spin_lock_release(&index->lock);
+    if (!start) return 1;
+
+    double started_at = monotonic_seconds();
+    index_build build;
+    int built = build_index(index->bank, total, &build);
+
+    spin_lock_acquire(&index->lock);
+    index->rebuilding = 0;
+    if (!built || !reserve_slots(index, total)) {
+        index->needs_rebuild = 1;
+        spin_lock_release(&index->lock);
+        if (built) {
+            free_lists(build.lists);
+            free(build.trigram_counts);
+        }
+        return 0;
+    }
+    posting_list *old_lists = index->lists;
+    index->lists = build.lists;
+    memcpy(index->trigram_counts, build.trigram_counts, (size_t)total);
+    index->indexed_count = total;
+    index->postings = build.postings;
+    index->stale_postings = 0;
+    for (int i = 0; i < index->renamed_count && !index->needs_rebuild; i++) {
+        int added = index_slot(index, index->renamed[i]);
+        if (added < 0) index->needs_rebuild = 1;
+        else index->stale_postings += added;
+    }
+    index->renamed_count = 0;
+    long long postings = index->postings;
+    spin_lock_release(&index->lock);
+
+    free_lists(old_lists);
+    free(build.trigram_counts);
+    char message[120];
+    snprintf(message, sizeof(message), "Indice de nomes reconstruido: %d produtos, %lld entradas, %.3f s",
+             total, postings, monotonic_seconds() - started_at);
+    log_message(LOG_INFO, "name_index", message);
+    return 1;
+}
+
+// aviso de alteração de nome vindo do banco
+static void on_name_changed(void *context, int slot, int fields) {
+    (void)fields;
+    name_index *index = context;
+    spin_lock_acquire(&index->lock);
+    if (slot < 0) {
+        index->needs_rebuild = 1;
+    } else if (index->rebuilding) {
+        // a montagem em curso pode ter lido o nome antigo: reaplicado na troca
+        // (cadastros além dela entram depois, por catch_up)
+        if (slot < index->rebuild_count) {
+            if (index->renamed_count < NAME_PENDING_RENAMES) index->renamed[index->renamed_count++] = slot;
+            else index->needs_rebuild = 1;
+        }
+    } else if (!index->needs_rebuild) {
+        if (slot >= index->indexed_count) {
+            // cadastro: entra com os demais ainda não indexados
+            if (!catch_up(index)) index->needs_rebuild = 1;
+        } else {
+            // renomeação: o nome novo entra; o antigo vira entrada obsoleta
+            int added = index_slot(index, slot);
+            if (added < 0) {
+                index->needs_rebuild = 1;
+            } else {
+                index->stale_postings += added;
+                if (index->stale_postings * 4 > index->postings) index->needs_rebuild = 1;
+            }
+        }
+    }
+    spin_lock_release(&index->lock);
+}
+
+// ============================================================================
+// RESULTADOS (heap limitado: a raiz é o pior resultado guardado)
+// ============================================================================
+
+// verifica se a é melhor que b (cobertura, semelhança e, por fim, código)
+static int better_match(const name_match *a, const name_match *b) {
+    if (a->score != b->score) return a->score > b->score;
+    if (a->similarity != b->similarity) return a->similarity > b->similarity;
+    return a->item.code < b->item.code;
+}
+
+// desce o elemento i no heap de n elementos
+static void sift_down(name_match *heap, int n, int i) {
+    while (1) {
+        int worst = i, left = 2 * i + 1, right = left + 1;
+        if (left < n && better_match(&heap[worst], &heap[left])) worst = left;
+        if (right < n && better_match(&heap[worst], &heap[right])) worst = right;
+        if (worst == i) return;
+        name_match swap = heap[i];
+        heap[i] = heap[worst];
+        heap[worst] = swap;
+        i = worst;
+    }
+}
+
+// oferece um resultado ao heap
+static void offer_match(name_match *heap, int *count, int limit, const name_match *match) {
+    if (*count < limit) {
+        // sobe o novo elemento enquanto for pior que o pai
+        int i = (*count)++;
+        heap[i] = *match;
+        while (i > 0) {
+            int parent = (i - 1) / 2;
+            if (!better_match(&heap[parent], &heap[i])) break;
+            name_match swap = heap[i];
+            heap[i] = heap[parent];
+            heap[parent] = swap;
+            i = parent;
+        }
+    } else if (better_match(match, &heap[0])) {
+        heap[0] = *match;
+        sift_down(heap, *count, 0);
+    }
+}
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// cria o índice
+int initialize_name_index(name_index *index, product_bank *bank) {
+    if (!index || !bank) return 0;
+    memset(index, 0, sizeof(*index));
+    index->lists = calloc(TRIGRAM_COUNT, sizeof(posting_list));
+    if (!index->lists) {
+        log_message(LOG_ERROR, "name_index", "Memoria insuficiente para o indice de nomes");
+        return 0;
+    }
+    if (!add_product_listener(bank, PRODUCT_FIELD_NAME, on_name_changed, index)) {
+        free(index->lists);
+        index->lists = NULL;
+        return 0;
+    }
+    index->bank = bank;
+    index->needs_rebuild = 1;
+    return 1;
+}
+
+// libera o índice
+void free_name_index(name_index *index) {
+    if (!index || !index->lists) return;
+    remove_product_listener(index->bank, on_name_changed, index);
+    free_lists(index->lists);
+    free(index->trigram_counts);
+    free(index->hits);
+    free(index->touched);
+    free(index->candidates);
+    memset(index, 0, sizeof(*index));
+}
+
+// busca aproximada
+int search_product_names(name_index *index, const char *query, name_match out[], int limit) {
+    if (!index || !index->bank || !query || !out || limit <= 0) return -1;
+    if (limit > NAME_SEARCH_MAX_RESULTS) limit = NAME_SEARCH_MAX_RESULTS;
+
+    int query_trigrams[NAME_MAX_TRIGRAMS];
+    int query_count = extract_trigrams(query, NAME_QUERY_MAX_LENGTH, query_trigrams);
+    if (query_count == 0) return 0;
+
+    int ready = refresh_index(index);
+    spin_lock_acquire(&index->lock);
+    // durante uma reconstrução as listas atuais vão ser trocadas: os
+    // cadastros novos entram depois da troca
+    if (ready && !index->rebuilding) ready = catch_up(index);
+    if (!ready) {
+        spin_lock_release(&index->lock);
+        log_message(LOG_ERROR, "name_index", "Memoria insuficiente para buscar nomes");
+        return -1;
+    }
+
+    // mínimo de trigramas em comum e quantas listas (as mais curtas) bastam
+    int required = (int)ceil(query_count * NAME_SEARCH_MIN_COVERAGE);
+    if (required < 1) required = 1;
+    int scanned = query_count - required + 1;
+
+    int order[NAME_MAX_TRIGRAMS];
+    for (int i = 0; i < query_count; i++) {
+        int value = query_trigrams[i], j = i - 1;
+        while (j >= 0 && index->lists[order[j]].count > index->lists[value].count) {
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = value;
+    }
+
+    // conta em quantas das listas percorridas cada posição aparece
+    int touched_count = 0;
+    for (int i = 0; i < scanned; i++) {
+        const posting_list *list = &index->lists[order[i]];
+        for (int k = 0; k < list->count; k++) {
+            int slot = list->slots[k];
+            if (index->hits[slot] == 0) index->touched[touched_count++] = slot;
+            if (index->hits[slot] < 255) index->hits[slot]++;
+        }
+    }
+
+    // candidatos do que mais apareceu para o que menos apareceu
+    int bucket_start[NAME_MAX_TRIGRAMS + 2] = { 0 };
+    for (int i = 0; i < touched_count; i++) {
+        int hits = index->hits[index->touched[i]];
+        if (hits > scanned) hits = scanned;
+        bucket_start[scanned - hits + 1]++;
+    }
+    for (int b = 1; b <= scanned + 1; b++) bucket_start[b] += bucket_start[b - 1];
+    for (int i = 0; i < touched_count; i++) {
+        int slot = index->touched[i];
+        int hits = index->hits[slot] > scanned ? scanned : index->hits[slot];
+        index->candidates[bucket_start[scanned - hits]++] = slot;
+    }
+
+    int found = 0;
+    for (int i = 0; i < touched_count; i++) {
+        int slot = index->candidates[i];
+        int hits = index->hits[slot] > scanned ? scanned : index->hits[slot];
+
+        // melhor caso: presente também em todas as listas não percorridas
+        int best_common = hits + query_count - scanned;
+        double best_case = (double)best_common / query_count;
+        if (found == limit) {
+            if (best_case < out[0].score) break;
+            // mesma cobertura: só interessa se a semelhança puder ser maior
+            int name_count = index->trigram_counts[slot];
+            if (best_common > name_count) best_common = name_count;
+            double best_similarity = (double)best_common / (query_count + name_count - best_common);
+            if (best_case == out[0].score && best_similarity < out[0].similarity) continue;
+        }
+
+        name_match match;
+        if (read_product_at(index->bank, slot, &match.item) != 1) continue;
+        int trigrams[NAME_MAX_TRIGRAMS];
+        int count = slot_trigrams(index->bank, slot, trigrams);
+        if (count < 0) continue;
+        int common = common_trigrams(query_trigrams, query_count, trigrams, count);
+        if (common < required) continue;
+
+        match.score = (double)common / query_count;
+        match.similarity = (double)common / (query_count + count - common);
+        offer_match(out, &found, limit, &match);
+    }
+
+    for (int i = 0; i < touched_count; i++) index->hits[index->touched[i]] = 0;
+    spin_lock_release(&index->lock);
+
+    // ordena no lugar: retira o pior da raiz e o coloca no fim
+    for (int n = found - 1; n > 0; n--) {
+        name_match swap = out[0];
+        out[0] = out[n];
+        out[n] = swap;
+        sift_down(out, n, 0);
+    }
+    return found;
+}
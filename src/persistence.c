@@ -27,35 +27,45 @@ int save_products_to_file(const product_bank *bank, const char *file_path) {
         return 0;
     }
 
-    FILE *file = fopen(file_path, "wb");
-    if (!file) {
-        log_message(LOG_ERROR, "persistence", "Nao foi possivel abrir arquivo para escrita");
-        return 0;
-    }
-
-    // escreve cabecalho
+    // o banco pode estar em uso (vendas, cadastros): contagem e proximo
+    // codigo sao lidos juntos na trava de cadastro, e cada produto e copiado
+    // pelo seqlock da sua faixa; o arquivo e escrito a partir da copia
     file_header header;
     header.version = FILE_FORMAT_VERSION;
+    spin_lock *register_lock = (spin_lock *)&bank->register_lock;
+    spin_lock_acquire(register_lock);
     header.product_count = bank->count;
     header.next_code = bank->next_code;
+    spin_lock_release(register_lock);
 
-    if (fwrite(&header, sizeof(file_header), 1, file) != 1) {
-        log_message(LOG_ERROR, "persistence", "Erro ao escrever cabecalho");
-        fclose(file);
+    product *items = malloc((header.product_count ? (size_t)header.product_count : 1) * sizeof(product));
+    if (!items) {
+        log_message(LOG_ERROR, "persistence", "Memoria insuficiente para salvar produtos");
         return 0;
     }
+    for (int i = 0; i < header.product_count; i++) {
+        read_product_at(bank, i, &items[i]);
+    }
 
-    // escreve array de produtos
-    if (bank->count > 0) {
-        size_t written = fwrite(bank->list, sizeof(product), bank->count, file);
-        if (written != (size_t)bank->count) {
-            log_message(LOG_ERROR, "persistence", "Erro ao escrever produtos");
-            fclose(file);
-            return 0;
-        }
+    FILE *file = fopen(file_path, "wb");
+    if (!file) {
+        free(items);
+        log_message(LOG_ERROR, "persistence", "Nao foi possivel abrir arquivo para escrita");
+        return 0;
     }
 
+    // escreve cabecalho e array de produtos
+    int ok = fwrite(&header, sizeof(file_header), 1, file) == 1;
+    if (!ok) {
+        log_message(LOG_ERROR, "persistence", "Erro ao escrever cabecalho");
+    } else if (header.product_count > 0
+               && fwrite(items, sizeof(product), header.product_count, file) != (size_t)header.product_count) {
+        log_message(LOG_ERROR, "persistence", "Erro ao escrever produtos");
+        ok = 0;
+    }
+    free(items);
     fclose(file);
+    if (!ok) return 0;
     log_message(LOG_INFO, "persistence", "Dados salvos com sucesso");
     return 1;
 }
@@ -108,12 +118,188 @@ int load_products_from_file(product_bank *bank, const char *file_path) {
     // atualiza contadores do banco
     bank->count = header.product_count;
     bank->next_code = header.next_code;
+    refresh_name_keys(bank);
+    mark_product_changed(bank, -1);
+    notify_product_changed(bank, -1, PRODUCT_FIELD_ALL);
 
     fclose(file);
     log_message(LOG_INFO, "persistence", "Dados carregados com sucesso");
     return 1;
 }
 
+// cabecalho do arquivo de movimentacoes
+typedef struct {
+    int version;            // versao do formato
+    int record_size;        // sizeof(movement_record), detecta layout diferente
+    unsigned record_count;  // quantidade de registros salvos
+    unsigned last_batch;    // ultimo identificador de lancamento
+} movements_header;
+
+// salva livro de movimentacoes em arquivo binario
+int save_movements_to_file(const movement_ledger *ledger, const char *file_path) {
+    if (!ledger || !file_path) {
+        log_message(LOG_ERROR, "persistence", "Parametros invalidos para salvar movimentacoes");
+        return 0;
+    }
+
+    FILE *file = fopen(file_path, "wb");
+    if (!file) {
+        log_message(LOG_ERROR, "persistence", "Nao foi possivel abrir arquivo de movimentacoes para escrita");
+        return 0;
+    }
+
+    // contagem e array de blocos lidos na trava do livro: registros abaixo da
+    // contagem nao mudam mais, e o array lido continua valido mesmo que o
+    // livro cresca durante a gravacao (arrays trocados so saem em
+    // free_movement_ledger)
+    movements_header header;
+    header.version = MOVEMENTS_FORMAT_VERSION;
+    header.record_size = (int)sizeof(movement_record);
+    spin_lock *lock = (spin_lock *)&ledger->lock;
+    spin_lock_acquire(lock);
+    header.record_count = ledger->count;
+    header.last_batch = ledger->last_batch;
+    movement_record *const *chunks = ledger->chunks;
+    spin_lock_release(lock);
+
+    if (fwrite(&header, sizeof(movements_header), 1, file) != 1) {
+        log_message(LOG_ERROR, "persistence", "Erro ao escrever cabecalho de movimentacoes");
+        fclose(file);
+        return 0;
+    }
+
+    // escreve bloco a bloco (registros de um bloco sao contiguos)
+    size_t remaining = header.record_count;
+    for (size_t c = 0; remaining > 0; c++) {
+        size_t n = remaining < MOVEMENT_CHUNK_SIZE ? remaining : MOVEMENT_CHUNK_SIZE;
+        if (fwrite(chunks[c], sizeof(movement_record), n, file) != n) {
+            log_message(LOG_ERROR, "persistence", "Erro ao escrever movimentacoes");
+            fclose(file);
+            return 0;
+        }
+        remaining -= n;
+    }
+
+    fclose(file);
+    log_message(LOG_INFO, "persistence", "Movimentacoes salvas com sucesso");
+    return 1;
+}
+
+// carrega livro de movimentacoes do arquivo binario
+int load_movements_from_file(movement_ledger *ledger, const char *file_path) {
+    if (!ledger || !file_path) {
+        log_message(LOG_ERROR, "persistence", "Parametros invalidos para carregar movimentacoes");
+        return 0;
+    }
+
+    FILE *file = fopen(file_path, "rb");
+    if (!file) {
+        log_message(LOG_WARNING, "persistence", "Arquivo de movimentacoes nao encontrado");
+        return 0;
+    }
+
+    movements_header header;
+    if (fread(&header, sizeof(movements_header), 1, file) != 1) {
+        log_message(LOG_ERROR, "persistence", "Erro ao ler cabecalho de movimentacoes");
+        fclose(file);
+        return 0;
+    }
+
+    if (header.version != MOVEMENTS_FORMAT_VERSION || header.record_size != (int)sizeof(movement_record)) {
+        log_message(LOG_ERROR, "persistence", "Versao de arquivo de movimentacoes incompativel");
+        fclose(file);
+        return 0;
+    }
+
+    // le em blocos do tamanho dos blocos do livro
+    movement_record *buffer = malloc(MOVEMENT_CHUNK_SIZE * sizeof(movement_record));
+    if (!buffer) {
+        log_message(LOG_ERROR, "persistence", "Memoria insuficiente para carregar movimentacoes");
+        fclose(file);
+        return 0;
+    }
+
+    size_t remaining = header.record_count;
+    while (remaining > 0) {
+        size_t n = remaining < MOVEMENT_CHUNK_SIZE ? remaining : MOVEMENT_CHUNK_SIZE;
+        if (fread(buffer, sizeof(movement_record), n, file) != n) {
+            log_message(LOG_ERROR, "persistence", "Erro ao ler movimentacoes");
+            break;
+        }
+        if (!append_loaded_movements(ledger, buffer, n)) {
+            log_message(LOG_ERROR, "persistence", "Arquivo de movimentacoes corrompido");
+            break;
+        }
+        remaining -= n;
+    }
+
+    free(buffer);
+    fclose(file);
+    if (remaining > 0) {
+        return 0;
+    }
+    if (header.last_batch > ledger->last_batch) {
+        ledger->last_batch = header.last_batch;
+    }
+
+    log_message(LOG_INFO, "persistence", "Movimentacoes carregadas com sucesso");
+    return 1;
+}
+
+// abre arquivo de dados para leitura em fluxo
+int open_snapshot_reader(snapshot_reader *reader, const char *file_path) {
+    if (!reader || !file_path) {
+        log_message(LOG_ERROR, "persistence", "Parametros invalidos para leitura em fluxo");
+        return 0;
+    }
+    reader->file = fopen(file_path, "rb");
+    if (!reader->file) {
+        log_message(LOG_WARNING, "persistence", "Arquivo de dados nao encontrado");
+        return 0;
+    }
+
+    file_header header;
+    if (fread(&header, sizeof(file_header), 1, reader->file) != 1
+        || header.version != FILE_FORMAT_VERSION || header.product_count < 0) {
+        log_message(LOG_ERROR, "persistence", "Cabecalho de arquivo invalido ou versao incompativel");
+        fclose(reader->file);
+        reader->file = NULL;
+        return 0;
+    }
+
+    reader->product_count = header.product_count;
+    reader->next_code = header.next_code;
+    reader->remaining = header.product_count;
+    reader->filled = 0;
+    reader->position = 0;
+    return 1;
+}
+
+// le proximo produto (um bloco do arquivo por vez)
+int read_next_snapshot_product(snapshot_reader *reader, product *out) {
+    if (!reader || !reader->file || !out) return -1;
+    if (reader->position == reader->filled) {
+        if (reader->remaining == 0) return 0;
+        int n = reader->remaining < SNAPSHOT_READ_BATCH ? reader->remaining : SNAPSHOT_READ_BATCH;
+        if (fread(reader->batch, sizeof(product), (size_t)n, reader->file) != (size_t)n) {
+            log_message(LOG_ERROR, "persistence", "Arquivo de dados truncado");
+            return -1;
+        }
+        reader->remaining -= n;
+        reader->filled = n;
+        reader->position = 0;
+    }
+    *out = reader->batch[reader->position++];
+    return 1;
+}
+
+// fecha leitura em fluxo
+void close_snapshot_reader(snapshot_reader *reader) {
+    if (!reader || !reader->file) return;
+    fclose(reader->file);
+    reader->file = NULL;
+}
+
 // verifica se arquivo existe
 int data_file_exists(const char *file_path) {
     if (!file_path) return 0;
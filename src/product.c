@@ -1,80 +1,254 @@
 #include <stdio.h>
 #include <string.h>
 #include "product.h"
+#include "mvcc.h"
+#include "utils.h"
 #include "validation.h"
 
-// inicializa o banco de produtos: zera contagem e códigos automáticos
+// bancos já inicializados no processo (base das gerações de cada banco)
+static uint64_t bank_epochs = 0;
+
+// inicializa o banco de produtos: zera contagem, travas e códigos automáticos
 void initialize_product_bank(product_bank *bank) {
     if (!bank) return;
-    memset(bank->list, 0, sizeof(bank->list));
-    bank->count = 0;
+    // os ouvintes sobrevivem à reinicialização (ex.: recarga do arquivo)
+    product_listener listeners[BANK_MAX_LISTENERS];
+    int listener_count = bank->listener_count;
+    int quiet = bank->quiet;
+    struct bank_versions *versions = bank->versions;
+    memcpy(listeners, bank->listeners, sizeof(listeners));
+
+    memset(bank, 0, sizeof(*bank));
     bank->next_code = 1;
+
+    // cada inicialização começa as gerações em uma faixa própria
+    bank->epoch = __atomic_add_fetch(&bank_epochs, 1, __ATOMIC_RELAXED);
+    uint64_t epoch = bank->epoch << 32;
+    bank->generation = epoch;
+    for (int c = 0; c <= CATEGORY_OTHERS; c++) {
+        bank->category_generations[c] = epoch;
+    }
+
+    memcpy(bank->listeners, listeners, sizeof(listeners));
+    bank->listener_count = listener_count;
+    bank->quiet = quiet;
+    bank->versions = versions;
+    notify_product_changed(bank, -1, PRODUCT_FIELD_ALL);
 }
 
-// cadastra novo produto, retorna 1 se sucesso, 0 se erro de validação ou cheio
-int register_product(product_bank *bank, const char *name, float price, int quantity, int minimum_stock, int category, int unit) {
-    if (!bank || !name) return 0;
-    if (bank->count >= MAX_PRODUCTS) {
-        printf("Limite máximo de produtos atingido.\n");
-        return 0;
+// registra ouvinte
+int add_product_listener(product_bank *bank, int fields,
+                         void (*on_change)(void *context, int slot, int fields), void *context) {
+    if (!bank || !on_change || bank->listener_count >= BANK_MAX_LISTENERS) return 0;
+    product_listener *listener = &bank->listeners[bank->listener_count++];
+    listener->on_change = on_change;
+    listener->context = context;
+    listener->fields = fields;
+    return 1;
+}
+
+// remove ouvinte
+void remove_product_listener(product_bank *bank,
+                             void (*on_change)(void *context, int slot, int fields), void *context) {
+    if (!bank) return;
+    for (int i = 0; i < bank->listener_count; i++) {
+        product_listener *listener = &bank->listeners[i];
+        if (listener->on_change == on_change && listener->context == context) {
+            *listener = bank->listeners[--bank->listener_count];
+            return;
+        }
+    }
+}
+
+// avisa ouvintes interessados
+void notify_product_changed(product_bank *bank, int slot, int fields) {
+    if (!bank) return;
+    for (int i = 0; i < bank->listener_count; i++) {
+        product_listener *listener = &bank->listeners[i];
+        if (listener->fields & fields) listener->on_change(listener->context, slot, fields);
+    }
+}
+
+// mensagem ao operador (omitida no modo silencioso)
+static void say(const product_bank *bank, const char *message) {
+    if (!bank || !bank->quiet) printf("%s\n", message);
+}
+
+// avisa as leituras por versão antes de alterar um produto já publicado
+static unsigned begin_change(product_bank *bank, const product *p) {
+    return bank->versions ? versions_write_begin(bank->versions, (int)(p - bank->list)) : 0;
+}
+
+// encerra o aviso de begin_change
+static void end_change(product_bank *bank, unsigned token) {
+    if (bank->versions) versions_write_end(bank->versions, token);
+}
+
+// posição da categoria no array de gerações
+static int category_slot(int category) {
+    return category >= CATEGORY_FOOD && category <= CATEGORY_OTHERS ? category : 0;
+}
+
+// avança as gerações depois de uma alteração (publica a alteração aos leitores)
+void mark_product_changed(product_bank *bank, int category) {
+    if (!bank) return;
+    if (category < 0) {
+        for (int c = 0; c <= CATEGORY_OTHERS; c++) {
+            __atomic_fetch_add(&bank->category_generations[c], 1, __ATOMIC_RELEASE);
+        }
+    } else {
+        __atomic_fetch_add(&bank->category_generations[category_slot(category)], 1, __ATOMIC_RELEASE);
     }
+    __atomic_fetch_add(&bank->generation, 1, __ATOMIC_RELEASE);
+}
+
+// geração global
+uint64_t bank_generation(const product_bank *bank) {
+    return bank ? __atomic_load_n(&bank->generation, __ATOMIC_ACQUIRE) : 0;
+}
+
+// geração de uma categoria
+uint64_t category_generation(const product_bank *bank, int category) {
+    if (!bank) return 0;
+    return __atomic_load_n(&bank->category_generations[category_slot(category)], __ATOMIC_ACQUIRE);
+}
+
+// quantidade de produtos publicada (leitura segura com cadastros concorrentes)
+static int published_count(const product_bank *bank) {
+    return __atomic_load_n(&bank->count, __ATOMIC_ACQUIRE);
+}
+
+// seqlock da faixa à qual o produto pertence
+static seq_lock *stripe_of(const product_bank *bank, const product *p) {
+    size_t slot = (size_t)(p - bank->list);
+    return (seq_lock *)&bank->stripes[slot % BANK_LOCK_STRIPES];
+}
+
+// normaliza o nome uma única vez para a chave de comparação
+static void compute_name_key(const char *name, name_key *key) {
+    char folded[PRODUCT_NAME_MAX_LENGTH + 1];
+    int length = fold_text(name, PRODUCT_NAME_MAX_LENGTH - 1, folded);
+    memcpy(key->text, folded, (size_t)length + 1);
+    key->length = (unsigned char)length;
+}
+
+// cadastra novo produto, retorna o código, ou -1 se erro de validação ou cheio
+int register_product(product_bank *bank, const char *name, float price, int quantity, int minimum_stock, int category, int unit) {
+    if (!bank || !name) return -1;
     // valida todos os campos
     if (!is_valid_name_format(name)) {
-        printf("Nome do produto inválido.\n");
-        return 0;
+        say(bank, "Nome do produto inválido.");
+        return -1;
     }
     if (!is_valid_price(price)) {
-        printf("Preço inválido.\n");
-        return 0;
+        say(bank, "Preço inválido.");
+        return -1;
     }
     if (!is_valid_quantity(quantity)) {
-        printf("Quantidade inválida.\n");
-        return 0;
+        say(bank, "Quantidade inválida.");
+        return -1;
     }
     if (!is_valid_minimum_stock(minimum_stock, quantity)) {
-        printf("Estoque mínimo inválido.\n");
-        return 0;
+        say(bank, "Estoque mínimo inválido.");
+        return -1;
     }
     if (!is_valid_category(category)) {
-        printf("Categoria inválida.\n");
-        return 0;
+        say(bank, "Categoria inválida.");
+        return -1;
     }
     if (!is_valid_unit(unit)) {
-        printf("Unidade de medida inválida.\n");
-        return 0;
+        say(bank, "Unidade de medida inválida.");
+        return -1;
+    }
+    return register_validated_product(bank, name, price, quantity, minimum_stock, category, unit);
+}
+
+// cadastra produto já validado (ex.: linhas limpas de validate_product_columns)
+int register_validated_product(product_bank *bank, const char *name, float price, int quantity,
+                               int minimum_stock, int category, int unit) {
+    if (!bank || !name) return -1;
+    // cadastros são serializados; o produto só fica visível aos leitores
+    // quando count é publicado, já com todos os campos preenchidos
+    spin_lock_acquire(&bank->register_lock);
+    if (bank->count >= MAX_PRODUCTS) {
+        spin_lock_release(&bank->register_lock);
+        say(bank, "Limite máximo de produtos atingido.");
+        return -1;
     }
     // preenche o novo produto
-    product *p = &bank->list[bank->count];
+    int slot = bank->count;
+    product *p = &bank->list[slot];
     p->code = bank->next_code++;
     strncpy(p->name, name, sizeof(p->name) - 1);
     p->name[sizeof(p->name) - 1] = '\0';
+    compute_name_key(p->name, &bank->name_keys[slot]);
     p->price = price;
     p->quantity = quantity;
     p->minimum_stock = minimum_stock;
     p->category = category;
     p->unit = unit;
     p->active = 1;
-    bank->count++;
-    printf("Produto cadastrado com sucesso!\n");
-    return 1;
+    int code = p->code;
+    __atomic_store_n(&bank->count, bank->count + 1, __ATOMIC_RELEASE);
+    spin_lock_release(&bank->register_lock);
+    mark_product_changed(bank, category);
+    notify_product_changed(bank, slot, PRODUCT_FIELD_ALL);
+    say(bank, "Produto cadastrado com sucesso!");
+    return code;
 }
 
-// busca produto pelo código
+// busca binária do código no intervalo [low, bank->count)
+// retorna a posição do primeiro produto com código >= code
+static int lower_bound_by_code(const product_bank *bank, int low, int code) {
+    int high = published_count(bank);
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (bank->list[mid].code < code) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// busca produto pelo código (list é ordenado por código)
 product *find_product_by_code(product_bank *bank, int code) {
     if (!bank) return NULL;
-    for (int i = 0; i < bank->count; ++i) {
-        if (bank->list[i].active && bank->list[i].code == code) {
-            return &bank->list[i];
-        }
+    int i = lower_bound_by_code(bank, 0, code);
+    if (i < published_count(bank) && bank->list[i].active && bank->list[i].code == code) {
+        return &bank->list[i];
     }
     return NULL;
 }
 
+// busca vários produtos com códigos em ordem crescente
+int find_products_by_codes(product_bank *bank, const int codes[], size_t count,
+                           product *out_array[]) {
+    if (!bank || !codes || !out_array) return 0;
+    int found = 0;
+    int position = 0;
+    int total = published_count(bank);
+    for (size_t k = 0; k < count; k++) {
+        // cada busca começa onde a anterior parou
+        position = lower_bound_by_code(bank, position, codes[k]);
+        product *p = NULL;
+        if (position < total && bank->list[position].code == codes[k]
+            && bank->list[position].active) {
+            p = &bank->list[position];
+            found++;
+        }
+        out_array[k] = p;
+    }
+    return found;
+}
+
 // lista produtos ativos (até max_out)
 int list_active_products(const product_bank *bank, product *out_array[], size_t max_out) {
     if (!bank || !out_array) return 0;
     int count = 0;
-    for (int i = 0; i < bank->count && count < (int)max_out; ++i) {
+    int total = published_count(bank);
+    for (int i = 0; i < total && count < (int)max_out; ++i) {
         if (bank->list[i].active) {
             out_array[count++] = (product *)&bank->list[i];
         }
@@ -83,58 +257,250 @@ int list_active_products(const product_bank *bank, product *out_array[], size_t
 }
 
 // edita produto identificado pelo código
-int update_product(product_bank *bank, int code, const char *new_name, float new_price, int new_quantity, int new_minimum_stock, int new_category, int new_unit) {
+int update_product(product_bank *bank, int code, const char *new_name, float new_price, int new_minimum_stock, int new_category, int new_unit) {
     product *p = find_product_by_code(bank, code);
     if (!p) {
-        printf("Produto não encontrado.\n");
+        say(bank, "Produto não encontrado.");
         return 0;
     }
+    // edição completa: exclusiva na faixa; leitores repetem se pegarem no meio
+    int old_category = p->category;
+    int changed_fields = 0;
+    seq_lock *stripe = stripe_of(bank, p);
+    unsigned change = begin_change(bank, p);
+    seq_lock_write_begin(stripe);
     if (new_name && is_valid_name_format(new_name)) {
+        if (strncmp(p->name, new_name, sizeof(p->name) - 1) != 0) changed_fields |= PRODUCT_FIELD_NAME;
         strncpy(p->name, new_name, sizeof(p->name) - 1);
         p->name[sizeof(p->name) - 1] = '\0';
+        if (changed_fields & PRODUCT_FIELD_NAME) compute_name_key(p->name, &bank->name_keys[p - bank->list]);
+    }
+    if (is_valid_price(new_price)) {
+        if (p->price != new_price) changed_fields |= PRODUCT_FIELD_PRICE;
+        p->price = new_price;
+    }
+    // quantidade não é gravada aqui: só muda por variações atômicas
+    // (adjust_product_quantity), registradas no livro pelos chamadores
+    if (is_valid_minimum_stock(new_minimum_stock, __atomic_load_n(&p->quantity, __ATOMIC_RELAXED))) {
+        p->minimum_stock = new_minimum_stock;
     }
-    if (is_valid_price(new_price)) p->price = new_price;
-    if (is_valid_quantity(new_quantity)) p->quantity = new_quantity;
-    if (is_valid_minimum_stock(new_minimum_stock, new_quantity)) p->minimum_stock = new_minimum_stock;
     if (is_valid_category(new_category)) p->category = new_category;
     if (is_valid_unit(new_unit)) p->unit = new_unit;
-    printf("Produto atualizado com sucesso.\n");
+    seq_lock_write_end(stripe);
+    end_change(bank, change);
+    // troca de categoria invalida as duas categorias
+    if (p->category != old_category) mark_product_changed(bank, old_category);
+    mark_product_changed(bank, p->category);
+    notify_product_changed(bank, (int)(p - bank->list), changed_fields | PRODUCT_FIELD_CATALOG);
+    say(bank, "Produto atualizado com sucesso.");
+    return 1;
+}
+
+// grava imagem de produto de outro banco
+int apply_product_image(product_bank *bank, const product *image) {
+    if (!bank || !image) return 0;
+    spin_lock_acquire(&bank->register_lock);
+    int slot = lower_bound_by_code(bank, 0, image->code);
+    if (slot < bank->count && bank->list[slot].code == image->code) {
+        spin_lock_release(&bank->register_lock);
+        product *p = &bank->list[slot];
+        int old_category = p->category;
+        int changed_fields = PRODUCT_FIELD_CATALOG;
+        if (strncmp(p->name, image->name, sizeof(p->name)) != 0) changed_fields |= PRODUCT_FIELD_NAME;
+        if (p->price != image->price) changed_fields |= PRODUCT_FIELD_PRICE;
+        if (p->quantity != image->quantity) changed_fields |= PRODUCT_FIELD_QUANTITY;
+
+        seq_lock *stripe = stripe_of(bank, p);
+        unsigned change = begin_change(bank, p);
+        seq_lock_write_begin(stripe);
+        memcpy(p->name, image->name, sizeof(p->name));
+        p->name[sizeof(p->name) - 1] = '\0';
+        if (changed_fields & PRODUCT_FIELD_NAME) compute_name_key(p->name, &bank->name_keys[slot]);
+        p->price = image->price;
+        __atomic_store_n(&p->quantity, image->quantity, __ATOMIC_RELAXED);
+        p->minimum_stock = image->minimum_stock;
+        p->category = image->category;
+        p->unit = image->unit;
+        p->active = image->active;
+        seq_lock_write_end(stripe);
+        end_change(bank, change);
+
+        if (p->category != old_category) mark_product_changed(bank, old_category);
+        mark_product_changed(bank, p->category);
+        notify_product_changed(bank, slot, changed_fields);
+        return 1;
+    }
+    if (image->code != bank->next_code || bank->count >= MAX_PRODUCTS) {
+        spin_lock_release(&bank->register_lock);
+        return 0;
+    }
+    // mesmo caminho do cadastro: publicado via count já preenchido
+    slot = bank->count;
+    product *p = &bank->list[slot];
+    *p = *image;
+    p->name[sizeof(p->name) - 1] = '\0';
+    compute_name_key(p->name, &bank->name_keys[slot]);
+    bank->next_code++;
+    __atomic_store_n(&bank->count, bank->count + 1, __ATOMIC_RELEASE);
+    spin_lock_release(&bank->register_lock);
+    mark_product_changed(bank, p->category);
+    notify_product_changed(bank, slot, PRODUCT_FIELD_ALL);
+    return 1;
+}
+
+// troca o estado ativo dentro da seção de escrita do seqlock (exclusiva
+// entre escritores): só quem muda o estado avisa gerações e ouvintes
+// - retorna 1 se mudou, 0 se o produto já estava no estado pedido
+static int set_product_active(product_bank *bank, product *p, int active) {
+    seq_lock *stripe = stripe_of(bank, p);
+    unsigned change = begin_change(bank, p);
+    seq_lock_write_begin(stripe);
+    int changed = p->active != active;
+    if (changed) p->active = active;
+    seq_lock_write_end(stripe);
+    end_change(bank, change);
+    if (!changed) return 0;
+    mark_product_changed(bank, p->category);
+    notify_product_changed(bank, (int)(p - bank->list), PRODUCT_FIELD_CATALOG);
     return 1;
 }
 
 // inativa (soft delete) produto
 int deactivate_product(product_bank *bank, int code) {
     product *p = find_product_by_code(bank, code);
-    if (!p) {
-        printf("Produto não encontrado.\n");
+    if (!p || !set_product_active(bank, p, 0)) {
+        say(bank, "Produto não encontrado.");
         return 0;
     }
-    p->active = 0;
-    printf("Produto inativado.\n");
+    say(bank, "Produto inativado.");
     return 1;
 }
 
 // ativa produto inativo
 int activate_product(product_bank *bank, int code) {
     if (!bank) return 0;
-    for (int i = 0; i < bank->count; ++i) {
-        if (!bank->list[i].active && bank->list[i].code == code) {
-            bank->list[i].active = 1;
-            printf("Produto reativado.\n");
+    int i = lower_bound_by_code(bank, 0, code);
+    if (i < published_count(bank) && bank->list[i].code == code
+        && set_product_active(bank, &bank->list[i], 1)) {
+        say(bank, "Produto reativado.");
+        return 1;
+    }
+    say(bank, "Produto não encontrado ou já ativo.");
+    return 0;
+}
+
+// soma delta à quantidade de forma atômica (compare-and-swap)
+int adjust_product_quantity(product_bank *bank, product *p, int delta, int *previous) {
+    if (!apply_quantity_delta(bank, p, delta, previous)) return 0;
+    publish_quantity_change(bank, p);
+    return 1;
+}
+
+// compare-and-swap da quantidade, sem avisos
+int apply_quantity_delta(product_bank *bank, product *p, int delta, int *previous) {
+    if (!bank || !p) return 0;
+    unsigned change = begin_change(bank, p);
+    int current = __atomic_load_n(&p->quantity, __ATOMIC_RELAXED);
+    for (;;) {
+        long long result = (long long)current + delta;
+        if (result < 0 || result > MAX_QUANTITY) {
+            end_change(bank, change);
+            return 0;
+        }
+        // se outro terminal alterou no meio, current recebe o valor novo e repete
+        if (__atomic_compare_exchange_n(&p->quantity, &current, (int)result, 1,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            end_change(bank, change);
+            if (previous) *previous = current;
             return 1;
         }
     }
-    printf("Produto não encontrado ou já ativo.\n");
-    return 0;
+}
+
+// gerações e ouvintes da quantidade alterada
+void publish_quantity_change(product_bank *bank, product *p) {
+    if (!bank || !p) return;
+    mark_product_changed(bank, p->category);
+    if (bank->listener_count) {
+        notify_product_changed(bank, (int)(p - bank->list), PRODUCT_FIELD_QUANTITY);
+    }
+}
+
+// cópia da página para as fotos antes de entrar na trava do chamador
+void prepare_product_change(product_bank *bank, const product *p) {
+    if (bank && p && bank->versions) versions_prepare_write(bank->versions, (int)(p - bank->list));
+}
+
+// quantidade em estoque menos a reservada
+int available_quantity(const product_bank *bank, const product *p) {
+    if (!bank || !p) return 0;
+    size_t slot = (size_t)(p - bank->list);
+    return __atomic_load_n(&p->quantity, __ATOMIC_RELAXED)
+         - __atomic_load_n(&bank->reserved[slot], __ATOMIC_RELAXED);
+}
+
+// copia o produto da posição slot sob o protocolo de leitura do seqlock
+static void copy_slot(const product_bank *bank, int slot, product *out) {
+    const seq_lock *stripe = stripe_of(bank, &bank->list[slot]);
+    unsigned start;
+    do {
+        start = seq_lock_read_begin(stripe);
+        memcpy(out, &bank->list[slot], sizeof(product));
+    } while (seq_lock_read_retry(stripe, start));
+}
+
+// copia a chave de nome de forma consistente, localizada pela posição
+int read_name_key_at(const product_bank *bank, int slot, name_key *out) {
+    if (!bank || !out || slot < 0 || slot >= published_count(bank)) return -1;
+    const seq_lock *stripe = stripe_of(bank, &bank->list[slot]);
+    int active;
+    unsigned start;
+    do {
+        start = seq_lock_read_begin(stripe);
+        memcpy(out, &bank->name_keys[slot], sizeof(name_key));
+        active = bank->list[slot].active;
+    } while (seq_lock_read_retry(stripe, start));
+    return active;
+}
+
+// recalcula todas as chaves de nome
+void refresh_name_keys(product_bank *bank) {
+    if (!bank) return;
+    for (int i = 0; i < bank->count; i++) compute_name_key(bank->list[i].name, &bank->name_keys[i]);
+}
+
+// copia o produto de forma consistente, localizado pelo código
+int read_product_snapshot(const product_bank *bank, int code, product *out) {
+    if (!bank || !out) return 0;
+    int i = lower_bound_by_code(bank, 0, code);
+    if (i >= published_count(bank) || bank->list[i].code != code) return 0;
+    copy_slot(bank, i, out);
+    return out->active;
+}
+
+// copia o produto de forma consistente, localizado pela posição
+int read_product_at(const product_bank *bank, int slot, product *out) {
+    if (!bank || !out || slot < 0 || slot >= published_count(bank)) return -1;
+    copy_slot(bank, slot, out);
+    return out->active;
 }
 
 // lista produtos abaixo do estoque mínimo
+// cada produto é avaliado com uma leitura consistente (seqlock da faixa)
 int list_products_below_minimum(const product_bank *bank, product *out_array[], size_t max_out) {
     if (!bank || !out_array) return 0;
     int count = 0;
-    for (int i = 0; i < bank->count && count < (int)max_out; ++i) {
+    int total = published_count(bank);
+    for (int i = 0; i < total && count < (int)max_out; ++i) {
         const product *p = &bank->list[i];
-        if (p->active && p->quantity <= p->minimum_stock) {
+        const seq_lock *stripe = stripe_of(bank, p);
+        int below;
+        unsigned start;
+        do {
+            start = seq_lock_read_begin(stripe);
+            below = p->active && available_quantity(bank, p) <= p->minimum_stock;
+        } while (seq_lock_read_retry(stripe, start));
+        if (below) {
             out_array[count++] = (product *)p;
         }
     }
@@ -169,7 +535,8 @@ const char *unit_to_string(int unit) {
 int count_active_products(const product_bank *bank) {
     if (!bank) return 0;
     int count = 0;
-    for (int i = 0; i < bank->count; i++) {
+    int total = published_count(bank);
+    for (int i = 0; i < total; i++) {
         if (bank->list[i].active) {
             count++;
         }
@@ -181,7 +548,8 @@ int count_active_products(const product_bank *bank) {
 float calculate_total_stock_value(const product_bank *bank) {
     if (!bank) return 0.0f;
     float total = 0.0f;
-    for (int i = 0; i < bank->count; i++) {
+    int count = published_count(bank);
+    for (int i = 0; i < count; i++) {
         const product *p = &bank->list[i];
         if (p->active) {
             total += p->price * p->quantity;
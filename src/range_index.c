@@ -0,0 +1,388 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "range_index.h"
+#include "logger.h"
+#include "sorting.h"
+#include "utils.h"
+
+// ============================================================================
+// MÓDULO: range_index — Implementação dos índices de faixa
+// ============================================================================
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// monta a chave de uma entrada
+static uint64_t entry_key(uint32_t value, int slot) {
+    return ((uint64_t)value << 32) | (uint32_t)slot;
+}
+
+// posição de uma chave
+static int key_slot(uint64_t key) {
+    return (int)(key & 0xFFFFFFFFu);
+}
+
+// valor de uma chave
+static uint32_t key_value(uint64_t key) {
+    return (uint32_t)(key >> 32);
+}
+
+// primeira entrada com chave >= key em entries[0, count)
+static int lower_bound(const range_entry *entries, int count, uint64_t key) {
+    int low = 0, high = count;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (entries[middle].key < key) low = middle + 1;
+        else high = middle;
+    }
+    return low;
+}
+
+// verifica se a entrada ainda é a atual da sua posição
+static int entry_is_current(const range_index *index, const range_entry *entry) {
+    return entry->stamp == index->stamps[key_slot(entry->key)];
+}
+
+// ============================================================================
+// MEMÓRIA
+// ============================================================================
+
+// garante arrays por posição para slot_count posições
+static int reserve_slots(range_index *index, int slot_count) {
+    if (slot_count <= index->slot_capacity) return 1;
+    int capacity = index->slot_capacity ? index->slot_capacity : 1024;
+    while (capacity < slot_count) capacity *= 2;
+
+    uint32_t *values = realloc(index->values, (size_t)capacity * sizeof(uint32_t));
+    if (!values) return 0;
+    index->values = values;
+    uint32_t *stamps = realloc(index->stamps, (size_t)capacity * sizeof(uint32_t));
+    if (!stamps) return 0;
+    memset(stamps + index->slot_capacity, 0,
+           (size_t)(capacity - index->slot_capacity) * sizeof(uint32_t));
+    index->stamps = stamps;
+    index->slot_capacity = capacity;
+    return 1;
+}
+
+// garante run e spare com pelo menos entry_count entradas
+static int reserve_run(range_index *index, int entry_count) {
+    if (entry_count <= index->run_capacity) return 1;
+    int capacity = index->run_capacity ? index->run_capacity : 1024;
+    while (capacity < entry_count) capacity *= 2;
+
+    range_entry *run = realloc(index->run, (size_t)capacity * sizeof(range_entry));
+    if (!run) return 0;
+    index->run = run;
+    range_entry *spare = realloc(index->spare, (size_t)capacity * sizeof(range_entry));
+    if (!spare) return 0;
+    index->spare = spare;
+    index->run_capacity = capacity;
+    return 1;
+}
+
+// ============================================================================
+// MANUTENÇÃO
+// ============================================================================
+
+// intercala run e delta em spare, descartando entradas obsoletas
+static int merge_delta(range_index *index) {
+    if (!reserve_run(index, index->run_count + index->delta_count)) return 0;
+    const range_entry *run = index->run;
+    const range_entry *delta = index->delta;
+    range_entry *out = index->spare;
+    int i = 0, j = 0, count = 0;
+    while (i < index->run_count || j < index->delta_count) {
+        const range_entry *next;
+        if (j >= index->delta_count || (i < index->run_count && run[i].key < delta[j].key)) {
+            next = &run[i++];
+        } else {
+            next = &delta[j++];
+        }
+        if (entry_is_current(index, next)) out[count++] = *next;
+    }
+    index->spare = index->run;
+    index->run = out;
+    index->run_count = count;
+    index->delta_count = 0;
+    return 1;
+}
+
+// insere uma entrada no delta (mantém a ordem)
+static int insert_delta(range_index *index, range_entry entry) {
+    if (index->delta_count == RANGE_DELTA_MAX && !merge_delta(index)) return 0;
+    int at = lower_bound(index->delta, index->delta_count, entry.key);
+    memmove(&index->delta[at + 1], &index->delta[at],
+            (size_t)(index->delta_count - at) * sizeof(range_entry));
+    index->delta[at] = entry;
+    index->delta_count++;
+    return 1;
+}
+
+// registra o valor atual de uma posição
+// - retorna 1 se sucesso (ou nada mudou), 0 se memória insuficiente
+static int index_slot(range_index *index, int slot) {
+    product item;
+    if (read_product_at(index->bank, slot, &item) < 0) return 1;
+    if (!reserve_slots(index, slot + 1)) return 0;
+    uint32_t value = range_value_of(index->field, &item);
+    if (slot < index->indexed_count && index->values[slot] == value) return 1;
+    index->values[slot] = value;
+    index->stamps[slot]++;
+    range_entry entry = { entry_key(value, slot), index->stamps[slot] };
+    return insert_delta(index, entry);
+}
+
+// indexa as posições cadastradas desde a última atualização
+static int catch_up(range_index *index) {
+    int total = __atomic_load_n(&index->bank->count, __ATOMIC_ACQUIRE);
+    while (index->indexed_count < total) {
+        if (!index_slot(index, index->indexed_count)) return 0;
+        index->indexed_count++;
+    }
+    return 1;
+}
+
+// ordena o banco inteiro de novo (radix sort dos valores)
+static int rebuild_index(range_index *index) {
+    double started_at = monotonic_seconds();
+    int total = __atomic_load_n(&index->bank->count, __ATOMIC_ACQUIRE);
+    if (!reserve_slots(index, total) || !reserve_run(index, total)) return 0;
+    sort_pair *pairs = malloc(2 * (size_t)(total > 0 ? total : 1) * sizeof(sort_pair));
+    if (!pairs) return 0;
+
+    // pares em ordem de posição: o radix sort estável mantém os empates
+    // em ordem de código
+    int count = 0;
+    for (int slot = 0; slot < total; slot++) {
+        product item;
+        if (read_product_at(index->bank, slot, &item) < 0) break;
+        uint32_t value = range_value_of(index->field, &item);
+        index->values[slot] = value;
+        index->stamps[slot]++;
+        pairs[count].key = value;
+        pairs[count].slot = slot;
+        count++;
+    }
+    radix_sort_pairs(pairs, pairs + count, (size_t)count);
+    for (int i = 0; i < count; i++) {
+        int slot = pairs[i].slot;
+        index->run[i].key = entry_key((uint32_t)pairs[i].key, slot);
+        index->run[i].stamp = index->stamps[slot];
+    }
+    free(pairs);
+
+    index->run_count = count;
+    index->delta_count = 0;
+    index->indexed_count = count;
+    index->needs_rebuild = 0;
+
+    char message[120];
+    snprintf(message, sizeof(message), "Indice de %s reconstruido: %d produtos, %.3f s",
+             range_field_to_string(index->field), count, monotonic_seconds() - started_at);
+    log_message(LOG_INFO, "range_index", message);
+    return 1;
+}
+
+// aplica as alterações marcadas desde a última consulta (chamado com a trava)
+// - posições ainda não indexadas ficam para catch_up
+static int fold_dirty(range_index *index) {
+    if (!__atomic_exchange_n(&index->dirty_pending, 0, __ATOMIC_ACQ_REL)) return 1;
+    for (int word = 0; word < RANGE_DIRTY_WORDS; word++) {
+        uint64_t bits = __atomic_exchange_n(&index->dirty[word], 0, __ATOMIC_ACQ_REL);
+        while (bits) {
+            int slot = word * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (slot < index->indexed_count && !index_slot(index, slot)) return 0;
+        }
+    }
+    return 1;
+}
+
+// aviso de alteração vindo do banco
+// - alteração de um produto só marca a posição (sem trava: vendas não se
+//   serializam no índice); a consulta seguinte aplica
+static void on_value_changed(void *context, int slot, int fields) {
+    (void)fields;
+    range_index *index = context;
+    if (slot < 0) {
+        spin_lock_acquire(&index->lock);
+        index->needs_rebuild = 1;
+        spin_lock_release(&index->lock);
+    } else if (slot < MAX_PRODUCTS) {
+        __atomic_fetch_or(&index->dirty[slot / 64], 1ULL << (slot % 64), __ATOMIC_RELEASE);
+        __atomic_store_n(&index->dirty_pending, 1, __ATOMIC_RELEASE);
+    }
+}
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// cria o índice
+int initialize_range_index(range_index *index, product_bank *bank, range_field field) {
+    if (!index || !bank) return 0;
+    if (field != RANGE_BY_PRICE && field != RANGE_BY_QUANTITY) return 0;
+    memset(index, 0, sizeof(*index));
+    int fields = field == RANGE_BY_PRICE ? PRODUCT_FIELD_PRICE : PRODUCT_FIELD_QUANTITY;
+    if (!add_product_listener(bank, fields, on_value_changed, index)) return 0;
+    index->bank = bank;
+    index->field = field;
+    index->needs_rebuild = 1;
+    return 1;
+}
+
+// libera o índice
+void free_range_index(range_index *index) {
+    if (!index || !index->bank) return;
+    remove_product_listener(index->bank, on_value_changed, index);
+    free(index->run);
+    free(index->spare);
+    free(index->values);
+    free(index->stamps);
+    memset(index, 0, sizeof(*index));
+}
+
+// valor indexado
+uint32_t range_value_of(range_field field, const product *p) {
+    if (!p) return 0;
+    if (field == RANGE_BY_PRICE) {
+        return p->price > 0 ? (uint32_t)((double)p->price * 100.0 + 0.5) : 0;
+    }
+    return p->quantity > 0 ? (uint32_t)p->quantity : 0;
+}
+
+// abre a consulta
+int open_range(range_cursor *cursor, range_index *index, uint32_t low, uint32_t high) {
+    if (!cursor) return 0;
+    // cursor inválido já nasce encerrado (next_range_page devolve 0)
+    memset(cursor, 0, sizeof(*cursor));
+    cursor->finished = 1;
+    if (!index || !index->bank || low > high) return 0;
+
+    cursor->index = index;
+    cursor->low = low;
+    cursor->high = high;
+    cursor->next_key = entry_key(low, 0);
+    cursor->finished = 0;
+    return 1;
+}
+
+// prepara o índice para leitura (chamado com a trava)
+// - retorna 1 se sucesso, 0 se memória insuficiente
+static int prepare_for_read(range_index *index) {
+    // alterações marcadas antes da reconstrução já entram nela
+    if (index->needs_rebuild) {
+        for (int word = 0; word < RANGE_DIRTY_WORDS; word++) {
+            __atomic_store_n(&index->dirty[word], 0, __ATOMIC_RELAXED);
+        }
+    }
+    if ((index->needs_rebuild && !rebuild_index(index)) || !fold_dirty(index) || !catch_up(index)) {
+        index->needs_rebuild = 1;
+        log_message(LOG_ERROR, "range_index", "Memoria insuficiente para o indice de faixa");
+        return 0;
+    }
+    return 1;
+}
+
+// posições de uma faixa
+int collect_range_slots(range_index *index, uint32_t low, uint32_t high,
+                        int out[], size_t max_out) {
+    if (!index || !index->bank || !out || low > high) return -1;
+    spin_lock_acquire(&index->lock);
+    if (!prepare_for_read(index)) {
+        spin_lock_release(&index->lock);
+        return -1;
+    }
+
+    const range_entry *run = index->run;
+    const range_entry *delta = index->delta;
+    uint64_t first = entry_key(low, 0);
+    int i = lower_bound(run, index->run_count, first);
+    int j = lower_bound(delta, index->delta_count, first);
+    size_t count = 0;
+    while (1) {
+        const range_entry *next;
+        if (i < index->run_count && (j >= index->delta_count || run[i].key < delta[j].key)) {
+            next = &run[i++];
+        } else if (j < index->delta_count) {
+            next = &delta[j++];
+        } else {
+            break;
+        }
+        if (key_value(next->key) > high) break;
+        if (!entry_is_current(index, next)) continue;
+        if (count == max_out) {
+            count = (size_t)-1;
+            break;
+        }
+        out[count++] = key_slot(next->key);
+    }
+    spin_lock_release(&index->lock);
+    return count == (size_t)-1 ? -1 : (int)count;
+}
+
+// próxima página
+int next_range_page(range_cursor *cursor, listing_row out[], size_t page_size) {
+    if (!cursor || !cursor->index || !out || cursor->finished) return 0;
+    range_index *index = cursor->index;
+
+    spin_lock_acquire(&index->lock);
+    if (!prepare_for_read(index)) {
+        spin_lock_release(&index->lock);
+        cursor->finished = 1;
+        return -1;
+    }
+
+    const range_entry *run = index->run;
+    const range_entry *delta = index->delta;
+    int i = lower_bound(run, index->run_count, cursor->next_key);
+    int j = lower_bound(delta, index->delta_count, cursor->next_key);
+    int count = 0;
+    while (count < (int)page_size) {
+        const range_entry *next;
+        if (i < index->run_count && (j >= index->delta_count || run[i].key < delta[j].key)) {
+            next = &run[i++];
+        } else if (j < index->delta_count) {
+            next = &delta[j++];
+        } else {
+            cursor->finished = 1;
+            break;
+        }
+        if (key_value(next->key) > cursor->high) {
+            cursor->finished = 1;
+            break;
+        }
+        cursor->next_key = next->key + 1;
+        if (!entry_is_current(index, next)) continue;
+
+        int slot = key_slot(next->key);
+        listing_row *row = &out[count];
+        if (read_product_at(index->bank, slot, &row->item) != 1) continue;
+        // a entrada pode estar atrás do produto (mudou depois da última
+        // marcação): a cópia vale só se ainda cair na faixa
+        uint32_t value = range_value_of(index->field, &row->item);
+        if (value < cursor->low || value > cursor->high) continue;
+        row->available = row->item.quantity
+                       - __atomic_load_n(&index->bank->reserved[slot], __ATOMIC_RELAXED);
+        count++;
+    }
+    spin_lock_release(&index->lock);
+
+    cursor->emitted += count;
+    return count;
+}
+
+// ainda há linhas?
+int range_has_more(const range_cursor *cursor) {
+    return cursor && cursor->index && !cursor->finished;
+}
+
+// converte campo em string
+const char *range_field_to_string(range_field field) {
+    switch (field) {
+        case RANGE_BY_PRICE: return "preco";
+        case RANGE_BY_QUANTITY: return "quantidade";
+    }
+    return "desconhecido";
+}
@@ -0,0 +1,145 @@
+#include <string.h>
+#include "ranking.h"
+
+// ============================================================================
+// MÓDULO: ranking — Implementação das consultas top K
+// ============================================================================
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// a ordem de cada critério: 1 = maior é melhor, 0 = menor é melhor
+static int higher_is_better(ranking_metric metric) {
+    return metric != RANKING_LOWEST_COVER;
+}
+
+// verifica se a entrada a fica à frente de b no ranking
+static int ranks_before(const ranking_entry *a, const ranking_entry *b, int descending) {
+    if (a->score != b->score) {
+        return descending ? a->score > b->score : a->score < b->score;
+    }
+    return a->item.code < b->item.code;  // empate: menor código primeiro
+}
+
+// desce a entrada da posição i até restaurar o heap (raiz = pior entrada)
+static void sift_down(ranking_entry heap[], size_t size, size_t i, int descending) {
+    ranking_entry moving = heap[i];
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= size) break;
+        // escolhe o filho pior (o que deve subir para perto da raiz)
+        if (child + 1 < size && ranks_before(&heap[child], &heap[child + 1], descending)) child++;
+        if (!ranks_before(&moving, &heap[child], descending)) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = moving;
+}
+
+// sobe a entrada da posição i até restaurar o heap
+static void sift_up(ranking_entry heap[], size_t i, int descending) {
+    ranking_entry moving = heap[i];
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!ranks_before(&heap[parent], &moving, descending)) break;
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = moving;
+}
+
+// calcula o score do produto; retorna 0 se o produto não entra no ranking
+static int score_of(const product_bank *bank, velocity_tracker *velocity, ranking_metric metric,
+                    int slot, const product *item, uint32_t now, double *score) {
+    switch (metric) {
+        case RANKING_STOCK_VALUE: {
+            long long cents = (long long)((double)item->price * 100.0 + 0.5) * item->quantity;
+            *score = cents / 100.0;
+            return 1;
+        }
+        case RANKING_LOWEST_COVER: {
+            double cover = days_of_cover(velocity, bank, &bank->list[slot], now);
+            if (cover >= DAYS_OF_COVER_INFINITE) return 0;  // sem vendas recentes
+            *score = cover;
+            return 1;
+        }
+        case RANKING_OVERSTOCK: {
+            int minimum = item->minimum_stock > 0 ? item->minimum_stock : 1;
+            *score = (double)item->quantity / minimum;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// seleciona os k melhores
+int rank_products(const product_bank *bank, velocity_tracker *velocity, ranking_metric metric,
+                  size_t k, uint32_t now, ranking_entry out[]) {
+    if (!bank || !out || k == 0) return 0;
+    if (metric == RANKING_LOWEST_COVER && !velocity) return 0;
+    if (metric != RANKING_STOCK_VALUE && metric != RANKING_LOWEST_COVER && metric != RANKING_OVERSTOCK) {
+        return 0;
+    }
+    if (k > RANKING_MAX_K) k = RANKING_MAX_K;
+    int descending = higher_is_better(metric);
+
+    size_t size = 0;
+    ranking_entry candidate;
+    for (int slot = 0; read_product_at(bank, slot, &candidate.item) >= 0; slot++) {
+        if (!candidate.item.active) continue;
+        if (!score_of(bank, velocity, metric, slot, &candidate.item, now, &candidate.score)) continue;
+
+        if (size < k) {
+            candidate.available = candidate.item.quantity
+                                - __atomic_load_n(&bank->reserved[slot], __ATOMIC_RELAXED);
+            out[size] = candidate;
+            sift_up(out, size++, descending);
+        } else if (ranks_before(&candidate, &out[0], descending)) {
+            // melhor que o pior guardado: substitui a raiz
+            candidate.available = candidate.item.quantity
+                                - __atomic_load_n(&bank->reserved[slot], __ATOMIC_RELAXED);
+            out[0] = candidate;
+            sift_down(out, size, 0, descending);
+        }
+    }
+
+    // ordena no lugar: a raiz (pior) vai para o fim a cada passo
+    for (size_t end = size; end > 1; end--) {
+        ranking_entry worst = out[0];
+        out[0] = out[end - 1];
+        out[end - 1] = worst;
+        sift_down(out, end - 1, 0, descending);
+    }
+    return (int)size;
+}
+
+// próxima entrada do ranking
+static int ranking_source_next(void *state, report_row *row) {
+    ranking_cursor *cursor = state;
+    if (cursor->position >= cursor->count) return 0;
+    const ranking_entry *e = &cursor->entries[cursor->position++];
+    row->item = e->item;
+    row->available = e->available;
+    row->score = e->score;
+    return 1;
+}
+
+// prepara fonte sobre o ranking
+void open_ranking_report_source(report_source *source, ranking_cursor *cursor,
+                                const ranking_entry *entries, int count) {
+    if (!source || !cursor) return;
+    cursor->entries = entries;
+    cursor->count = entries ? count : 0;
+    cursor->position = 0;
+    source->next = ranking_source_next;
+    source->state = cursor;
+}
+
+// converte critério em string
+const char *ranking_metric_to_string(int metric) {
+    switch (metric) {
+        case RANKING_STOCK_VALUE: return "Maior Valor em Estoque";
+        case RANKING_LOWEST_COVER: return "Menor Cobertura (dias)";
+        case RANKING_OVERSTOCK: return "Maior Excesso sobre o Minimo";
+        default: return "Desconhecido";
+    }
+}
@@ -0,0 +1,743 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "relatorio.h"
+#include "logger.h"
+#include "utils.h"
+
+#ifdef _WIN32
+    #include <direct.h>
+    #define mkdir_portable(path) _mkdir(path)
+#else
+    #define mkdir_portable(path) mkdir(path, 0755)
+#endif
+
+// ============================================================================
+// MÓDULO: relatorio — Implementação dos relatórios em fluxo
+// ============================================================================
+// Cada tipo de relatório é uma tabela de colunas; o mesmo laço de linhas
+// serve aos três formatos. Números são formatados à mão direto no buffer
+// (sem printf por campo) e valores monetários são somados em centavos.
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// campos que podem aparecer em uma coluna
+typedef enum {
+    FIELD_CODE,
+    FIELD_NAME,
+    FIELD_CATEGORY,
+    FIELD_UNIT,
+    FIELD_QUANTITY,
+    FIELD_AVAILABLE,
+    FIELD_MINIMUM,
+    FIELD_PRICE,
+    FIELD_VALUE,
+    FIELD_SHORTAGE,
+    FIELD_SCORE
+} report_field;
+
+// descrição de uma coluna
+typedef struct {
+    report_field field;
+    const char *key;        // nome no CSV e no JSON
+    const char *title;      // cabeçalho no texto de largura fixa
+    int width;              // largura no texto de largura fixa
+} report_column;
+
+// colunas do inventário
+static const report_column inventory_columns[] = {
+    { FIELD_CODE,      "codigo",     "CODIGO",     6 },
+    { FIELD_NAME,      "nome",       "NOME",       30 },
+    { FIELD_CATEGORY,  "categoria",  "CATEGORIA",  12 },
+    { FIELD_UNIT,      "unidade",    "UNIDADE",    8 },
+    { FIELD_QUANTITY,  "quantidade", "QUANTIDADE", 10 },
+    { FIELD_AVAILABLE, "disponivel", "DISPONIVEL", 10 },
+    { FIELD_MINIMUM,   "minimo",     "MINIMO",     8 },
+    { FIELD_PRICE,     "preco",      "PRECO",      12 }
+};
+
+// colunas da valorização
+static const report_column valuation_columns[] = {
+    { FIELD_CODE,      "codigo",     "CODIGO",     6 },
+    { FIELD_NAME,      "nome",       "NOME",       30 },
+    { FIELD_CATEGORY,  "categoria",  "CATEGORIA",  12 },
+    { FIELD_QUANTITY,  "quantidade", "QUANTIDADE", 10 },
+    { FIELD_PRICE,     "preco",      "PRECO",      12 },
+    { FIELD_VALUE,     "valor",      "VALOR",      16 }
+};
+
+// colunas da reposição
+static const report_column low_stock_columns[] = {
+    { FIELD_CODE,      "codigo",     "CODIGO",     6 },
+    { FIELD_NAME,      "nome",       "NOME",       30 },
+    { FIELD_CATEGORY,  "categoria",  "CATEGORIA",  12 },
+    { FIELD_AVAILABLE, "disponivel", "DISPONIVEL", 10 },
+    { FIELD_MINIMUM,   "minimo",     "MINIMO",     8 },
+    { FIELD_SHORTAGE,  "falta",      "FALTA",      8 }
+};
+
+// colunas do ranking
+static const report_column ranking_columns[] = {
+    { FIELD_CODE,      "codigo",     "CODIGO",     6 },
+    { FIELD_NAME,      "nome",       "NOME",       30 },
+    { FIELD_CATEGORY,  "categoria",  "CATEGORIA",  12 },
+    { FIELD_QUANTITY,  "quantidade", "QUANTIDADE", 10 },
+    { FIELD_MINIMUM,   "minimo",     "MINIMO",     8 },
+    { FIELD_PRICE,     "preco",      "PRECO",      12 },
+    { FIELD_SCORE,     "indicador",  "INDICADOR",  16 }
+};
+
+// tamanho do rascunho usado para formatar um campo
+#define FIELD_SCRATCH_SIZE 32
+// espaço reservado no buffer para uma linha de produto
+// (nome com todos os bytes escapados no JSON + demais campos com folga)
+#define ROW_MAX_BYTES 2048
+
+// ============================================================================
+// BUFFER DE ESCRITA
+// ============================================================================
+
+// aloca o buffer
+int initialize_report_buffer(report_buffer *buffer, size_t size) {
+    if (!buffer) return 0;
+    memset(buffer, 0, sizeof(*buffer));
+    if (size == 0) size = REPORT_BUFFER_SIZE;
+    if (size < 2 * ROW_MAX_BYTES) size = 2 * ROW_MAX_BYTES;  // sempre cabe uma linha inteira
+    buffer->data = malloc(size);
+    if (!buffer->data) {
+        log_message(LOG_ERROR, "relatorio", "Memoria insuficiente para o buffer de relatorios");
+        return 0;
+    }
+    buffer->size = size;
+    return 1;
+}
+
+// libera o buffer
+void free_report_buffer(report_buffer *buffer) {
+    if (!buffer) return;
+    free(buffer->data);
+    memset(buffer, 0, sizeof(*buffer));
+}
+
+// grava no arquivo o que está acumulado no buffer
+static void buffer_flush(report_buffer *b) {
+    if (b->used == 0) return;
+    if (fwrite(b->data, 1, b->used, b->file) != b->used) b->failed = 1;
+    b->written += b->used;
+    b->used = 0;
+}
+
+// acrescenta n bytes ao buffer
+static void put_bytes(report_buffer *b, const char *s, size_t n) {
+    if (n > b->size - b->used) {
+        buffer_flush(b);
+        if (n > b->size) {
+            // maior que o buffer inteiro: vai direto para o arquivo
+            if (fwrite(s, 1, n, b->file) != n) b->failed = 1;
+            b->written += n;
+            return;
+        }
+    }
+    memcpy(b->data + b->used, s, n);
+    b->used += n;
+}
+
+// acrescenta uma string terminada em nulo
+static void put_text(report_buffer *b, const char *s) {
+    put_bytes(b, s, strlen(s));
+}
+
+// acrescenta um caractere repetido count vezes
+static void put_repeated(report_buffer *b, char c, int count) {
+    while (count > 0) {
+        if (b->used == b->size) buffer_flush(b);
+        size_t n = b->size - b->used;
+        if (n > (size_t)count) n = (size_t)count;
+        memset(b->data + b->used, c, n);
+        b->used += n;
+        count -= (int)n;
+    }
+}
+
+// ============================================================================
+// FORMATAÇÃO DE CAMPOS
+// ============================================================================
+
+// escreve value em decimal no fim de out, retorna o tamanho
+static int format_long(char *out, long long value) {
+    char digits[24];
+    int n = 0;
+    unsigned long long v = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+
+    int len = 0;
+    if (value < 0) out[len++] = '-';
+    while (n > 0) out[len++] = digits[--n];
+    return len;
+}
+
+// escreve valor em centavos como reais com duas casas, retorna o tamanho
+static int format_cents(char *out, long long cents) {
+    int len = 0;
+    if (cents < 0) {
+        out[len++] = '-';
+        cents = -cents;
+    }
+    len += format_long(out + len, cents / 100);
+    out[len++] = '.';
+    out[len++] = (char)('0' + (cents % 100) / 10);
+    out[len++] = (char)('0' + cents % 10);
+    return len;
+}
+
+// preço unitário em centavos (arredondado)
+static long long price_cents(const product *p) {
+    return (long long)((double)p->price * 100.0 + 0.5);  // preços nunca são negativos
+}
+
+// formata o campo da coluna para a linha
+// - campos de texto devolvem a string do produto em *text
+// - campos numéricos são escritos em scratch
+// - retorna o tamanho; *is_text indica se o campo é texto
+static int format_field(const report_column *column, const report_row *row,
+                        char *scratch, const char **text, int *is_text) {
+    const product *p = &row->item;
+    *is_text = 0;
+    *text = scratch;
+    switch (column->field) {
+        case FIELD_CODE:      return format_long(scratch, p->code);
+        case FIELD_QUANTITY:  return format_long(scratch, p->quantity);
+        case FIELD_AVAILABLE: return format_long(scratch, row->available);
+        case FIELD_MINIMUM:   return format_long(scratch, p->minimum_stock);
+        case FIELD_SHORTAGE:  return format_long(scratch, p->minimum_stock - row->available);
+        case FIELD_PRICE:     return format_cents(scratch, price_cents(p));
+        case FIELD_VALUE:     return format_cents(scratch, price_cents(p) * p->quantity);
+        case FIELD_SCORE:     return format_cents(scratch, (long long)(row->score * 100.0
+                                                  + (row->score < 0 ? -0.5 : 0.5)));
+        case FIELD_NAME:      *text = p->name; break;
+        case FIELD_CATEGORY:  *text = category_to_string(p->category); break;
+        case FIELD_UNIT:      *text = unit_to_string(p->unit); break;
+    }
+    *is_text = 1;
+    return (int)strnlen(*text, PRODUCT_NAME_MAX_LENGTH);
+}
+
+// escreve texto em campo CSV (entre aspas se necessário), retorna o novo fim
+static char *emit_csv_text(char *out, const char *s, int len) {
+    int needs_quotes = 0;
+    for (int i = 0; i < len; i++) {
+        if (s[i] == ',' || s[i] == '"' || s[i] == '\n' || s[i] == '\r') {
+            needs_quotes = 1;
+            break;
+        }
+    }
+    if (!needs_quotes) {
+        memcpy(out, s, (size_t)len);
+        return out + len;
+    }
+    *out++ = '"';
+    for (int i = 0; i < len; i++) {
+        if (s[i] == '"') *out++ = '"';  // aspas internas são duplicadas
+        *out++ = s[i];
+    }
+    *out++ = '"';
+    return out;
+}
+
+// escreve texto como string JSON (com escapes), retorna o novo fim
+static char *emit_json_text(char *out, const char *s, int len) {
+    static const char hex[] = "0123456789abcdef";
+    *out++ = '"';
+    for (int i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)s[i];
+        if (c == '"' || c == '\\') {
+            *out++ = '\\';
+            *out++ = (char)c;
+        } else if (c < 0x20) {
+            memcpy(out, "\\u00", 4);
+            out[4] = hex[c >> 4];
+            out[5] = hex[c & 15];
+            out += 6;
+        } else {
+            *out++ = (char)c;
+        }
+    }
+    *out++ = '"';
+    return out;
+}
+
+// escreve campo de largura fixa (texto à esquerda, números à direita)
+// a largura conta caracteres UTF-8, não bytes; textos longos são cortados
+static char *emit_fixed(char *out, const char *s, int len, int width, int align_right) {
+    int chars = 0;
+    int cut = len;
+    for (int i = 0; i < len; i++) {
+        if (((unsigned char)s[i] & 0xC0) == 0x80) continue;  // continuação UTF-8
+        if (chars == width) {
+            cut = i;
+            break;
+        }
+        chars++;
+    }
+    int pad = width - chars;
+    if (align_right) {
+        memset(out, ' ', (size_t)pad);
+        out += pad;
+    }
+    memcpy(out, s, (size_t)cut);
+    out += cut;
+    if (!align_right) {
+        memset(out, ' ', (size_t)pad);
+        out += pad;
+    }
+    return out;
+}
+
+// acrescenta texto como string JSON
+static void put_json_text(report_buffer *b, const char *s, int len) {
+    char escaped[ROW_MAX_BYTES];
+    if (len > PRODUCT_NAME_MAX_LENGTH) len = PRODUCT_NAME_MAX_LENGTH;
+    put_bytes(b, escaped, (size_t)(emit_json_text(escaped, s, len) - escaped));
+}
+
+// acrescenta campo de largura fixa
+static void put_fixed(report_buffer *b, const char *s, int len, int width, int align_right) {
+    char field[ROW_MAX_BYTES];
+    if (len > PRODUCT_NAME_MAX_LENGTH) len = PRODUCT_NAME_MAX_LENGTH;
+    put_bytes(b, field, (size_t)(emit_fixed(field, s, len, width, align_right) - field));
+}
+
+// ============================================================================
+// FONTE DO BANCO
+// ============================================================================
+
+// próximo produto ativo do banco
+static int bank_source_next(void *state, report_row *row) {
+    bank_report_cursor *cursor = state;
+    listing_row line;
+    if (next_listing_page(&cursor->listing, &line, 1) != 1) return 0;
+    row->item = line.item;
+    row->available = line.available;
+    row->score = 0.0;
+    return 1;
+}
+
+// prepara fonte sobre o banco
+int open_bank_report_source(report_source *source, bank_report_cursor *cursor,
+                            const product_bank *bank, int order) {
+    if (!source || !cursor) return 0;
+    source->next = bank_source_next;
+    source->state = cursor;
+    return open_listing(&cursor->listing, bank, LISTING_ACTIVE, 0, order);
+}
+
+// prepara fonte sobre uma seleção
+int open_selection_report_source(report_source *source, bank_report_cursor *cursor,
+                                 const product_bank *bank, const slot_bitmap *selection,
+                                 int order) {
+    if (!source || !cursor) return 0;
+    source->next = bank_source_next;
+    source->state = cursor;
+    return open_selection_listing(&cursor->listing, bank, selection, order);
+}
+
+// próximo produto ativo da foto
+static int snapshot_source_next(void *state, report_row *row) {
+    bank_snapshot *snapshot = state;
+    if (!next_snapshot_product(snapshot, &row->item)) return 0;
+    const product_bank *bank = snapshot->versions->bank;
+    int slot = snapshot->position - 1;
+    row->available = row->item.quantity - __atomic_load_n(&bank->reserved[slot], __ATOMIC_RELAXED);
+    row->score = 0.0;
+    return 1;
+}
+
+// prepara fonte sobre uma foto
+int open_snapshot_report_source(report_source *source, bank_snapshot *snapshot) {
+    if (!source || !snapshot || !snapshot->versions) return 0;
+    snapshot->position = 0;
+    source->next = snapshot_source_next;
+    source->state = snapshot;
+    return 1;
+}
+
+// libera a fonte do banco
+void close_bank_report_source(bank_report_cursor *cursor) {
+    if (!cursor) return;
+    close_listing(&cursor->listing);
+}
+
+// ============================================================================
+// GERAÇÃO
+// ============================================================================
+
+// colunas e nome de arquivo de cada tipo
+static const report_column *columns_of(report_kind kind, int *count) {
+    switch (kind) {
+        case REPORT_INVENTORY:
+            *count = (int)(sizeof(inventory_columns) / sizeof(inventory_columns[0]));
+            return inventory_columns;
+        case REPORT_VALUATION:
+            *count = (int)(sizeof(valuation_columns) / sizeof(valuation_columns[0]));
+            return valuation_columns;
+        case REPORT_LOW_STOCK:
+            *count = (int)(sizeof(low_stock_columns) / sizeof(low_stock_columns[0]));
+            return low_stock_columns;
+        case REPORT_RANKING:
+            *count = (int)(sizeof(ranking_columns) / sizeof(ranking_columns[0]));
+            return ranking_columns;
+    }
+    *count = 0;
+    return NULL;
+}
+
+// nome curto usado no arquivo e no JSON
+static const char *kind_key(report_kind kind) {
+    switch (kind) {
+        case REPORT_INVENTORY: return "inventario";
+        case REPORT_VALUATION: return "valorizacao";
+        case REPORT_LOW_STOCK: return "reposicao";
+        case REPORT_RANKING: return "ranking";
+    }
+    return "relatorio";
+}
+
+// extensão do arquivo de cada formato
+static const char *format_extension(report_format format) {
+    switch (format) {
+        case REPORT_FORMAT_CSV: return "csv";
+        case REPORT_FORMAT_TEXT: return "txt";
+        case REPORT_FORMAT_JSON: return "json";
+    }
+    return NULL;
+}
+
+// converte tipo de relatório em string descritiva
+const char *report_kind_to_string(int kind) {
+    switch (kind) {
+        case REPORT_INVENTORY: return "Inventario";
+        case REPORT_VALUATION: return "Valorizacao do Estoque";
+        case REPORT_LOW_STOCK: return "Reposicao (Abaixo do Minimo)";
+        case REPORT_RANKING: return "Ranking";
+        default: return "Desconhecido";
+    }
+}
+
+// monta caminho com data e hora
+int build_named_report_path(char *out, size_t size, const char *name, const char *extension) {
+    if (!out || !name || !extension) return 0;
+
+    char stamp[32];
+    time_t now = time(NULL);
+    strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", localtime(&now));
+    int n = snprintf(out, size, "%s/%s_%s.%s", REPORT_DIRECTORY, name, stamp, extension);
+    return n > 0 && (size_t)n < size;
+}
+
+// monta caminho de um tipo de relatório
+int build_report_path(char *out, size_t size, report_kind kind, report_format format) {
+    return build_named_report_path(out, size, kind_key(kind), format_extension(format));
+}
+
+// verifica se a linha entra no relatório
+static int row_included(report_kind kind, const report_row *row) {
+    if (!row->item.active) return 0;
+    if (kind == REPORT_LOW_STOCK) return row->available <= row->item.minimum_stock;
+    return 1;
+}
+
+// linha separadora do texto de largura fixa
+static void put_text_rule(report_buffer *b, const report_column *columns, int count) {
+    int width = 0;
+    for (int c = 0; c < count; c++) width += columns[c].width + (c ? 1 : 0);
+    put_repeated(b, '-', width);
+    put_bytes(b, "\n", 1);
+}
+
+// cabeçalho do relatório
+static void put_header(report_buffer *b, report_kind kind, report_format format,
+                       const report_column *columns, int count, const char *generated_at) {
+    switch (format) {
+        case REPORT_FORMAT_CSV:
+            for (int c = 0; c < count; c++) {
+                if (c) put_bytes(b, ",", 1);
+                put_text(b, columns[c].key);
+            }
+            put_bytes(b, "\n", 1);
+            break;
+        case REPORT_FORMAT_TEXT:
+            put_text(b, "RELATORIO: ");
+            put_text(b, report_kind_to_string(kind));
+            put_text(b, "\nGerado em: ");
+            put_text(b, generated_at);
+            put_bytes(b, "\n\n", 2);
+            for (int c = 0; c < count; c++) {
+                if (c) put_bytes(b, " ", 1);
+                put_fixed(b, columns[c].title, (int)strlen(columns[c].title), columns[c].width,
+                          columns[c].field != FIELD_NAME && columns[c].field != FIELD_CATEGORY
+                          && columns[c].field != FIELD_UNIT);
+            }
+            put_bytes(b, "\n", 1);
+            put_text_rule(b, columns, count);
+            break;
+        case REPORT_FORMAT_JSON:
+            put_text(b, "{\n  \"relatorio\": \"");
+            put_text(b, kind_key(kind));
+            put_text(b, "\",\n  \"gerado_em\": \"");
+            put_text(b, generated_at);
+            put_text(b, "\",\n  \"linhas\": [");
+            break;
+    }
+}
+
+// uma linha de produto, montada direto no buffer
+static void put_row(report_buffer *b, report_format format, const report_column *columns,
+                    int count, const report_row *row, int first) {
+    char scratch[FIELD_SCRATCH_SIZE];
+    const char *text;
+    int is_text;
+
+    if (b->size - b->used < ROW_MAX_BYTES) buffer_flush(b);
+    char *out = b->data + b->used;
+
+    if (format == REPORT_FORMAT_JSON) {
+        if (!first) *out++ = ',';
+        memcpy(out, "\n    {", 6);
+        out += 6;
+    }
+
+    for (int c = 0; c < count; c++) {
+        int len = format_field(&columns[c], row, scratch, &text, &is_text);
+        switch (format) {
+            case REPORT_FORMAT_CSV:
+                if (c) *out++ = ',';
+                if (is_text) {
+                    out = emit_csv_text(out, text, len);
+                } else {
+                    memcpy(out, text, (size_t)len);
+                    out += len;
+                }
+                break;
+            case REPORT_FORMAT_TEXT:
+                if (c) *out++ = ' ';
+                out = emit_fixed(out, text, len, columns[c].width, !is_text);
+                break;
+            case REPORT_FORMAT_JSON: {
+                size_t key_length = strlen(columns[c].key);
+                if (c) {
+                    memcpy(out, ", ", 2);
+                    out += 2;
+                }
+                *out++ = '"';
+                memcpy(out, columns[c].key, key_length);
+                out += key_length;
+                memcpy(out, "\": ", 3);
+                out += 3;
+                if (is_text) {
+                    out = emit_json_text(out, text, len);
+                } else {
+                    memcpy(out, text, (size_t)len);
+                    out += len;
+                }
+                break;
+            }
+        }
+    }
+
+    *out++ = format == REPORT_FORMAT_JSON ? '}' : '\n';
+    b->used = (size_t)(out - b->data);
+}
+
+// rodapé com totais (valorização inclui subtotal por categoria)
+static void put_footer(report_buffer *b, report_kind kind, report_format format,
+                       const report_column *columns, int count, int rows,
+                       long long total_cents, const long long category_cents[]) {
+    char scratch[FIELD_SCRATCH_SIZE];
+    int len;
+    int with_categories = kind == REPORT_VALUATION;
+
+    switch (format) {
+        case REPORT_FORMAT_CSV:
+            if (!with_categories) break;
+            put_text(b, "\ncategoria,valor\n");
+            for (int c = CATEGORY_FOOD; c <= CATEGORY_OTHERS; c++) {
+                put_text(b, category_to_string(c));
+                put_bytes(b, ",", 1);
+                len = format_cents(scratch, category_cents[c]);
+                put_bytes(b, scratch, (size_t)len);
+                put_bytes(b, "\n", 1);
+            }
+            put_text(b, "Total,");
+            len = format_cents(scratch, total_cents);
+            put_bytes(b, scratch, (size_t)len);
+            put_bytes(b, "\n", 1);
+            break;
+        case REPORT_FORMAT_TEXT:
+            put_text_rule(b, columns, count);
+            put_text(b, "Produtos listados: ");
+            len = format_long(scratch, rows);
+            put_bytes(b, scratch, (size_t)len);
+            put_bytes(b, "\n", 1);
+            if (!with_categories) break;
+            for (int c = CATEGORY_FOOD; c <= CATEGORY_OTHERS; c++) {
+                const char *name = category_to_string(c);
+                put_fixed(b, name, (int)strlen(name), 12, 0);
+                put_text(b, " R$ ");
+                len = format_cents(scratch, category_cents[c]);
+                put_fixed(b, scratch, len, 16, 1);
+                put_bytes(b, "\n", 1);
+            }
+            put_fixed(b, "TOTAL", 5, 12, 0);
+            put_text(b, " R$ ");
+            len = format_cents(scratch, total_cents);
+            put_fixed(b, scratch, len, 16, 1);
+            put_bytes(b, "\n", 1);
+            break;
+        case REPORT_FORMAT_JSON:
+            put_text(b, rows ? "\n  ],\n  \"total_linhas\": " : "],\n  \"total_linhas\": ");
+            len = format_long(scratch, rows);
+            put_bytes(b, scratch, (size_t)len);
+            if (with_categories) {
+                put_text(b, ",\n  \"categorias\": [");
+                for (int c = CATEGORY_FOOD; c <= CATEGORY_OTHERS; c++) {
+                    const char *name = category_to_string(c);
+                    put_text(b, c == CATEGORY_FOOD ? "\n    {\"categoria\": " : ",\n    {\"categoria\": ");
+                    put_json_text(b, name, (int)strlen(name));
+                    put_text(b, ", \"valor\": ");
+                    len = format_cents(scratch, category_cents[c]);
+                    put_bytes(b, scratch, (size_t)len);
+                    put_bytes(b, "}", 1);
+                }
+                put_text(b, "\n  ],\n  \"valor_total\": ");
+                len = format_cents(scratch, total_cents);
+                put_bytes(b, scratch, (size_t)len);
+            }
+            put_text(b, "\n}\n");
+            break;
+    }
+}
+
+// cria o diretório do arquivo, se houver (falha se já existe é ignorada)
+static void create_parent_directory(const char *file_path) {
+    char dir_path[REPORT_PATH_MAX];
+    const char *slash = strrchr(file_path, '/');
+    const char *backslash = strrchr(file_path, '\\');
+    if (backslash > slash) slash = backslash;
+    if (!slash || (size_t)(slash - file_path) >= sizeof(dir_path)) return;
+    memcpy(dir_path, file_path, (size_t)(slash - file_path));
+    dir_path[slash - file_path] = '\0';
+    mkdir_portable(dir_path);
+}
+
+// ============================================================================
+// ESCRITA PELO BUFFER (relatórios gerais e outros módulos)
+// ============================================================================
+
+// abre o arquivo e o associa ao buffer
+int begin_report_file(report_buffer *buffer, const char *file_path) {
+    if (!buffer || !buffer->data || !file_path) return 0;
+    create_parent_directory(file_path);
+    buffer->file = fopen(file_path, "wb");
+    if (!buffer->file) return 0;
+    buffer->used = 0;
+    buffer->written = 0;
+    buffer->failed = 0;
+    return 1;
+}
+
+// acrescenta texto
+void report_put_text(report_buffer *buffer, const char *text) {
+    put_text(buffer, text);
+}
+
+// acrescenta número inteiro
+void report_put_long(report_buffer *buffer, long long value) {
+    char digits[24];
+    put_bytes(buffer, digits, (size_t)format_long(digits, value));
+}
+
+// acrescenta preço com duas casas
+void report_put_price(report_buffer *buffer, const product *p) {
+    char digits[32];
+    put_bytes(buffer, digits, (size_t)format_cents(digits, price_cents(p)));
+}
+
+// acrescenta campo de texto CSV
+void report_put_csv_text(report_buffer *buffer, const char *text) {
+    char escaped[ROW_MAX_BYTES];
+    int len = (int)strnlen(text, PRODUCT_NAME_MAX_LENGTH);
+    put_bytes(buffer, escaped, (size_t)(emit_csv_text(escaped, text, len) - escaped));
+}
+
+// grava o restante e fecha o arquivo
+int end_report_file(report_buffer *buffer, const char *file_path, int complete) {
+    if (!buffer || !buffer->file) return 0;
+    buffer_flush(buffer);
+    if (fclose(buffer->file) != 0) buffer->failed = 1;
+    buffer->file = NULL;
+    if (buffer->failed || !complete) {
+        remove(file_path);
+        return 0;
+    }
+    return 1;
+}
+
+// gera o relatório completo
+int write_report(report_buffer *buffer, report_kind kind, report_format format,
+                 report_source *source, const char *file_path, report_summary *summary) {
+    int column_count;
+    const report_column *columns = columns_of(kind, &column_count);
+    if (!buffer || !buffer->data || !source || !source->next || !file_path
+        || !columns || !format_extension(format)) {
+        log_message(LOG_ERROR, "relatorio", "Parametros invalidos para gerar relatorio");
+        return 0;
+    }
+    double started_at = monotonic_seconds();
+
+    if (!begin_report_file(buffer, file_path)) {
+        log_message(LOG_ERROR, "relatorio", "Nao foi possivel criar o arquivo do relatorio");
+        return 0;
+    }
+
+    char generated_at[32];
+    time_t now = time(NULL);
+    strftime(generated_at, sizeof(generated_at), "%Y-%m-%d %H:%M:%S", localtime(&now));
+
+    put_header(buffer, kind, format, columns, column_count, generated_at);
+
+    // laço principal: uma linha por vez, sem alocação
+    report_row row;
+    int rows = 0;
+    long long total_cents = 0;
+    long long category_cents[CATEGORY_OTHERS + 1] = { 0 };
+    while (source->next(source->state, &row)) {
+        if (!row_included(kind, &row)) continue;
+        put_row(buffer, format, columns, column_count, &row, rows == 0);
+
+        long long value = price_cents(&row.item) * row.item.quantity;
+        total_cents += value;
+        if (row.item.category >= CATEGORY_FOOD && row.item.category <= CATEGORY_OTHERS) {
+            category_cents[row.item.category] += value;
+        }
+        rows++;
+    }
+
+    put_footer(buffer, kind, format, columns, column_count, rows, total_cents, category_cents);
+    if (!end_report_file(buffer, file_path, 1)) {
+        log_message(LOG_ERROR, "relatorio", "Erro ao gravar relatorio");
+        return 0;
+    }
+
+    if (summary) {
+        summary->rows = rows;
+        summary->bytes = buffer->written;
+        summary->total_value_cents = total_cents;
+        summary->elapsed_seconds = monotonic_seconds() - started_at;
+    }
+    log_message(LOG_INFO, "relatorio", "Relatorio gerado com sucesso");
+    return 1;
+}
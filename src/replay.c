@@ -0,0 +1,211 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "replay.h"
+#include "persistence.h"
+#include "validation.h"
+#include "sync.h"
+#include "utils.h"
+#include "logger.h"
+
+// ============================================================================
+// MÓDULO: replay — Implementação da reconstrução paralela
+// ============================================================================
+// Fase 1 (soma): cada thread percorre uma faixa contínua de registros e
+//   acumula variações em arrays privados indexados por código
+// Fase 2 (junção): cada thread recebe uma faixa de posições do banco
+//   (= faixa de códigos, pois list é ordenado) e soma os parciais de todas
+//   as threads apenas para os seus códigos
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// tarefa da fase 1: somar uma faixa de registros
+typedef struct {
+    const movement_ledger *ledger;
+    uint32_t first;         // primeiro registro da faixa
+    uint32_t last;          // fim da faixa (exclusivo)
+    int code_limit;         // códigos válidos: 1 .. code_limit - 1
+    long long *sums;        // soma das variações por código (privado)
+    uint32_t *counts;       // registros por código (privado)
+    unsigned unknown;       // registros com código fora do banco
+} fold_task;
+
+// tarefa da fase 2: juntar parciais de uma faixa de posições do banco
+typedef struct {
+    product_bank *bank;
+    const fold_task *folds;
+    int fold_count;
+    int first_slot;         // primeira posição do banco
+    int last_slot;          // fim da faixa (exclusivo)
+    int apply;
+    int folded;             // produtos com histórico
+    int mismatches;         // produtos divergentes do snapshot
+} merge_task;
+
+// fase 1: soma variações da faixa de registros, bloco a bloco
+static void *fold_worker(void *arg) {
+    fold_task *task = arg;
+    uint32_t index = task->first;
+
+    while (index < task->last) {
+        const movement_record *chunk = task->ledger->chunks[index / MOVEMENT_CHUNK_SIZE];
+        uint32_t offset = index % MOVEMENT_CHUNK_SIZE;
+        uint32_t n = MOVEMENT_CHUNK_SIZE - offset;
+        if (n > task->last - index) n = task->last - index;
+
+        for (uint32_t k = 0; k < n; k++) {
+            const movement_record *r = &chunk[offset + k];
+            if (r->code <= 0 || r->code >= task->code_limit) {
+                task->unknown++;
+                continue;
+            }
+            task->sums[r->code] += r->delta;
+            task->counts[r->code]++;
+        }
+        index += n;
+    }
+    return NULL;
+}
+
+// fase 2: junta os parciais e confere com o snapshot
+static void *merge_worker(void *arg) {
+    merge_task *task = arg;
+
+    for (int slot = task->first_slot; slot < task->last_slot; slot++) {
+        product *p = &task->bank->list[slot];
+        if (p->code <= 0 || p->code >= task->folds[0].code_limit) continue;
+
+        long long total = 0;
+        uint32_t records = 0;
+        for (int t = 0; t < task->fold_count; t++) {
+            total += task->folds[t].sums[p->code];
+            records += task->folds[t].counts[p->code];
+        }
+        if (records == 0) continue;  // sem histórico: vale o snapshot
+
+        task->folded++;
+        if (total == p->quantity) continue;
+
+        task->mismatches++;
+        if (task->apply && total >= 0 && total <= MAX_QUANTITY) {
+            p->quantity = (int)total;
+        }
+    }
+    return NULL;
+}
+
+// reconstrói quantidades a partir do livro
+int replay_movements(const movement_ledger *ledger, product_bank *bank,
+                     int thread_count, int apply, replay_report *report) {
+    if (!ledger || !bank) return 0;
+    double started_at = monotonic_seconds();
+
+    if (thread_count <= 0) thread_count = cpu_count();
+    if (thread_count > REPLAY_MAX_THREADS) thread_count = REPLAY_MAX_THREADS;
+    // poucas movimentações não compensam o custo de criar threads:
+    // cada thread recebe pelo menos um bloco inteiro do livro
+    if ((uint32_t)thread_count > ledger->count / MOVEMENT_CHUNK_SIZE) {
+        thread_count = (int)(ledger->count / MOVEMENT_CHUNK_SIZE);
+        if (thread_count < 1) thread_count = 1;
+    }
+
+    // fase 1: arrays privados por thread, faixas de registros alinhadas a blocos
+    fold_task folds[REPLAY_MAX_THREADS];
+    memset(folds, 0, sizeof(folds));
+    int code_limit = bank->next_code > 1 ? bank->next_code : 1;
+    uint32_t chunks = (ledger->count + MOVEMENT_CHUNK_SIZE - 1) / MOVEMENT_CHUNK_SIZE;
+    int ok = 1;
+
+    for (int t = 0; t < thread_count; t++) {
+        fold_task *task = &folds[t];
+        task->ledger = ledger;
+        task->code_limit = code_limit;
+        uint64_t first_chunk = (uint64_t)chunks * t / thread_count;
+        uint64_t last_chunk = (uint64_t)chunks * (t + 1) / thread_count;
+        task->first = (uint32_t)(first_chunk * MOVEMENT_CHUNK_SIZE);
+        task->last = (uint32_t)(last_chunk * MOVEMENT_CHUNK_SIZE);
+        if (task->first > ledger->count) task->first = ledger->count;
+        if (task->last > ledger->count) task->last = ledger->count;
+        task->sums = calloc((size_t)code_limit, sizeof(long long));
+        task->counts = calloc((size_t)code_limit, sizeof(uint32_t));
+        if (!task->sums || !task->counts) ok = 0;
+    }
+
+    replay_report result;
+    memset(&result, 0, sizeof(result));
+
+    if (ok) {
+        run_parallel(fold_worker, folds, sizeof(fold_task), thread_count);
+
+        // fase 2: cada thread junta os parciais de uma faixa de códigos
+        merge_task merges[REPLAY_MAX_THREADS];
+        memset(merges, 0, sizeof(merges));
+        for (int t = 0; t < thread_count; t++) {
+            merges[t].bank = bank;
+            merges[t].folds = folds;
+            merges[t].fold_count = thread_count;
+            merges[t].first_slot = (int)((long long)bank->count * t / thread_count);
+            merges[t].last_slot = (int)((long long)bank->count * (t + 1) / thread_count);
+            merges[t].apply = apply;
+        }
+        run_parallel(merge_worker, merges, sizeof(merge_task), thread_count);
+
+        for (int t = 0; t < thread_count; t++) {
+            result.unknown_records += folds[t].unknown;
+            result.products_folded += merges[t].folded;
+            result.mismatches += merges[t].mismatches;
+        }
+        result.records = ledger->count;
+        result.threads = thread_count;
+    } else {
+        log_message(LOG_ERROR, "replay", "Memoria insuficiente para reconstruir o estoque");
+    }
+
+    for (int t = 0; t < thread_count; t++) {
+        free(folds[t].sums);
+        free(folds[t].counts);
+    }
+
+    if (ok && result.mismatches > 0) {
+        if (apply) {
+            mark_product_changed(bank, -1);
+            notify_product_changed(bank, -1, PRODUCT_FIELD_QUANTITY);
+        }
+        log_message(LOG_WARNING, "replay", "Snapshot diverge do livro de movimentacoes");
+    }
+
+    result.elapsed_seconds = monotonic_seconds() - started_at;
+    if (report) *report = result;
+    return ok;
+}
+
+// carrega snapshot e livro e reconstrói o estoque
+int restore_saved_state(product_bank *bank, movement_ledger *ledger,
+                        const char *products_path, const char *movements_path) {
+    if (!bank || !ledger || !products_path) return 0;
+    if (!load_products_from_file(bank, products_path)) {
+        return 0;
+    }
+
+    if (!movements_path || !data_file_exists(movements_path)) {
+        return 1;  // ainda sem movimentações: vale o snapshot
+    }
+    if (!load_movements_from_file(ledger, movements_path)) {
+        free_movement_ledger(ledger);
+        return 1;
+    }
+
+    replay_report report;
+    if (replay_movements(ledger, bank, 0, 1, &report)) {
+        char message[200];
+        snprintf(message, sizeof(message),
+                 "Estoque reconstruido: %u movimentacoes, %d produtos, %d divergencias, %d threads, %.3f s",
+                 report.records, report.products_folded, report.mismatches,
+                 report.threads, report.elapsed_seconds);
+        log_message(LOG_INFO, "replay", message);
+    }
+
+    // recalcula velocidade de vendas com o histórico carregado
+    rebuild_sales_velocity(ledger, bank);
+    return 1;
+}
@@ -0,0 +1,778 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include "replication.h"
+#include "logger.h"
+#include "utils.h"
+
+#ifndef _WIN32
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+// ============================================================================
+// MÓDULO: replication — Implementação do envio e da réplica
+// ============================================================================
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// buffer de saída do envio
+#define REPLICATION_OUTPUT_SIZE (1 << 20)
+// buffer de entrada da réplica (cabe sempre um quadro inteiro)
+#define STANDBY_INPUT_SIZE (4 * REPLICATION_FRAME_MAX)
+// espera máxima de cada volta da réplica (ms), para atender os pedidos
+#define STANDBY_POLL_MS 200
+
+// pedidos à réplica (tratador de sinal)
+static volatile sig_atomic_t promotion_requested = 0;
+static volatile sig_atomic_t standby_stop_requested = 0;
+
+void request_standby_promotion(void) {
+    promotion_requested = 1;
+}
+
+void request_standby_stop(void) {
+    standby_stop_requested = 1;
+}
+
+// ============================================================================
+// CODIFICAÇÃO
+// ============================================================================
+
+static void put_u32(unsigned char *at, uint32_t value) {
+    for (int i = 0; i < 4; i++) at[i] = (unsigned char)(value >> (8 * i));
+}
+
+static void put_u64(unsigned char *at, uint64_t value) {
+    for (int i = 0; i < 8; i++) at[i] = (unsigned char)(value >> (8 * i));
+}
+
+static uint32_t get_u32(const unsigned char *at) {
+    return (uint32_t)at[0] | (uint32_t)at[1] << 8 | (uint32_t)at[2] << 16 | (uint32_t)at[3] << 24;
+}
+
+static uint64_t get_u64(const unsigned char *at) {
+    return (uint64_t)get_u32(at) | (uint64_t)get_u32(at + 4) << 32;
+}
+
+// relógio dos quadros SYNC/ACK (monotônico, comum aos processos da máquina)
+static uint64_t now_nanoseconds(void) {
+    return (uint64_t)(monotonic_seconds() * 1e9);
+}
+
+#ifdef _WIN32
+
+// sem sockets Unix: a réplica não está disponível
+int start_replication(replication_primary *primary, product_bank *bank,
+                      movement_ledger *ledger, const char *socket_path) {
+    (void)bank;
+    (void)ledger;
+    (void)socket_path;
+    if (primary) memset(primary, 0, sizeof(*primary));
+    log_message(LOG_ERROR, "replication", "Replica disponivel apenas em sistemas POSIX");
+    return 0;
+}
+
+void stop_replication(replication_primary *primary) {
+    (void)primary;
+}
+
+void get_replication_stats(replication_primary *primary, replication_stats *out) {
+    (void)primary;
+    if (out) memset(out, 0, sizeof(*out));
+}
+
+int run_standby(const standby_config *config, standby_stats *stats) {
+    (void)config;
+    if (stats) memset(stats, 0, sizeof(*stats));
+    log_message(LOG_ERROR, "replication", "Replica disponivel apenas em sistemas POSIX");
+    return -1;
+}
+
+#else
+
+// ============================================================================
+// PRINCIPAL - CAPTURA DO CADASTRO
+// ============================================================================
+
+// aumenta o array de imagens pendentes para caber mais needed
+// - chamada com a trava do livro, que é solta durante a alocação e retomada:
+//   quem chama confere o espaço de novo na volta
+// - retorna 1 se o array cresceu (aqui ou em outra thread), 0 sem memória
+static int grow_pending(replication_primary *primary, size_t needed) {
+    spin_lock *lock = &primary->ledger->lock;
+    size_t capacity = primary->pending_capacity ? primary->pending_capacity * 2 : 64;
+    while (capacity < primary->pending_count + needed) capacity *= 2;
+    spin_lock_release(lock);
+    catalog_image *grown = malloc(capacity * sizeof(catalog_image));
+    spin_lock_acquire(lock);
+    if (!grown) return 0;
+    catalog_image *unused = grown;
+    if (capacity > primary->pending_capacity) {
+        if (primary->pending_count > 0) {
+            memcpy(grown, primary->pending, primary->pending_count * sizeof(catalog_image));
+        }
+        unused = primary->pending;
+        primary->pending = grown;
+        primary->pending_capacity = capacity;
+    }
+    if (unused) {
+        spin_lock_release(lock);
+        free(unused);
+        spin_lock_acquire(lock);
+    }
+    return 1;
+}
+
+// acrescenta a imagem da posição slot (chamada com a trava do livro e
+// espaço garantido por grow_pending)
+static void capture_image(replication_primary *primary, int slot) {
+    catalog_image *image = &primary->pending[primary->pending_count];
+    if (read_product_at(primary->bank, slot, &image->item) < 0) return;
+    image->position = primary->ledger->count;
+    primary->pending_count++;
+}
+
+// ouvinte de alterações de cadastro do banco
+static void on_catalog_change(void *context, int slot, int fields) {
+    (void)fields;
+    replication_primary *primary = context;
+    spin_lock_acquire(&primary->ledger->lock);
+    // imagens que esta alteração acrescenta (o estado pode mudar enquanto
+    // grow_pending aloca sem a trava: a conta é refeita na volta)
+    while (primary->capturing && slot >= 0) {
+        size_t needed = slot < primary->captured_slots ? 1
+                      : primary->synced ? (size_t)(slot - primary->captured_slots + 1) : 0;
+        if (primary->pending_capacity - primary->pending_count >= needed) break;
+        if (!grow_pending(primary, needed)) {
+            // sem memória: recomeça tudo na próxima volta (nada se perde)
+            primary->reset_requested = 1;
+            spin_lock_release(&primary->ledger->lock);
+            return;
+        }
+    }
+    if (primary->capturing) {
+        if (slot < 0) {
+            primary->reset_requested = 1;       // carga do arquivo: banco inteiro
+        } else if (slot < primary->captured_slots) {
+            capture_image(primary, slot);
+        } else if (primary->synced) {
+            // cadastros novos vão em ordem de código
+            while (primary->captured_slots <= slot) capture_image(primary, primary->captured_slots++);
+        }
+        // na sincronização inicial, posições ainda não enviadas vão no bloco delas
+    }
+    spin_lock_release(&primary->ledger->lock);
+}
+
+// ============================================================================
+// PRINCIPAL - ENVIO
+// ============================================================================
+
+// estado da thread de envio
+typedef struct {
+    replication_primary *primary;
+    unsigned char *output;
+    size_t used;
+    uint32_t shipped;               // livro enviado até aqui
+    movement_record *records;       // registros copiados do livro
+    uint64_t records_shipped;
+    uint64_t images_shipped;
+    catalog_image *spare;           // array de imagens da volta anterior (reaproveitado)
+    size_t spare_capacity;
+} shipper;
+
+// envia o buffer inteiro
+static int flush_output(shipper *s) {
+    size_t sent = 0;
+    while (sent < s->used) {
+        ssize_t n = send(s->primary->fd, s->output + sent, s->used - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        sent += (size_t)n;
+    }
+    s->used = 0;
+    return 1;
+}
+
+// abre um quadro com content bytes de conteúdo; retorna onde escrevê-lo
+static unsigned char *begin_frame(shipper *s, replication_frame kind, size_t content) {
+    if (s->used + 5 + content > REPLICATION_OUTPUT_SIZE && !flush_output(s)) return NULL;
+    unsigned char *at = s->output + s->used;
+    put_u32(at, (uint32_t)(content + 1));
+    at[4] = (unsigned char)kind;
+    s->used += 5 + content;
+    return at + 5;
+}
+
+// envia os registros do livro até a posição end
+static int ship_records(shipper *s, uint32_t end) {
+    while (s->shipped < end) {
+        size_t wanted = end - s->shipped;
+        if (wanted > REPLICATION_BATCH_RECORDS) wanted = REPLICATION_BATCH_RECORDS;
+        size_t copied = copy_movements(s->primary->ledger, s->shipped, s->records, wanted);
+        if (copied == 0) return 0;
+        unsigned char *at = begin_frame(s, REPLICATION_MOVEMENTS, 8 + copied * sizeof(movement_record));
+        if (!at) return 0;
+        put_u32(at, s->shipped);
+        put_u32(at + 4, (uint32_t)copied);
+        memcpy(at + 8, s->records, copied * sizeof(movement_record));
+        s->shipped += (uint32_t)copied;
+        s->records_shipped += copied;
+    }
+    return 1;
+}
+
+// envia as imagens na ordem do livro, intercaladas com os registros
+static int ship_images(shipper *s, const catalog_image *images, size_t count) {
+    size_t i = 0;
+    while (i < count) {
+        uint32_t position = images[i].position;
+        if (!ship_records(s, position)) return 0;
+        size_t n = 1;
+        while (i + n < count && n < REPLICATION_SYNC_PRODUCTS && images[i + n].position == position) n++;
+        unsigned char *at = begin_frame(s, REPLICATION_PRODUCTS, 8 + n * sizeof(product));
+        if (!at) return 0;
+        put_u32(at, position);
+        put_u32(at + 4, (uint32_t)n);
+        for (size_t k = 0; k < n; k++) {
+            memcpy(at + 8 + k * sizeof(product), &images[i + k].item, sizeof(product));
+        }
+        s->images_shipped += n;
+        i += n;
+    }
+    return 1;
+}
+
+// lê os ACKs disponíveis sem esperar
+static int read_acks(shipper *s) {
+    unsigned char frame[64];
+    for (;;) {
+        ssize_t n = recv(s->primary->fd, frame, 17, MSG_DONTWAIT | MSG_PEEK);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 1;
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        if (n < 17) return 1;                       // ACK incompleto: próxima volta
+        if (recv(s->primary->fd, frame, 17, 0) != 17) return 0;
+        if (get_u32(frame) != 13 || frame[4] != REPLICATION_ACK) return 0;
+        uint64_t sent_at = get_u64(frame + 5);
+        uint32_t position = get_u32(frame + 13);
+        replication_primary *primary = s->primary;
+        spin_lock_acquire(&primary->stats_lock);
+        primary->stats.acked_position = position;
+        primary->stats.last_round_trip_seconds = (double)(now_nanoseconds() - sent_at) / 1e9;
+        spin_lock_release(&primary->stats_lock);
+    }
+}
+
+// conecta à réplica
+static int connect_standby(const char *path) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// começa (ou recomeça) o envio do zero nesta conexão
+static int begin_session(shipper *s) {
+    replication_primary *primary = s->primary;
+    spin_lock_acquire(&primary->ledger->lock);
+    primary->capturing = 1;
+    primary->synced = 0;
+    primary->captured_slots = 0;
+    primary->pending_count = 0;
+    primary->reset_requested = 0;
+    spin_lock_release(&primary->ledger->lock);
+    s->shipped = 0;
+    s->used = 0;
+    return begin_frame(s, REPLICATION_RESET, 0) != NULL;
+}
+
+// encerra a conexão e para a captura
+static void end_session(shipper *s) {
+    replication_primary *primary = s->primary;
+    spin_lock_acquire(&primary->ledger->lock);
+    primary->capturing = 0;
+    primary->pending_count = 0;
+    spin_lock_release(&primary->ledger->lock);
+    close(primary->fd);
+    primary->fd = -1;
+    spin_lock_acquire(&primary->stats_lock);
+    primary->stats.connected = 0;
+    spin_lock_release(&primary->stats_lock);
+}
+
+// uma volta de envio: bloco da sincronização inicial, imagens e registros
+// novos, SYNC; retorna 0 se a conexão caiu
+static int ship_round(shipper *s) {
+    replication_primary *primary = s->primary;
+    catalog_image *images;
+    size_t image_count;
+    uint32_t end;
+    int complete;
+
+    spin_lock_acquire(&primary->ledger->lock);
+    if (!primary->synced) {
+        int published, last;
+        while (1) {
+            published = __atomic_load_n(&primary->bank->count, __ATOMIC_ACQUIRE);
+            last = primary->captured_slots + REPLICATION_SYNC_PRODUCTS;
+            if (last > published) last = published;
+            size_t needed = last > primary->captured_slots ? (size_t)(last - primary->captured_slots) : 0;
+            if (primary->pending_capacity - primary->pending_count >= needed) break;
+            if (!grow_pending(primary, needed)) {
+                spin_lock_release(&primary->ledger->lock);
+                log_message(LOG_ERROR, "replication", "Memoria insuficiente para as imagens do cadastro");
+                return 0;
+            }
+        }
+        while (primary->captured_slots < last) capture_image(primary, primary->captured_slots++);
+        if (primary->captured_slots >= published) primary->synced = 1;
+    }
+    // imagens e posição final lidas juntas: imagens capturadas depois desta
+    // volta têm posição >= end
+    end = primary->ledger->count;
+    complete = primary->synced;
+    // troca pelo array da volta anterior: as capturas seguintes não alocam
+    images = primary->pending;
+    image_count = primary->pending_count;
+    size_t image_capacity = primary->pending_capacity;
+    primary->pending = s->spare;
+    primary->pending_count = 0;
+    primary->pending_capacity = s->spare_capacity;
+    spin_lock_release(&primary->ledger->lock);
+
+    int ok = ship_images(s, images, image_count) && ship_records(s, end);
+    s->spare = images;
+    s->spare_capacity = image_capacity;
+    unsigned char *at = ok ? begin_frame(s, REPLICATION_SYNC, 13) : NULL;
+    if (at) {
+        put_u64(at, now_nanoseconds());
+        put_u32(at + 8, end);
+        at[12] = (unsigned char)complete;
+    }
+    ok = at && flush_output(s) && read_acks(s);
+
+    spin_lock_acquire(&primary->stats_lock);
+    primary->stats.records_shipped = s->records_shipped;
+    primary->stats.images_shipped = s->images_shipped;
+    primary->stats.shipped_position = s->shipped;
+    spin_lock_release(&primary->stats_lock);
+    return ok;
+}
+
+// espera ms milissegundos ou um ACK
+static void wait_round(replication_primary *primary, int milliseconds) {
+    if (primary->fd < 0) {
+        struct timespec pause = { milliseconds / 1000, (long)(milliseconds % 1000) * 1000000L };
+        nanosleep(&pause, NULL);
+        return;
+    }
+    struct pollfd watch = { primary->fd, POLLIN, 0 };
+    poll(&watch, 1, milliseconds);
+}
+
+// thread de envio
+static void *shipper_main(void *argument) {
+    shipper s;
+    memset(&s, 0, sizeof(s));
+    s.primary = argument;
+    replication_primary *primary = s.primary;
+    s.output = malloc(REPLICATION_OUTPUT_SIZE);
+    s.records = malloc(REPLICATION_BATCH_RECORDS * sizeof(movement_record));
+    if (!s.output || !s.records) {
+        log_message(LOG_ERROR, "replication", "Memoria insuficiente para o envio a replica");
+        free(s.output);
+        free(s.records);
+        return NULL;
+    }
+
+    int was_connected = 0;
+    while (__atomic_load_n(&primary->running, __ATOMIC_ACQUIRE)) {
+        if (primary->fd < 0) {
+            primary->fd = connect_standby(primary->socket_path);
+            if (primary->fd < 0) {
+                if (was_connected) log_message(LOG_WARNING, "replication", "Replica desconectada");
+                was_connected = 0;
+                for (int waited = 0; waited < REPLICATION_RETRY_MS
+                     && __atomic_load_n(&primary->running, __ATOMIC_ACQUIRE); waited += 50) {
+                    wait_round(primary, 50);
+                }
+                continue;
+            }
+            was_connected = 1;
+            spin_lock_acquire(&primary->stats_lock);
+            primary->stats.connected = 1;
+            primary->stats.connections++;
+            spin_lock_release(&primary->stats_lock);
+            log_message(LOG_INFO, "replication", "Replica conectada: reenviando estado completo");
+            if (!begin_session(&s)) {
+                end_session(&s);
+                continue;
+            }
+        } else if (__atomic_load_n(&primary->reset_requested, __ATOMIC_ACQUIRE) && !begin_session(&s)) {
+            end_session(&s);
+            continue;
+        }
+        if (!ship_round(&s)) {
+            end_session(&s);
+            continue;
+        }
+        // sincronização inicial em andamento: próxima volta sem esperar
+        if (primary->synced) wait_round(primary, REPLICATION_INTERVAL_MS);
+    }
+
+    // última volta: o que foi alterado até aqui chega à réplica
+    if (primary->fd >= 0) {
+        ship_round(&s);
+        end_session(&s);
+    }
+    free(s.output);
+    free(s.records);
+    free(s.spare);
+    return NULL;
+}
+
+// ============================================================================
+// PRINCIPAL - API
+// ============================================================================
+
+// começa o envio
+int start_replication(replication_primary *primary, product_bank *bank,
+                      movement_ledger *ledger, const char *socket_path) {
+    if (!primary || !bank || !ledger || !socket_path) return 0;
+    memset(primary, 0, sizeof(*primary));
+    if (strlen(socket_path) >= sizeof(primary->socket_path)) {
+        log_message(LOG_ERROR, "replication", "Caminho do socket da replica muito longo");
+        return 0;
+    }
+    strcpy(primary->socket_path, socket_path);
+    primary->bank = bank;
+    primary->ledger = ledger;
+    primary->fd = -1;
+    primary->running = 1;
+    if (!add_product_listener(bank, PRODUCT_FIELD_CATALOG, on_catalog_change, primary)) {
+        log_message(LOG_ERROR, "replication", "Banco sem espaco para o ouvinte da replica");
+        return 0;
+    }
+    if (pthread_create(&primary->thread, NULL, shipper_main, primary) != 0) {
+        remove_product_listener(bank, on_catalog_change, primary);
+        log_message(LOG_ERROR, "replication", "Nao foi possivel criar a thread de envio");
+        return 0;
+    }
+    return 1;
+}
+
+// encerra o envio
+void stop_replication(replication_primary *primary) {
+    if (!primary || !primary->bank) return;
+    __atomic_store_n(&primary->running, 0, __ATOMIC_RELEASE);
+    pthread_join(primary->thread, NULL);
+    remove_product_listener(primary->bank, on_catalog_change, primary);
+    free(primary->pending);
+    primary->pending = NULL;
+    primary->bank = NULL;
+}
+
+// números do envio
+void get_replication_stats(replication_primary *primary, replication_stats *out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (!primary || !primary->ledger) return;
+    spin_lock_acquire(&primary->stats_lock);
+    *out = primary->stats;
+    spin_lock_release(&primary->stats_lock);
+    uint32_t count = __atomic_load_n(&primary->ledger->count, __ATOMIC_ACQUIRE);
+    out->lag_records = count > out->acked_position ? count - out->acked_position : 0;
+}
+
+// ============================================================================
+// RÉPLICA - APLICAÇÃO
+// ============================================================================
+
+// estado da réplica
+// - a ressincronização de cada conexão é montada em banco e livro à parte;
+//   o estado da réplica só é trocado quando o principal a dá por completa
+typedef struct {
+    const standby_config *config;
+    standby_stats *stats;
+    int fd;
+    unsigned char *input;
+    size_t used;
+    product_bank *bank;             // destino dos quadros: o da réplica ou o rascunho
+    movement_ledger *ledger;
+    product_bank *scratch_bank;     // ressincronização em andamento
+    movement_ledger scratch_ledger;
+    int resyncing;                  // 1 = RESET recebido, sincronização ainda incompleta
+} standby_state;
+
+// nova conexão do principal: recomeça a ressincronização no rascunho
+// (o estado da réplica segue intacto até a troca)
+static void apply_reset(standby_state *state) {
+    free_movement_ledger(&state->scratch_ledger);
+    initialize_product_bank(state->scratch_bank);
+    state->bank = state->scratch_bank;
+    state->ledger = &state->scratch_ledger;
+    state->resyncing = 1;
+    state->stats->resets++;
+}
+
+// sincronização completa: o rascunho passa a ser o estado da réplica
+static void install_resync(standby_state *state) {
+    movement_ledger *ledger = state->config->ledger;
+    product_bank *bank = state->config->bank;
+
+    // os blocos do livro mudam de dono; o acompanhamento de vendas fica
+    free_movement_ledger(ledger);
+    velocity_tracker *velocity = ledger->velocity;
+    *ledger = state->scratch_ledger;
+    ledger->velocity = velocity;
+    initialize_movement_ledger(&state->scratch_ledger);
+
+    // produtos copiados na ordem dos códigos (os ouvintes do banco são avisados)
+    initialize_product_bank(bank);
+    const product_bank *scratch = state->scratch_bank;
+    for (int i = 0; i < scratch->count; i++) {
+        if (!apply_product_image(bank, &scratch->list[i])) state->stats->divergences++;
+    }
+    state->bank = bank;
+    state->ledger = ledger;
+    state->resyncing = 0;
+    state->stats->resyncs_completed++;
+}
+
+// imagens de produto na posição do livro
+static int apply_products(standby_state *state, const unsigned char *content, size_t length) {
+    if (length < 8) return 0;
+    uint32_t position = get_u32(content);
+    uint32_t count = get_u32(content + 4);
+    if (length != 8 + (size_t)count * sizeof(product) || position != state->ledger->count) return 0;
+    product image;
+    for (uint32_t i = 0; i < count; i++) {
+        memcpy(&image, content + 8 + (size_t)i * sizeof(product), sizeof(product));
+        if (apply_product_image(state->bank, &image)) {
+            state->stats->images_applied++;
+        } else {
+            state->stats->divergences++;
+        }
+    }
+    return 1;
+}
+
+// registros do livro: anexados em lote e aplicados às quantidades
+static int apply_movements(standby_state *state, const unsigned char *content, size_t length) {
+    if (length < 8) return 0;
+    uint32_t first = get_u32(content);
+    uint32_t count = get_u32(content + 4);
+    movement_ledger *ledger = state->ledger;
+    product_bank *bank = state->bank;
+    if (length != 8 + (size_t)count * sizeof(movement_record) || first != ledger->count) return 0;
+
+    // o conteúdo do quadro não tem alinhamento garantido
+    movement_record *records = malloc((count ? count : 1) * sizeof(movement_record));
+    if (!records) return 0;
+    memcpy(records, content + 8, (size_t)count * sizeof(movement_record));
+    if (!append_loaded_movements(ledger, records, count)) {
+        free(records);
+        return 0;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        const movement_record *r = &records[i];
+        product *p = find_product_by_code(bank, r->code);
+        if (!p) {
+            // na sincronização inicial o produto ainda pode não ter chegado:
+            // a imagem dele virá com a quantidade já somada
+            if (r->code < bank->next_code) state->stats->divergences++;
+            continue;
+        }
+        // saldo inicial é absoluto; os demais, variações
+        int delta = r->type == MOVEMENT_OPENING
+                  ? r->delta - __atomic_load_n(&p->quantity, __ATOMIC_RELAXED) : r->delta;
+        if (delta != 0 && !adjust_product_quantity(bank, p, delta, NULL)) state->stats->divergences++;
+    }
+    free(records);
+    state->stats->records_applied += count;
+    return 1;
+}
+
+// confirma ao principal o que já foi aplicado
+static int send_ack(standby_state *state, uint64_t sent_at, uint32_t position) {
+    unsigned char frame[17];
+    put_u32(frame, 13);
+    frame[4] = REPLICATION_ACK;
+    put_u64(frame + 5, sent_at);
+    put_u32(frame + 13, position);
+    return send(state->fd, frame, sizeof(frame), MSG_NOSIGNAL) == (ssize_t)sizeof(frame);
+}
+
+// aplica os quadros completos do buffer; retorna 0 se o quadro é inválido
+static int apply_frames(standby_state *state) {
+    size_t offset = 0;
+    while (state->used - offset >= 5) {
+        uint32_t length = get_u32(state->input + offset);
+        if (length == 0 || length > REPLICATION_FRAME_MAX + 1) return 0;
+        if (state->used - offset < 4 + (size_t)length) break;
+        const unsigned char *content = state->input + offset + 5;
+        size_t content_length = length - 1;
+        int ok = 1;
+        switch (state->input[offset + 4]) {
+            case REPLICATION_RESET:
+                apply_reset(state);
+                break;
+            case REPLICATION_PRODUCTS:
+                ok = apply_products(state, content, content_length);
+                break;
+            case REPLICATION_MOVEMENTS:
+                ok = apply_movements(state, content, content_length);
+                break;
+            case REPLICATION_SYNC: {
+                if (content_length != 13) return 0;
+                uint64_t sent_at = get_u64(content);
+                uint32_t position = get_u32(content + 8);
+                double lag = (double)(now_nanoseconds() - sent_at) / 1e9;
+                if (state->resyncing && content[12]) install_resync(state);
+                if (!state->resyncing) state->stats->applied_position = position;
+                state->stats->last_lag_seconds = lag;
+                if (lag > state->stats->max_lag_seconds) state->stats->max_lag_seconds = lag;
+                // o principal pode já ter fechado depois da última volta: o
+                // ACK perdido não invalida os quadros seguintes do buffer (a
+                // desconexão aparece no recv)
+                send_ack(state, sent_at, position);
+                break;
+            }
+            default:
+                ok = 0;
+        }
+        if (!ok) return 0;
+        state->stats->frames++;
+        offset += 4 + (size_t)length;
+    }
+    memmove(state->input, state->input + offset, state->used - offset);
+    state->used -= offset;
+    return 1;
+}
+
+// cria o socket de escuta (remove um socket antigo deixado no mesmo caminho)
+static int open_listener(const char *path) {
+    struct sockaddr_un address;
+    if (strlen(path) >= sizeof(address.sun_path)) return -1;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    struct stat info;
+    if (stat(path, &info) == 0 && S_ISSOCK(info.st_mode)) unlink(path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(fd, 1) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// ============================================================================
+// RÉPLICA - API
+// ============================================================================
+
+// recebe e aplica até promoção ou encerramento
+int run_standby(const standby_config *config, standby_stats *stats) {
+    if (!config || !config->bank || !config->ledger || !config->socket_path) return -1;
+    standby_stats local;
+    standby_state state;
+    memset(&state, 0, sizeof(state));
+    state.config = config;
+    state.stats = stats ? stats : &local;
+    memset(state.stats, 0, sizeof(*state.stats));
+    state.fd = -1;
+    state.bank = config->bank;
+    state.ledger = config->ledger;
+
+    int listen_fd = open_listener(config->socket_path);
+    state.input = malloc(STANDBY_INPUT_SIZE);
+    state.scratch_bank = calloc(1, sizeof(product_bank));
+    if (state.scratch_bank) state.scratch_bank->quiet = 1;
+    if (listen_fd < 0 || !state.input || !state.scratch_bank) {
+        if (listen_fd >= 0) close(listen_fd);
+        free(state.input);
+        free(state.scratch_bank);
+        log_message(LOG_ERROR, "replication", "Nao foi possivel abrir o socket da replica");
+        return -1;
+    }
+    char message[200];
+    snprintf(message, sizeof(message), "Replica aguardando o principal em %s", config->socket_path);
+    log_message(LOG_INFO, "replication", message);
+
+    promotion_requested = 0;
+    standby_stop_requested = 0;
+    while (!promotion_requested && !standby_stop_requested) {
+        struct pollfd watch = { state.fd >= 0 ? state.fd : listen_fd, POLLIN, 0 };
+        if (poll(&watch, 1, STANDBY_POLL_MS) <= 0) continue;
+
+        if (state.fd < 0) {
+            state.fd = accept(listen_fd, NULL, NULL);
+            if (state.fd >= 0) {
+                state.used = 0;
+                state.stats->connections++;
+                log_message(LOG_INFO, "replication", "Principal conectado");
+            }
+            continue;
+        }
+
+        ssize_t n = recv(state.fd, state.input + state.used, STANDBY_INPUT_SIZE - state.used, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n > 0) state.used += (size_t)n;
+        if (n <= 0 || !apply_frames(&state)) {
+            log_message(n <= 0 ? LOG_WARNING : LOG_ERROR, "replication",
+                        n <= 0 ? "Principal desconectado: replica mantem o ultimo estado aplicado"
+                               : "Quadro invalido do principal: conexao encerrada");
+            close(state.fd);
+            state.fd = -1;
+        }
+    }
+
+    if (state.fd >= 0) close(state.fd);
+    close(listen_fd);
+    unlink(config->socket_path);
+    free(state.input);
+    free_movement_ledger(&state.scratch_ledger);
+    free(state.scratch_bank);
+
+    if (!promotion_requested) {
+        log_message(LOG_INFO, "replication", "Replica encerrada sem promocao");
+        return 0;
+    }
+    // ressincronização incompleta fica de fora: vale a última troca completa
+    if (state.stats->resyncs_completed == 0) {
+        log_message(LOG_ERROR, "replication",
+                    "Promocao recusada: nenhuma sincronizacao completa recebida do principal");
+        return 0;
+    }
+    if (state.resyncing) {
+        log_message(LOG_WARNING, "replication",
+                    "Promocao durante ressincronizacao: assumido o estado da ultima sincronizacao completa");
+    }
+    // métricas de venda não vêm pelo envio: recalculadas a partir do livro
+    if (config->ledger->velocity) rebuild_sales_velocity(config->ledger, config->bank);
+    snprintf(message, sizeof(message),
+             "Replica promovida: livro aplicado ate %u, atraso maximo %.3f s, %llu divergencias",
+             state.stats->applied_position, state.stats->max_lag_seconds,
+             (unsigned long long)state.stats->divergences);
+    log_message(LOG_INFO, "replication", message);
+    return 1;
+}
+
+#endif // _WIN32
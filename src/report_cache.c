@@ -0,0 +1,113 @@
+#include <string.h>
+#include "report_cache.h"
+#include "listing.h"
+
+// ============================================================================
+// MÓDULO: report_cache — Implementação do cache de resumos
+// ============================================================================
+// A geração é lida ANTES do recálculo, que corre fora da trava (percorre o
+// banco inteiro). O resultado só é guardado se a geração ainda for a mesma
+// na volta: se o banco mudou durante o cálculo, ele é devolvido mas não
+// guardado (nunca se guarda um resultado velho com geração nova). A trava
+// cobre só a consulta e a gravação do cache.
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// inicializa cache vazio
+void initialize_report_cache(report_cache *cache, const product_bank *bank) {
+    if (!cache) return;
+    memset(cache, 0, sizeof(*cache));
+    cache->bank = bank;
+}
+
+// quantidade de ativos
+int cached_active_count(report_cache *cache) {
+    if (!cache || !cache->bank) return 0;
+    uint64_t generation = bank_generation(cache->bank);
+    spin_lock_acquire(&cache->lock);
+    if (cache->active_generation == generation) {
+        cache->hits++;
+        int count = cache->active_count;
+        spin_lock_release(&cache->lock);
+        return count;
+    }
+    cache->misses++;
+    spin_lock_release(&cache->lock);
+
+    int count = count_active_products(cache->bank);
+    spin_lock_acquire(&cache->lock);
+    if (bank_generation(cache->bank) == generation) {
+        cache->active_count = count;
+        cache->active_generation = generation;
+    }
+    spin_lock_release(&cache->lock);
+    return count;
+}
+
+// quantidade abaixo do mínimo
+int cached_below_minimum_count(report_cache *cache) {
+    if (!cache || !cache->bank) return 0;
+    uint64_t generation = bank_generation(cache->bank);
+    spin_lock_acquire(&cache->lock);
+    if (cache->below_generation == generation) {
+        cache->hits++;
+        int count = cache->below_count;
+        spin_lock_release(&cache->lock);
+        return count;
+    }
+    cache->misses++;
+    spin_lock_release(&cache->lock);
+
+    // recalcula percorrendo a listagem inteira em páginas
+    listing_cursor cursor;
+    listing_row page[LISTING_PAGE_SIZE];
+    int count = 0, rows;
+    open_listing(&cursor, cache->bank, LISTING_BELOW_MINIMUM, 0, SORT_BY_CODE);
+    while ((rows = next_listing_page(&cursor, page, LISTING_PAGE_SIZE)) > 0) {
+        count += rows;
+    }
+    close_listing(&cursor);
+
+    spin_lock_acquire(&cache->lock);
+    if (bank_generation(cache->bank) == generation) {
+        cache->below_count = count;
+        cache->below_generation = generation;
+    }
+    spin_lock_release(&cache->lock);
+    return count;
+}
+
+// totais de uma categoria
+int cached_category_totals(report_cache *cache, int category, aggregate_group *out) {
+    if (!cache || !cache->bank || !out) return 0;
+    if (category < CATEGORY_FOOD || category > CATEGORY_OTHERS) return 0;
+
+    uint64_t generations[CATEGORY_OTHERS + 1];
+    for (int c = 0; c <= CATEGORY_OTHERS; c++) {
+        generations[c] = category_generation(cache->bank, c);
+    }
+    spin_lock_acquire(&cache->lock);
+    if (cache->category_generations[category] == generations[category]) {
+        cache->hits++;
+        *out = cache->category_totals[category];
+        spin_lock_release(&cache->lock);
+        return 1;
+    }
+    cache->misses++;
+    spin_lock_release(&cache->lock);
+
+    // uma única passada recalcula todas as categorias; cada uma é guardada
+    // se não mudou durante o cálculo
+    aggregate_result result;
+    if (!aggregate_products(cache->bank, GROUP_BY_CATEGORY, 0, &result)) return 0;
+    spin_lock_acquire(&cache->lock);
+    for (int c = 0; c <= CATEGORY_OTHERS; c++) {
+        if (category_generation(cache->bank, c) == generations[c]) {
+            cache->category_totals[c] = result.groups[c];
+            cache->category_generations[c] = generations[c];
+        }
+    }
+    spin_lock_release(&cache->lock);
+    *out = result.groups[category];
+    return 1;
+}
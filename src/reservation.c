@@ -0,0 +1,309 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "reservation.h"
+#include "logger.h"
+
+// ============================================================================
+// MÓDULO: reservation — Implementação das reservas e da roda de temporização
+// ============================================================================
+// Listas da roda são duplamente encadeadas por índice dentro do pool, então
+// inserir, remover e expirar não alocam memória.
+// Identificador de reserva: (geração << 20) | (posição no pool + 1)
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// bits do identificador usados pela posição no pool
+#define ID_INDEX_BITS 20
+#define ID_INDEX_MASK ((1u << ID_INDEX_BITS) - 1)
+// bits usados pela geração (identificador cabe em int positivo)
+#define ID_GENERATION_MASK 0x7FFu
+// reservas vencidas recolhidas por vez sob a trava (devolvidas fora dela)
+#define EXPIRE_BATCH 256
+
+_Static_assert(RESERVATION_MAX_PENDING <= ID_INDEX_MASK,
+               "RESERVATION_MAX_PENDING precisa caber na posicao do identificador");
+
+// deslocamentos dos níveis 1 e 2 (log2 da faixa de ticks de cada posição)
+#define LEVEL1_SHIFT 8
+#define LEVEL2_SHIFT 14
+
+// identificação das listas: [0, 256) nível 0, [256, 320) nível 1, [320, 384) nível 2
+#define BUCKET_LEVEL1 WHEEL_LEVEL0_SIZE
+#define BUCKET_LEVEL2 (WHEEL_LEVEL0_SIZE + WHEEL_LEVEL_SIZE)
+
+// cabeça da lista identificada por bucket
+static int *bucket_head(reservation_table *table, int bucket) {
+    if (bucket < BUCKET_LEVEL1) return &table->level0[bucket];
+    if (bucket < BUCKET_LEVEL2) return &table->level1[bucket - BUCKET_LEVEL1];
+    return &table->level2[bucket - BUCKET_LEVEL2];
+}
+
+// insere a entrada na lista da roda correspondente ao seu vencimento
+// vencimentos já passados caem na posição do tick atual
+static void wheel_insert(reservation_table *table, int index) {
+    reservation_entry *e = &table->entries[index];
+    uint32_t expires = e->expires_at;
+    if (expires < table->current_tick) expires = table->current_tick;
+    uint32_t delta = expires - table->current_tick;
+
+    int bucket;
+    if (delta < WHEEL_LEVEL0_SIZE) {
+        bucket = (int)(expires % WHEEL_LEVEL0_SIZE);
+    } else if (delta < (1u << LEVEL2_SHIFT)) {
+        bucket = BUCKET_LEVEL1 + (int)((expires >> LEVEL1_SHIFT) % WHEEL_LEVEL_SIZE);
+    } else {
+        bucket = BUCKET_LEVEL2 + (int)((expires >> LEVEL2_SHIFT) % WHEEL_LEVEL_SIZE);
+    }
+
+    int *head = bucket_head(table, bucket);
+    e->bucket = bucket;
+    e->prev = -1;
+    e->next = *head;
+    if (*head >= 0) table->entries[*head].prev = index;
+    *head = index;
+}
+
+// remove a entrada da lista da roda em que está
+static void wheel_remove(reservation_table *table, int index) {
+    reservation_entry *e = &table->entries[index];
+    if (e->bucket < 0) return;
+    if (e->prev >= 0) {
+        table->entries[e->prev].next = e->next;
+    } else {
+        *bucket_head(table, e->bucket) = e->next;
+    }
+    if (e->next >= 0) table->entries[e->next].prev = e->prev;
+    e->bucket = -1;
+}
+
+// devolve a entrada ao pool livre (invalida o identificador antigo)
+static void release_entry(reservation_table *table, int index) {
+    reservation_entry *e = &table->entries[index];
+    e->code = 0;
+    e->quantity = 0;
+    e->generation = (uint16_t)((e->generation + 1) & ID_GENERATION_MASK);
+    e->next = table->free_head;
+    table->free_head = index;
+    table->pending--;
+}
+
+// obtém uma entrada livre, aumentando o pool se necessário (-1 se cheio)
+static int allocate_entry(reservation_table *table) {
+    if (table->free_head < 0) {
+        int max_capacity = RESERVATION_MAX_PENDING;
+        if (table->capacity >= max_capacity) return -1;
+        int capacity = table->capacity ? table->capacity * 2 : 1024;
+        if (capacity > max_capacity) capacity = max_capacity;
+
+        reservation_entry *entries = realloc(table->entries, (size_t)capacity * sizeof(reservation_entry));
+        if (!entries) return -1;
+        // encadeia as novas entradas na lista livre
+        for (int i = capacity - 1; i >= table->capacity; i--) {
+            memset(&entries[i], 0, sizeof(reservation_entry));
+            entries[i].bucket = -1;
+            entries[i].next = table->free_head;
+            table->free_head = i;
+        }
+        table->entries = entries;
+        table->capacity = capacity;
+    }
+
+    int index = table->free_head;
+    table->free_head = table->entries[index].next;
+    table->pending++;
+    return index;
+}
+
+// localiza a entrada pendente de um identificador (-1 se inválido ou antigo)
+static int find_entry(const reservation_table *table, uint32_t id) {
+    int index = (int)(id & ID_INDEX_MASK) - 1;
+    uint16_t generation = (uint16_t)((id >> ID_INDEX_BITS) & ID_GENERATION_MASK);
+    if (index < 0 || index >= table->capacity) return -1;
+    const reservation_entry *e = &table->entries[index];
+    if (e->code == 0 || e->generation != generation) return -1;
+    return index;
+}
+
+// inicializa tabela e roda vazias
+void initialize_reservation_table(reservation_table *table, movement_ledger *ledger,
+                                  product_bank *bank, uint32_t now) {
+    if (!table) return;
+    memset(table, 0, sizeof(*table));
+    table->ledger = ledger;
+    table->bank = bank;
+    table->free_head = -1;
+    table->current_tick = now;
+    for (int i = 0; i < WHEEL_LEVEL0_SIZE; i++) table->level0[i] = -1;
+    for (int i = 0; i < WHEEL_LEVEL_SIZE; i++) {
+        table->level1[i] = -1;
+        table->level2[i] = -1;
+    }
+}
+
+// desfaz reservas pendentes e libera o pool
+void free_reservation_table(reservation_table *table) {
+    if (!table) return;
+    spin_lock_acquire(&table->lock);
+    reservation_entry *entries = table->entries;
+    int capacity = table->capacity;
+    uint32_t tick = table->current_tick;
+    spin_lock_release(&table->lock);
+    // o pool já saiu da tabela: devolve as unidades sem a trava
+    for (int i = 0; i < capacity; i++) {
+        if (entries[i].code != 0) release_held_stock(table->bank, entries[i].code, entries[i].quantity);
+    }
+    free(entries);
+    initialize_reservation_table(table, table->ledger, table->bank, tick);
+}
+
+// cria reserva: segura o disponível e agenda a expiração
+uint32_t create_reservation(reservation_table *table, int code, int quantity,
+                            uint32_t timeout_seconds) {
+    if (!table || quantity <= 0 || timeout_seconds == 0 || timeout_seconds > RESERVATION_MAX_TIMEOUT) {
+        return 0;
+    }
+    if (!hold_stock(table->ledger, table->bank, code, quantity)) {
+        log_message(LOG_WARNING, "reservation", "Reserva recusada: disponivel insuficiente");
+        return 0;
+    }
+
+    spin_lock_acquire(&table->lock);
+    int index = allocate_entry(table);
+    if (index < 0) {
+        spin_lock_release(&table->lock);
+        release_held_stock(table->bank, code, quantity);
+        log_message(LOG_ERROR, "reservation", "Limite de reservas pendentes atingido");
+        return 0;
+    }
+
+    // o prazo conta do instante atual, mesmo que a roda esteja atrasada
+    uint32_t now = (uint32_t)time(NULL);
+    if (now < table->current_tick) now = table->current_tick;
+
+    reservation_entry *e = &table->entries[index];
+    e->code = code;
+    e->quantity = quantity;
+    e->expires_at = now + timeout_seconds;
+    wheel_insert(table, index);
+    uint32_t id = ((uint32_t)e->generation << ID_INDEX_BITS) | (uint32_t)(index + 1);
+    spin_lock_release(&table->lock);
+    return id;
+}
+
+// retira a reserva da tabela, devolvendo código e quantidade
+static int detach_reservation(reservation_table *table, uint32_t id, int *code, int *quantity) {
+    spin_lock_acquire(&table->lock);
+    int index = find_entry(table, id);
+    if (index < 0) {
+        spin_lock_release(&table->lock);
+        return 0;
+    }
+    *code = table->entries[index].code;
+    *quantity = table->entries[index].quantity;
+    wheel_remove(table, index);
+    release_entry(table, index);
+    spin_lock_release(&table->lock);
+    return 1;
+}
+
+// confirma reserva como venda
+int commit_reservation(reservation_table *table, uint32_t id) {
+    if (!table) return 0;
+    int code, quantity;
+    if (!detach_reservation(table, id, &code, &quantity)) return 0;
+
+    if (!commit_held_stock(table->ledger, table->bank, code, quantity)) {
+        release_held_stock(table->bank, code, quantity);
+        return 0;
+    }
+    return 1;
+}
+
+// cancela reserva
+int cancel_reservation(reservation_table *table, uint32_t id) {
+    if (!table) return 0;
+    int code, quantity;
+    if (!detach_reservation(table, id, &code, &quantity)) return 0;
+    release_held_stock(table->bank, code, quantity);
+    return 1;
+}
+
+// redistribui uma lista de nível superior nos níveis inferiores
+static void cascade(reservation_table *table, int *head) {
+    int index = *head;
+    *head = -1;
+    while (index >= 0) {
+        int next = table->entries[index].next;
+        wheel_insert(table, index);
+        index = next;
+    }
+}
+
+// unidades de uma reserva vencida, a devolver fora da trava
+typedef struct {
+    int code;
+    int quantity;
+} expired_hold;
+
+// avança a roda tick a tick até now, recolhendo até EXPIRE_BATCH vencidas
+// (chamada com a trava da tabela)
+// - as entradas voltam ao pool; só código e quantidade ficam em batch
+// - lote cheio no meio de um tick: o restante fica na posição do tick atual
+//   e é recolhido primeiro na chamada seguinte
+// - retorna 1 se o lote encheu antes de chegar a now
+static int collect_expired(reservation_table *table, uint32_t now, expired_hold batch[], int *count) {
+    while (1) {
+        // tudo que está na posição do tick atual já venceu
+        int slot0 = (int)(table->current_tick % WHEEL_LEVEL0_SIZE);
+        while (table->level0[slot0] >= 0) {
+            if (*count == EXPIRE_BATCH) return 1;
+            int index = table->level0[slot0];
+            reservation_entry *e = &table->entries[index];
+            table->level0[slot0] = e->next;
+            if (e->next >= 0) table->entries[e->next].prev = -1;
+            e->bucket = -1;
+            batch[*count].code = e->code;
+            batch[*count].quantity = e->quantity;
+            (*count)++;
+            release_entry(table, index);
+        }
+
+        // sem reservas pendentes não há o que percorrer
+        if (table->pending == 0) {
+            if (now > table->current_tick) table->current_tick = now;
+            return 0;
+        }
+        if (table->current_tick >= now) return 0;
+
+        uint32_t tick = ++table->current_tick;
+        // ao completar uma volta de um nível, desce a próxima faixa do nível acima
+        if (tick % WHEEL_LEVEL0_SIZE == 0) {
+            int slot1 = (int)((tick >> LEVEL1_SHIFT) % WHEEL_LEVEL_SIZE);
+            if (slot1 == 0) {
+                cascade(table, &table->level2[(tick >> LEVEL2_SHIFT) % WHEEL_LEVEL_SIZE]);
+            }
+            cascade(table, &table->level1[slot1]);
+        }
+    }
+}
+
+// avança a roda até now: as vencidas são recolhidas em lotes sob a trava e
+// devolvidas ao disponível depois de soltá-la
+int advance_reservations(reservation_table *table, uint32_t now) {
+    if (!table) return 0;
+    expired_hold batch[EXPIRE_BATCH];
+    int expired = 0, more = 1;
+    while (more) {
+        int count = 0;
+        spin_lock_acquire(&table->lock);
+        more = collect_expired(table, now, batch, &count);
+        spin_lock_release(&table->lock);
+        for (int i = 0; i < count; i++) release_held_stock(table->bank, batch[i].code, batch[i].quantity);
+        expired += count;
+    }
+    if (expired > 0) {
+        log_message(LOG_INFO, "reservation", "Reservas expiradas devolvidas ao estoque disponivel");
+    }
+    return expired;
+}
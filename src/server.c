@@ -0,0 +1,525 @@
+#ifndef _WIN32
+    #define _GNU_SOURCE         // accept4
+#endif
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include "server.h"
+#include "logger.h"
+#include "utils.h"
+#include "validation.h"
+
+#ifndef _WIN32
+    #include <sys/epoll.h>
+    #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+// ============================================================================
+// MÓDULO: server — Implementação do serviço local
+// ============================================================================
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// pedido de encerramento (tratador de sinal)
+static volatile sig_atomic_t stop_requested = 0;
+
+// pede o encerramento
+void request_server_stop(void) {
+    stop_requested = 1;
+}
+
+// ============================================================================
+// HISTOGRAMA DE LATÊNCIA
+// ============================================================================
+// Log-linear: valores abaixo de 16 ns têm faixa própria; acima disso, cada
+// potência de 2 é dividida em 8 faixas (erro relativo de até 12,5%)
+
+// faixa do histograma de um valor em nanossegundos
+static int latency_bucket(uint64_t nanoseconds) {
+    if (nanoseconds < 16) return (int)nanoseconds;
+    int exponent = 63 - __builtin_clzll(nanoseconds);
+    int index = 16 + (exponent - 4) * 8 + (int)((nanoseconds >> (exponent - 3)) & 7);
+    return index < SERVER_LATENCY_BUCKETS ? index : SERVER_LATENCY_BUCKETS - 1;
+}
+
+// maior valor que cai na faixa
+static uint64_t bucket_limit(int index) {
+    if (index < 16) return (uint64_t)index;
+    int exponent = (index - 16) / 8 + 4;
+    int step = (index - 16) % 8;
+    return ((uint64_t)(8 + step + 1) << (exponent - 3)) - 1;
+}
+
+// percentil da latência
+uint64_t server_latency_percentile(const server_stats *stats, double fraction) {
+    if (!stats) return 0;
+    uint64_t total = 0;
+    for (int i = 0; i < SERVER_LATENCY_BUCKETS; i++) total += stats->latency[i];
+    if (total == 0) return 0;
+    uint64_t target = (uint64_t)(fraction * (double)total);
+    if (target < 1) target = 1;
+    if (target > total) target = total;
+    uint64_t seen = 0;
+    for (int i = 0; i < SERVER_LATENCY_BUCKETS; i++) {
+        seen += stats->latency[i];
+        if (seen >= target) return bucket_limit(i);
+    }
+    return bucket_limit(SERVER_LATENCY_BUCKETS - 1);
+}
+
+#ifdef _WIN32
+
+// sem sockets Unix nem epoll: o serviço não está disponível
+int run_server(const server_config *config, server_stats *stats) {
+    (void)config;
+    if (stats) memset(stats, 0, sizeof(*stats));
+    log_message(LOG_ERROR, "server", "Servico local indisponivel no Windows");
+    return 0;
+}
+
+#else
+
+// eventos tratados por volta do laço
+#define SERVER_EVENTS 64
+
+// bytes lidos por chamada de recv
+#define SERVER_READ_CHUNK 65536
+
+// maior corpo de resposta (RANGE com SERVER_RANGE_MAX códigos)
+#define SERVER_BODY_MAX (3 + 4 * SERVER_RANGE_MAX)
+
+// respostas pendentes de envio a partir das quais a conexão deixa de ser lida
+#define SERVER_OUTPUT_HIGH (1 << 20)
+
+// maior buffer de entrada de uma conexão (cheio, sempre contém um quadro
+// completo: a leitura só volta depois que ele é processado)
+#define SERVER_INPUT_MAX (4 * SERVER_READ_CHUNK)
+
+// ============================================================================
+// CONEXÕES
+// ============================================================================
+
+// conexão com um cliente
+typedef struct connection {
+    int fd;
+    unsigned char *in;          // bytes recebidos ainda não processados
+    size_t in_used;
+    size_t in_capacity;
+    unsigned char *out;         // respostas (out_sent já enviados)
+    size_t out_used;
+    size_t out_sent;
+    size_t out_capacity;
+    uint32_t interest;          // eventos registrados no epoll
+    int input_closed;           // 1 = cliente fechou a escrita: só falta responder
+    struct connection *prev;    // lista das conexões abertas
+    struct connection *next;
+} connection;
+
+// estado do laço de eventos
+typedef struct {
+    const server_config *config;
+    server_stats *stats;
+    int epoll_fd;
+    int listen_fd;
+    listing_row *rows;          // rascunho das consultas RANGE
+    connection *open;           // conexões abertas (encerradas no fim)
+} server_state;
+
+// garante espaço para mais extra bytes de resposta
+static int reserve_output(connection *conn, size_t extra) {
+    if (conn->out_sent > 0 && conn->out_sent == conn->out_used) {
+        conn->out_sent = conn->out_used = 0;
+    }
+    if (conn->out_used + extra <= conn->out_capacity) return 1;
+    if (conn->out_sent > 0) {
+        memmove(conn->out, conn->out + conn->out_sent, conn->out_used - conn->out_sent);
+        conn->out_used -= conn->out_sent;
+        conn->out_sent = 0;
+        if (conn->out_used + extra <= conn->out_capacity) return 1;
+    }
+    size_t capacity = conn->out_capacity ? conn->out_capacity : SERVER_READ_CHUNK;
+    while (capacity < conn->out_used + extra) capacity *= 2;
+    unsigned char *grown = realloc(conn->out, capacity);
+    if (!grown) return 0;
+    conn->out = grown;
+    conn->out_capacity = capacity;
+    return 1;
+}
+
+// escrita de inteiros little-endian
+static void put_u16(unsigned char *at, uint32_t value) {
+    at[0] = (unsigned char)value;
+    at[1] = (unsigned char)(value >> 8);
+}
+
+static void put_u32(unsigned char *at, uint32_t value) {
+    for (int i = 0; i < 4; i++) at[i] = (unsigned char)(value >> (8 * i));
+}
+
+static void put_u64(unsigned char *at, uint64_t value) {
+    for (int i = 0; i < 8; i++) at[i] = (unsigned char)(value >> (8 * i));
+}
+
+// leitura de inteiros little-endian
+static uint32_t get_u16(const unsigned char *at) {
+    return (uint32_t)at[0] | (uint32_t)at[1] << 8;
+}
+
+static uint32_t get_u32(const unsigned char *at) {
+    return (uint32_t)at[0] | (uint32_t)at[1] << 8 | (uint32_t)at[2] << 16 | (uint32_t)at[3] << 24;
+}
+
+// encerra a conexão
+static void close_connection(server_state *state, connection *conn) {
+    if (conn->prev) conn->prev->next = conn->next;
+    else state->open = conn->next;
+    if (conn->next) conn->next->prev = conn->prev;
+    epoll_ctl(state->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    free(conn->in);
+    free(conn->out);
+    free(conn);
+}
+
+// ============================================================================
+// OPERAÇÕES
+// ============================================================================
+
+// monta o corpo da resposta de uma requisição em body (até SERVER_BODY_MAX)
+// - retorna a situação; *length recebe o tamanho do corpo
+static server_status execute(server_state *state, const unsigned char *args, size_t arg_length,
+                             int operation, unsigned char *body, size_t *length) {
+    const server_config *config = state->config;
+    *length = 0;
+    switch (operation) {
+        case SERVER_OP_PING:
+            return SERVER_OK;
+
+        case SERVER_OP_LOOKUP: {
+            if (arg_length != 4) return SERVER_BAD_REQUEST;
+            int code = (int)get_u32(args);
+            product p;
+            p.code = 0;
+            read_product_snapshot(config->bank, code, &p);   // inativos também
+            if (p.code != code || !is_valid_code(code)) return SERVER_NOT_FOUND;
+            // reservas são por posição: o disponível é lido no próprio banco
+            product *live = find_product_by_code(config->bank, code);
+            int available = live ? available_quantity(config->bank, live) : p.quantity;
+            size_t name_length = strnlen(p.name, sizeof(p.name) - 1);
+            put_u32(body, (uint32_t)p.code);
+            put_u32(body + 4, range_value_of(RANGE_BY_PRICE, &p));
+            put_u32(body + 8, (uint32_t)p.quantity);
+            put_u32(body + 12, (uint32_t)available);
+            put_u32(body + 16, (uint32_t)p.minimum_stock);
+            body[20] = (unsigned char)p.category;
+            body[21] = (unsigned char)p.unit;
+            body[22] = (unsigned char)p.active;
+            body[23] = (unsigned char)name_length;
+            memcpy(body + 24, p.name, name_length);
+            *length = 24 + name_length;
+            return SERVER_OK;
+        }
+
+        case SERVER_OP_MOVE: {
+            if (arg_length != 9 || !config->ledger) return SERVER_BAD_REQUEST;
+            int code = (int)get_u32(args);
+            int type = args[4];
+            int quantity = (int)get_u32(args + 5);
+            if (type < MOVEMENT_IN || type > MOVEMENT_ADJUSTMENT) return SERVER_BAD_REQUEST;
+            product p;
+            if (!read_product_snapshot(config->bank, code, &p)) return SERVER_NOT_FOUND;
+            if (!record_movement(config->ledger, config->bank, code, (movement_type)type, quantity)) {
+                return SERVER_REFUSED;
+            }
+            read_product_snapshot(config->bank, code, &p);
+            put_u32(body, (uint32_t)p.quantity);
+            *length = 4;
+            return SERVER_OK;
+        }
+
+        case SERVER_OP_RANGE: {
+            if (arg_length != 11) return SERVER_BAD_REQUEST;
+            int field = args[0];
+            uint32_t low = get_u32(args + 1);
+            uint32_t high = get_u32(args + 5);
+            uint32_t limit = get_u16(args + 9);
+            range_index *index = field == RANGE_BY_PRICE ? config->prices
+                               : field == RANGE_BY_QUANTITY ? config->quantities : NULL;
+            if (!index || low > high || limit > SERVER_RANGE_MAX) return SERVER_BAD_REQUEST;
+            range_cursor cursor;
+            if (!open_range(&cursor, index, low, high)) return SERVER_BAD_REQUEST;
+            int count = limit > 0 ? next_range_page(&cursor, state->rows, limit) : 0;
+            if (count < 0) return SERVER_FAILED;
+            put_u16(body, (uint32_t)count);
+            body[2] = (unsigned char)(count == (int)limit && range_has_more(&cursor));
+            for (int i = 0; i < count; i++) {
+                put_u32(body + 3 + 4 * i, (uint32_t)state->rows[i].item.code);
+            }
+            *length = 3 + 4 * (size_t)count;
+            return SERVER_OK;
+        }
+
+        case SERVER_OP_STATS: {
+            if (arg_length != 0) return SERVER_BAD_REQUEST;
+            const server_stats *stats = state->stats;
+            put_u64(body, stats->requests);
+            put_u64(body + 8, stats->connections);
+            put_u32(body + 16, (uint32_t)server_latency_percentile(stats, 0.50));
+            put_u32(body + 20, (uint32_t)server_latency_percentile(stats, 0.99));
+            put_u32(body + 24, (uint32_t)server_latency_percentile(stats, 0.999));
+            put_u32(body + 28, (uint32_t)server_latency_percentile(stats, 1.0));
+            *length = 32;
+            return SERVER_OK;
+        }
+    }
+    return SERVER_BAD_REQUEST;
+}
+
+// processa os quadros completos recebidos (em ordem) e enfileira as respostas
+// - received_at: instante em que os bytes chegaram (base da latência)
+// - retorna 1 se sucesso, 0 se a conexão deve ser encerrada
+static int process_frames(server_state *state, connection *conn, double received_at) {
+    unsigned char body[SERVER_BODY_MAX];
+    size_t offset = 0;
+    while (conn->out_used - conn->out_sent < SERVER_OUTPUT_HIGH) {
+        if (conn->in_used - offset < 4) break;
+        uint32_t frame_length = get_u32(conn->in + offset);
+        if (frame_length < 5 || frame_length > SERVER_FRAME_MAX) {
+            state->stats->protocol_errors++;
+            log_message(LOG_WARNING, "server", "Quadro invalido: conexao encerrada");
+            return 0;
+        }
+        if (conn->in_used - offset - 4 < frame_length) break;
+        const unsigned char *frame = conn->in + offset + 4;
+        offset += 4 + frame_length;
+
+        size_t body_length;
+        server_status status = execute(state, frame + 5, frame_length - 5, frame[4],
+                                       body, &body_length);
+        if (!reserve_output(conn, 9 + body_length)) return 0;
+        unsigned char *at = conn->out + conn->out_used;
+        put_u32(at, (uint32_t)(5 + body_length));
+        memcpy(at + 4, frame, 4);   // id da requisição
+        at[8] = (unsigned char)status;
+        memcpy(at + 9, body, body_length);
+        conn->out_used += 9 + body_length;
+
+        double elapsed = monotonic_seconds() - received_at;
+        state->stats->latency[latency_bucket((uint64_t)(elapsed * 1e9))]++;
+        state->stats->requests++;
+    }
+    // descarta o que foi processado (o resto é um quadro incompleto)
+    if (offset > 0) {
+        memmove(conn->in, conn->in + offset, conn->in_used - offset);
+        conn->in_used -= offset;
+    }
+    return 1;
+}
+
+// envia o que for possível das respostas pendentes
+// - retorna 1 se sucesso, 0 se a conexão caiu
+static int flush_output(connection *conn) {
+    while (conn->out_sent < conn->out_used) {
+        ssize_t sent = send(conn->fd, conn->out + conn->out_sent,
+                            conn->out_used - conn->out_sent, MSG_NOSIGNAL);
+        if (sent > 0) {
+            conn->out_sent += (size_t)sent;
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        return 0;
+    }
+    return 1;
+}
+
+// verifica se a entrada já tem um quadro inteiro (ou um tamanho inválido)
+static int has_complete_frame(const connection *conn) {
+    if (conn->in_used < 4) return 0;
+    uint32_t frame_length = get_u32(conn->in);
+    return frame_length > SERVER_FRAME_MAX || conn->in_used - 4 >= frame_length;
+}
+
+// verifica se a conexão pode receber mais bytes
+// - não lê com SERVER_OUTPUT_HIGH de respostas por enviar (cliente que não
+//   lê as respostas), com o buffer de entrada cheio nem depois que o cliente
+//   fechou a escrita
+static int accepts_input(const connection *conn) {
+    return !conn->input_closed
+        && conn->out_used - conn->out_sent < SERVER_OUTPUT_HIGH
+        && conn->in_used < SERVER_INPUT_MAX;
+}
+
+// ajusta os eventos registrados no epoll ao estado da conexão
+// - sem leitura, EPOLLIN e EPOLLRDHUP saem do registro (o epoll é por nível:
+//   senão o laço giraria sem fazer nada); a saída pendente mantém EPOLLOUT e
+//   a leitura volta quando ela escoar
+static void update_interest(server_state *state, connection *conn) {
+    uint32_t wanted = (accepts_input(conn) ? EPOLLIN | EPOLLRDHUP : 0)
+                    | (conn->out_sent < conn->out_used ? EPOLLOUT : 0);
+    if (wanted == conn->interest) return;
+    struct epoll_event event;
+    event.events = wanted;
+    event.data.ptr = conn;
+    epoll_ctl(state->epoll_fd, EPOLL_CTL_MOD, conn->fd, &event);
+    conn->interest = wanted;
+}
+
+// trata os eventos de uma conexão
+// - cliente que fecha só a escrita (recv == 0) ainda recebe as respostas dos
+//   quadros já enviados: a conexão fica aberta até a saída escoar
+// - retorna 1 se a conexão continua aberta, 0 se deve ser encerrada
+static int serve_connection(server_state *state, connection *conn, uint32_t events) {
+    if (events & EPOLLERR) return 0;
+    if ((events & (EPOLLIN | EPOLLHUP | EPOLLRDHUP)) && accepts_input(conn)) {
+        if (conn->in_capacity - conn->in_used < SERVER_READ_CHUNK
+            && conn->in_capacity < SERVER_INPUT_MAX) {
+            size_t capacity = conn->in_used + SERVER_READ_CHUNK;
+            if (capacity > SERVER_INPUT_MAX) capacity = SERVER_INPUT_MAX;
+            unsigned char *grown = realloc(conn->in, capacity);
+            if (!grown) return 0;
+            conn->in = grown;
+            conn->in_capacity = capacity;
+        }
+        ssize_t got = recv(conn->fd, conn->in + conn->in_used,
+                           conn->in_capacity - conn->in_used, 0);
+        if (got > 0) {
+            conn->in_used += (size_t)got;
+        } else if (got == 0) {
+            conn->input_closed = 1;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            return 0;
+        }
+    }
+    // também roda depois de EPOLLOUT: quadros retidos pela saída cheia voltam
+    // a andar quando ela escoa, sem esperar novos bytes do cliente
+    do {
+        if (!process_frames(state, conn, monotonic_seconds())) return 0;
+        if (!flush_output(conn)) return 0;
+    } while (conn->out_sent == conn->out_used && has_complete_frame(conn));
+    if (conn->input_closed && conn->out_sent == conn->out_used && !has_complete_frame(conn)) return 0;
+    update_interest(state, conn);
+    return 1;
+}
+
+// aceita as conexões pendentes
+static void accept_connections(server_state *state) {
+    while (1) {
+        int fd = accept4(state->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                log_message(LOG_WARNING, "server", "Falha ao aceitar conexao");
+            }
+            return;
+        }
+        connection *conn = calloc(1, sizeof(connection));
+        struct epoll_event event;
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.ptr = conn;
+        if (!conn || (conn->fd = fd, epoll_ctl(state->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)) {
+            free(conn);
+            close(fd);
+            log_message(LOG_WARNING, "server", "Conexao recusada: recursos insuficientes");
+            continue;
+        }
+        conn->interest = event.events;
+        conn->next = state->open;
+        if (state->open) state->open->prev = conn;
+        state->open = conn;
+        state->stats->connections++;
+    }
+}
+
+// cria o socket de escuta (remove um socket antigo deixado no mesmo caminho)
+static int open_listener(const char *path) {
+    struct sockaddr_un address;
+    if (strlen(path) >= sizeof(address.sun_path)) return -1;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    struct stat info;
+    if (stat(path, &info) == 0 && S_ISSOCK(info.st_mode)) unlink(path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// atende clientes até o pedido de encerramento
+int run_server(const server_config *config, server_stats *stats) {
+    if (!config || !config->bank || !config->socket_path) return 0;
+    server_stats local;
+    server_state state;
+    memset(&state, 0, sizeof(state));
+    state.config = config;
+    state.stats = stats ? stats : &local;
+    memset(state.stats, 0, sizeof(*state.stats));
+
+    state.listen_fd = open_listener(config->socket_path);
+    if (state.listen_fd < 0) {
+        log_message(LOG_ERROR, "server", "Nao foi possivel abrir o socket do servico");
+        return 0;
+    }
+    state.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    state.rows = malloc(SERVER_RANGE_MAX * sizeof(listing_row));
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;      // NULL identifica o socket de escuta
+    if (state.epoll_fd < 0 || !state.rows
+        || epoll_ctl(state.epoll_fd, EPOLL_CTL_ADD, state.listen_fd, &event) != 0) {
+        if (state.epoll_fd >= 0) close(state.epoll_fd);
+        close(state.listen_fd);
+        unlink(config->socket_path);
+        free(state.rows);
+        log_message(LOG_ERROR, "server", "Nao foi possivel iniciar o laco de eventos");
+        return 0;
+    }
+
+    char message[200];
+    snprintf(message, sizeof(message), "Servico atendendo em %s", config->socket_path);
+    log_message(LOG_INFO, "server", message);
+
+    stop_requested = 0;
+    struct epoll_event events[SERVER_EVENTS];
+    while (!stop_requested) {
+        int ready = epoll_wait(state.epoll_fd, events, SERVER_EVENTS, 1000);
+        for (int i = 0; i < ready; i++) {
+            connection *conn = events[i].data.ptr;
+            if (!conn) {
+                accept_connections(&state);
+            } else if (!serve_connection(&state, conn, events[i].events)) {
+                close_connection(&state, conn);
+            }
+        }
+    }
+
+    while (state.open) close_connection(&state, state.open);
+    close(state.listen_fd);
+    unlink(config->socket_path);
+    close(state.epoll_fd);
+    free(state.rows);
+    snprintf(message, sizeof(message),
+             "Servico encerrado: %llu requisicoes, %llu conexoes, p50 %llu ns, p99 %llu ns, p999 %llu ns",
+             (unsigned long long)state.stats->requests, (unsigned long long)state.stats->connections,
+             (unsigned long long)server_latency_percentile(state.stats, 0.50),
+             (unsigned long long)server_latency_percentile(state.stats, 0.99),
+             (unsigned long long)server_latency_percentile(state.stats, 0.999));
+    log_message(LOG_INFO, "server", message);
+    return 1;
+}
+
+#endif // _WIN32
@@ -0,0 +1,276 @@
+#include <stdlib.h>
+#include <string.h>
+#include "slot_bitmap.h"
+
+// ============================================================================
+// MÓDULO: slot_bitmap — Implementação dos conjuntos comprimidos
+// ============================================================================
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// ============================================================================
+// BLOCOS
+// ============================================================================
+
+// libera a memória de um bloco
+static void free_container(bitmap_container *container) {
+    free(container->values);
+    free(container->words);
+    container->values = NULL;
+    container->words = NULL;
+    container->cardinality = 0;
+}
+
+// reserva espaço para mais um bloco
+static bitmap_container *push_container(slot_bitmap *bitmap, uint32_t key) {
+    if (bitmap->count > 0 && bitmap->containers[bitmap->count - 1].key >= key) return NULL;
+    if (bitmap->count == bitmap->capacity) {
+        int capacity = bitmap->capacity ? bitmap->capacity * 2 : 8;
+        bitmap_container *containers = realloc(bitmap->containers,
+                                               (size_t)capacity * sizeof(bitmap_container));
+        if (!containers) return NULL;
+        bitmap->containers = containers;
+        bitmap->capacity = capacity;
+    }
+    bitmap_container *container = &bitmap->containers[bitmap->count];
+    memset(container, 0, sizeof(*container));
+    container->key = key;
+    return container;
+}
+
+// acrescenta um bloco em formato lista (values com cardinality posições)
+static int append_values(slot_bitmap *bitmap, uint32_t key, const uint16_t *values, int cardinality) {
+    if (cardinality == 0) return 1;
+    bitmap_container *container = push_container(bitmap, key);
+    if (!container) return 0;
+    container->values = malloc((size_t)cardinality * sizeof(uint16_t));
+    if (!container->values) return 0;
+    memcpy(container->values, values, (size_t)cardinality * sizeof(uint16_t));
+    container->cardinality = cardinality;
+    bitmap->count++;
+    return 1;
+}
+
+// expande um bloco para mapa de bits (words precisa de BITMAP_WORDS palavras)
+static void expand_container(const bitmap_container *container, uint64_t *words) {
+    if (container->words) {
+        memcpy(words, container->words, BITMAP_WORDS * sizeof(uint64_t));
+        return;
+    }
+    memset(words, 0, BITMAP_WORDS * sizeof(uint64_t));
+    for (int i = 0; i < container->cardinality; i++) {
+        uint16_t value = container->values[i];
+        words[value >> 6] |= (uint64_t)1 << (value & 63);
+    }
+}
+
+// verifica se o bloco contém os 16 bits baixos value
+static int container_contains(const bitmap_container *container, uint16_t value) {
+    if (container->words) return (int)((container->words[value >> 6] >> (value & 63)) & 1);
+    int low = 0, high = container->cardinality;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (container->values[middle] < value) low = middle + 1;
+        else high = middle;
+    }
+    return low < container->cardinality && container->values[low] == value;
+}
+
+// ============================================================================
+// OPERAÇÕES ENTRE BLOCOS
+// ============================================================================
+
+// intersecta duas listas
+// - out precisa de min(a_count, b_count) posições
+// - retorna quantidade de posições em out
+static int intersect_values(const uint16_t *a, int a_count, const uint16_t *b, int b_count,
+                            uint16_t *out) {
+    int i = 0, j = 0, n = 0;
+    while (i < a_count && j < b_count) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (a[i] > b[j]) {
+            j++;
+        } else {
+            out[n++] = a[i];
+            i++;
+            j++;
+        }
+    }
+    return n;
+}
+
+// intersecta dois blocos de mesma key e acrescenta o resultado a out
+// - scratch: BITMAP_WORDS palavras para a e outras BITMAP_WORDS para b
+static int intersect_containers(const bitmap_container *a, const bitmap_container *b,
+                                slot_bitmap *out, uint64_t *scratch) {
+    uint16_t values[BITMAP_ARRAY_MAX];
+
+    // duas listas: intercalação
+    if (a->values && b->values) {
+        int n = intersect_values(a->values, a->cardinality, b->values, b->cardinality, values);
+        return append_values(out, a->key, values, n);
+    }
+
+    // lista de um lado e mapa do outro: consulta de bits, o resultado é lista
+    if (a->values || b->values) {
+        const bitmap_container *list = a->values ? a : b;
+        const bitmap_container *map = a->values ? b : a;
+        int n = 0;
+        for (int i = 0; i < list->cardinality; i++) {
+            if (container_contains(map, list->values[i])) values[n++] = list->values[i];
+        }
+        return append_values(out, a->key, values, n);
+    }
+
+    // dois mapas: palavra a palavra
+    uint64_t *left = scratch;
+    uint64_t *right = scratch + BITMAP_WORDS;
+    expand_container(a, left);
+    expand_container(b, right);
+    for (int w = 0; w < BITMAP_WORDS; w++) left[w] &= right[w];
+    return bitmap_append_words(out, a->key, left);
+}
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// conjunto vazio
+void initialize_slot_bitmap(slot_bitmap *bitmap) {
+    if (!bitmap) return;
+    memset(bitmap, 0, sizeof(*bitmap));
+}
+
+// libera o conjunto
+void free_slot_bitmap(slot_bitmap *bitmap) {
+    if (!bitmap) return;
+    for (int i = 0; i < bitmap->count; i++) free_container(&bitmap->containers[i]);
+    free(bitmap->containers);
+    memset(bitmap, 0, sizeof(*bitmap));
+}
+
+// acrescenta bloco em mapa de bits
+int bitmap_append_words(slot_bitmap *bitmap, uint32_t key, const uint64_t words[BITMAP_WORDS]) {
+    if (!bitmap || !words) return 0;
+    int cardinality = 0;
+    for (int w = 0; w < BITMAP_WORDS; w++) cardinality += __builtin_popcountll(words[w]);
+    if (cardinality == 0) return 1;
+
+    if (cardinality <= BITMAP_ARRAY_MAX) {
+        // poucas posições: vira lista
+        uint16_t values[BITMAP_ARRAY_MAX];
+        int n = 0;
+        for (int w = 0; w < BITMAP_WORDS; w++) {
+            uint64_t word = words[w];
+            while (word) {
+                values[n++] = (uint16_t)(w * 64 + __builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+        return append_values(bitmap, key, values, n);
+    }
+
+    bitmap_container *container = push_container(bitmap, key);
+    if (!container) return 0;
+    container->words = malloc(BITMAP_WORDS * sizeof(uint64_t));
+    if (!container->words) return 0;
+    memcpy(container->words, words, BITMAP_WORDS * sizeof(uint64_t));
+    container->cardinality = cardinality;
+    bitmap->count++;
+    return 1;
+}
+
+// monta a partir de posições ordenadas
+int bitmap_from_sorted(slot_bitmap *bitmap, const int *slots, size_t count) {
+    if (!bitmap || (!slots && count > 0)) return 0;
+    free_slot_bitmap(bitmap);
+    uint64_t words[BITMAP_WORDS];
+    size_t i = 0;
+    while (i < count) {
+        uint32_t key = (uint32_t)slots[i] >> 16;
+        memset(words, 0, sizeof(words));
+        for (; i < count && ((uint32_t)slots[i] >> 16) == key; i++) {
+            uint32_t low = (uint32_t)slots[i] & 0xFFFF;
+            words[low >> 6] |= (uint64_t)1 << (low & 63);
+        }
+        if (!bitmap_append_words(bitmap, key, words)) {
+            free_slot_bitmap(bitmap);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// interseção (blocos presentes só de um lado ficam de fora)
+int bitmap_and(const slot_bitmap *a, const slot_bitmap *b, slot_bitmap *out) {
+    if (!a || !b || !out || out == a || out == b) return 0;
+    free_slot_bitmap(out);
+    uint64_t *scratch = malloc(2 * BITMAP_WORDS * sizeof(uint64_t));
+    if (!scratch) return 0;
+
+    int ok = 1;
+    int i = 0, j = 0;
+    while (ok && i < a->count && j < b->count) {
+        const bitmap_container *left = &a->containers[i];
+        const bitmap_container *right = &b->containers[j];
+        if (left->key < right->key) {
+            i++;
+        } else if (right->key < left->key) {
+            j++;
+        } else {
+            ok = intersect_containers(left, right, out, scratch);
+            i++;
+            j++;
+        }
+    }
+    free(scratch);
+    if (!ok) free_slot_bitmap(out);
+    return ok;
+}
+
+// pertinência
+int bitmap_contains(const slot_bitmap *bitmap, int slot) {
+    if (!bitmap || slot < 0) return 0;
+    uint32_t key = (uint32_t)slot >> 16;
+    int low = 0, high = bitmap->count;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (bitmap->containers[middle].key < key) low = middle + 1;
+        else high = middle;
+    }
+    if (low == bitmap->count || bitmap->containers[low].key != key) return 0;
+    return container_contains(&bitmap->containers[low], (uint16_t)(slot & 0xFFFF));
+}
+
+// cardinalidade
+long long bitmap_cardinality(const slot_bitmap *bitmap) {
+    if (!bitmap) return 0;
+    long long total = 0;
+    for (int i = 0; i < bitmap->count; i++) total += bitmap->containers[i].cardinality;
+    return total;
+}
+
+// posições em ordem crescente
+int bitmap_to_slots(const slot_bitmap *bitmap, int out[], size_t max_out) {
+    if (!bitmap || !out) return 0;
+    size_t n = 0;
+    for (int i = 0; i < bitmap->count && n < max_out; i++) {
+        const bitmap_container *container = &bitmap->containers[i];
+        int base = (int)(container->key << 16);
+        if (container->values) {
+            for (int v = 0; v < container->cardinality && n < max_out; v++) {
+                out[n++] = base + container->values[v];
+            }
+            continue;
+        }
+        for (int w = 0; w < BITMAP_WORDS && n < max_out; w++) {
+            uint64_t word = container->words[w];
+            while (word && n < max_out) {
+                out[n++] = base + w * 64 + __builtin_ctzll(word);
+                word &= word - 1;
+            }
+        }
+    }
+    return (int)n;
+}
@@ -0,0 +1,216 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "snapshot_diff.h"
+#include "persistence.h"
+#include "relatorio.h"
+#include "logger.h"
+#include "utils.h"
+
+// ============================================================================
+// MÓDULO: snapshot_diff — Implementação da comparação em fluxo
+// ============================================================================
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// campos alterados (combinados em uma máscara)
+#define CHANGED_NAME     (1 << 0)
+#define CHANGED_PRICE    (1 << 1)
+#define CHANGED_QUANTITY (1 << 2)
+#define CHANGED_MINIMUM  (1 << 3)
+#define CHANGED_CATEGORY (1 << 4)
+#define CHANGED_UNIT     (1 << 5)
+#define CHANGED_ACTIVE   (1 << 6)
+
+// campos contados em other_changed
+#define CHANGED_OTHER (CHANGED_NAME | CHANGED_MINIMUM | CHANGED_CATEGORY | CHANGED_UNIT)
+
+// compara campo a campo (bytes após o fim do nome não contam)
+static int changed_fields(const product *before, const product *after) {
+    int mask = 0;
+    if (strncmp(before->name, after->name, PRODUCT_NAME_MAX_LENGTH) != 0) mask |= CHANGED_NAME;
+    if (before->price != after->price) mask |= CHANGED_PRICE;
+    if (before->quantity != after->quantity) mask |= CHANGED_QUANTITY;
+    if (before->minimum_stock != after->minimum_stock) mask |= CHANGED_MINIMUM;
+    if (before->category != after->category) mask |= CHANGED_CATEGORY;
+    if (before->unit != after->unit) mask |= CHANGED_UNIT;
+    if (before->active != after->active) mask |= CHANGED_ACTIVE;
+    return mask;
+}
+
+// escreve a lista de campos alterados separados por ';'
+static void write_changed_fields(report_buffer *report, int mask) {
+    static const struct { int bit; const char *name; } fields[] = {
+        { CHANGED_NAME, "nome" }, { CHANGED_PRICE, "preco" }, { CHANGED_QUANTITY, "quantidade" },
+        { CHANGED_MINIMUM, "minimo" }, { CHANGED_CATEGORY, "categoria" }, { CHANGED_UNIT, "unidade" },
+        { CHANGED_ACTIVE, "ativo" }
+    };
+    int first = 1;
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        if (!(mask & fields[i].bit)) continue;
+        if (!first) report_put_text(report, ";");
+        report_put_text(report, fields[i].name);
+        first = 0;
+    }
+}
+
+// uma linha do relatório (before ou after podem ser NULL)
+static void write_change(report_buffer *report, const char *change, int mask,
+                         const product *before, const product *after) {
+    const product *current = after ? after : before;
+    report_put_long(report, current->code);
+    report_put_text(report, ",");
+    report_put_text(report, change);
+    report_put_text(report, ",");
+    write_changed_fields(report, mask);
+    report_put_text(report, ",");
+    report_put_csv_text(report, current->name);
+    // lado ausente (produto novo ou removido) fica com as colunas vazias
+    report_put_text(report, ",");
+    if (before) report_put_price(report, before);
+    report_put_text(report, ",");
+    if (after) report_put_price(report, after);
+    report_put_text(report, ",");
+    if (before) report_put_long(report, before->quantity);
+    report_put_text(report, ",");
+    if (after) report_put_long(report, after->quantity);
+    report_put_text(report, ",");
+    report_put_long(report, (after ? after->quantity : 0) - (before ? before->quantity : 0));
+    report_put_text(report, "\n");
+}
+
+// uma linha do resumo
+static void write_summary_line(report_buffer *report, const char *name, int value) {
+    report_put_text(report, name);
+    report_put_text(report, ",");
+    report_put_long(report, value);
+    report_put_text(report, "\n");
+}
+
+// avança um lado da junção, conferindo a ordem de código
+// retorna 1 se leu, 0 no fim, -1 se erro
+static int advance(snapshot_reader *reader, product *current, int *last_code) {
+    int status = read_next_snapshot_product(reader, current);
+    if (status == 1) {
+        if (current->code <= *last_code) {
+            log_message(LOG_ERROR, "snapshot_diff", "Arquivo de dados fora de ordem de codigo");
+            return -1;
+        }
+        *last_code = current->code;
+    }
+    return status;
+}
+
+// compara os arquivos
+int diff_snapshots(const char *old_path, const char *new_path, report_buffer *buffer,
+                   const char *report_path, snapshot_diff_summary *summary) {
+    if (!old_path || !new_path || !summary || (report_path && !buffer)) return 0;
+    double started_at = monotonic_seconds();
+    memset(summary, 0, sizeof(*summary));
+
+    // os dois leitores guardam um bloco de produtos cada: ficam no heap
+    snapshot_reader *readers = malloc(2 * sizeof(snapshot_reader));
+    if (!readers) {
+        log_message(LOG_ERROR, "snapshot_diff", "Memoria insuficiente para comparar arquivos");
+        return 0;
+    }
+    snapshot_reader *before_reader = &readers[0];
+    snapshot_reader *after_reader = &readers[1];
+    if (!open_snapshot_reader(before_reader, old_path)) {
+        free(readers);
+        return 0;
+    }
+    if (!open_snapshot_reader(after_reader, new_path)) {
+        close_snapshot_reader(before_reader);
+        free(readers);
+        return 0;
+    }
+
+    report_buffer *report = NULL;
+    if (report_path) {
+        if (!begin_report_file(buffer, report_path)) {
+            log_message(LOG_ERROR, "snapshot_diff", "Nao foi possivel criar o relatorio de diferencas");
+            close_snapshot_reader(before_reader);
+            close_snapshot_reader(after_reader);
+            free(readers);
+            return 0;
+        }
+        report = buffer;
+        report_put_text(report, "codigo,alteracao,campos,nome,preco_anterior,preco_novo,"
+                        "quantidade_anterior,quantidade_nova,variacao_quantidade\n");
+    }
+
+    summary->old_count = before_reader->product_count;
+    summary->new_count = after_reader->product_count;
+    summary->header_changed = before_reader->next_code != after_reader->next_code;
+
+    // junção por intercalação: sempre avança o lado de menor código
+    product before, after;
+    int before_last = 0, after_last = 0;
+    int has_before = advance(before_reader, &before, &before_last);
+    int has_after = advance(after_reader, &after, &after_last);
+
+    while (has_before > 0 || has_after > 0) {
+        if (has_before < 0 || has_after < 0) break;
+
+        if (has_after == 0 || (has_before > 0 && before.code < after.code)) {
+            summary->removed++;
+            summary->changed_products++;
+            if (report) write_change(report, "removido", 0, &before, NULL);
+            has_before = advance(before_reader, &before, &before_last);
+        } else if (has_before == 0 || after.code < before.code) {
+            summary->added++;
+            summary->changed_products++;
+            if (report) write_change(report, "novo", 0, NULL, &after);
+            has_after = advance(after_reader, &after, &after_last);
+        } else {
+            int mask = changed_fields(&before, &after);
+            if (mask == 0) {
+                summary->unchanged++;
+            } else {
+                summary->changed_products++;
+                const char *change = "alterado";
+                if (mask & CHANGED_ACTIVE) {
+                    change = after.active ? "reativado" : "inativado";
+                    if (after.active) summary->reactivated++; else summary->deactivated++;
+                }
+                if (mask & CHANGED_PRICE) summary->price_changed++;
+                if (mask & CHANGED_QUANTITY) summary->quantity_changed++;
+                if (mask & CHANGED_OTHER) summary->other_changed++;
+                if (report) write_change(report, change, mask, &before, &after);
+            }
+            has_before = advance(before_reader, &before, &before_last);
+            has_after = advance(after_reader, &after, &after_last);
+        }
+    }
+    int ok = has_before == 0 && has_after == 0;
+
+    if (report) {
+        report_put_text(report, "\nresumo,quantidade\n");
+        write_summary_line(report, "novos", summary->added);
+        write_summary_line(report, "removidos", summary->removed);
+        write_summary_line(report, "inativados", summary->deactivated);
+        write_summary_line(report, "reativados", summary->reactivated);
+        write_summary_line(report, "preco_alterado", summary->price_changed);
+        write_summary_line(report, "quantidade_alterada", summary->quantity_changed);
+        write_summary_line(report, "outros_campos", summary->other_changed);
+        write_summary_line(report, "sem_alteracao", summary->unchanged);
+        if (!end_report_file(report, report_path, ok)) ok = 0;
+    }
+    close_snapshot_reader(before_reader);
+    close_snapshot_reader(after_reader);
+    free(readers);
+
+    summary->elapsed_seconds = monotonic_seconds() - started_at;
+    if (ok) {
+        log_message(LOG_INFO, "snapshot_diff", "Comparacao de arquivos concluida");
+    }
+    return ok;
+}
+
+// verifica se não há diferenças
+int snapshots_identical(const snapshot_diff_summary *summary) {
+    if (!summary) return 0;
+    return summary->changed_products == 0 && !summary->header_changed
+        && summary->old_count == summary->new_count;
+}
@@ -0,0 +1,531 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sorting.h"
+#include "logger.h"
+#include "sync.h"
+#include "utils.h"
+
+// ============================================================================
+// MÓDULO: sorting — Implementação das visões ordenadas
+// ============================================================================
+// As visões são guardadas por banco (até SORT_CACHED_BANKS bancos, o menos
+// usado é reaproveitado), identificado pelo endereço e pela inicialização:
+// um banco recarregado nunca reaproveita a visão anterior. A trava global
+// cobre só o diretório de bancos; cada visão tem seu mutex, mantido durante
+// a atualização (alocação e ordenação) e a cópia, de modo que ordenar uma
+// visão não segura as demais. Um banco em uso (users > 0) não é reaproveitado.
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// quantidade de chaves de ordenação
+#define SORT_KEY_COUNT (SORT_BY_VALUE + 1)
+// bytes do nome normalizado que entram na chave
+#define NAME_KEY_BYTES 8
+// a visão é ordenada do zero quando mais de 1/INCREMENTAL_DIVISOR dos
+// produtos mudou desde a última construção
+#define INCREMENTAL_DIVISOR 16
+// bancos com visões guardadas ao mesmo tempo (ex.: vários handles da biblioteca)
+#define SORT_CACHED_BANKS 16
+
+// chave extraída de uma posição do banco
+typedef struct {
+    uint64_t key;           // chave já ajustada à direção
+    uint32_t check;         // hash do nome (só SORT_BY_NAME): detecta renomeação
+    int active;             // 1 se o produto estava ativo na extração
+} slot_state;
+
+// visão guardada de uma ordem
+typedef struct {
+    pthread_mutex_t lock;   // serializa atualização e cópia (iniciado uma vez)
+    const product_bank *bank;
+    uint64_t epoch;         // inicialização do banco na construção
+    uint64_t generation;    // geração do banco na construção (0 = não construída)
+    int slot_count;         // posições cobertas por states
+    int capacity;           // posições alocadas
+    slot_state *states;     // chaves da última construção, por posição
+    slot_state *fresh;      // chaves da extração atual (trocado com states)
+    int *sorted;            // posições dos ativos, na ordem da visão
+    int sorted_count;
+} sorted_view;
+
+// visões de um banco: uma por chave e direção
+typedef struct {
+    const product_bank *bank;   // NULL = livre
+    uint64_t last_used;
+    int users;                  // chamadas com visões deste banco em uso
+    sorted_view views[SORT_KEY_COUNT][2];
+} bank_views;
+
+static bank_views cached[SORT_CACHED_BANKS];
+static uint64_t cache_clock;
+static spin_lock views_lock;            // só o diretório (cached, users, last_used)
+static pthread_once_t view_locks_once = PTHREAD_ONCE_INIT;
+
+// inicia os mutexes de todas as visões
+static void init_view_locks(void) {
+    for (int i = 0; i < SORT_CACHED_BANKS; i++) {
+        for (int key = 0; key < SORT_KEY_COUNT; key++) {
+            for (int direction = 0; direction < 2; direction++) {
+                pthread_mutex_init(&cached[i].views[key][direction].lock, NULL);
+            }
+        }
+    }
+}
+
+// ============================================================================
+// COMPARAÇÃO DE NOMES
+// ============================================================================
+
+// compara dois nomes normalizados (prefixo menor vem antes)
+static int compare_folded(const char *a, int a_length, const char *b, int b_length) {
+    int common = a_length < b_length ? a_length : b_length;
+    int result = memcmp(a, b, (size_t)common);
+    if (result != 0) return result;
+    return (a_length > b_length) - (a_length < b_length);
+}
+
+// compara os nomes atuais de duas posições (chaves já normalizadas no banco)
+static int compare_slot_names(const product_bank *bank, int a, int b) {
+    name_key first, second;
+    if (read_name_key_at(bank, a, &first) < 0 || read_name_key_at(bank, b, &second) < 0) return 0;
+    return compare_folded(first.text, first.length, second.text, second.length);
+}
+
+// hash FNV-1a do nome normalizado
+static uint32_t name_check(const char *name, int length) {
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)name[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// ============================================================================
+// CHAVES
+// ============================================================================
+
+// chave de 64 bits do produto (crescente; a direção é aplicada depois)
+// - name: chave de nome da posição (usada só em SORT_BY_NAME)
+static uint64_t product_key(int key, const product *p, const name_key *name) {
+    uint64_t cents = (uint64_t)((double)p->price * 100.0 + 0.5);
+    uint64_t quantity = p->quantity > 0 ? (uint64_t)p->quantity : 0;
+    switch (key) {
+        case SORT_BY_NAME: {
+            uint64_t prefix = 0;
+            for (int i = 0; i < NAME_KEY_BYTES; i++) {
+                prefix = (prefix << 8) | (i < name->length ? (unsigned char)name->text[i] : 0);
+            }
+            return prefix;
+        }
+        case SORT_BY_PRICE:
+            return cents;
+        case SORT_BY_QUANTITY:
+            return quantity;
+        case SORT_BY_VALUE:
+            return cents * quantity;
+        default:
+            return (uint64_t)(unsigned)p->code;
+    }
+}
+
+// extrai as chaves de todas as posições do banco para view->fresh
+static void extract_states(sorted_view *view, int key, int descending, int total) {
+    product item;
+    name_key name;
+    name.length = 0;
+    for (int slot = 0; slot < total; slot++) {
+        slot_state *state = &view->fresh[slot];
+        int status = read_product_at(view->bank, slot, &item);
+        state->active = status == 1;
+        state->key = 0;
+        state->check = 0;
+        if (!state->active) continue;
+        if (key == SORT_BY_NAME && read_name_key_at(view->bank, slot, &name) < 0) name.length = 0;
+        state->key = product_key(key, &item, &name);
+        if (descending) state->key = ~state->key;
+        if (key == SORT_BY_NAME) state->check = name_check(name.text, name.length);
+    }
+}
+
+// ordem entre duas posições da visão: chave, nome completo (nomes com o
+// mesmo prefixo) e, por fim, código
+static int compare_entries(const sorted_view *view, int key, int descending, int a, int b) {
+    uint64_t a_key = view->fresh[a].key, b_key = view->fresh[b].key;
+    if (a_key != b_key) return a_key < b_key ? -1 : 1;
+    if (key == SORT_BY_NAME) {
+        int result = compare_slot_names(view->bank, a, b);
+        if (result != 0) return descending ? -result : result;
+    }
+    return (a > b) - (a < b);
+}
+
+// ============================================================================
+// ORDENAÇÃO
+// ============================================================================
+
+// radix sort LSD estável de 8 bits
+void radix_sort_pairs(sort_pair *pairs, sort_pair *scratch, size_t count) {
+    if (count < 2) return;
+    // um único percurso conta os 8 bytes de todas as chaves
+    size_t histogram[8][256];
+    memset(histogram, 0, sizeof(histogram));
+    for (size_t i = 0; i < count; i++) {
+        uint64_t key = pairs[i].key;
+        for (int b = 0; b < 8; b++) {
+            histogram[b][(key >> (8 * b)) & 0xFF]++;
+        }
+    }
+
+    sort_pair *from = pairs, *to = scratch;
+    for (int b = 0; b < 8; b++) {
+        size_t *counts = histogram[b];
+        // todos no mesmo balde: esta passada não muda nada
+        if (counts[(from[0].key >> (8 * b)) & 0xFF] == count) continue;
+
+        size_t offset = 0;
+        for (int d = 0; d < 256; d++) {
+            size_t n = counts[d];
+            counts[d] = offset;
+            offset += n;
+        }
+        for (size_t i = 0; i < count; i++) {
+            to[counts[(from[i].key >> (8 * b)) & 0xFF]++] = from[i];
+        }
+        sort_pair *swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from != pairs) memcpy(pairs, from, count * sizeof(sort_pair));
+}
+
+// nome normalizado de um produto em um trecho de mesmo prefixo
+typedef struct {
+    int slot;
+    int sign;               // -1 nas ordens decrescentes
+    name_key name;
+} named_slot;
+
+// nome e depois código
+static int compare_named_slots(const void *a, const void *b) {
+    const named_slot *first = a, *second = b;
+    int result = compare_folded(first->name.text, first->name.length,
+                                second->name.text, second->name.length);
+    if (result != 0) return result * first->sign;
+    return (first->slot > second->slot) - (first->slot < second->slot);
+}
+
+// ordena pelo nome completo os trechos com o mesmo prefixo de 8 bytes
+// - retorna 1 se sucesso, 0 se memória insuficiente
+static int refine_name_ties(const product_bank *bank, sort_pair *pairs, size_t count, int descending) {
+    size_t start = 0;
+    while (start < count) {
+        size_t end = start + 1;
+        while (end < count && pairs[end].key == pairs[start].key) end++;
+        size_t run = end - start;
+        if (run > 1) {
+            named_slot *names = malloc(run * sizeof(named_slot));
+            if (!names) return 0;
+            for (size_t i = 0; i < run; i++) {
+                names[i].slot = pairs[start + i].slot;
+                names[i].sign = descending ? -1 : 1;
+                if (read_name_key_at(bank, names[i].slot, &names[i].name) < 0) names[i].name.length = 0;
+            }
+            qsort(names, run, sizeof(named_slot), compare_named_slots);
+            for (size_t i = 0; i < run; i++) pairs[start + i].slot = names[i].slot;
+            free(names);
+        }
+        start = end;
+    }
+    return 1;
+}
+
+// ordena as posições ativas listadas em slots (na ordem da visão)
+// - slots pode ter qualquer ordem; sai ordenado no lugar
+// - retorna 1 se sucesso, 0 se memória insuficiente
+static int sort_slots(const sorted_view *view, int key, int descending, int *slots, int count) {
+    if (count < 2) return 1;
+    sort_pair *pairs = malloc(2 * (size_t)count * sizeof(sort_pair));
+    if (!pairs) return 0;
+    for (int i = 0; i < count; i++) {
+        pairs[i].key = view->fresh[slots[i]].key;
+        pairs[i].slot = slots[i];
+    }
+    // o radix sort é estável: com as posições em ordem crescente na entrada,
+    // os empates já saem em ordem de código
+    radix_sort_pairs(pairs, pairs + count, (size_t)count);
+    int ok = key != SORT_BY_NAME || refine_name_ties(view->bank, pairs, (size_t)count, descending);
+    for (int i = 0; i < count; i++) slots[i] = pairs[i].slot;
+    free(pairs);
+    return ok;
+}
+
+// ============================================================================
+// CONSTRUÇÃO DAS VISÕES
+// ============================================================================
+
+// garante espaço para total posições
+static int reserve_view(sorted_view *view, int total) {
+    if (total <= view->capacity) return 1;
+    slot_state *states = realloc(view->states, (size_t)total * sizeof(slot_state));
+    if (!states) return 0;
+    view->states = states;
+    slot_state *fresh = realloc(view->fresh, (size_t)total * sizeof(slot_state));
+    if (!fresh) return 0;
+    view->fresh = fresh;
+    int *sorted = realloc(view->sorted, (size_t)total * sizeof(int));
+    if (!sorted) return 0;
+    view->sorted = sorted;
+    view->capacity = total;
+    return 1;
+}
+
+// ordena do zero todas as posições ativas
+static int rebuild_view(sorted_view *view, int key, int descending, int total) {
+    int count = 0;
+    for (int slot = 0; slot < total; slot++) {
+        if (view->fresh[slot].active) view->sorted[count++] = slot;
+    }
+    if (!sort_slots(view, key, descending, view->sorted, count)) return 0;
+    view->sorted_count = count;
+    return 1;
+}
+
+// retira da visão as posições alteradas e intercala de volta as que
+// continuam ativas, já ordenadas entre si
+static int merge_changes(sorted_view *view, int key, int descending, int total,
+                         const unsigned char *dirty, int changed) {
+    int *changed_slots = malloc((size_t)(changed > 0 ? changed : 1) * sizeof(int));
+    int *merged = malloc((size_t)(total > 0 ? total : 1) * sizeof(int));
+    if (!changed_slots || !merged) {
+        free(changed_slots);
+        free(merged);
+        return 0;
+    }
+
+    int added = 0;
+    for (int slot = 0; slot < total; slot++) {
+        if (dirty[slot] && view->fresh[slot].active) changed_slots[added++] = slot;
+    }
+    if (!sort_slots(view, key, descending, changed_slots, added)) {
+        free(changed_slots);
+        free(merged);
+        return 0;
+    }
+
+    int count = 0, next = 0;
+    for (int i = 0; i < view->sorted_count; i++) {
+        int slot = view->sorted[i];
+        if (slot >= total || dirty[slot]) continue;
+        while (next < added && compare_entries(view, key, descending, changed_slots[next], slot) < 0) {
+            merged[count++] = changed_slots[next++];
+        }
+        merged[count++] = slot;
+    }
+    while (next < added) merged[count++] = changed_slots[next++];
+
+    memcpy(view->sorted, merged, (size_t)count * sizeof(int));
+    view->sorted_count = count;
+    free(changed_slots);
+    free(merged);
+    return 1;
+}
+
+// atualiza a visão para a geração atual do banco (chamada com view->lock)
+static int refresh_view(sorted_view *view, const product_bank *bank, int key, int descending) {
+    // banco reinicializado: as chaves guardadas não valem mais
+    if (view->epoch != bank->epoch) {
+        view->generation = 0;
+        view->slot_count = 0;
+        view->sorted_count = 0;
+        view->epoch = bank->epoch;
+    }
+    uint64_t generation = bank_generation(bank);
+    if (view->generation == generation) return 1;
+
+    int total = __atomic_load_n(&bank->count, __ATOMIC_ACQUIRE);
+    if (!reserve_view(view, total)) return 0;
+    // posições nunca somem de um banco; se sumiram, ele foi reinicializado
+    int reusable = view->generation != 0 && total >= view->slot_count;
+    view->bank = bank;
+    extract_states(view, key, descending, total);
+
+    // posições cujas chaves mudaram desde a última construção
+    unsigned char *dirty = NULL;
+    int changed = 0;
+    if (reusable) {
+        dirty = calloc((size_t)(total > 0 ? total : 1), 1);
+        if (!dirty) return 0;
+        for (int slot = 0; slot < total; slot++) {
+            const slot_state *now = &view->fresh[slot];
+            int differs;
+            if (slot >= view->slot_count) {
+                differs = 1;
+            } else {
+                const slot_state *before = &view->states[slot];
+                differs = now->active != before->active || now->key != before->key
+                       || now->check != before->check;
+            }
+            if (differs) {
+                dirty[slot] = 1;
+                changed++;
+            }
+        }
+    }
+
+    int ok;
+    if (reusable && (long long)changed * INCREMENTAL_DIVISOR <= total) {
+        ok = changed == 0 || merge_changes(view, key, descending, total, dirty, changed);
+    } else {
+        ok = rebuild_view(view, key, descending, total);
+    }
+    free(dirty);
+
+    if (!ok) {
+        view->generation = 0;
+        return 0;
+    }
+    // as chaves extraídas passam a ser a referência da próxima atualização
+    slot_state *swap = view->states;
+    view->states = view->fresh;
+    view->fresh = swap;
+    view->slot_count = total;
+    view->generation = generation;
+    return 1;
+}
+
+// libera a memória das visões de um banco (chamada com views_lock, sem users)
+// - o mutex de cada visão é mantido
+static void release_views(bank_views *entry) {
+    for (int key = 0; key < SORT_KEY_COUNT; key++) {
+        for (int direction = 0; direction < 2; direction++) {
+            sorted_view *view = &entry->views[key][direction];
+            free(view->states);
+            free(view->fresh);
+            free(view->sorted);
+            view->bank = NULL;
+            view->epoch = 0;
+            view->generation = 0;
+            view->slot_count = 0;
+            view->capacity = 0;
+            view->states = NULL;
+            view->fresh = NULL;
+            view->sorted = NULL;
+            view->sorted_count = 0;
+        }
+    }
+}
+
+// visões do banco, marcadas em uso (chamada com views_lock)
+// - banco novo: ocupa uma entrada livre ou a usada há mais tempo sem users
+// - retorna NULL se todas as entradas estão em uso
+static bank_views *views_of(const product_bank *bank) {
+    bank_views *entry = NULL;
+    for (int i = 0; i < SORT_CACHED_BANKS && !entry; i++) {
+        if (cached[i].bank == bank) entry = &cached[i];
+    }
+    if (!entry) {
+        for (int i = 0; i < SORT_CACHED_BANKS; i++) {
+            if (!cached[i].bank) {
+                entry = &cached[i];
+                break;
+            }
+            if (cached[i].users == 0 && (!entry || cached[i].last_used < entry->last_used)) {
+                entry = &cached[i];
+            }
+        }
+        if (!entry) return NULL;
+        release_views(entry);
+        entry->bank = bank;
+    }
+    entry->last_used = ++cache_clock;
+    entry->users++;
+    return entry;
+}
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+// valida a ordem
+int is_valid_sort_order(int order) {
+    int key = order & ~SORT_DESCENDING;
+    return key >= SORT_BY_CODE && key <= SORT_BY_VALUE;
+}
+
+// posições na ordem pedida
+int sorted_slots(const product_bank *bank, int order, int out_slots[], size_t max_out) {
+    if (!bank || !out_slots || !is_valid_sort_order(order)) return -1;
+    int key = order & ~SORT_DESCENDING;
+    int descending = (order & SORT_DESCENDING) != 0;
+
+    // ordem de código crescente é a própria ordem do banco
+    if (key == SORT_BY_CODE && !descending) {
+        product item;
+        int count = 0;
+        for (int slot = 0; count < (int)max_out && read_product_at(bank, slot, &item) >= 0; slot++) {
+            if (item.active) out_slots[count++] = slot;
+        }
+        return count;
+    }
+
+    pthread_once(&view_locks_once, init_view_locks);
+    spin_lock_acquire(&views_lock);
+    bank_views *entry = views_of(bank);
+    spin_lock_release(&views_lock);
+    if (!entry) {
+        log_message(LOG_ERROR, "sorting", "Sem entrada livre para as visoes ordenadas");
+        return -1;
+    }
+
+    // a atualização corre fora da trava global: só esta visão espera
+    sorted_view *view = &entry->views[key][descending];
+    pthread_mutex_lock(&view->lock);
+    int count = -1;
+    if (refresh_view(view, bank, key, descending)) {
+        count = view->sorted_count < (int)max_out ? view->sorted_count : (int)max_out;
+        memcpy(out_slots, view->sorted, (size_t)count * sizeof(int));
+    }
+    pthread_mutex_unlock(&view->lock);
+
+    spin_lock_acquire(&views_lock);
+    entry->users--;
+    spin_lock_release(&views_lock);
+    if (count < 0) log_message(LOG_ERROR, "sorting", "Memoria insuficiente para ordenar a listagem");
+    return count;
+}
+
+// libera as visões de todos os bancos
+void free_sorted_views(void) {
+    spin_lock_acquire(&views_lock);
+    for (int i = 0; i < SORT_CACHED_BANKS; i++) {
+        release_views(&cached[i]);
+        cached[i].bank = NULL;
+    }
+    spin_lock_release(&views_lock);
+}
+
+// libera as visões de um banco
+void forget_sorted_views(const product_bank *bank) {
+    spin_lock_acquire(&views_lock);
+    for (int i = 0; i < SORT_CACHED_BANKS; i++) {
+        if (cached[i].bank == bank) {
+            release_views(&cached[i]);
+            cached[i].bank = NULL;
+        }
+    }
+    spin_lock_release(&views_lock);
+}
+
+// ordem -> string
+const char *sort_order_to_string(int order) {
+    int descending = (order & SORT_DESCENDING) != 0;
+    switch (order & ~SORT_DESCENDING) {
+        case SORT_BY_CODE: return descending ? "Codigo (decrescente)" : "Codigo";
+        case SORT_BY_NAME: return descending ? "Nome (Z-A)" : "Nome (A-Z)";
+        case SORT_BY_PRICE: return descending ? "Maior preco" : "Menor preco";
+        case SORT_BY_QUANTITY: return descending ? "Maior quantidade" : "Menor quantidade";
+        case SORT_BY_VALUE: return descending ? "Maior valor em estoque" : "Menor valor em estoque";
+        default: return "Desconhecida";
+    }
+}
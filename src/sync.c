@@ -0,0 +1,123 @@
+#include <pthread.h>
+#include "sync.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+    #define yield_thread() SwitchToThread()
+#else
+    #include <sched.h>
+    #include <unistd.h>
+    #define yield_thread() sched_yield()
+#endif
+
+// ============================================================================
+// MÓDULO: sync — Implementação das primitivas de sincronização
+// ============================================================================
+// Usa as operações __atomic do GCC (disponíveis também no MinGW/ucrt64)
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// tentativas de espera ativa antes de ceder o processador
+#define SPIN_LIMIT 128
+
+// espera um pouco antes de tentar novamente (cede a CPU após muitas tentativas)
+static void spin_wait(unsigned *spins) {
+    if (++(*spins) >= SPIN_LIMIT) {
+        *spins = 0;
+        yield_thread();
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    else {
+        __builtin_ia32_pause();
+    }
+#endif
+}
+
+// adquire a trava de espera ativa
+void spin_lock_acquire(spin_lock *lock) {
+    unsigned spins = 0;
+    for (;;) {
+        // só tenta o exchange quando a trava parece livre (menos tráfego de cache)
+        if (!__atomic_load_n(&lock->locked, __ATOMIC_RELAXED)
+            && !__atomic_exchange_n(&lock->locked, 1, __ATOMIC_ACQUIRE)) {
+            return;
+        }
+        spin_wait(&spins);
+    }
+}
+
+// libera a trava de espera ativa
+void spin_lock_release(spin_lock *lock) {
+    __atomic_store_n(&lock->locked, 0, __ATOMIC_RELEASE);
+}
+
+// inicia escrita: torna a sequência ímpar (exclusivo entre escritores)
+void seq_lock_write_begin(seq_lock *lock) {
+    unsigned spins = 0;
+    for (;;) {
+        unsigned current = __atomic_load_n(&lock->sequence, __ATOMIC_RELAXED);
+        if (!(current & 1u)
+            && __atomic_compare_exchange_n(&lock->sequence, &current, current + 1,
+                                           1, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            // garante que a sequência ímpar fique visível antes dos dados
+            __atomic_thread_fence(__ATOMIC_RELEASE);
+            return;
+        }
+        spin_wait(&spins);
+    }
+}
+
+// encerra escrita: sequência volta a ser par
+void seq_lock_write_end(seq_lock *lock) {
+    __atomic_fetch_add(&lock->sequence, 1, __ATOMIC_RELEASE);
+}
+
+// inicia leitura: aguarda sequência par
+unsigned seq_lock_read_begin(const seq_lock *lock) {
+    unsigned spins = 0;
+    for (;;) {
+        unsigned current = __atomic_load_n(&lock->sequence, __ATOMIC_ACQUIRE);
+        if (!(current & 1u)) {
+            return current;
+        }
+        spin_wait(&spins);
+    }
+}
+
+// confere se a sequência mudou desde o início da leitura
+int seq_lock_read_retry(const seq_lock *lock, unsigned start) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&lock->sequence, __ATOMIC_RELAXED) != start;
+}
+
+// consulta a quantidade de processadores do sistema
+int cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int count = (int)info.dwNumberOfProcessors;
+#else
+    int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return count > 0 ? count : 1;
+}
+
+// executa as tarefas em paralelo e espera todas terminarem
+void run_parallel(void *(*worker)(void *), void *tasks, size_t task_size, int count) {
+    pthread_t threads[PARALLEL_MAX_THREADS];
+    int started = 0;
+    if (count > PARALLEL_MAX_THREADS) count = PARALLEL_MAX_THREADS;
+
+    for (int t = 1; t < count; t++) {
+        void *task = (char *)tasks + t * task_size;
+        if (pthread_create(&threads[started], NULL, worker, task) != 0) {
+            worker(task);  // sem thread disponível: executa na thread atual
+            continue;
+        }
+        started++;
+    }
+    if (count > 0) worker(tasks);
+    for (int t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+    }
+}
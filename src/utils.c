@@ -1,9 +1,15 @@
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <time.h>
 #include "utils.h"
 
+#ifdef _WIN32
+    #include <windows.h>
+#endif
+
 // ============================================================================
 // MÓDULO: utils — Implementação das funções utilitárias
 // ============================================================================
@@ -123,16 +129,113 @@ void read_str_safe(char *str, int max_length) {
 
 // converte todos os caracteres de uma string para maiúsculas (in-place)
 // útil para comparações case-insensitive
+// letras acentuadas de 2 bytes (0xC3 0xA0..0xBE, "ç" -> "Ç") também são
+// convertidas: a maiúscula fica 0x20 abaixo no segundo byte
 void str_to_upper(char *str) {
     for (int i = 0; str[i] != '\0'; ++i) {
+        unsigned char c = (unsigned char)str[i];
+        if (c == 0xC3) {
+            unsigned char next = (unsigned char)str[i + 1];
+            // 0xB7 é o sinal de divisão, 0xBF ("ÿ") não tem maiúscula em Latin-1
+            if (next >= 0xA0 && next <= 0xBE && next != 0xB7) str[i + 1] = (char)(next - 0x20);
+            if (next != '\0') ++i;
+            continue;
+        }
         // cast para unsigned char previne comportamento indefinido com ASCII estendido
-        str[i] = (char) toupper((unsigned char) str[i]);
+        str[i] = (char)(c < 0x80 ? toupper(c) : c);
     }
 }
 
+// letras de 2 bytes por byte inicial 0xC2..0xC5 (U+0080..U+017F): letra
+// base de cada segundo byte 0x80..0xBF; '_' = mantém os dois bytes
+static const char fold_rows[4][65] = {
+    // 0xC2: símbolos; só o espaço não separável (U+00A0) vira espaço
+    "________________________________ _______________________________",
+    // 0xC3: Latin-1 (À..ÿ)
+    "aaaaaaaceeeeiiiidnooooo_ouuuuy_saaaaaaaceeeeiiiidnooooo_ouuuuy_y",
+    // 0xC4: Latin Extended-A (Ā..Ŀ)
+    "aaaaaaccccccccddddeeeeeeeeeegggggggghhhhiiiiiiiiii__jjkkklllllll",
+    // 0xC5: Latin Extended-A (ŀ..ſ)
+    "lllnnnnnnnnnoooooo__rrrrrrssssssssttttttuuuuuuuuuuuuwwyyyzzzzzzs"
+};
+
+// converte 8 bytes ASCII (nenhum com o bit alto) para minúsculas de uma vez
+// - soma constantes a todos os bytes ao mesmo tempo: o bit alto de cada byte
+//   indica se ele é >= 'A' e se é > 'Z' (sem vai-um entre bytes, já que todos
+//   são menores que 0x80); as letras maiúsculas ganham o bit 0x20
+static uint64_t lower_ascii_word(uint64_t word) {
+    const uint64_t ones = 0x0101010101010101ULL;
+    uint64_t at_least_a = word + ones * (0x80 - 'A');
+    uint64_t above_z = word + ones * (0x80 - 'Z' - 1);
+    uint64_t upper = at_least_a & ~above_z & (ones * 0x80);
+    return word | (upper >> 2);
+}
+
+// normaliza texto: minúsculas e sem acentos
+int fold_text(const char *text, size_t max_length, char *out) {
+    const char *end = memchr(text, '\0', max_length);
+    size_t n = end ? (size_t)(end - text) : max_length;
+    size_t i = 0, length = 0;
+    while (i < n) {
+        // caminho rápido: trechos só de ASCII andam 8 bytes por vez
+        if (i + 8 <= n) {
+            uint64_t word;
+            memcpy(&word, text + i, sizeof(word));
+            if ((word & 0x8080808080808080ULL) == 0) {
+                word = lower_ascii_word(word);
+                memcpy(out + length, &word, sizeof(word));
+                i += 8;
+                length += 8;
+                continue;
+            }
+        }
+
+        unsigned char c = (unsigned char)text[i];
+        if (c < 0x80) {
+            out[length++] = (char)((c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c);
+            i++;
+            continue;
+        }
+        unsigned char next = i + 1 < n ? (unsigned char)text[i + 1] : 0;
+        if ((next & 0xC0) == 0x80) {
+            if (c >= 0xC2 && c <= 0xC5) {
+                char base = fold_rows[c - 0xC2][next - 0x80];
+                if (base != '_') {
+                    out[length++] = base;
+                    i += 2;
+                    continue;
+                }
+            } else if (c == 0xCC || (c == 0xCD && next < 0xB0)) {
+                // acento combinante (U+0300..U+036F, texto decomposto): descartado
+                i += 2;
+                continue;
+            }
+        }
+        // demais bytes (outros alfabetos, símbolos) ficam como estão
+        out[length++] = (char)c;
+        i++;
+    }
+    out[length] = '\0';
+    return (int)length;
+}
+
 // pausa a execução aguardando o usuário pressionar ENTER
 // usado para manter telas de menu e mensagens visíveis
 void pause_screen(void) {
     printf("\nPressione ENTER para continuar...");
     clear_input_buffer();
 }
+
+// relógio monotônico (não sofre ajustes de data/hora do sistema)
+double monotonic_seconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+#endif
+}
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <math.h>
@@ -108,3 +109,184 @@ int is_valid_unit(int unit) {
     }
     return 1;
 }
+
+// ============================================================================
+// VALIDAÇÃO EM LOTE
+// ============================================================================
+
+// linhas por bloco (bits de uma palavra dos mapas)
+#define VALIDATION_BLOCK 64
+
+// classes de byte dos nomes
+#define NAME_BYTE_INVALID 1     // fora do conjunto aceito por is_valid_name_format
+#define NAME_BYTE_VISIBLE 2     // conta como caractere não branco
+
+// motivos de erro por regra (mesmos textos do modo lote)
+static const char *const rule_messages[VALIDATION_RULE_COUNT] = {
+    "nome invalido", "preco invalido", "quantidade invalida",
+    "estoque minimo invalido", "categoria invalida", "unidade invalida"
+};
+
+// monta a tabela de classes com as mesmas regras de is_valid_name_format
+static void build_name_classes(unsigned char classes[256]) {
+    for (int c = 0; c < 256; c++) {
+        if (c == ' ') {
+            classes[c] = 0;
+        } else if (isalpha(c) || isdigit(c) || c == '-' || c == '\'' || c >= 128) {
+            classes[c] = NAME_BYTE_VISIBLE;
+        } else {
+            classes[c] = NAME_BYTE_INVALID;
+        }
+    }
+}
+
+// junta as marcas (0 ou 1) de n linhas nos bits de uma palavra
+static uint64_t pack_flags(const unsigned char flags[VALIDATION_BLOCK], size_t n) {
+    uint64_t word = 0;
+    for (size_t i = 0; i < n; i++) word |= (uint64_t)flags[i] << i;
+    return word;
+}
+
+// nomes do bloco: uma consulta à tabela por byte
+static void check_names(const char *const *names, size_t n, const unsigned char classes[256],
+                        unsigned char flags[VALIDATION_BLOCK]) {
+    for (size_t i = 0; i < n; i++) {
+        const unsigned char *name = (const unsigned char *)names[i];
+        if (!name) {
+            flags[i] = 1;
+            continue;
+        }
+        unsigned char seen = 0;
+        size_t length = 0;
+        for (; name[length]; length++) seen |= classes[name[length]];
+        flags[i] = (length < 2) | ((seen & NAME_BYTE_INVALID) != 0) | ((seen & NAME_BYTE_VISIBLE) == 0);
+    }
+}
+
+// preços do bloco: faixa e duas casas decimais, sem desvios
+// (fora da faixa o valor escalado é zerado, evitando conversões indefinidas)
+static void check_prices(const float *prices, size_t n, unsigned char flags[VALIDATION_BLOCK]) {
+    for (size_t i = 0; i < n; i++) {
+        float price = prices[i];
+        int in_range = (price >= MIN_PRICE) & (price <= MAX_PRICE);
+        float scaled = in_range ? price * 100.0f : 0.0f;
+        float error = scaled - (float)(int)(scaled + 0.5f);
+        error = error < 0.0f ? -error : error;
+        flags[i] = (unsigned char)(!in_range | (error > 0.001f));
+    }
+}
+
+// faixa fechada [low, high] de uma coluna inteira
+static void check_int_range(const int *values, size_t n, int low, int high,
+                            unsigned char flags[VALIDATION_BLOCK]) {
+    for (size_t i = 0; i < n; i++) {
+        flags[i] = (unsigned char)((values[i] < low) | (values[i] > high));
+    }
+}
+
+// estoque mínimo do bloco (não negativo e até a quantidade)
+static void check_minimum_stocks(const int *minimums, const int *quantities, size_t n,
+                                 unsigned char flags[VALIDATION_BLOCK]) {
+    for (size_t i = 0; i < n; i++) {
+        flags[i] = (unsigned char)((minimums[i] < 0) | (minimums[i] > quantities[i]));
+    }
+}
+
+// valida todas as linhas em uma passada, bloco a bloco
+int validate_product_columns(const product_columns *columns, validation_report *report) {
+    if (!columns || !report) return 0;
+    memset(report, 0, sizeof(*report));
+    report->count = columns->count;
+    report->words = (columns->count + VALIDATION_BLOCK - 1) / VALIDATION_BLOCK;
+
+    // um bloco de memória para todos os mapas (regras + qualquer regra)
+    uint64_t *maps = calloc((VALIDATION_RULE_COUNT + 1) * (report->words ? report->words : 1),
+                            sizeof(uint64_t));
+    if (!maps) return 0;
+    for (int rule = 0; rule < VALIDATION_RULE_COUNT; rule++) {
+        report->failures[rule] = maps + (size_t)rule * report->words;
+    }
+    report->invalid = maps + (size_t)VALIDATION_RULE_COUNT * report->words;
+
+    unsigned char classes[256];
+    unsigned char flags[VALIDATION_BLOCK];
+    build_name_classes(classes);
+
+    for (size_t w = 0; w < report->words; w++) {
+        size_t base = w * VALIDATION_BLOCK;
+        size_t n = columns->count - base < VALIDATION_BLOCK ? columns->count - base : VALIDATION_BLOCK;
+        uint64_t words[VALIDATION_RULE_COUNT] = { 0 };
+
+        if (columns->names) {
+            check_names(columns->names + base, n, classes, flags);
+            words[VALIDATION_RULE_NAME] = pack_flags(flags, n);
+        }
+        if (columns->prices) {
+            check_prices(columns->prices + base, n, flags);
+            words[VALIDATION_RULE_PRICE] = pack_flags(flags, n);
+        }
+        if (columns->quantities) {
+            check_int_range(columns->quantities + base, n, 0, MAX_QUANTITY, flags);
+            words[VALIDATION_RULE_QUANTITY] = pack_flags(flags, n);
+        }
+        if (columns->minimum_stocks && columns->quantities) {
+            check_minimum_stocks(columns->minimum_stocks + base, columns->quantities + base, n, flags);
+            words[VALIDATION_RULE_MINIMUM_STOCK] = pack_flags(flags, n);
+        }
+        if (columns->categories) {
+            check_int_range(columns->categories + base, n, 1, 5, flags);
+            words[VALIDATION_RULE_CATEGORY] = pack_flags(flags, n);
+        }
+        if (columns->units) {
+            check_int_range(columns->units + base, n, 1, 5, flags);
+            words[VALIDATION_RULE_UNIT] = pack_flags(flags, n);
+        }
+
+        uint64_t any = 0;
+        for (int rule = 0; rule < VALIDATION_RULE_COUNT; rule++) {
+            report->failures[rule][w] = words[rule];
+            report->failure_counts[rule] += (size_t)__builtin_popcountll(words[rule]);
+            any |= words[rule];
+        }
+        report->invalid[w] = any;
+        report->invalid_count += (size_t)__builtin_popcountll(any);
+    }
+    return 1;
+}
+
+// regras violadas por uma linha
+unsigned validation_row_failures(const validation_report *report, size_t row) {
+    if (!report || !report->invalid || row >= report->count) return 0;
+    unsigned mask = 0;
+    for (int rule = 0; rule < VALIDATION_RULE_COUNT; rule++) {
+        mask |= (unsigned)((report->failures[rule][row / VALIDATION_BLOCK] >> (row % VALIDATION_BLOCK)) & 1) << rule;
+    }
+    return mask;
+}
+
+// próxima linha com falha na regra, a partir de row
+size_t next_validation_failure(const validation_report *report, validation_rule rule, size_t row) {
+    if (!report || !report->invalid || rule > VALIDATION_RULE_COUNT) return report ? report->count : 0;
+    const uint64_t *map = rule == VALIDATION_RULE_COUNT ? report->invalid : report->failures[rule];
+    size_t w = row / VALIDATION_BLOCK;
+    if (w >= report->words) return report->count;
+    // descarta os bits das linhas antes de row na primeira palavra
+    uint64_t word = map[w] & (~0ULL << (row % VALIDATION_BLOCK));
+    while (!word) {
+        if (++w >= report->words) return report->count;
+        word = map[w];
+    }
+    return w * VALIDATION_BLOCK + (size_t)__builtin_ctzll(word);
+}
+
+// motivo do erro de uma regra
+const char *validation_rule_message(validation_rule rule) {
+    return rule < VALIDATION_RULE_COUNT ? rule_messages[rule] : "regra desconhecida";
+}
+
+// libera os mapas (alocados em um bloco que começa no mapa da primeira regra)
+void free_validation_report(validation_report *report) {
+    if (!report) return;
+    free(report->failures[0]);
+    memset(report, 0, sizeof(*report));
+}
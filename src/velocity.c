@@ -0,0 +1,177 @@
+#include <math.h>
+#include <string.h>
+#include "velocity.h"
+
+// ============================================================================
+// MÓDULO: velocity — Implementação das métricas de venda
+// ============================================================================
+// Identificadores em inglês, snake_case; comentários em português
+// ============================================================================
+
+// segundos em um dia
+#define SECONDS_PER_DAY 86400.0
+
+// inicializa o acompanhamento
+void initialize_velocity_tracker(velocity_tracker *tracker, double half_life_days,
+                                 double horizon_days) {
+    if (!tracker) return;
+    memset(tracker, 0, sizeof(*tracker));
+    if (half_life_days <= 0.0) half_life_days = VELOCITY_DEFAULT_HALF_LIFE_DAYS;
+    if (horizon_days <= 0.0) horizon_days = VELOCITY_DEFAULT_HORIZON_DAYS;
+    tracker->lambda_per_day = log(2.0) / half_life_days;
+    tracker->horizon_days = horizon_days;
+    tracker->alert_head = -1;
+}
+
+// zera métricas mantendo a configuração
+void reset_velocity_tracker(velocity_tracker *tracker) {
+    if (!tracker) return;
+    spin_lock_acquire(&tracker->lock);
+    memset(tracker->entries, 0, sizeof(tracker->entries));
+    tracker->alert_head = -1;
+    tracker->alert_count = 0;
+    spin_lock_release(&tracker->lock);
+}
+
+// soma decaída da entrada no instante now (sem alterar a entrada)
+static double decayed_at(const velocity_tracker *tracker, const velocity_entry *e, uint32_t now) {
+    if (e->decayed_sales == 0.0 || now <= e->last_update) {
+        return e->decayed_sales;
+    }
+    double elapsed_days = (now - e->last_update) / SECONDS_PER_DAY;
+    return e->decayed_sales * exp(-tracker->lambda_per_day * elapsed_days);
+}
+
+// cobertura em dias para a soma decaída informada
+static double cover_for(const velocity_tracker *tracker, double decayed, int quantity) {
+    double velocity = tracker->lambda_per_day * decayed;
+    if (velocity <= 0.0) return DAYS_OF_COVER_INFINITE;
+    return quantity / velocity;
+}
+
+// insere a posição na lista de alerta (chamador segura a trava)
+static void alert_insert(velocity_tracker *tracker, int slot) {
+    velocity_entry *e = &tracker->entries[slot];
+    if (e->in_alert) return;
+    e->in_alert = 1;
+    e->alert_prev = -1;
+    e->alert_next = tracker->alert_head;
+    if (tracker->alert_head >= 0) {
+        tracker->entries[tracker->alert_head].alert_prev = slot;
+    }
+    tracker->alert_head = slot;
+    tracker->alert_count++;
+}
+
+// remove a posição da lista de alerta (chamador segura a trava)
+static void alert_remove(velocity_tracker *tracker, int slot) {
+    velocity_entry *e = &tracker->entries[slot];
+    if (!e->in_alert) return;
+    if (e->alert_prev >= 0) {
+        tracker->entries[e->alert_prev].alert_next = e->alert_next;
+    } else {
+        tracker->alert_head = e->alert_next;
+    }
+    if (e->alert_next >= 0) {
+        tracker->entries[e->alert_next].alert_prev = e->alert_prev;
+    }
+    e->in_alert = 0;
+    tracker->alert_count--;
+}
+
+// reavalia o alerta de uma posição com a soma já atualizada até now
+static void reevaluate(velocity_tracker *tracker, const product *p, int slot) {
+    velocity_entry *e = &tracker->entries[slot];
+    int quantity = __atomic_load_n(&p->quantity, __ATOMIC_RELAXED);
+    if (p->active && cover_for(tracker, e->decayed_sales, quantity) < tracker->horizon_days) {
+        alert_insert(tracker, slot);
+    } else {
+        alert_remove(tracker, slot);
+    }
+}
+
+// posição do produto no banco, ou -1 se não pertence a ele
+static int slot_of(const product_bank *bank, const product *p) {
+    if (!bank || !p || p < bank->list || p >= bank->list + MAX_PRODUCTS) return -1;
+    return (int)(p - bank->list);
+}
+
+// registra venda: decai a soma até o instante da venda e acrescenta a quantidade
+void velocity_record_sale(velocity_tracker *tracker, const product_bank *bank,
+                          const product *p, int quantity, uint32_t when) {
+    int slot = slot_of(bank, p);
+    if (!tracker || slot < 0 || quantity <= 0) return;
+
+    spin_lock_acquire(&tracker->lock);
+    velocity_entry *e = &tracker->entries[slot];
+    e->decayed_sales = decayed_at(tracker, e, when) + quantity;
+    if (when > e->last_update) e->last_update = when;
+    reevaluate(tracker, p, slot);
+    spin_lock_release(&tracker->lock);
+}
+
+// reavalia alerta após mudança de quantidade
+void velocity_refresh(velocity_tracker *tracker, const product_bank *bank,
+                      const product *p, uint32_t when) {
+    int slot = slot_of(bank, p);
+    if (!tracker || slot < 0) return;
+
+    spin_lock_acquire(&tracker->lock);
+    velocity_entry *e = &tracker->entries[slot];
+    e->decayed_sales = decayed_at(tracker, e, when);
+    if (when > e->last_update) e->last_update = when;
+    reevaluate(tracker, p, slot);
+    spin_lock_release(&tracker->lock);
+}
+
+// velocidade de vendas em unidades por dia
+double sales_velocity(velocity_tracker *tracker, const product_bank *bank,
+                      const product *p, uint32_t now) {
+    int slot = slot_of(bank, p);
+    if (!tracker || slot < 0) return 0.0;
+
+    spin_lock_acquire(&tracker->lock);
+    double decayed = decayed_at(tracker, &tracker->entries[slot], now);
+    spin_lock_release(&tracker->lock);
+    return tracker->lambda_per_day * decayed;
+}
+
+// dias de cobertura do estoque atual
+double days_of_cover(velocity_tracker *tracker, const product_bank *bank,
+                     const product *p, uint32_t now) {
+    int slot = slot_of(bank, p);
+    if (!tracker || slot < 0) return DAYS_OF_COVER_INFINITE;
+
+    spin_lock_acquire(&tracker->lock);
+    double decayed = decayed_at(tracker, &tracker->entries[slot], now);
+    spin_lock_release(&tracker->lock);
+    return cover_for(tracker, decayed, __atomic_load_n(&p->quantity, __ATOMIC_RELAXED));
+}
+
+// lista candidatos do alerta que ainda esgotam dentro de days dias
+int list_stockout_alerts(velocity_tracker *tracker, const product_bank *bank,
+                         double days, uint32_t now, product *out_array[], size_t max_out) {
+    if (!tracker || !bank || !out_array) return 0;
+    if (days > tracker->horizon_days) days = tracker->horizon_days;
+
+    spin_lock_acquire(&tracker->lock);
+    int count = 0;
+    int slot = tracker->alert_head;
+    while (slot >= 0 && count < (int)max_out) {
+        const product *p = &bank->list[slot];
+        velocity_entry *e = &tracker->entries[slot];
+        int next = e->alert_next;
+
+        double cover = cover_for(tracker, decayed_at(tracker, e, now),
+                                 __atomic_load_n(&p->quantity, __ATOMIC_RELAXED));
+        if (!p->active || cover >= tracker->horizon_days) {
+            // saiu do horizonte desde o último evento: limpa o candidato
+            alert_remove(tracker, slot);
+        } else if (cover < days) {
+            out_array[count++] = (product *)p;
+        }
+        slot = next;
+    }
+    spin_lock_release(&tracker->lock);
+    return count;
+}